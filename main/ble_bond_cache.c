@@ -0,0 +1,145 @@
+#include "ble_bond_cache.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static ble_bond_entry_t s_entries[BLE_BOND_CACHE_MAX];
+static size_t s_count = 0;
+static uint32_t s_use_seq = 0;
+// Loaded from the host task, read from status and control paths
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static bool ble_bond_cache_same(const ble_bond_entry_t *entry, uint8_t addr_type, const uint8_t addr[6])
+{
+    return entry->addr_type == addr_type && memcmp(entry->addr, addr, sizeof(entry->addr)) == 0;
+}
+
+// Called with s_lock held
+static ble_bond_entry_t *ble_bond_cache_find(uint8_t addr_type, const uint8_t addr[6])
+{
+    for (size_t i = 0; i < s_count; ++i)
+    {
+        if (ble_bond_cache_same(&s_entries[i], addr_type, addr))
+        {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+bool ble_bond_cache_load(const ble_bond_entry_t *peers, size_t count)
+{
+    bool fits = count <= BLE_BOND_CACHE_MAX;
+    if (!fits)
+    {
+        count = BLE_BOND_CACHE_MAX;
+    }
+
+    ble_bond_entry_t next[BLE_BOND_CACHE_MAX];
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < count; ++i)
+    {
+        next[i] = peers[i];
+        const ble_bond_entry_t *known = ble_bond_cache_find(peers[i].addr_type, peers[i].addr);
+        next[i].last_seen_us = known ? known->last_seen_us : peers[i].last_seen_us;
+        next[i].last_used = known ? known->last_used : 0;
+    }
+    memcpy(s_entries, next, count * sizeof(next[0]));
+    s_count = count;
+    portEXIT_CRITICAL(&s_lock);
+    return fits;
+}
+
+bool ble_bond_cache_touch(uint8_t addr_type, const uint8_t addr[6], int64_t now_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    ble_bond_entry_t *entry = ble_bond_cache_find(addr_type, addr);
+    if (entry)
+    {
+        entry->last_seen_us = now_us;
+        entry->last_used = ++s_use_seq;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return entry != NULL;
+}
+
+bool ble_bond_cache_promote(uint8_t addr_type, const uint8_t addr[6])
+{
+    portENTER_CRITICAL(&s_lock);
+    ble_bond_entry_t *entry = ble_bond_cache_find(addr_type, addr);
+    if (entry)
+    {
+        entry->last_used = ++s_use_seq;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return entry != NULL;
+}
+
+size_t ble_bond_cache_count(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    size_t count = s_count;
+    portEXIT_CRITICAL(&s_lock);
+    return count;
+}
+
+bool ble_bond_cache_contains(uint8_t addr_type, const uint8_t addr[6])
+{
+    portENTER_CRITICAL(&s_lock);
+    bool found = ble_bond_cache_find(addr_type, addr) != NULL;
+    portEXIT_CRITICAL(&s_lock);
+    return found;
+}
+
+size_t ble_bond_cache_list(ble_bond_entry_t *out, size_t max)
+{
+    portENTER_CRITICAL(&s_lock);
+    size_t count = s_count < max ? s_count : max;
+    memcpy(out, s_entries, count * sizeof(out[0]));
+    portEXIT_CRITICAL(&s_lock);
+    return count;
+}
+
+size_t ble_bond_cache_list_recent(ble_bond_entry_t *out, size_t max)
+{
+    ble_bond_entry_t all[BLE_BOND_CACHE_MAX];
+    size_t count = ble_bond_cache_list(all, BLE_BOND_CACHE_MAX);
+
+    // Insertion sort, stable so never-used hosts stay in store order
+    for (size_t i = 1; i < count; ++i)
+    {
+        ble_bond_entry_t entry = all[i];
+        size_t j = i;
+        while (j > 0 && all[j - 1].last_used < entry.last_used)
+        {
+            all[j] = all[j - 1];
+            --j;
+        }
+        all[j] = entry;
+    }
+
+    count = count < max ? count : max;
+    memcpy(out, all, count * sizeof(out[0]));
+    return count;
+}
+
+bool ble_bond_cache_lru(ble_bond_entry_t *victim, const ble_bond_entry_t *keep, size_t keep_count)
+{
+    bool found = false;
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < s_count; ++i)
+    {
+        bool kept = false;
+        for (size_t k = 0; k < keep_count && !kept; ++k)
+        {
+            kept = ble_bond_cache_same(&s_entries[i], keep[k].addr_type, keep[k].addr);
+        }
+        // Strictly older, so ties keep the earlier (older) bond
+        if (!kept && (!found || s_entries[i].last_used < victim->last_used))
+        {
+            *victim = s_entries[i];
+            found = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return found;
+}
@@ -0,0 +1,45 @@
+#ifndef BLE_BOND_CACHE_H
+#define BLE_BOND_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// RAM copy of the bonded hosts in the NimBLE store, so status queries do not
+// walk the store or NVS. ble_hid reloads it at boot and whenever the store
+// is written or deleted from.
+#define BLE_BOND_CACHE_MAX 8
+
+typedef struct
+{
+    uint8_t addr_type;
+    uint8_t addr[6];     // identity address, NimBLE byte order
+    int64_t last_seen_us; // esp_timer time of the last secured connection, 0 if none since boot
+    uint32_t last_used;   // recency; higher is more recent, 0 never used
+} ble_bond_entry_t;
+
+// Replaces the cached peers with the store's list. Peers still present keep
+// their last-seen time. Returns false (and keeps the first
+// BLE_BOND_CACHE_MAX) when the list does not fit.
+bool ble_bond_cache_load(const ble_bond_entry_t *peers, size_t count);
+
+// Records a secured connection from a bonded host. Returns false when the
+// host is not cached (the store has not been reloaded yet).
+bool ble_bond_cache_touch(uint8_t addr_type, const uint8_t addr[6], int64_t now_us);
+// Makes the host the most recently used without a connection: a selected
+// host, or the recency order restored at boot
+bool ble_bond_cache_promote(uint8_t addr_type, const uint8_t addr[6]);
+
+size_t ble_bond_cache_count(void);
+bool ble_bond_cache_contains(uint8_t addr_type, const uint8_t addr[6]);
+// Copies up to max entries, in store order; returns how many were copied
+size_t ble_bond_cache_list(ble_bond_entry_t *out, size_t max);
+// Same, most recently used first
+size_t ble_bond_cache_list_recent(ble_bond_entry_t *out, size_t max);
+
+// The eviction candidate: the least recently used host that is not in keep
+// (connected hosts, the one bonding). Never-used hosts go first, oldest bond
+// first. Returns false when every cached host is kept.
+bool ble_bond_cache_lru(ble_bond_entry_t *victim, const ble_bond_entry_t *keep, size_t keep_count);
+
+#endif // BLE_BOND_CACHE_H
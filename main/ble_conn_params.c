@@ -0,0 +1,595 @@
+#include "ble_conn_params.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "host/ble_hs.h"
+#include "host/ble_gap.h"
+#include "nimble/nimble_port.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "BLE_CONN_PARAMS";
+
+// Active: 7.5-15 ms so a report waits at most one short connection event.
+// Slave latency lets the radio sleep between reports without delaying them,
+// since the peripheral may transmit at any event it chooses to attend.
+#define CONN_ACTIVE_ITVL_MIN 6  // 7.5 ms
+#define CONN_ACTIVE_ITVL_MAX 12 // 15 ms
+#define CONN_ACTIVE_LATENCY 4
+#define CONN_ACTIVE_TIMEOUT 200 // 2 s
+
+// Idle: long interval and high latency. Input still leaves at the next event
+// we attend; only host->device traffic (LED reports) waits for the latency.
+#define CONN_IDLE_ITVL_MIN 80  // 100 ms
+#define CONN_IDLE_ITVL_MAX 100 // 125 ms
+#define CONN_IDLE_LATENCY 10
+#define CONN_IDLE_TIMEOUT 600 // 6 s
+
+// Hysteresis: any input selects the active profile, but the idle profile is
+// only chosen after this much silence.
+#define CONN_IDLE_AFTER_MS 10000
+// Rate limiting: hosts refuse (or silently ignore) updates that arrive too
+// close together, so requests are spaced out and refused ones back off.
+#define CONN_MIN_REQUEST_SPACING_MS 5000
+#define CONN_REJECT_BACKOFF_MAX_MS 60000
+// Link-layer procedures time out after 40 s; stop waiting for an answer then.
+#define CONN_PENDING_TIMEOUT_MS 40000
+#define CONN_EVALUATE_PERIOD_MS 500
+
+// Data Length Extension: one 251-octet PDU can carry several queued reports
+// in a single connection event. The time is the 1M PHY worst case; the
+// controller shortens it on 2M.
+#define CONN_DLE_TX_OCTETS 251
+#define CONN_DLE_TX_TIME 2120
+// Link-layer defaults until the controller reports otherwise
+#define CONN_DEFAULT_OCTETS 27
+#define CONN_DEFAULT_TIME 328
+
+#ifdef CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#define CONN_MAX_CONNECTIONS CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#else
+#define CONN_MAX_CONNECTIONS 1
+#endif
+
+// Each central negotiates on its own: a host that is not being routed input
+// drops to the idle profile while another one is in use.
+typedef struct
+{
+    bool in_use;
+    uint16_t conn_handle;
+    ble_conn_profile_t current;  // last accepted
+    ble_conn_profile_t pending;  // awaiting CONN_UPDATE
+    ble_conn_profile_t deferred; // held back by rate limit
+    bool wake_pending;           // input arrived while an idle request was out
+    TickType_t pending_since;
+    TickType_t last_activity;
+    TickType_t next_request;
+    uint32_t backoff_ms;
+    TickType_t profile_since;
+    ble_conn_params_t accepted;
+    ble_conn_link_t link;
+} ble_conn_params_slot_t;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static ble_conn_params_slot_t s_slots[CONN_MAX_CONNECTIONS];
+static ble_conn_params_stats_t s_stats = {0};
+
+// Runs on the NimBLE host task: ble_gap_update_params takes the host lock,
+// which a timer service callback must not wait on
+static struct ble_npl_callout s_evaluate_callout;
+static bool s_evaluate_callout_ready = false;
+
+static bool tick_reached(TickType_t now, TickType_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static ble_conn_params_slot_t *ble_conn_params_find(uint16_t conn_handle)
+{
+    for (size_t i = 0; i < CONN_MAX_CONNECTIONS; ++i)
+    {
+        if (s_slots[i].in_use && s_slots[i].conn_handle == conn_handle)
+        {
+            return &s_slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Caller holds s_lock
+static void ble_conn_params_enter_profile(ble_conn_params_slot_t *slot, ble_conn_profile_t profile,
+                                          TickType_t now)
+{
+    s_stats.time_ms[slot->current] += (uint64_t)(now - slot->profile_since) * portTICK_PERIOD_MS;
+    slot->profile_since = now;
+    slot->current = profile;
+}
+
+static void ble_conn_params_refresh(ble_conn_params_slot_t *slot)
+{
+    struct ble_gap_conn_desc desc;
+    if (ble_gap_conn_find(slot->conn_handle, &desc) != 0)
+    {
+        return;
+    }
+
+    slot->accepted.interval = desc.conn_itvl;
+    slot->accepted.latency = desc.conn_latency;
+    slot->accepted.supervision_timeout = desc.supervision_timeout;
+}
+
+static void ble_conn_params_fill(ble_conn_profile_t profile, struct ble_gap_upd_params *params)
+{
+    memset(params, 0, sizeof(*params));
+    if (profile == BLE_CONN_PROFILE_ACTIVE)
+    {
+        params->itvl_min = CONN_ACTIVE_ITVL_MIN;
+        params->itvl_max = CONN_ACTIVE_ITVL_MAX;
+        params->latency = CONN_ACTIVE_LATENCY;
+        params->supervision_timeout = CONN_ACTIVE_TIMEOUT;
+    }
+    else
+    {
+        params->itvl_min = CONN_IDLE_ITVL_MIN;
+        params->itvl_max = CONN_IDLE_ITVL_MAX;
+        params->latency = CONN_IDLE_LATENCY;
+        params->supervision_timeout = CONN_IDLE_TIMEOUT;
+    }
+}
+
+// woke: input just ended an idle period, so an active request skips the
+// spacing and backoff, and one waiting on a pending idle request goes out as
+// soon as that request is answered. The exemption is safe: it happens at
+// most once per CONN_IDLE_AFTER_MS of silence, and it is the one request
+// the user is waiting on.
+static void ble_conn_params_evaluate(ble_conn_params_slot_t *slot, bool woke)
+{
+    TickType_t now = xTaskGetTickCount();
+    ble_conn_profile_t target;
+    uint16_t conn_handle;
+
+    portENTER_CRITICAL(&s_lock);
+    if (!slot->in_use)
+    {
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+    conn_handle = slot->conn_handle;
+
+    if (woke && slot->pending == BLE_CONN_PROFILE_IDLE)
+    {
+        // A request in flight cannot be withdrawn; on_update follows it up
+        slot->wake_pending = true;
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+    if (slot->pending != BLE_CONN_PROFILE_NONE)
+    {
+        if (!tick_reached(now, slot->pending_since + pdMS_TO_TICKS(CONN_PENDING_TIMEOUT_MS)))
+        {
+            portEXIT_CRITICAL(&s_lock);
+            return;
+        }
+        // No answer at all; treat it as refused so the backoff applies.
+        slot->pending = BLE_CONN_PROFILE_NONE;
+        s_stats.rejects++;
+        woke |= slot->wake_pending;
+        slot->wake_pending = false;
+    }
+
+    target = tick_reached(now, slot->last_activity + pdMS_TO_TICKS(CONN_IDLE_AFTER_MS))
+                 ? BLE_CONN_PROFILE_IDLE
+                 : BLE_CONN_PROFILE_ACTIVE;
+    if (target == slot->current)
+    {
+        slot->deferred = BLE_CONN_PROFILE_NONE;
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+    if (!(woke && target == BLE_CONN_PROFILE_ACTIVE) && !tick_reached(now, slot->next_request))
+    {
+        if (slot->deferred != target)
+        {
+            slot->deferred = target;
+            s_stats.deferred++;
+        }
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+
+    slot->deferred = BLE_CONN_PROFILE_NONE;
+    slot->pending = target;
+    slot->pending_since = now;
+    slot->next_request = now + pdMS_TO_TICKS(CONN_MIN_REQUEST_SPACING_MS);
+    s_stats.requests++;
+    portEXIT_CRITICAL(&s_lock);
+
+    struct ble_gap_upd_params params;
+    ble_conn_params_fill(target, &params);
+    int rc = ble_gap_update_params(conn_handle, &params);
+    if (rc != 0)
+    {
+        portENTER_CRITICAL(&s_lock);
+        if (slot->in_use && slot->conn_handle == conn_handle)
+        {
+            slot->pending = BLE_CONN_PROFILE_NONE;
+        }
+        s_stats.rejects++;
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGW(TAG, "Failed to request %s parameters (conn %u); rc=%d",
+                 ble_conn_params_profile_name(target), conn_handle, rc);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Requested %s parameters (conn %u): interval %u-%u, latency %u, timeout %u",
+             ble_conn_params_profile_name(target), conn_handle, params.itvl_min, params.itvl_max,
+             params.latency, params.supervision_timeout);
+}
+
+static void ble_conn_params_evaluate_callout(struct ble_npl_event *ev)
+{
+    (void)ev;
+    bool any_connected = false;
+    for (size_t i = 0; i < CONN_MAX_CONNECTIONS; ++i)
+    {
+        ble_conn_params_evaluate(&s_slots[i], false);
+        any_connected |= s_slots[i].in_use;
+    }
+
+    // Callouts are one-shot; stops re-arming once the last host is gone
+    if (any_connected)
+    {
+        ble_npl_callout_reset(&s_evaluate_callout, ble_npl_time_ms_to_ticks32(CONN_EVALUATE_PERIOD_MS));
+    }
+}
+
+static void ble_conn_params_reset_link(ble_conn_link_t *link)
+{
+    link->tx_phy = BLE_GAP_LE_PHY_1M;
+    link->rx_phy = BLE_GAP_LE_PHY_1M;
+    link->max_tx_octets = CONN_DEFAULT_OCTETS;
+    link->max_tx_time = CONN_DEFAULT_TIME;
+    link->max_rx_octets = CONN_DEFAULT_OCTETS;
+    link->max_rx_time = CONN_DEFAULT_TIME;
+}
+
+// Both requests are best effort: a controller or central that lacks the
+// feature leaves the link on 1M PHY with 27-octet PDUs, which still works.
+static void ble_conn_params_negotiate_link(ble_conn_params_slot_t *slot)
+{
+    uint16_t conn_handle = slot->conn_handle;
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+    if (ble_gap_read_le_phy(conn_handle, &tx_phy, &rx_phy) == 0)
+    {
+        slot->link.tx_phy = tx_phy;
+        slot->link.rx_phy = rx_phy;
+    }
+
+    int rc = ble_gap_set_data_len(conn_handle, CONN_DLE_TX_OCTETS, CONN_DLE_TX_TIME);
+    if (rc != 0)
+    {
+        ESP_LOGW(TAG, "Data length extension unavailable (rc=%d); using %u-octet PDUs",
+                 rc, slot->link.max_tx_octets);
+    }
+
+#ifdef CONFIG_BT_NIMBLE_LL_CFG_FEAT_LE_2M_PHY
+    if (slot->link.tx_phy != BLE_GAP_LE_PHY_2M || slot->link.rx_phy != BLE_GAP_LE_PHY_2M)
+    {
+        // Allow 1M alongside 2M so the central can decline without failing
+        rc = ble_gap_set_prefered_le_phy(conn_handle,
+                                         BLE_GAP_LE_PHY_2M_MASK | BLE_GAP_LE_PHY_1M_MASK,
+                                         BLE_GAP_LE_PHY_2M_MASK | BLE_GAP_LE_PHY_1M_MASK,
+                                         BLE_GAP_LE_PHY_CODED_ANY);
+        if (rc != 0)
+        {
+            ESP_LOGW(TAG, "2M PHY request failed (rc=%d); staying on %s",
+                     rc, ble_conn_params_phy_name(slot->link.tx_phy));
+        }
+    }
+#else
+    ESP_LOGI(TAG, "2M PHY not supported by this controller; staying on %s",
+             ble_conn_params_phy_name(slot->link.tx_phy));
+#endif
+}
+
+void ble_conn_params_on_connect(uint16_t conn_handle)
+{
+    TickType_t now = xTaskGetTickCount();
+    ble_conn_params_slot_t *slot = NULL;
+
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < CONN_MAX_CONNECTIONS; ++i)
+    {
+        if (!s_slots[i].in_use)
+        {
+            slot = &s_slots[i];
+            break;
+        }
+    }
+    if (slot)
+    {
+        memset(slot, 0, sizeof(*slot));
+        slot->in_use = true;
+        slot->conn_handle = conn_handle;
+        slot->current = BLE_CONN_PROFILE_NONE;
+        slot->pending = BLE_CONN_PROFILE_NONE;
+        slot->deferred = BLE_CONN_PROFILE_NONE;
+        slot->last_activity = now;
+        slot->next_request = now;
+        slot->backoff_ms = CONN_MIN_REQUEST_SPACING_MS;
+        slot->profile_since = now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!slot)
+    {
+        ESP_LOGW(TAG, "No parameter slot for conn %u; leaving it to the central", conn_handle);
+        return;
+    }
+
+    ble_conn_params_refresh(slot);
+    ESP_LOGI(TAG, "Initial parameters (conn %u): interval %u, latency %u, timeout %u",
+             conn_handle, slot->accepted.interval, slot->accepted.latency,
+             slot->accepted.supervision_timeout);
+
+    ble_conn_params_reset_link(&slot->link);
+    ble_conn_params_negotiate_link(slot);
+    ble_conn_params_evaluate(slot, false);
+
+    // GAP events arrive on the host task, which also runs the callout
+    if (!s_evaluate_callout_ready)
+    {
+        ble_npl_callout_init(&s_evaluate_callout, nimble_port_get_dflt_eventq(),
+                             ble_conn_params_evaluate_callout, NULL);
+        s_evaluate_callout_ready = true;
+    }
+    if (!ble_npl_callout_is_active(&s_evaluate_callout) &&
+        ble_npl_callout_reset(&s_evaluate_callout, ble_npl_time_ms_to_ticks32(CONN_EVALUATE_PERIOD_MS)) != 0)
+    {
+        ESP_LOGW(TAG, "Failed to start parameter evaluation");
+    }
+}
+
+void ble_conn_params_on_disconnect(uint16_t conn_handle)
+{
+    bool any_connected = false;
+
+    portENTER_CRITICAL(&s_lock);
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    if (slot)
+    {
+        ble_conn_params_enter_profile(slot, BLE_CONN_PROFILE_NONE, xTaskGetTickCount());
+        memset(slot, 0, sizeof(*slot));
+    }
+    for (size_t i = 0; i < CONN_MAX_CONNECTIONS; ++i)
+    {
+        any_connected |= s_slots[i].in_use;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!any_connected && s_evaluate_callout_ready)
+    {
+        ble_npl_callout_stop(&s_evaluate_callout);
+    }
+}
+
+void ble_conn_params_on_phy_update(uint16_t conn_handle, int status, uint8_t tx_phy, uint8_t rx_phy)
+{
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    if (!slot)
+    {
+        return;
+    }
+
+    if (status != 0)
+    {
+        ESP_LOGW(TAG, "PHY update failed (conn %u); status=%d, staying on %s",
+                 conn_handle, status, ble_conn_params_phy_name(slot->link.tx_phy));
+        return;
+    }
+
+    slot->link.tx_phy = tx_phy;
+    slot->link.rx_phy = rx_phy;
+    ESP_LOGI(TAG, "PHY updated (conn %u): tx %s, rx %s", conn_handle,
+             ble_conn_params_phy_name(tx_phy), ble_conn_params_phy_name(rx_phy));
+}
+
+void ble_conn_params_on_data_len(uint16_t conn_handle, uint16_t max_tx_octets, uint16_t max_tx_time,
+                                 uint16_t max_rx_octets, uint16_t max_rx_time)
+{
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    if (!slot)
+    {
+        return;
+    }
+
+    slot->link.max_tx_octets = max_tx_octets;
+    slot->link.max_tx_time = max_tx_time;
+    slot->link.max_rx_octets = max_rx_octets;
+    slot->link.max_rx_time = max_rx_time;
+    ESP_LOGI(TAG, "Data length (conn %u): tx %u octets/%u us, rx %u octets/%u us",
+             conn_handle, max_tx_octets, max_tx_time, max_rx_octets, max_rx_time);
+}
+
+void ble_conn_params_on_update(uint16_t conn_handle, int status)
+{
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    if (!slot)
+    {
+        return;
+    }
+
+    // The central may also change parameters on its own, so always re-read
+    // what the controller is using rather than assuming our request won.
+    ble_conn_params_refresh(slot);
+
+    TickType_t now = xTaskGetTickCount();
+    ble_conn_profile_t requested;
+    bool woke;
+
+    portENTER_CRITICAL(&s_lock);
+    requested = slot->pending;
+    slot->pending = BLE_CONN_PROFILE_NONE;
+    woke = slot->wake_pending;
+    slot->wake_pending = false;
+    if (requested == BLE_CONN_PROFILE_NONE)
+    {
+        s_stats.peer_updates++;
+    }
+    else if (status == 0)
+    {
+        s_stats.accepts++;
+        slot->backoff_ms = CONN_MIN_REQUEST_SPACING_MS;
+        ble_conn_params_enter_profile(slot, requested, now);
+    }
+    else
+    {
+        s_stats.rejects++;
+        slot->next_request = now + pdMS_TO_TICKS(slot->backoff_ms);
+        slot->backoff_ms = slot->backoff_ms * 2 > CONN_REJECT_BACKOFF_MAX_MS ? CONN_REJECT_BACKOFF_MAX_MS
+                                                                             : slot->backoff_ms * 2;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (requested != BLE_CONN_PROFILE_NONE && status != 0)
+    {
+        ESP_LOGW(TAG, "%s parameters rejected (conn %u); status=%d, keeping interval %u",
+                 ble_conn_params_profile_name(requested), conn_handle, status,
+                 slot->accepted.interval);
+    }
+    else
+    {
+        ESP_LOGI(TAG, "Parameters updated (conn %u, %s): interval %u (%u.%02u ms), latency %u, timeout %u ms",
+                 conn_handle,
+                 requested == BLE_CONN_PROFILE_NONE ? "by central" : ble_conn_params_profile_name(requested),
+                 slot->accepted.interval, (slot->accepted.interval * 125) / 100,
+                 (slot->accepted.interval * 125) % 100, slot->accepted.latency,
+                 slot->accepted.supervision_timeout * 10);
+    }
+
+    if (woke)
+    {
+        ble_conn_params_evaluate(slot, true);
+    }
+}
+
+void ble_conn_params_note_activity(uint16_t conn_handle)
+{
+    TickType_t now = xTaskGetTickCount();
+
+    for (size_t i = 0; i < CONN_MAX_CONNECTIONS; ++i)
+    {
+        ble_conn_params_slot_t *slot = &s_slots[i];
+        if (!slot->in_use ||
+            (conn_handle != BLE_HS_CONN_HANDLE_NONE && slot->conn_handle != conn_handle))
+        {
+            continue;
+        }
+
+        portENTER_CRITICAL(&s_lock);
+        bool woke = tick_reached(now, slot->last_activity + pdMS_TO_TICKS(CONN_IDLE_AFTER_MS));
+        slot->last_activity = now;
+        // Only the idle->active edge needs an immediate request; everything
+        // else is picked up by the periodic evaluation.
+        bool evaluate = (slot->current != BLE_CONN_PROFILE_ACTIVE && slot->pending == BLE_CONN_PROFILE_NONE) ||
+                        (woke && slot->pending == BLE_CONN_PROFILE_IDLE);
+        portEXIT_CRITICAL(&s_lock);
+
+        if (evaluate)
+        {
+            ble_conn_params_evaluate(slot, woke);
+        }
+    }
+}
+
+ble_conn_profile_t ble_conn_params_get_profile(uint16_t conn_handle)
+{
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    return slot ? slot->current : BLE_CONN_PROFILE_NONE;
+}
+
+bool ble_conn_params_get_accepted(uint16_t conn_handle, ble_conn_params_t *out)
+{
+    if (!out)
+    {
+        return false;
+    }
+
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    if (!slot)
+    {
+        memset(out, 0, sizeof(*out));
+        return false;
+    }
+
+    *out = slot->accepted;
+    return true;
+}
+
+bool ble_conn_params_get_link(uint16_t conn_handle, ble_conn_link_t *out)
+{
+    if (!out)
+    {
+        return false;
+    }
+
+    ble_conn_params_slot_t *slot = ble_conn_params_find(conn_handle);
+    if (!slot)
+    {
+        memset(out, 0, sizeof(*out));
+        return false;
+    }
+
+    *out = slot->link;
+    return true;
+}
+
+void ble_conn_params_get_stats(ble_conn_params_stats_t *out)
+{
+    if (!out)
+    {
+        return;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    for (size_t i = 0; i < CONN_MAX_CONNECTIONS; ++i)
+    {
+        if (s_slots[i].in_use)
+        {
+            out->time_ms[s_slots[i].current] +=
+                (uint64_t)(now - s_slots[i].profile_since) * portTICK_PERIOD_MS;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+const char *ble_conn_params_profile_name(ble_conn_profile_t profile)
+{
+    switch (profile)
+    {
+    case BLE_CONN_PROFILE_ACTIVE:
+        return "active";
+    case BLE_CONN_PROFILE_IDLE:
+        return "idle";
+    default:
+        return "none";
+    }
+}
+
+const char *ble_conn_params_phy_name(uint8_t phy)
+{
+    switch (phy)
+    {
+    case BLE_GAP_LE_PHY_1M:
+        return "1M";
+    case BLE_GAP_LE_PHY_2M:
+        return "2M";
+    case BLE_GAP_LE_PHY_CODED:
+        return "coded";
+    default:
+        return "unknown";
+    }
+}
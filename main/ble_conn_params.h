@@ -0,0 +1,68 @@
+#ifndef BLE_CONN_PARAMS_H
+#define BLE_CONN_PARAMS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Connection parameter profiles requested from the central
+typedef enum
+{
+    BLE_CONN_PROFILE_NONE = 0,
+    BLE_CONN_PROFILE_ACTIVE,
+    BLE_CONN_PROFILE_IDLE,
+    BLE_CONN_PROFILE_COUNT
+} ble_conn_profile_t;
+
+// Parameters in controller units, as reported by ble_gap_conn_find()
+typedef struct
+{
+    uint16_t interval;            // 1.25 ms units
+    uint16_t latency;             // connection events the peripheral may skip
+    uint16_t supervision_timeout; // 10 ms units
+} ble_conn_params_t;
+
+// Link-layer PHY and Data Length Extension state
+typedef struct
+{
+    uint8_t tx_phy; // BLE_GAP_LE_PHY_1M / _2M / _CODED
+    uint8_t rx_phy;
+    uint16_t max_tx_octets; // 27 without DLE, up to 251
+    uint16_t max_tx_time;   // microseconds
+    uint16_t max_rx_octets;
+    uint16_t max_rx_time;
+} ble_conn_link_t;
+
+typedef struct
+{
+    uint32_t requests;    // ble_gap_update_params calls issued
+    uint32_t accepts;     // our requests answered with status 0
+    uint32_t rejects;     // refused by the central or failed locally
+    uint32_t peer_updates; // parameter changes the central made on its own
+    uint32_t deferred;    // switches held back by rate limiting or backoff
+    uint64_t time_ms[BLE_CONN_PROFILE_COUNT]; // connected time per accepted profile, summed over links
+} ble_conn_params_stats_t;
+
+// GAP event hooks, called from the NimBLE host task. Every connected central
+// is tracked separately; the stats are totals across all of them.
+void ble_conn_params_on_connect(uint16_t conn_handle);
+void ble_conn_params_on_disconnect(uint16_t conn_handle);
+void ble_conn_params_on_update(uint16_t conn_handle, int status);
+void ble_conn_params_on_phy_update(uint16_t conn_handle, int status, uint8_t tx_phy, uint8_t rx_phy);
+void ble_conn_params_on_data_len(uint16_t conn_handle, uint16_t max_tx_octets, uint16_t max_tx_time,
+                                 uint16_t max_rx_octets, uint16_t max_rx_time);
+
+// Called whenever input is queued for a host (BLE_HS_CONN_HANDLE_NONE for
+// every connected host). The first input after idle asks for the active
+// profile right away, skipping the request spacing and reject backoff, or
+// as soon as a pending idle request is answered; the idle profile follows
+// once input has stopped for the idle timeout.
+void ble_conn_params_note_activity(uint16_t conn_handle);
+
+ble_conn_profile_t ble_conn_params_get_profile(uint16_t conn_handle);
+bool ble_conn_params_get_accepted(uint16_t conn_handle, ble_conn_params_t *out);
+bool ble_conn_params_get_link(uint16_t conn_handle, ble_conn_link_t *out);
+void ble_conn_params_get_stats(ble_conn_params_stats_t *out);
+const char *ble_conn_params_profile_name(ble_conn_profile_t profile);
+const char *ble_conn_params_phy_name(uint8_t phy);
+
+#endif // BLE_CONN_PARAMS_H
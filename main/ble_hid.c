@@ -13,7 +13,19 @@
 #include "services/gatt/ble_svc_gatt.h"
 #include "store/config/ble_store_config.h"
 #include "nvs_keystore.h"
+#include "ble_conn_params.h"
 #include "mouse_report_builder.h"
+#include "keyboard_report_builder.h"
+#include "hid_report_descriptor.h"
+#include "hid_metrics.h"
+#include "hid_event_log.h"
+#include "hid_send_plan.h"
+#include "ble_reconnect.h"
+#include "ble_bond_cache.h"
+#include "task_topology.h"
+#include "esp_timer.h"
+#include "esp_bt.h"
+#include "sdkconfig.h"
 #include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
@@ -26,135 +38,6 @@ void ble_store_config_init(void);
 
 static const char *TAG = "BLE_HID";
 
-// Combined HID Report Descriptor (Mouse + Keyboard + Consumer)
-static const uint8_t hid_report_map[] = {
-    // Mouse (Report ID 1) — five buttons with vertical & horizontal scroll
-    0x05, 0x01,        // Usage Page (Generic Desktop)
-    0x09, 0x02,        // Usage (Mouse)
-    0xA1, 0x01,        // Collection (Application)
-    0x85, 0x01,        //   Report ID (1)
-    0x09, 0x01,        //   Usage (Pointer)
-    0xA1, 0x00,        //   Collection (Physical)
-    0x05, 0x09,        //     Usage Page (Buttons)
-    0x19, 0x01,        //     Usage Minimum (Button 1)
-    0x29, 0x05,        //     Usage Maximum (Button 5)
-    0x15, 0x00,        //     Logical Minimum (0)
-    0x25, 0x01,        //     Logical Maximum (1)
-    0x95, 0x05,        //     Report Count (5)
-    0x75, 0x01,        //     Report Size (1)
-    0x81, 0x02,        //     Input (Data, Variable, Absolute)
-    0x95, 0x01,        //     Report Count (1) - padding
-    0x75, 0x03,        //     Report Size (3)
-    0x81, 0x03,        //     Input (Constant, Variable, Absolute)
-    0x05, 0x01,        //     Usage Page (Generic Desktop)
-    0x09, 0x30,        //     Usage (X)
-    0x09, 0x31,        //     Usage (Y)
-    0x09, 0x38,        //     Usage (Wheel)
-    0x15, 0x81,        //     Logical Minimum (-127)
-    0x25, 0x7F,        //     Logical Maximum (127)
-    0x75, 0x08,        //     Report Size (8)
-    0x95, 0x03,        //     Report Count (3)
-    0x81, 0x06,        //     Input (Data, Variable, Relative)
-    0x05, 0x0C,        //     Usage Page (Consumer)
-    0x0A, 0x38, 0x02,  //     Usage (AC Pan) - horizontal scroll
-    0x15, 0x81,        //     Logical Minimum (-127)
-    0x25, 0x7F,        //     Logical Maximum (127)
-    0x75, 0x08,        //     Report Size (8)
-    0x95, 0x01,        //     Report Count (1)
-    0x81, 0x06,        //     Input (Data, Variable, Relative)
-    0xC0,              //   End Collection
-    0xC0,              // End Collection
-
-    // Keyboard (Report ID 2) — byte-for-byte match with reference
-    0x05, 0x01,        // Usage Page (Generic Desktop)
-    0x09, 0x06,        // Usage (Keyboard)
-    0xA1, 0x01,        // Collection (Application)
-    0x85, 0x02,        //   Report ID (2)
-    0x75, 0x01,        //   Report Size (1)
-    0x95, 0x08,        //   Report Count (8)
-    0x05, 0x07,        //   Usage Page (Key Codes)
-    0x19, 0xE0,        //   Usage Minimum (224)
-    0x29, 0xE7,        //   Usage Maximum (231)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x01,        //   Logical Maximum (1)
-    0x81, 0x02,        //   Input (Data, Variable, Absolute)
-    0x95, 0x01,        //   Report Count (1)
-    0x75, 0x08,        //   Report Size (8)
-    0x81, 0x01,        //   Input (Constant)
-    0x95, 0x05,        //   Report Count (5)
-    0x75, 0x01,        //   Report Size (1)
-    0x05, 0x08,        //   Usage Page (LEDs)
-    0x19, 0x01,        //   Usage Minimum (1)
-    0x29, 0x05,        //   Usage Maximum (5)
-    0x91, 0x02,        //   Output (Data, Variable, Absolute)
-    0x95, 0x01,        //   Report Count (1)
-    0x75, 0x03,        //   Report Size (3)
-    0x91, 0x01,        //   Output (Constant)
-    0x95, 0x06,        //   Report Count (6)
-    0x75, 0x08,        //   Report Size (8)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x65,        //   Logical Maximum (101)
-    0x05, 0x07,        //   Usage Page (Key Codes)
-    0x19, 0x00,        //   Usage Minimum (0)
-    0x29, 0x65,        //   Usage Maximum (101)
-    0x81, 0x00,        //   Input (Data, Array)
-    0xC0,              // End Collection
-
-    // Consumer Control (Report ID 3) — ESP32 combo bitfield layout
-    0x05, 0x0C,        // Usage Page (Consumer)
-    0x09, 0x01,        // Usage (Consumer Control)
-    0xA1, 0x01,        // Collection (Application)
-    0x85, 0x03,        //   Report ID (3)
-    0x05, 0x0C,        //   Usage Page (Consumer)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x01,        //   Logical Maximum (1)
-    0x75, 0x01,        //   Report Size (1)
-    0x95, 0x10,        //   Report Count (16)
-    0x09, 0xB5,        //   Usage (Scan Next Track)
-    0x09, 0xB6,        //   Usage (Scan Previous Track)
-    0x09, 0xB7,        //   Usage (Stop)
-    0x09, 0xCD,        //   Usage (Play/Pause)
-    0x09, 0xE2,        //   Usage (Mute)
-    0x09, 0xE9,        //   Usage (Volume Up)
-    0x09, 0xEA,        //   Usage (Volume Down)
-    0x0A, 0x23, 0x02,  //   Usage (AC Home / WWW Home)
-    0x0A, 0x94, 0x01,  //   Usage (AL My Computer)
-    0x0A, 0x92, 0x01,  //   Usage (AL Calculator)
-    0x0A, 0x2A, 0x02,  //   Usage (AC Bookmarks)
-    0x0A, 0x21, 0x02,  //   Usage (AC Search)
-    0x0A, 0x26, 0x02,  //   Usage (AC Stop)
-    0x0A, 0x24, 0x02,  //   Usage (AC Back)
-    0x0A, 0x83, 0x01,  //   Usage (AL Consumer Control Configuration / Media Select)
-    0x0A, 0x8A, 0x01,  //   Usage (AL Email Reader / Mail)
-    0x81, 0x02,        //   Input (Data, Variable, Absolute)
-    0xC0,              // End Collection
-};
-
-static const uint16_t s_consumer_usages[] = {
-    0x00B5, // Scan Next Track
-    0x00B6, // Scan Previous Track
-    0x00B7, // Stop
-    0x00CD, // Play/Pause
-    0x00E2, // Mute
-    0x00E9, // Volume Up
-    0x00EA, // Volume Down
-    0x0223, // WWW Home
-    0x0194, // My Computer
-    0x0192, // Calculator
-    0x022A, // WWW Favorites
-    0x0221, // WWW Search
-    0x0226, // WWW Stop
-    0x0224, // WWW Back
-    0x0183, // Media Select
-    0x018A, // Mail
-};
-
-// Report Reference descriptors
-static const uint8_t mouse_report_ref[] = {0x01, 0x01};    // Report ID 1, Input
-static const uint8_t keyboard_input_ref[] = {0x02, 0x01};  // Report ID 2, Input
-static const uint8_t keyboard_output_ref[] = {0x02, 0x02}; // Report ID 2, Output
-static const uint8_t consumer_report_ref[] = {0x03, 0x01}; // Report ID 3, Input
-
 // UUIDs
 #define HID_SERVICE_UUID 0x1812
 #define DEVICE_INFO_SERVICE_UUID 0x180A
@@ -174,41 +57,119 @@ static const uint8_t consumer_report_ref[] = {0x03, 0x01}; // Report ID 3, Input
 // State
 static ble_hid_handles_t s_handles = {0};
 static void (*s_state_callback)(hid_device_state_t) = NULL;
-static ble_connection_info_t s_conn_info = {0};
 static char s_device_name[32] = "ESP32 HID";
 static uint8_t s_adv_handle = 0;
 
-// Report storage
-static uint8_t s_mouse_report[HID_MOUSE_REPORT_LEN] = {0};
-static uint8_t s_keyboard_report[9] = {0};
-static uint16_t s_consumer_report = 0;
-static uint8_t s_boot_mouse_report[3] = {0};
-static uint8_t s_boot_keyboard_report[8] = {0};
-static uint8_t s_keyboard_leds = 0;
+// Reconnect advertising (see ble_reconnect.h)
+// 211.25-318.75 ms: slow enough to be cheap, quick enough that a host
+// scanning in the background still finds the device within seconds
+#define BLE_HID_ADV_SLOW_ITVL_MIN 338
+#define BLE_HID_ADV_SLOW_ITVL_MAX 510
+// Advertising TX power: the controller default while a host is expected to
+// connect soon, lower once the schedule has fallen back to slow advertising
+#define BLE_HID_ADV_TX_POWER_FAST ESP_PWR_LVL_P3
+#define BLE_HID_ADV_TX_POWER_SLOW ESP_PWR_LVL_N0
+_Static_assert(BLE_HID_MAX_BONDS <= BLE_BOND_CACHE_MAX, "Bond cache must hold every stored bond");
+static ble_addr_t s_bonded_peers[BLE_HID_MAX_BONDS];
+static int s_bonded_peer_count = 0;
+static ble_addr_t s_directed_peer;
+// bond_select target; pending until it connects or the schedule ends
+static ble_addr_t s_selected_peer;
+static bool s_select_pending = false;
+static portMUX_TYPE s_select_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ble_store_config's handlers, wrapped to keep ble_bond_cache in step
+static ble_store_write_fn *s_store_write = NULL;
+static ble_store_delete_fn *s_store_delete = NULL;
+
+// Report formats, shared by every host (mouse_mode / keyboard_mode)
+static bool s_mouse_high_resolution = true;
+static bool s_keyboard_nkro = true;
 static uint8_t s_battery_level = 100;
-static uint8_t s_protocol_mode = 1; // Report protocol
-static uint8_t s_hid_control = 0;
 
-// Notification retry configuration
-#define HID_NOTIFY_MAX_ATTEMPTS 16
-#define HID_NOTIFY_RETRY_BASE_DELAY_MS 10
-#define HID_NOTIFY_RETRY_MAX_DELAY_MS 160
-#define HID_NOTIFY_MAX_WAIT_MS 500
+// Per-connection flow control. Each host gets its own small queue so one
+// that runs out of link buffers only delays itself; hid_send_plan decides
+// what each drain cycle actually sends from it.
+#define BLE_HID_CONN_QUEUE_DEPTH HID_SEND_PLAN_MAX
+// A single input update can produce a report-protocol and a boot report
+#define BLE_HID_REPORTS_PER_UPDATE 2
+
+_Static_assert(HID_MOUSE_REPORT_LEN <= HID_SEND_REPORT_MAX_LEN &&
+                   HID_HIRES_MOUSE_INPUT_REPORT_LEN <= HID_SEND_REPORT_MAX_LEN &&
+                   HID_POINTER_INPUT_REPORT_LEN <= HID_SEND_REPORT_MAX_LEN &&
+                   HID_CONSUMER_INPUT_REPORT_LEN <= HID_SEND_REPORT_MAX_LEN &&
+                   sizeof(hid_keyboard_input_report_t) <= HID_SEND_REPORT_MAX_LEN,
+               "Queued report slots must fit every input report");
 
-// ENOMEM metrics tracking
 typedef struct
 {
-    uint16_t handle;
-    uint32_t attempts;
-    uint32_t successes;
-    uint32_t failures;
-    uint32_t enomem_alloc;
-    uint32_t enomem_notify;
-} hid_enomem_metric_t;
+    bool in_use;
+    uint16_t conn_handle;
+    uint32_t connect_seq; // orders hosts by connection time
+
+    // Subscription state
+    bool subscribed_mouse;
+    bool subscribed_mouse_boot;
+    bool subscribed_keyboard;
+    bool subscribed_keyboard_boot;
+    bool subscribed_consumer;
+    bool subscribed_pointer;
+    bool subscribed_hires_mouse;
+    bool subscribed_keyboard_nkro;
+
+    // Written by the host
+    uint8_t protocol_mode;
+    uint8_t hid_control;
+    uint8_t keyboard_leds;
+    hid_hires_mouse_feature_report_t hires_mouse_feature;
+
+    // Part-detent scrolling not yet sent to a host taking whole detents
+    mouse_wheel_carry_t wheel_carry;
+
+    // Last report sent on each characteristic, served back on reads
+    uint8_t mouse_report[HID_MOUSE_REPORT_LEN];
+    hid_keyboard_input_report_t keyboard_report;
+    uint16_t consumer_report;
+    uint8_t pointer_report[HID_POINTER_INPUT_REPORT_LEN];
+    uint8_t hires_mouse_report[HID_HIRES_MOUSE_INPUT_REPORT_LEN];
+    hid_keyboard_nkro_input_report_t keyboard_nkro_report;
+    uint8_t boot_mouse_report[HID_BOOT_MOUSE_REPORT_LEN];
+
+    // Last input routed here, replayed when the host switches protocol mode
+    keyboard_state_t keyboard_state;
+    uint8_t mouse_buttons;
+
+    ble_connection_info_t info;
+
+    hid_pending_report_t queue[BLE_HID_CONN_QUEUE_DEPTH];
+    size_t queue_head;
+    size_t queue_count;
+    uint32_t queue_popped; // counts pops, to line a drain snapshot up with the queue
+    uint8_t queue_group;   // stamped on the reports of one input update
+    bool draining;
+    int congestion;        // consecutive out-of-buffer sends, drives backoff
+    TickType_t retry_at;
+    uint32_t dropped;
+    uint32_t congested;
+    // When each report type was last handed to the stack, until NOTIFY_TX
+    int64_t notify_started_us[HID_METRICS_REPORT_COUNT];
+} ble_hid_conn_t;
+
+static ble_hid_conn_t s_conns[BLE_HID_MAX_CONNECTIONS];
+static portMUX_TYPE s_conn_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint16_t s_route = BLE_HID_ROUTE_ALL;
+static uint32_t s_connect_seq = 0;
+static TaskHandle_t s_drain_task = NULL;
+
+// The boot keyboard report is the report-protocol payload without its Report
+// ID, so it is served straight out of keyboard_report instead of a copy.
+#define BOOT_KEYBOARD_REPORT(conn) (&(conn)->keyboard_report.modifiers)
+#define BOOT_KEYBOARD_REPORT_LEN (sizeof(hid_keyboard_input_report_t) - 1)
 
-static hid_enomem_metric_t s_enomem_metrics[12];
-static size_t s_enomem_metric_count = 0;
-static portMUX_TYPE s_enomem_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+// Notification retry configuration
+#define HID_NOTIFY_MAX_ATTEMPTS 16
+#define HID_NOTIFY_RETRY_BASE_DELAY_MS 10
+#define HID_NOTIFY_RETRY_MAX_DELAY_MS 160
 
 static uint32_t hid_notify_calculate_delay_ms(int attempt)
 {
@@ -220,218 +181,421 @@ static uint32_t hid_notify_calculate_delay_ms(int attempt)
     return delay;
 }
 
-static hid_enomem_metric_t *hid_notify_get_or_create_metric(uint16_t attr_handle)
+// Maps an input report characteristic to its metrics bucket
+static hid_metrics_report_t ble_hid_report_type(uint16_t attr_handle)
 {
-    size_t index = SIZE_MAX;
-
-    for (size_t i = 0; i < s_enomem_metric_count; ++i)
+    if (attr_handle == s_handles.mouse_report_handle)
     {
-        if (s_enomem_metrics[i].handle == attr_handle)
-        {
-            index = i;
-            break;
-        }
+        return HID_METRICS_REPORT_MOUSE;
     }
-
-    if (index == SIZE_MAX)
+    if (attr_handle == s_handles.hires_mouse_input_handle)
     {
-        if (s_enomem_metric_count < (sizeof(s_enomem_metrics) / sizeof(s_enomem_metrics[0])))
-        {
-            index = s_enomem_metric_count++;
-        }
-        else
-        {
-            index = s_enomem_metric_count - 1;
-        }
-
-        s_enomem_metrics[index].handle = attr_handle;
-        s_enomem_metrics[index].attempts = 0;
-        s_enomem_metrics[index].successes = 0;
-        s_enomem_metrics[index].failures = 0;
-        s_enomem_metrics[index].enomem_alloc = 0;
-        s_enomem_metrics[index].enomem_notify = 0;
+        return HID_METRICS_REPORT_HIRES_MOUSE;
     }
-
-    return &s_enomem_metrics[index];
+    if (attr_handle == s_handles.mouse_boot_input_handle)
+    {
+        return HID_METRICS_REPORT_BOOT_MOUSE;
+    }
+    if (attr_handle == s_handles.keyboard_input_handle)
+    {
+        return HID_METRICS_REPORT_KEYBOARD;
+    }
+    if (attr_handle == s_handles.keyboard_nkro_input_handle)
+    {
+        return HID_METRICS_REPORT_KEYBOARD_NKRO;
+    }
+    if (attr_handle == s_handles.keyboard_boot_input_handle)
+    {
+        return HID_METRICS_REPORT_BOOT_KEYBOARD;
+    }
+    if (attr_handle == s_handles.consumer_input_handle)
+    {
+        return HID_METRICS_REPORT_CONSUMER;
+    }
+    if (attr_handle == s_handles.pointer_input_handle)
+    {
+        return HID_METRICS_REPORT_POINTER;
+    }
+    return HID_METRICS_REPORT_COUNT;
 }
 
-static uint32_t hid_notify_compute_rate_basis_points(const hid_enomem_metric_t *metric)
+// Forward declarations
+static int ble_hid_gap_event(struct ble_gap_event *event, void *arg);
+static void ble_hid_on_sync(void);
+static void ble_hid_on_reset(int reason);
+static esp_err_t ble_hid_advertise_phase(ble_adv_phase_t phase);
+
+// Refills ble_bond_cache from the store's RAM copy; no flash access
+static void ble_hid_reload_bonds(void)
 {
-    uint32_t total_events = metric->enomem_alloc + metric->enomem_notify;
-    if (metric->attempts == 0 || total_events == 0)
+    ble_addr_t peers[BLE_HID_MAX_BONDS];
+    int count = 0;
+    int rc = ble_store_util_bonded_peers(peers, &count, BLE_HID_MAX_BONDS);
+    if (rc != 0)
     {
-        return 0;
+        ESP_LOGW(TAG, "Failed to list bonds; rc=%d", rc);
+        count = 0;
     }
 
-    return (total_events * 10000) / metric->attempts;
+    ble_bond_entry_t entries[BLE_HID_MAX_BONDS] = {0};
+    for (int i = 0; i < count; ++i)
+    {
+        entries[i].addr_type = peers[i].type;
+        memcpy(entries[i].addr, peers[i].val, sizeof(entries[i].addr));
+    }
+    ble_bond_cache_load(entries, (size_t)count);
 }
 
-static void hid_notify_record_attempt(uint16_t attr_handle)
+// Bonds are the security records; CCCD writes are frequent and do not
+// change the list
+static bool ble_hid_store_obj_is_bond(int obj_type)
 {
-    portENTER_CRITICAL(&s_enomem_metrics_lock);
-    hid_enomem_metric_t *metric = hid_notify_get_or_create_metric(attr_handle);
-    metric->attempts++;
-    portEXIT_CRITICAL(&s_enomem_metrics_lock);
+    return obj_type == BLE_STORE_OBJ_TYPE_OUR_SEC || obj_type == BLE_STORE_OBJ_TYPE_PEER_SEC;
 }
 
-static void hid_notify_record_success(uint16_t attr_handle)
+static int ble_hid_store_write(int obj_type, const union ble_store_value *val)
 {
-    portENTER_CRITICAL(&s_enomem_metrics_lock);
-    hid_enomem_metric_t *metric = hid_notify_get_or_create_metric(attr_handle);
-    metric->successes++;
-    portEXIT_CRITICAL(&s_enomem_metrics_lock);
+    int rc = s_store_write(obj_type, val);
+    if (ble_hid_store_obj_is_bond(obj_type))
+    {
+        ble_hid_reload_bonds();
+    }
+    return rc;
 }
 
-static void hid_notify_record_failure(uint16_t attr_handle)
+static int ble_hid_store_delete(int obj_type, const union ble_store_key *key)
 {
-    portENTER_CRITICAL(&s_enomem_metrics_lock);
-    hid_enomem_metric_t *metric = hid_notify_get_or_create_metric(attr_handle);
-    metric->failures++;
-    portEXIT_CRITICAL(&s_enomem_metrics_lock);
+    int rc = s_store_delete(obj_type, key);
+    if (ble_hid_store_obj_is_bond(obj_type))
+    {
+        ble_hid_reload_bonds();
+    }
+    return rc;
 }
 
-static void hid_notify_record_enomem(uint16_t attr_handle, int attempt, const char *stage)
+static bool tick_reached(TickType_t now, TickType_t deadline)
 {
-    uint32_t attempts = 0;
-    uint32_t events = 0;
-    uint32_t rate_bp = 0;
+    return (int32_t)(now - deadline) >= 0;
+}
 
-    portENTER_CRITICAL(&s_enomem_metrics_lock);
-    size_t index = SIZE_MAX;
-    for (size_t i = 0; i < s_enomem_metric_count; ++i)
+static ble_hid_conn_t *ble_hid_conn_find(uint16_t conn_handle)
+{
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
     {
-        if (s_enomem_metrics[i].handle == attr_handle)
+        if (s_conns[i].in_use && s_conns[i].conn_handle == conn_handle)
         {
-            index = i;
-            break;
+            return &s_conns[i];
         }
     }
+    return NULL;
+}
+
+static bool ble_hid_conn_routed(const ble_hid_conn_t *conn)
+{
+    return conn->in_use && (s_route == BLE_HID_ROUTE_ALL || s_route == conn->conn_handle);
+}
+
+static void ble_hid_conn_reset(ble_hid_conn_t *conn, uint16_t conn_handle)
+{
+    memset(conn, 0, sizeof(*conn));
+    conn->in_use = true;
+    conn->conn_handle = conn_handle;
+    conn->connect_seq = ++s_connect_seq;
+    conn->protocol_mode = BLE_HID_PROTOCOL_MODE_REPORT;
+    conn->hires_mouse_feature.report_id = HID_REPORT_ID_HIRES_MOUSE;
+    conn->mouse_report[0] = HID_REPORT_ID_MOUSE;
+    conn->keyboard_report.report_id = HID_REPORT_ID_KEYBOARD;
+    conn->pointer_report[0] = HID_REPORT_ID_POINTER;
+    conn->hires_mouse_report[0] = HID_REPORT_ID_HIRES_MOUSE;
+    conn->keyboard_nkro_report.report_id = HID_REPORT_ID_KEYBOARD_NKRO;
+}
+
+// Caller holds s_conn_lock
+static void ble_hid_conn_queue_pop(ble_hid_conn_t *conn)
+{
+    conn->queue_head = (conn->queue_head + 1) % BLE_HID_CONN_QUEUE_DEPTH;
+    conn->queue_count--;
+    conn->queue_popped++;
+}
 
-    if (index == SIZE_MAX)
+// Caller holds s_conn_lock
+static void ble_hid_conn_queue_push(ble_hid_conn_t *conn, uint16_t attr_handle,
+                                    const void *data, size_t len)
+{
+    if (conn->queue_count == BLE_HID_CONN_QUEUE_DEPTH)
     {
-        if (s_enomem_metric_count < (sizeof(s_enomem_metrics) / sizeof(s_enomem_metrics[0])))
-        {
-            index = s_enomem_metric_count++;
-        }
-        else
-        {
-            // Re-use the last slot if we run out of dedicated metric entries.
-            index = s_enomem_metric_count - 1;
-        }
-        s_enomem_metrics[index].handle = attr_handle;
-        s_enomem_metrics[index].attempts = 0;
-        s_enomem_metrics[index].successes = 0;
-        s_enomem_metrics[index].failures = 0;
-        s_enomem_metrics[index].enomem_alloc = 0;
-        s_enomem_metrics[index].enomem_notify = 0;
+        // Only this host is behind. Keyboard, button and consumer reports
+        // carry full state, so dropping the oldest still leaves the host with
+        // the right keys held; only relative motion is lost.
+        hid_metrics_record_dropped(conn->queue[conn->queue_head].type);
+        hid_event_log_record(HID_EVENT_QUEUE_DROP, conn->queue[conn->queue_head].type,
+                             conn->conn_handle, 0);
+        ble_hid_conn_queue_pop(conn);
+        conn->dropped++;
     }
 
-    if (strcmp(stage, "alloc") == 0)
+    hid_pending_report_t *entry =
+        &conn->queue[(conn->queue_head + conn->queue_count) % BLE_HID_CONN_QUEUE_DEPTH];
+    entry->attr_handle = attr_handle;
+    entry->type = ble_hid_report_type(attr_handle);
+    entry->group = conn->queue_group;
+    entry->len = (uint8_t)len;
+    entry->retries = 0;
+    entry->done = false;
+    entry->queued_us = esp_timer_get_time();
+    memcpy(entry->data, data, len);
+    conn->queue_count++;
+}
+
+// Stamped before the send: NimBLE may report NOTIFY_TX from inside
+// ble_gatts_notify_custom().
+static void ble_hid_conn_before_send(void *ctx, const hid_pending_report_t *report, int64_t started_us)
+{
+    ble_hid_conn_t *conn = ctx;
+    if ((unsigned)report->type >= HID_METRICS_REPORT_COUNT)
     {
-        s_enomem_metrics[index].enomem_alloc++;
+        return;
     }
-    else
+
+    portENTER_CRITICAL(&s_conn_lock);
+    conn->notify_started_us[report->type] = started_us;
+    portEXIT_CRITICAL(&s_conn_lock);
+}
+
+// Caller holds s_conn_lock. Writes a drain cycle's outcome back to the queue:
+// finished reports at the head are popped, later ones stay flagged so the
+// next cycle leaves them out. Pushes may have dropped the oldest entries
+// since the snapshot was taken.
+static void ble_hid_conn_settle(ble_hid_conn_t *conn, const hid_pending_report_t *reports,
+                                size_t count, uint32_t popped)
+{
+    size_t gone = conn->queue_popped - popped;
+    for (size_t i = gone; i < count && i - gone < conn->queue_count; ++i)
     {
-        s_enomem_metrics[index].enomem_notify++;
+        hid_pending_report_t *entry =
+            &conn->queue[(conn->queue_head + i - gone) % BLE_HID_CONN_QUEUE_DEPTH];
+        entry->done = reports[i].done;
+        entry->retries = reports[i].retries;
     }
 
-    attempts = s_enomem_metrics[index].attempts;
-    events = s_enomem_metrics[index].enomem_alloc + s_enomem_metrics[index].enomem_notify;
-    rate_bp = hid_notify_compute_rate_basis_points(&s_enomem_metrics[index]);
-    portEXIT_CRITICAL(&s_enomem_metrics_lock);
-
-    ESP_LOGW(TAG,
-             "Notify ENOMEM (handle=0x%04X, attempt=%d, stage=%s, total=%" PRIu32
-             "/%" PRIu32 " attempts, rate=%" PRIu32 ".%02" PRIu32 "%%)",
-             attr_handle,
-             attempt + 1,
-             stage,
-             events,
-             attempts,
-             rate_bp / 100,
-             rate_bp % 100);
+    while (conn->queue_count > 0 && conn->queue[conn->queue_head].done)
+    {
+        ble_hid_conn_queue_pop(conn);
+    }
 }
 
-// Forward declarations
-static int ble_hid_gap_event(struct ble_gap_event *event, void *arg);
-static void ble_hid_on_sync(void);
-static void ble_hid_on_reset(int reason);
-
-static esp_err_t ble_hid_send_notification(uint16_t attr_handle, const uint8_t *data, size_t len)
+// Sends queued reports until the link runs out of buffers. Returns true if
+// reports are still waiting.
+static bool ble_hid_conn_drain(ble_hid_conn_t *conn)
 {
-    TickType_t start = xTaskGetTickCount();
-    const TickType_t max_wait = pdMS_TO_TICKS(HID_NOTIFY_MAX_WAIT_MS);
-
-    for (int attempt = 0; attempt < HID_NOTIFY_MAX_ATTEMPTS; ++attempt)
+    portENTER_CRITICAL(&s_conn_lock);
+    if (!conn->in_use || conn->draining)
     {
-        hid_notify_record_attempt(attr_handle);
+        bool waiting = conn->in_use && conn->queue_count > 0;
+        portEXIT_CRITICAL(&s_conn_lock);
+        return waiting;
+    }
+    conn->draining = true;
+    uint16_t conn_handle = conn->conn_handle;
+    portEXIT_CRITICAL(&s_conn_lock);
 
-        struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
-        if (!om)
+    bool waiting = false;
+    for (;;)
+    {
+        hid_pending_report_t reports[BLE_HID_CONN_QUEUE_DEPTH];
+        size_t count = 0;
+        uint32_t popped = 0;
+        bool report_protocol = true;
+        bool ready = false;
+
+        portENTER_CRITICAL(&s_conn_lock);
+        if (conn->in_use && conn->conn_handle == conn_handle && conn->queue_count > 0)
         {
-            hid_notify_record_enomem(attr_handle, attempt, "alloc");
-
-            if ((xTaskGetTickCount() - start) >= max_wait)
+            waiting = true;
+            ready = tick_reached(xTaskGetTickCount(), conn->retry_at);
+            if (ready)
             {
-                break;
+                count = conn->queue_count;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    reports[i] = conn->queue[(conn->queue_head + i) % BLE_HID_CONN_QUEUE_DEPTH];
+                }
+                popped = conn->queue_popped;
+                report_protocol = conn->protocol_mode == BLE_HID_PROTOCOL_MODE_REPORT;
             }
-
-            vTaskDelay(pdMS_TO_TICKS(hid_notify_calculate_delay_ms(attempt)));
-            continue;
         }
-
-        int rc = ble_gatts_notify_custom(s_handles.conn_handle, attr_handle, om);
-        if (rc == 0)
+        else
         {
-            hid_notify_record_success(attr_handle);
-            return ESP_OK;
+            waiting = false;
         }
+        portEXIT_CRITICAL(&s_conn_lock);
 
-        os_mbuf_free_chain(om);
+        if (!ready)
+        {
+            break;
+        }
 
-        if (rc == BLE_HS_ENOMEM)
+        // Everything queued goes out back-to-back, so it can share one
+        // connection event
+        hid_send_plan_t plan;
+        hid_send_result_t result;
+        hid_send_plan_build(reports, count, report_protocol, &plan);
+        hid_send_plan_submit(conn_handle, reports, &plan, ble_hid_conn_before_send, conn, &result);
+        for (size_t i = 0; i < count; ++i)
         {
-            hid_notify_record_enomem(attr_handle, attempt, "notify");
+            reports[i].done |= plan.skip[i];
+        }
 
-            if ((xTaskGetTickCount() - start) >= max_wait)
+        bool congested = result.last_err == ESP_ERR_NO_MEM;
+        portENTER_CRITICAL(&s_conn_lock);
+        if (conn->in_use && conn->conn_handle == conn_handle)
+        {
+            ble_hid_conn_settle(conn, reports, count, popped);
+            if (congested)
             {
-                break;
+                conn->congested++;
+                conn->retry_at = xTaskGetTickCount() +
+                                 pdMS_TO_TICKS(hid_notify_calculate_delay_ms(conn->congestion));
+                if (conn->congestion < HID_NOTIFY_MAX_ATTEMPTS)
+                {
+                    conn->congestion++;
+                }
+            }
+            else
+            {
+                conn->congestion = 0;
             }
+        }
+        portEXIT_CRITICAL(&s_conn_lock);
 
-            vTaskDelay(pdMS_TO_TICKS(hid_notify_calculate_delay_ms(attempt)));
-            continue;
+        if (congested)
+        {
+            break;
         }
+    }
 
-        ESP_LOGW(TAG, "Notify failed (handle=0x%04X, rc=%d)", attr_handle, rc);
-        return ESP_FAIL;
+    portENTER_CRITICAL(&s_conn_lock);
+    if (conn->in_use && conn->conn_handle == conn_handle)
+    {
+        conn->draining = false;
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
+
+    return waiting;
+}
+
+static void ble_hid_record_notify_tx(uint16_t conn_handle, uint16_t attr_handle)
+{
+    hid_metrics_report_t type = ble_hid_report_type(attr_handle);
+    if (type == HID_METRICS_REPORT_COUNT)
+    {
+        return;
+    }
+
+    int64_t started_us = 0;
+    portENTER_CRITICAL(&s_conn_lock);
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (conn)
+    {
+        started_us = conn->notify_started_us[type];
+        conn->notify_started_us[type] = 0;
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
+
+    if (started_us != 0)
+    {
+        hid_metrics_record_tx_latency(type, (uint32_t)(esp_timer_get_time() - started_us));
+    }
+}
+
+static void ble_hid_schedule_drain(void);
+
+static void ble_hid_drain_all(void)
+{
+    bool waiting = false;
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+    {
+        waiting |= ble_hid_conn_drain(&s_conns[i]);
+    }
+
+    if (waiting)
+    {
+        ble_hid_schedule_drain();
+    }
+}
+
+// Retries from the drain task, outside whatever context queued the reports
+static void ble_hid_schedule_drain(void)
+{
+    // Created in ble_hid_init, before the host task or hid_device can queue
+    if (s_drain_task)
+    {
+        xTaskNotifyGive(s_drain_task);
+    }
+}
+
+// Pinned next to the NimBLE host, so the retry path does not depend on the
+// FreeRTOS timer service task and whatever else runs in it
+static void ble_hid_drain_task(void *arg)
+{
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(HID_NOTIFY_RETRY_BASE_DELAY_MS));
+        // Requests made during the delay are covered by this pass
+        ulTaskNotifyTake(pdTRUE, 0);
+        ble_hid_drain_all();
     }
+}
 
-    hid_notify_record_failure(attr_handle);
+typedef esp_err_t (*ble_hid_conn_report_fn)(ble_hid_conn_t *conn, const void *state);
 
-    uint32_t attempts = 0;
-    uint32_t events = 0;
-    uint32_t failures = 0;
-    uint32_t rate_bp = 0;
+// Queues a report for every routed host, then pushes out whatever the links
+// will take right now.
+static esp_err_t ble_hid_route_report(ble_hid_conn_report_fn queue_report, const void *state)
+{
+    ble_hid_conn_t *targets[BLE_HID_MAX_CONNECTIONS];
+    size_t count = 0;
+    bool has_room = false;
+
+    portENTER_CRITICAL(&s_conn_lock);
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+    {
+        ble_hid_conn_t *conn = &s_conns[i];
+        if (ble_hid_conn_routed(conn))
+        {
+            targets[count++] = conn;
+            has_room |= BLE_HID_CONN_QUEUE_DEPTH - conn->queue_count >= BLE_HID_REPORTS_PER_UPDATE;
+        }
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
 
-    portENTER_CRITICAL(&s_enomem_metrics_lock);
-    hid_enomem_metric_t *metric = hid_notify_get_or_create_metric(attr_handle);
-    attempts = metric->attempts;
-    events = metric->enomem_alloc + metric->enomem_notify;
-    failures = metric->failures;
-    rate_bp = hid_notify_compute_rate_basis_points(metric);
-    portEXIT_CRITICAL(&s_enomem_metrics_lock);
+    if (count == 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Every routed host is backed up: push back so hid_device keeps
+    // coalescing the input instead of this layer dropping it.
+    if (!has_room)
+    {
+        ble_hid_drain_all();
+        return ESP_ERR_NO_MEM;
+    }
 
-    ESP_LOGW(TAG,
-             "Notify failed: out of memory (handle=0x%04X, attempts=%" PRIu32
-             ", ENOMEM=%" PRIu32 ", failures=%" PRIu32 ", rate=%" PRIu32 ".%02" PRIu32 "%%)",
-             attr_handle,
-             attempts,
-             events,
-             failures,
-             rate_bp / 100,
-             rate_bp % 100);
+    esp_err_t result = ESP_ERR_INVALID_STATE;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (queue_report(targets[i], state) == ESP_OK)
+        {
+            result = ESP_OK;
+        }
+    }
 
-    return ESP_ERR_NO_MEM;
+    if (result == ESP_OK)
+    {
+        ble_hid_drain_all();
+    }
+    return result;
 }
 
 // HID Information
@@ -466,34 +630,61 @@ static int hid_report_map_access(uint16_t conn_handle, uint16_t attr_handle,
 static int hid_control_point_access(uint16_t conn_handle, uint16_t attr_handle,
                                     struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
     {
         uint16_t len = OS_MBUF_PKTLEN(ctxt->om);
         if (len > 0)
         {
-            os_mbuf_copydata(ctxt->om, 0, 1, &s_hid_control);
-            ESP_LOGI(TAG, "HID Control Point: 0x%02x", s_hid_control);
+            os_mbuf_copydata(ctxt->om, 0, 1, &conn->hid_control);
+            ESP_LOGI(TAG, "HID Control Point (conn %u): 0x%02x", conn_handle, conn->hid_control);
         }
         return 0;
     }
     return BLE_ATT_ERR_UNLIKELY;
 }
 
+static void ble_hid_conn_resync(ble_hid_conn_t *conn);
+
 // Protocol Mode
 static int hid_protocol_mode_access(uint16_t conn_handle, uint16_t attr_handle,
                                     struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, &s_protocol_mode, 1);
+        return os_mbuf_append(ctxt->om, &conn->protocol_mode, 1);
     }
     else if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
     {
         uint16_t len = OS_MBUF_PKTLEN(ctxt->om);
-        if (len > 0)
+        uint8_t mode = 0;
+        if (len == 0 || os_mbuf_copydata(ctxt->om, 0, 1, &mode) != 0 ||
+            mode > BLE_HID_PROTOCOL_MODE_REPORT)
+        {
+            // Reserved values are ignored, as the HID service requires
+            return 0;
+        }
+
+        portENTER_CRITICAL(&s_conn_lock);
+        bool changed = conn->protocol_mode != mode;
+        conn->protocol_mode = mode;
+        portEXIT_CRITICAL(&s_conn_lock);
+
+        ESP_LOGI(TAG, "Protocol Mode (conn %u): %d", conn_handle, mode);
+        if (changed)
         {
-            os_mbuf_copydata(ctxt->om, 0, 1, &s_protocol_mode);
-            ESP_LOGI(TAG, "Protocol Mode: %d", s_protocol_mode);
+            ble_hid_conn_resync(conn);
         }
         return 0;
     }
@@ -504,9 +695,96 @@ static int hid_protocol_mode_access(uint16_t conn_handle, uint16_t attr_handle,
 static int mouse_report_access(uint16_t conn_handle, uint16_t attr_handle,
                                struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
+    {
+        return os_mbuf_append(ctxt->om, conn->mouse_report, sizeof(conn->mouse_report));
+    }
+    return BLE_ATT_ERR_UNLIKELY;
+}
+
+// High-Resolution Mouse Report (Report ID 5)
+static int hires_mouse_report_access(uint16_t conn_handle, uint16_t attr_handle,
+                                     struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
+    {
+        return os_mbuf_append(ctxt->om, conn->hires_mouse_report, sizeof(conn->hires_mouse_report));
+    }
+    return BLE_ATT_ERR_UNLIKELY;
+}
+
+// N-Key Rollover Keyboard Report (Report ID 6)
+static int keyboard_nkro_input_access(uint16_t conn_handle, uint16_t attr_handle,
+                                      struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
+    {
+        return os_mbuf_append(ctxt->om, &conn->keyboard_nkro_report, sizeof(conn->keyboard_nkro_report));
+    }
+    return BLE_ATT_ERR_UNLIKELY;
+}
+
+// High-Resolution Mouse Feature Report (Report ID 5 - Resolution Multipliers)
+static int hires_mouse_feature_access(uint16_t conn_handle, uint16_t attr_handle,
+                                      struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, s_mouse_report, sizeof(s_mouse_report));
+        return os_mbuf_append(ctxt->om, &conn->hires_mouse_feature, sizeof(conn->hires_mouse_feature));
+    }
+    else if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
+    {
+        uint8_t value[HID_HIRES_MOUSE_FEATURE_REPORT_LEN] = {0};
+        uint16_t len = OS_MBUF_PKTLEN(ctxt->om);
+        if (len > sizeof(value))
+        {
+            len = sizeof(value);
+        }
+        os_mbuf_copydata(ctxt->om, 0, len, value);
+
+        // HOGP feature writes omit the Report ID; tolerate hosts that echo it.
+        const uint8_t *payload = value;
+        if (len == HID_HIRES_MOUSE_FEATURE_REPORT_LEN && value[0] == HID_REPORT_ID_HIRES_MOUSE)
+        {
+            payload++;
+            len--;
+        }
+        if (len > 0)
+        {
+            conn->hires_mouse_feature.wheel_multiplier = payload[0] & 0x03;
+        }
+        if (len > 1)
+        {
+            conn->hires_mouse_feature.hwheel_multiplier = payload[1] & 0x03;
+        }
+        ESP_LOGI(TAG, "Resolution multiplier (conn %u): wheel=%u hwheel=%u", conn_handle,
+                 mouse_wheel_multiplier(conn->hires_mouse_feature.wheel_multiplier),
+                 mouse_wheel_multiplier(conn->hires_mouse_feature.hwheel_multiplier));
+        return 0;
     }
     return BLE_ATT_ERR_UNLIKELY;
 }
@@ -515,9 +793,15 @@ static int mouse_report_access(uint16_t conn_handle, uint16_t attr_handle,
 static int keyboard_input_access(uint16_t conn_handle, uint16_t attr_handle,
                                  struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, s_keyboard_report, sizeof(s_keyboard_report));
+        return os_mbuf_append(ctxt->om, &conn->keyboard_report, sizeof(conn->keyboard_report));
     }
     return BLE_ATT_ERR_UNLIKELY;
 }
@@ -526,17 +810,23 @@ static int keyboard_input_access(uint16_t conn_handle, uint16_t attr_handle,
 static int keyboard_output_access(uint16_t conn_handle, uint16_t attr_handle,
                                   struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, &s_keyboard_leds, 1);
+        return os_mbuf_append(ctxt->om, &conn->keyboard_leds, 1);
     }
     else if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
     {
         uint16_t len = OS_MBUF_PKTLEN(ctxt->om);
         if (len > 0)
         {
-            os_mbuf_copydata(ctxt->om, 0, 1, &s_keyboard_leds);
-            ESP_LOGI(TAG, "Keyboard LEDs: 0x%02x", s_keyboard_leds);
+            os_mbuf_copydata(ctxt->om, 0, 1, &conn->keyboard_leds);
+            ESP_LOGI(TAG, "Keyboard LEDs (conn %u): 0x%02x", conn_handle, conn->keyboard_leds);
         }
         return 0;
     }
@@ -544,6 +834,9 @@ static int keyboard_output_access(uint16_t conn_handle, uint16_t attr_handle,
 }
 
 // Consumer Report (Report ID 3)
+_Static_assert(sizeof(hid_consumer_usages) / sizeof(hid_consumer_usages[0]) == HID_CONSUMER_INPUT_USAGES_BITS,
+               "Consumer usage table must cover every bit of the consumer report");
+
 uint16_t ble_hid_consumer_usage_to_mask(uint16_t usage)
 {
     if (usage == 0)
@@ -551,11 +844,11 @@ uint16_t ble_hid_consumer_usage_to_mask(uint16_t usage)
         return 0;
     }
 
-    size_t count = sizeof(s_consumer_usages) / sizeof(s_consumer_usages[0]);
+    size_t count = sizeof(hid_consumer_usages) / sizeof(hid_consumer_usages[0]);
     for (size_t i = 0; i < count; ++i)
     {
         uint16_t mask = (uint16_t)(1u << i);
-        if (usage == s_consumer_usages[i] || usage == mask)
+        if (usage == hid_consumer_usages[i] || usage == mask)
         {
             return mask;
         }
@@ -571,13 +864,13 @@ uint16_t ble_hid_consumer_mask_to_usage(uint16_t mask)
         return 0;
     }
 
-    size_t count = sizeof(s_consumer_usages) / sizeof(s_consumer_usages[0]);
+    size_t count = sizeof(hid_consumer_usages) / sizeof(hid_consumer_usages[0]);
     for (size_t i = 0; i < count; ++i)
     {
         uint16_t bit = (uint16_t)(1u << i);
         if (bit == mask)
         {
-            return s_consumer_usages[i];
+            return hid_consumer_usages[i];
         }
     }
 
@@ -599,23 +892,52 @@ void ble_hid_consumer_mask_to_report(uint16_t mask, uint8_t report[2])
 static int consumer_report_access(uint16_t conn_handle, uint16_t attr_handle,
                                   struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
         // Keep the readback order consistent with the notification payload
         uint8_t report[2];
-        ble_hid_consumer_mask_to_report(s_consumer_report, report);
+        ble_hid_consumer_mask_to_report(conn->consumer_report, report);
         return os_mbuf_append(ctxt->om, report, sizeof(report));
     }
     return BLE_ATT_ERR_UNLIKELY;
 }
 
+// Absolute Pointer Report (Report ID 4)
+static int pointer_report_access(uint16_t conn_handle, uint16_t attr_handle,
+                                 struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
+    {
+        return os_mbuf_append(ctxt->om, conn->pointer_report, sizeof(conn->pointer_report));
+    }
+    return BLE_ATT_ERR_UNLIKELY;
+}
+
 // Boot Mouse Input
 static int boot_mouse_input_access(uint16_t conn_handle, uint16_t attr_handle,
                                    struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, s_boot_mouse_report, sizeof(s_boot_mouse_report));
+        return os_mbuf_append(ctxt->om, conn->boot_mouse_report, sizeof(conn->boot_mouse_report));
     }
     return BLE_ATT_ERR_UNLIKELY;
 }
@@ -624,9 +946,15 @@ static int boot_mouse_input_access(uint16_t conn_handle, uint16_t attr_handle,
 static int boot_keyboard_input_access(uint16_t conn_handle, uint16_t attr_handle,
                                       struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, s_boot_keyboard_report, sizeof(s_boot_keyboard_report));
+        return os_mbuf_append(ctxt->om, BOOT_KEYBOARD_REPORT(conn), BOOT_KEYBOARD_REPORT_LEN);
     }
     return BLE_ATT_ERR_UNLIKELY;
 }
@@ -635,17 +963,23 @@ static int boot_keyboard_input_access(uint16_t conn_handle, uint16_t attr_handle
 static int boot_keyboard_output_access(uint16_t conn_handle, uint16_t attr_handle,
                                        struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
+    ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+    if (!conn)
+    {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
     if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR)
     {
-        return os_mbuf_append(ctxt->om, &s_keyboard_leds, 1);
+        return os_mbuf_append(ctxt->om, &conn->keyboard_leds, 1);
     }
     else if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
     {
         uint16_t len = OS_MBUF_PKTLEN(ctxt->om);
         if (len > 0)
         {
-            os_mbuf_copydata(ctxt->om, 0, 1, &s_keyboard_leds);
-            ESP_LOGI(TAG, "Boot Keyboard LEDs: 0x%02x", s_keyboard_leds);
+            os_mbuf_copydata(ctxt->om, 0, 1, &conn->keyboard_leds);
+            ESP_LOGI(TAG, "Boot Keyboard LEDs (conn %u): 0x%02x", conn_handle, conn->keyboard_leds);
         }
         return 0;
     }
@@ -753,7 +1087,7 @@ static const struct ble_gatt_svc_def gatt_svcs[] = {
                                                                                                                                                                                                                                                                                                                                                                                                                       .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
                                                                                                                                                                                                                                                                                                                                                                                                                       .att_flags = BLE_ATT_F_READ,
                                                                                                                                                                                                                                                                                                                                                                                                                       .access_cb = report_reference_access,
-                                                                                                                                                                                                                                                                                                                                                                                                                      .arg = (void *)mouse_report_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                      .arg = (void *)hid_mouse_input_report_ref,
                                                                                                                                                                                                                                                                                                                                                                                                                   },
                                                                                                                                                                                                                                                                                                                                                                                                                   {0}}},
 
@@ -762,7 +1096,7 @@ static const struct ble_gatt_svc_def gatt_svcs[] = {
                                                                                                                                                                                                                                                                                                                                                                                                                           .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
                                                                                                                                                                                                                                                                                                                                                                                                                           .att_flags = BLE_ATT_F_READ,
                                                                                                                                                                                                                                                                                                                                                                                                                           .access_cb = report_reference_access,
-                                                                                                                                                                                                                                                                                                                                                                                                                          .arg = (void *)keyboard_input_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                          .arg = (void *)hid_keyboard_input_report_ref,
                                                                                                                                                                                                                                                                                                                                                                                                                       },
                                                                                                                                                                                                                                                                                                                                                                                                                       {0}}},
 
@@ -771,7 +1105,7 @@ static const struct ble_gatt_svc_def gatt_svcs[] = {
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     .att_flags = BLE_ATT_F_READ,
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     .access_cb = report_reference_access,
-                                                                                                                                                                                                                                                                                                                                                                                                                                                                                    .arg = (void *)keyboard_output_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                    .arg = (void *)hid_keyboard_output_report_ref,
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 },
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 {0}}},
 
@@ -780,7 +1114,43 @@ static const struct ble_gatt_svc_def gatt_svcs[] = {
                                                                                                                                                                                                                                                                                                                                                                                                                            .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
                                                                                                                                                                                                                                                                                                                                                                                                                            .att_flags = BLE_ATT_F_READ,
                                                                                                                                                                                                                                                                                                                                                                                                                            .access_cb = report_reference_access,
-                                                                                                                                                                                                                                                                                                                                                                                                                           .arg = (void *)consumer_report_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .arg = (void *)hid_consumer_input_report_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                       },
+                                                                                                                                                                                                                                                                                                                                                                                                                       {0}}},
+
+                                                                                                                                     // Absolute Pointer Report (ID 4)
+                                                                                                                                     {.uuid = BLE_UUID16_DECLARE(HID_REPORT_UUID), .access_cb = pointer_report_access, .val_handle = &s_handles.pointer_input_handle, .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY | BLE_GATT_CHR_F_READ_ENC, .min_key_size = 16, .descriptors = (struct ble_gatt_dsc_def[]){{
+                                                                                                                                                                                                                                                                                                                                                                                                                           .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
+                                                                                                                                                                                                                                                                                                                                                                                                                           .att_flags = BLE_ATT_F_READ,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .access_cb = report_reference_access,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .arg = (void *)hid_pointer_input_report_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                       },
+                                                                                                                                                                                                                                                                                                                                                                                                                       {0}}},
+
+                                                                                                                                     // High-Resolution Mouse Report (ID 5)
+                                                                                                                                     {.uuid = BLE_UUID16_DECLARE(HID_REPORT_UUID), .access_cb = hires_mouse_report_access, .val_handle = &s_handles.hires_mouse_input_handle, .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY | BLE_GATT_CHR_F_READ_ENC, .min_key_size = 16, .descriptors = (struct ble_gatt_dsc_def[]){{
+                                                                                                                                                                                                                                                                                                                                                                                                                           .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
+                                                                                                                                                                                                                                                                                                                                                                                                                           .att_flags = BLE_ATT_F_READ,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .access_cb = report_reference_access,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .arg = (void *)hid_hires_mouse_input_report_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                       },
+                                                                                                                                                                                                                                                                                                                                                                                                                       {0}}},
+
+                                                                                                                                     // High-Resolution Mouse Feature Report (ID 5)
+                                                                                                                                     {.uuid = BLE_UUID16_DECLARE(HID_REPORT_UUID), .access_cb = hires_mouse_feature_access, .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ_ENC | BLE_GATT_CHR_F_WRITE_ENC, .min_key_size = 16, .descriptors = (struct ble_gatt_dsc_def[]){{
+                                                                                                                                                                                                                                                                                                                                                                                                                           .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
+                                                                                                                                                                                                                                                                                                                                                                                                                           .att_flags = BLE_ATT_F_READ,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .access_cb = report_reference_access,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .arg = (void *)hid_hires_mouse_feature_report_ref,
+                                                                                                                                                                                                                                                                                                                                                                                                                       },
+                                                                                                                                                                                                                                                                                                                                                                                                                       {0}}},
+
+                                                                                                                                     // N-Key Rollover Keyboard Report (ID 6)
+                                                                                                                                     {.uuid = BLE_UUID16_DECLARE(HID_REPORT_UUID), .access_cb = keyboard_nkro_input_access, .val_handle = &s_handles.keyboard_nkro_input_handle, .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY | BLE_GATT_CHR_F_READ_ENC, .min_key_size = 16, .descriptors = (struct ble_gatt_dsc_def[]){{
+                                                                                                                                                                                                                                                                                                                                                                                                                           .uuid = BLE_UUID16_DECLARE(REPORT_REFERENCE_UUID),
+                                                                                                                                                                                                                                                                                                                                                                                                                           .att_flags = BLE_ATT_F_READ,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .access_cb = report_reference_access,
+                                                                                                                                                                                                                                                                                                                                                                                                                           .arg = (void *)hid_keyboard_nkro_input_report_ref,
                                                                                                                                                                                                                                                                                                                                                                                                                        },
                                                                                                                                                                                                                                                                                                                                                                                                                        {0}}},
 
@@ -814,6 +1184,159 @@ static const struct ble_gatt_svc_def gatt_svcs[] = {
                                                                                                                                      {0}}},
     {0}};
 
+// Identity address of a connected host, back in NimBLE byte order
+static void ble_hid_conn_peer(const ble_hid_conn_t *conn, ble_addr_t *addr)
+{
+    addr->type = conn->info.peer_addr_type;
+    for (int i = 0; i < 6; ++i)
+    {
+        addr->val[i] = conn->info.peer_addr[5 - i];
+    }
+}
+
+static size_t ble_hid_connected_peers(ble_bond_entry_t *out, size_t max)
+{
+    size_t count = 0;
+    portENTER_CRITICAL(&s_conn_lock);
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS && count < max; ++i)
+    {
+        if (s_conns[i].in_use)
+        {
+            ble_addr_t addr;
+            ble_hid_conn_peer(&s_conns[i], &addr);
+            out[count].addr_type = addr.type;
+            memcpy(out[count].addr, addr.val, sizeof(out[count].addr));
+            ++count;
+        }
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
+    return count;
+}
+
+static uint16_t ble_hid_peer_conn_handle(const ble_addr_t *peer)
+{
+    uint16_t conn_handle = BLE_HS_CONN_HANDLE_NONE;
+    portENTER_CRITICAL(&s_conn_lock);
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+    {
+        ble_addr_t addr;
+        ble_hid_conn_peer(&s_conns[i], &addr);
+        if (s_conns[i].in_use && ble_addr_cmp(&addr, peer) == 0)
+        {
+            conn_handle = s_conns[i].conn_handle;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
+    return conn_handle;
+}
+
+static void ble_hid_select_set(const ble_addr_t *peer)
+{
+    portENTER_CRITICAL(&s_select_lock);
+    s_select_pending = peer != NULL;
+    if (peer)
+    {
+        s_selected_peer = *peer;
+    }
+    portEXIT_CRITICAL(&s_select_lock);
+}
+
+static bool ble_hid_selected_peer(ble_addr_t *peer)
+{
+    portENTER_CRITICAL(&s_select_lock);
+    bool pending = s_select_pending;
+    *peer = s_selected_peer;
+    portEXIT_CRITICAL(&s_select_lock);
+    return pending;
+}
+
+// Ends the selection if it is for peer; returns whether it was
+static bool ble_hid_select_take(const ble_addr_t *peer)
+{
+    portENTER_CRITICAL(&s_select_lock);
+    bool match = s_select_pending && ble_addr_cmp(&s_selected_peer, peer) == 0;
+    if (match)
+    {
+        s_select_pending = false;
+    }
+    portEXIT_CRITICAL(&s_select_lock);
+    return match;
+}
+
+// Drops every stored subscription of peer; its bond stays. Returns how many
+static int ble_hid_store_forget_cccds(const ble_addr_t *peer)
+{
+    struct ble_store_key_cccd key = {.peer_addr = *peer};
+    int count = 0;
+    while (ble_store_delete_cccd(&key) == 0)
+    {
+        ++count;
+    }
+    return count;
+}
+
+// Connected hosts and the host whose record is being written
+static size_t ble_hid_store_keep(ble_bond_entry_t *keep, const ble_addr_t *writing)
+{
+    size_t keep_count = ble_hid_connected_peers(keep, BLE_HID_MAX_CONNECTIONS);
+    keep[keep_count].addr_type = writing->type;
+    memcpy(keep[keep_count].addr, writing->val, sizeof(keep[keep_count].addr));
+    return keep_count + 1;
+}
+
+// The store is full. A bond record overflow evicts the least recently used
+// bond rather than ble_store_util_status_rr's oldest one, and never a
+// connected host or the host being bonded; falls back to the oldest when
+// every bond is in use. A CCCD overflow never costs a bond: the least
+// recently used idle host gives up its subscriptions (it re-subscribes on
+// its next connection), and failing that the write is refused, leaving the
+// subscription live for this connection only.
+static int ble_hid_store_status(struct ble_store_status_event *event, void *arg)
+{
+    if (event->event_code != BLE_STORE_EVENT_OVERFLOW)
+    {
+        return ble_store_util_status_rr(event, arg);
+    }
+
+    ble_bond_entry_t keep[BLE_HID_MAX_CONNECTIONS + 1 + BLE_HID_MAX_BONDS];
+    ble_bond_entry_t victim;
+    if (ble_hid_store_obj_is_bond(event->overflow.obj_type))
+    {
+        size_t keep_count = ble_hid_store_keep(keep, &event->overflow.value->sec.peer_addr);
+        if (ble_bond_cache_lru(&victim, keep, keep_count))
+        {
+            ble_addr_t addr = {.type = victim.addr_type};
+            memcpy(addr.val, victim.addr, sizeof(addr.val));
+            ESP_LOGI(TAG, "Bond store full; evicting least recently used host");
+            ble_hid_select_take(&addr);
+            nvs_keystore_forget_peer(addr.type, addr.val);
+            return ble_store_util_delete_peer(&addr);
+        }
+        return ble_store_util_status_rr(event, arg);
+    }
+
+    if (event->overflow.obj_type == BLE_STORE_OBJ_TYPE_CCCD)
+    {
+        size_t keep_count = ble_hid_store_keep(keep, &event->overflow.value->cccd.peer_addr);
+        while (keep_count < sizeof(keep) / sizeof(keep[0]) && ble_bond_cache_lru(&victim, keep, keep_count))
+        {
+            ble_addr_t addr = {.type = victim.addr_type};
+            memcpy(addr.val, victim.addr, sizeof(addr.val));
+            if (ble_hid_store_forget_cccds(&addr) > 0)
+            {
+                ESP_LOGI(TAG, "CCCD store full; dropped subscriptions of least recently used host");
+                return 0;
+            }
+            // Nothing stored for this host; try the next one
+            keep[keep_count++] = victim;
+        }
+        ESP_LOGW(TAG, "CCCD store full; subscription not persisted");
+        return BLE_HS_ESTORE_CAP;
+    }
+    return ble_store_util_status_rr(event, arg);
+}
+
 static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
 {
     switch (event->type)
@@ -825,11 +1348,31 @@ static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
 
         if (event->connect.status == 0)
         {
-            s_handles.conn_handle = event->connect.conn_handle;
-            s_handles.connected = true;
+            ble_reconnect_on_connect(esp_timer_get_time());
 
-            memset(&s_conn_info, 0, sizeof(s_conn_info));
-            s_conn_info.connected = true;
+            ble_hid_conn_t *conn = NULL;
+
+            portENTER_CRITICAL(&s_conn_lock);
+            for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+            {
+                if (!s_conns[i].in_use)
+                {
+                    conn = &s_conns[i];
+                    ble_hid_conn_reset(conn, event->connect.conn_handle);
+                    break;
+                }
+            }
+            portEXIT_CRITICAL(&s_conn_lock);
+
+            if (!conn)
+            {
+                ESP_LOGW(TAG, "No free host slot for conn %u; disconnecting", event->connect.conn_handle);
+                ble_gap_terminate(event->connect.conn_handle, BLE_ERR_CONN_LIMIT);
+                break;
+            }
+
+            conn->info.connected = true;
+            conn->info.conn_handle = event->connect.conn_handle;
 
             struct ble_gap_conn_desc desc;
             if (ble_gap_conn_find(event->connect.conn_handle, &desc) == 0)
@@ -850,14 +1393,19 @@ static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
                 }
                 for (int i = 0; i < 6; ++i)
                 {
-                    s_conn_info.peer_addr[i] = addr->val[5 - i];
+                    conn->info.peer_addr[i] = addr->val[5 - i];
                 }
-                s_conn_info.peer_addr_type = addr->type;
-                s_conn_info.bonded = desc.sec_state.bonded;
-                s_conn_info.encrypted = desc.sec_state.encrypted;
-                s_conn_info.authenticated = desc.sec_state.authenticated;
+                conn->info.peer_addr_type = addr->type;
+                conn->info.bonded = desc.sec_state.bonded;
+                conn->info.encrypted = desc.sec_state.encrypted;
+                conn->info.authenticated = desc.sec_state.authenticated;
             }
 
+            ESP_LOGI(TAG, "Host %u connected (%u/%d)", event->connect.conn_handle,
+                     (unsigned)ble_hid_connection_count(), BLE_HID_MAX_CONNECTIONS);
+
+            ble_conn_params_on_connect(event->connect.conn_handle);
+
             if (s_state_callback)
             {
                 s_state_callback(DEVICE_STATE_CONNECTED);
@@ -871,7 +1419,8 @@ static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
         }
         else
         {
-            if (s_state_callback)
+            ble_reconnect_stop();
+            if (s_state_callback && ble_hid_connection_count() == 0)
             {
                 s_state_callback(DEVICE_STATE_IDLE);
             }
@@ -879,55 +1428,153 @@ static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
         break;
 
     case BLE_GAP_EVENT_DISCONNECT:
-        ESP_LOGI(TAG, "Disconnect; reason=%d", event->disconnect.reason);
-        s_handles.connected = false;
-        s_handles.subscribed_mouse = false;
-        s_handles.subscribed_mouse_boot = false;
-        s_handles.subscribed_keyboard = false;
-        s_handles.subscribed_keyboard_boot = false;
-        s_handles.subscribed_consumer = false;
-        memset(&s_conn_info, 0, sizeof(s_conn_info));
+    {
+        uint16_t conn_handle = event->disconnect.conn.conn_handle;
+        bool route_reset = false;
+
+        ESP_LOGI(TAG, "Disconnect; conn=%u reason=%d", conn_handle, event->disconnect.reason);
+
+        // Subscriptions, protocol mode, LEDs and Resolution Multipliers are
+        // all negotiated per connection, so they go with the slot.
+        portENTER_CRITICAL(&s_conn_lock);
+        ble_hid_conn_t *conn = ble_hid_conn_find(conn_handle);
+        if (conn)
+        {
+            memset(conn, 0, sizeof(*conn));
+        }
+        if (s_route == conn_handle)
+        {
+            s_route = BLE_HID_ROUTE_ALL;
+            route_reset = true;
+        }
+        portEXIT_CRITICAL(&s_conn_lock);
+
+        if (route_reset)
+        {
+            ESP_LOGI(TAG, "Routed host left; broadcasting to all hosts");
+        }
+        // A host leaving restarts a finished schedule, so it can come back
+        if (ble_reconnect_phase() == BLE_ADV_PHASE_OFF)
+        {
+            ble_reconnect_stop();
+        }
+        ble_conn_params_on_disconnect(conn_handle);
 
         if (s_state_callback)
         {
-            s_state_callback(DEVICE_STATE_IDLE);
+            s_state_callback(ble_hid_connection_count() > 0 ? DEVICE_STATE_CONNECTED : DEVICE_STATE_IDLE);
+        }
+        break;
+    }
+
+    case BLE_GAP_EVENT_CONN_UPDATE:
+        ESP_LOGI(TAG, "Connection update; status=%d", event->conn_update.status);
+        ble_conn_params_on_update(event->conn_update.conn_handle, event->conn_update.status);
+        if (s_state_callback && ble_hid_is_connected())
+        {
+            s_state_callback(DEVICE_STATE_CONNECTED);
+        }
+        break;
+
+    case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+        ble_conn_params_on_phy_update(event->phy_updated.conn_handle, event->phy_updated.status,
+                                      event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+        if (s_state_callback && ble_hid_is_connected())
+        {
+            s_state_callback(DEVICE_STATE_CONNECTED);
+        }
+        break;
+
+    case BLE_GAP_EVENT_DATA_LEN_CHG:
+        ble_conn_params_on_data_len(event->data_len_chg.conn_handle,
+                                    event->data_len_chg.max_tx_octets, event->data_len_chg.max_tx_time,
+                                    event->data_len_chg.max_rx_octets, event->data_len_chg.max_rx_time);
+        if (s_state_callback && ble_hid_is_connected())
+        {
+            s_state_callback(DEVICE_STATE_CONNECTED);
         }
         break;
 
     case BLE_GAP_EVENT_ADV_COMPLETE:
-        ESP_LOGI(TAG, "Advertising complete");
-        if (!s_handles.connected && s_state_callback)
+    {
+        ESP_LOGI(TAG, "Advertising complete; reason=%d", event->adv_complete.reason);
+        // A timed phase ran out; move on to the next without going idle
+        ble_adv_phase_t next = BLE_ADV_PHASE_IDLE;
+        if (event->adv_complete.reason == BLE_HS_ETIMEOUT)
+        {
+            next = ble_reconnect_next();
+        }
+        if (next != BLE_ADV_PHASE_IDLE && next != BLE_ADV_PHASE_OFF && ble_hid_advertise_phase(next) == ESP_OK)
+        {
+            if (s_state_callback)
+            {
+                s_state_callback(ble_hid_is_connected() ? DEVICE_STATE_CONNECTED : DEVICE_STATE_ADVERTISING);
+            }
+            break;
+        }
+        if (next == BLE_ADV_PHASE_OFF)
+        {
+            ESP_LOGI(TAG, "Advertising schedule finished; waiting for activity");
+            ble_hid_select_set(NULL);
+        }
+        else
+        {
+            ble_reconnect_stop();
+        }
+        if (!ble_hid_is_connected() && s_state_callback)
         {
             s_state_callback(DEVICE_STATE_IDLE);
         }
         break;
+    }
 
     case BLE_GAP_EVENT_SUBSCRIBE:
-        ESP_LOGI(TAG, "Subscribe event; attr_handle=%d, subscribed=%d",
+    {
+        ESP_LOGI(TAG, "Subscribe event; conn=%u attr_handle=%d, subscribed=%d",
+                 event->subscribe.conn_handle,
                  event->subscribe.attr_handle,
                  event->subscribe.cur_notify);
 
+        ble_hid_conn_t *conn = ble_hid_conn_find(event->subscribe.conn_handle);
+        if (!conn)
+        {
+            break;
+        }
+
         if (event->subscribe.attr_handle == s_handles.mouse_report_handle)
         {
-            s_handles.subscribed_mouse = event->subscribe.cur_notify;
+            conn->subscribed_mouse = event->subscribe.cur_notify;
         }
         else if (event->subscribe.attr_handle == s_handles.keyboard_input_handle)
         {
-            s_handles.subscribed_keyboard = event->subscribe.cur_notify;
+            conn->subscribed_keyboard = event->subscribe.cur_notify;
         }
         else if (event->subscribe.attr_handle == s_handles.mouse_boot_input_handle)
         {
-            s_handles.subscribed_mouse_boot = event->subscribe.cur_notify;
+            conn->subscribed_mouse_boot = event->subscribe.cur_notify;
         }
         else if (event->subscribe.attr_handle == s_handles.keyboard_boot_input_handle)
         {
-            s_handles.subscribed_keyboard_boot = event->subscribe.cur_notify;
+            conn->subscribed_keyboard_boot = event->subscribe.cur_notify;
         }
         else if (event->subscribe.attr_handle == s_handles.consumer_input_handle)
         {
-            s_handles.subscribed_consumer = event->subscribe.cur_notify;
+            conn->subscribed_consumer = event->subscribe.cur_notify;
+        }
+        else if (event->subscribe.attr_handle == s_handles.pointer_input_handle)
+        {
+            conn->subscribed_pointer = event->subscribe.cur_notify;
+        }
+        else if (event->subscribe.attr_handle == s_handles.hires_mouse_input_handle)
+        {
+            conn->subscribed_hires_mouse = event->subscribe.cur_notify;
+        }
+        else if (event->subscribe.attr_handle == s_handles.keyboard_nkro_input_handle)
+        {
+            conn->subscribed_keyboard_nkro = event->subscribe.cur_notify;
         }
         break;
+    }
 
     case BLE_GAP_EVENT_PASSKEY_ACTION:
     {
@@ -987,10 +1634,25 @@ static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
                          desc.sec_state.encrypted,
                          desc.sec_state.authenticated,
                          desc.sec_state.key_size);
-                s_conn_info.bonded = desc.sec_state.bonded;
-                s_conn_info.encrypted = desc.sec_state.encrypted;
-                s_conn_info.authenticated = desc.sec_state.authenticated;
-                if (s_state_callback && s_handles.connected)
+                ble_hid_conn_t *conn = ble_hid_conn_find(event->enc_change.conn_handle);
+                if (conn)
+                {
+                    conn->info.bonded = desc.sec_state.bonded;
+                    conn->info.encrypted = desc.sec_state.encrypted;
+                    conn->info.authenticated = desc.sec_state.authenticated;
+                }
+                if (desc.sec_state.bonded)
+                {
+                    // Target of the next directed advertising
+                    nvs_keystore_set_last_peer(desc.peer_id_addr.type, desc.peer_id_addr.val);
+                    ble_bond_cache_touch(desc.peer_id_addr.type, desc.peer_id_addr.val, esp_timer_get_time());
+                    // The bond_select target is back; send input to it
+                    if (ble_hid_select_take(&desc.peer_id_addr) && ble_hid_connection_count() > 1)
+                    {
+                        ble_hid_set_route(event->enc_change.conn_handle);
+                    }
+                }
+                if (s_state_callback)
                 {
                     s_state_callback(DEVICE_STATE_CONNECTED);
                 }
@@ -1000,6 +1662,10 @@ static int ble_hid_gap_event(struct ble_gap_event *event, void *arg)
 
     case BLE_GAP_EVENT_NOTIFY_TX:
         ESP_LOGD(TAG, "Notify TX; status=%d", event->notify_tx.status);
+        if (event->notify_tx.status == 0)
+        {
+            ble_hid_record_notify_tx(event->notify_tx.conn_handle, event->notify_tx.attr_handle);
+        }
         break;
 
     case BLE_GAP_EVENT_MTU:
@@ -1104,6 +1770,20 @@ esp_err_t ble_hid_init(const char *device_name)
     // Initialize bonding storage
     ble_store_config_init();
     nvs_keystore_init();
+    s_store_write = ble_hs_cfg.store_write_cb;
+    s_store_delete = ble_hs_cfg.store_delete_cb;
+    ble_hs_cfg.store_write_cb = ble_hid_store_write;
+    ble_hs_cfg.store_delete_cb = ble_hid_store_delete;
+    ble_hs_cfg.store_status_cb = ble_hid_store_status;
+    ble_hid_reload_bonds();
+
+    // Restore the recency order, least recent first so the last host to
+    // connect before the reboot ends up most recent
+    uint8_t order[NVS_KEYSTORE_MAX_PEERS][NVS_KEYSTORE_PEER_LEN];
+    for (size_t i = nvs_keystore_get_peer_order(order, NVS_KEYSTORE_MAX_PEERS); i > 0; --i)
+    {
+        ble_bond_cache_promote(order[i - 1][0], &order[i - 1][1]);
+    }
 
     // Register GATT services
     int rc = ble_gatts_count_cfg(gatt_svcs);
@@ -1131,6 +1811,16 @@ esp_err_t ble_hid_init(const char *device_name)
     ble_svc_gap_device_name_set(s_device_name);
     ble_svc_gap_device_appearance_set(0x03C2); // Generic HID appearance
 
+    // Notification failures are summarised off the hot path
+    hid_event_log_start();
+
+    if (!s_drain_task &&
+        xTaskCreatePinnedToCore(ble_hid_drain_task, "hid_drain", TASK_STACK_HID_DRAIN, NULL,
+                                TASK_PRIO_HID_DRAIN, &s_drain_task, TASK_CORE_BLE) != pdPASS)
+    {
+        ESP_LOGW(TAG, "Failed to start drain task");
+    }
+
     // Start the BLE host task
     nimble_port_freertos_init(ble_hid_host_task);
 
@@ -1148,7 +1838,35 @@ esp_err_t ble_hid_deinit(void)
     return rc == 0 ? ESP_OK : ESP_FAIL;
 }
 
-esp_err_t ble_hid_start_advertising(void)
+// Loads the bonded hosts and, if it is still one of them, the host that
+// connected last. A pending bond_select narrows both to the selected host.
+// Returns whether there are any bonds.
+static bool ble_hid_load_reconnect_peers(bool *have_last_peer, bool *selecting)
+{
+    *selecting = ble_hid_selected_peer(&s_directed_peer) &&
+                 ble_bond_cache_contains(s_directed_peer.type, s_directed_peer.val);
+    if (*selecting)
+    {
+        s_bonded_peers[0] = s_directed_peer;
+        s_bonded_peer_count = 1;
+        *have_last_peer = true;
+        return true;
+    }
+
+    ble_bond_entry_t bonds[BLE_HID_MAX_BONDS];
+    s_bonded_peer_count = (int)ble_bond_cache_list(bonds, BLE_HID_MAX_BONDS);
+    for (int i = 0; i < s_bonded_peer_count; ++i)
+    {
+        s_bonded_peers[i].type = bonds[i].addr_type;
+        memcpy(s_bonded_peers[i].val, bonds[i].addr, sizeof(s_bonded_peers[i].val));
+    }
+
+    *have_last_peer = nvs_keystore_get_last_peer(&s_directed_peer.type, s_directed_peer.val) &&
+                      ble_bond_cache_contains(s_directed_peer.type, s_directed_peer.val);
+    return s_bonded_peer_count > 0;
+}
+
+static esp_err_t ble_hid_advertise_phase(ble_adv_phase_t phase)
 {
     struct ble_gap_adv_params adv_params = {0};
     struct ble_hs_adv_fields fields = {0};
@@ -1186,25 +1904,94 @@ esp_err_t ble_hid_start_advertising(void)
     }
 
     // Advertising parameters
+    const ble_addr_t *direct_addr = NULL;
     adv_params.conn_mode = BLE_GAP_CONN_MODE_UND;
     adv_params.disc_mode = BLE_GAP_DISC_MODE_GEN;
     adv_params.itvl_min = BLE_GAP_ADV_FAST_INTERVAL1_MIN;
     adv_params.itvl_max = BLE_GAP_ADV_FAST_INTERVAL1_MAX;
 
-    rc = ble_gap_adv_start(s_adv_handle, BLE_ADDR_PUBLIC, BLE_HS_FOREVER,
+    switch (phase)
+    {
+    case BLE_ADV_PHASE_DIRECTED:
+        // High duty cycle: the controller ignores the interval
+        direct_addr = &s_directed_peer;
+        adv_params.conn_mode = BLE_GAP_CONN_MODE_DIR;
+        adv_params.disc_mode = BLE_GAP_DISC_MODE_NON;
+        adv_params.high_duty_cycle = 1;
+        break;
+    case BLE_ADV_PHASE_ACCEPT_LIST:
+        rc = ble_gap_wl_set(s_bonded_peers, (uint8_t)s_bonded_peer_count);
+        if (rc != 0)
+        {
+            ESP_LOGE(TAG, "Failed to set accept list; rc=%d", rc);
+            return ESP_FAIL;
+        }
+        adv_params.filter_policy = BLE_HCI_ADV_FILT_CONN;
+        break;
+    case BLE_ADV_PHASE_SLOW:
+        adv_params.itvl_min = BLE_HID_ADV_SLOW_ITVL_MIN;
+        adv_params.itvl_max = BLE_HID_ADV_SLOW_ITVL_MAX;
+        break;
+    default:
+        break;
+    }
+
+    bool slow = phase == BLE_ADV_PHASE_SLOW;
+    esp_err_t err = esp_ble_tx_power_set(ESP_BLE_PWR_TYPE_ADV,
+                                         slow ? BLE_HID_ADV_TX_POWER_SLOW : BLE_HID_ADV_TX_POWER_FAST);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to set advertising TX power: %s", esp_err_to_name(err));
+    }
+
+    uint32_t duration_ms = ble_reconnect_phase_duration_ms(phase);
+    rc = ble_gap_adv_start(s_adv_handle, direct_addr, duration_ms ? (int32_t)duration_ms : BLE_HS_FOREVER,
                            &adv_params, ble_hid_gap_event, NULL);
     if (rc != 0)
     {
-        ESP_LOGE(TAG, "Failed to start advertising; rc=%d", rc);
+        ESP_LOGE(TAG, "Failed to start %s advertising; rc=%d", ble_adv_phase_name(phase), rc);
         return ESP_FAIL;
     }
 
-    if (s_state_callback)
+    ESP_LOGI(TAG, "Advertising started (%s)", ble_adv_phase_name(phase));
+    return ESP_OK;
+}
+
+esp_err_t ble_hid_start_advertising(void)
+{
+    if (ble_gap_adv_active())
+    {
+        return ESP_OK;
+    }
+
+    if (ble_hid_connection_count() >= BLE_HID_MAX_CONNECTIONS)
+    {
+        ESP_LOGW(TAG, "All %d host slots in use; not advertising", BLE_HID_MAX_CONNECTIONS);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Reconnect sequence only when nobody is connected, or a host has been
+    // selected; a free slot next to a connected host is for pairing another
+    bool have_last_peer = false;
+    bool selecting = false;
+    bool have_bonds = ble_hid_load_reconnect_peers(&have_last_peer, &selecting);
+    bool reconnect = have_bonds && (ble_hid_connection_count() == 0 || selecting);
+    ble_adv_phase_t phase = ble_reconnect_start(reconnect, have_last_peer, esp_timer_get_time());
+
+    esp_err_t err = ble_hid_advertise_phase(phase);
+    if (err != ESP_OK)
+    {
+        ble_reconnect_stop();
+        return err;
+    }
+
+    // While other hosts are connected the device stays CONNECTED; it is only
+    // advertising for an additional one.
+    if (s_state_callback && !ble_hid_is_connected())
     {
         s_state_callback(DEVICE_STATE_ADVERTISING);
     }
 
-    ESP_LOGI(TAG, "Advertising started");
     return ESP_OK;
 }
 
@@ -1216,10 +2003,12 @@ esp_err_t ble_hid_stop_advertising(void)
         ESP_LOGE(TAG, "Failed to stop advertising; rc=%d", rc);
         return ESP_FAIL;
     }
+    ble_reconnect_stop();
+    ble_hid_select_set(NULL);
 
     ESP_LOGI(TAG, "Advertising stopped");
 
-    if (s_state_callback)
+    if (s_state_callback && !ble_hid_is_connected())
     {
         s_state_callback(DEVICE_STATE_IDLE);
     }
@@ -1227,110 +2016,275 @@ esp_err_t ble_hid_stop_advertising(void)
     return ESP_OK;
 }
 
-esp_err_t ble_hid_notify_mouse(const mouse_state_t *state)
+// Report protocol gets the Report ID characteristics and boot protocol the
+// boot ones, never both. A host that only subscribed to the other kind still
+// gets that kind rather than nothing.
+static bool ble_hid_conn_use_boot(const ble_hid_conn_t *conn, bool report_subscribed, bool boot_subscribed)
 {
-    if (!s_handles.connected)
+    if (conn->protocol_mode == BLE_HID_PROTOCOL_MODE_BOOT)
     {
-        return ESP_ERR_INVALID_STATE;
+        return boot_subscribed || !report_subscribed;
     }
+    return boot_subscribed && !report_subscribed;
+}
 
-    if (!s_handles.subscribed_mouse && !s_handles.subscribed_mouse_boot)
+static bool ble_hid_conn_mouse_boot(const ble_hid_conn_t *conn)
+{
+    return ble_hid_conn_use_boot(conn, conn->subscribed_mouse || conn->subscribed_hires_mouse,
+                                 conn->subscribed_mouse_boot);
+}
+
+static bool ble_hid_conn_keyboard_boot(const ble_hid_conn_t *conn)
+{
+    return ble_hid_conn_use_boot(conn, conn->subscribed_keyboard || conn->subscribed_keyboard_nkro,
+                                 conn->subscribed_keyboard_boot);
+}
+
+static bool ble_hid_conn_hires_mouse_active(const ble_hid_conn_t *conn)
+{
+    return s_mouse_high_resolution && conn->subscribed_hires_mouse && !ble_hid_conn_mouse_boot(conn);
+}
+
+static esp_err_t ble_hid_conn_queue_mouse(ble_hid_conn_t *conn, const void *arg)
+{
+    const mouse_state_t *state = arg;
+    esp_err_t err = ESP_OK;
+
+    portENTER_CRITICAL(&s_conn_lock);
+    conn->queue_group++;
+    conn->mouse_buttons = state->buttons;
+    if (ble_hid_conn_mouse_boot(conn))
     {
-        return ESP_ERR_INVALID_STATE;
+        if (conn->subscribed_mouse_boot)
+        {
+            // Boot report (no Report ID)
+            mouse_build_boot_report(state, conn->boot_mouse_report);
+            ble_hid_conn_queue_push(conn, s_handles.mouse_boot_input_handle,
+                                    conn->boot_mouse_report, sizeof(conn->boot_mouse_report));
+        }
+        else
+        {
+            err = ESP_ERR_INVALID_STATE;
+        }
+    }
+    // The 16-bit report replaces the legacy 8-bit one when the host has
+    // enabled it, so each movement is only sent once.
+    else if (ble_hid_conn_hires_mouse_active(conn))
+    {
+        mouse_build_hires_report(state, &conn->hires_mouse_feature, &conn->wheel_carry,
+                                 conn->hires_mouse_report);
+        ble_hid_conn_queue_push(conn, s_handles.hires_mouse_input_handle,
+                                conn->hires_mouse_report, sizeof(conn->hires_mouse_report));
+    }
+    else if (conn->subscribed_mouse)
+    {
+        mouse_build_report(state, &conn->wheel_carry, conn->mouse_report);
+        ble_hid_conn_queue_push(conn, s_handles.mouse_report_handle,
+                                conn->mouse_report, sizeof(conn->mouse_report));
     }
+    else
+    {
+        err = ESP_ERR_INVALID_STATE;
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
 
-    // Update report storage
-    mouse_build_report(state, s_mouse_report);
+    return err;
+}
 
-    // Boot report (no Report ID)
-    s_boot_mouse_report[0] = state->buttons & 0x07;
-    s_boot_mouse_report[1] = (int8_t)state->x;
-    s_boot_mouse_report[2] = (int8_t)state->y;
+esp_err_t ble_hid_notify_mouse(const mouse_state_t *state)
+{
+    return ble_hid_route_report(ble_hid_conn_queue_mouse, state);
+}
 
-    esp_err_t result = ESP_OK;
+// As ble_hid_set_keyboard_nkro: held buttons are released on the old
+// report (ID 5 or 1) and pressed again on the new one.
+void ble_hid_set_mouse_high_resolution(bool enable)
+{
+    if (enable == s_mouse_high_resolution)
+    {
+        return;
+    }
 
-    if (s_handles.subscribed_mouse)
+    static const mouse_state_t released = {0};
+    mouse_state_t held[BLE_HID_MAX_CONNECTIONS] = {0};
+    bool switched[BLE_HID_MAX_CONNECTIONS] = {0};
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
     {
-        esp_err_t err = ble_hid_send_notification(s_handles.mouse_report_handle,
-                                                  s_mouse_report,
-                                                  sizeof(s_mouse_report));
-        if (err != ESP_OK)
+        ble_hid_conn_t *conn = &s_conns[i];
+        portENTER_CRITICAL(&s_conn_lock);
+        switched[i] = conn->in_use && conn->subscribed_hires_mouse && !ble_hid_conn_mouse_boot(conn);
+        held[i].buttons = conn->mouse_buttons;
+        portEXIT_CRITICAL(&s_conn_lock);
+        if (switched[i] && held[i].buttons)
         {
-            result = err;
+            ble_hid_conn_queue_mouse(conn, &released);
         }
     }
 
-    if (s_handles.subscribed_mouse_boot)
+    s_mouse_high_resolution = enable;
+
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
     {
-        esp_err_t err = ble_hid_send_notification(s_handles.mouse_boot_input_handle,
-                                                  s_boot_mouse_report,
-                                                  sizeof(s_boot_mouse_report));
-        if (err != ESP_OK && result == ESP_OK)
+        if (switched[i] && held[i].buttons)
         {
-            result = err;
+            ble_hid_conn_queue_mouse(&s_conns[i], &held[i]);
         }
     }
+    ble_hid_schedule_drain();
+    ESP_LOGI(TAG, "Mouse report mode: %s", enable ? "high-resolution" : "legacy");
+}
 
-    return result;
+bool ble_hid_get_mouse_high_resolution(void)
+{
+    return s_mouse_high_resolution;
 }
 
-esp_err_t ble_hid_notify_keyboard(const keyboard_state_t *state)
+// hid_device splits wider motion into entries of at most this size and only
+// folds motion while the sum stays within it, so use the narrowest report
+// any routed host is getting.
+int16_t ble_hid_mouse_max_delta(void)
 {
-    if (!s_handles.connected)
+    bool any = false;
+    bool hires = true;
+
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
     {
-        return ESP_ERR_INVALID_STATE;
+        if (ble_hid_conn_routed(&s_conns[i]))
+        {
+            any = true;
+            hires &= ble_hid_conn_hires_mouse_active(&s_conns[i]);
+        }
     }
 
-    if (!s_handles.subscribed_keyboard && !s_handles.subscribed_keyboard_boot)
+    return any && hires ? HID_HIRES_MOUSE_INPUT_X_LOGICAL_MAX : HID_MOUSE_INPUT_X_LOGICAL_MAX;
+}
+
+// Boot-protocol hosts never parse the report map, so they only ever get the
+// 6KRO layout (Report ID 2 or the boot report).
+static bool ble_hid_conn_keyboard_nkro_active(const ble_hid_conn_t *conn)
+{
+    return s_keyboard_nkro && conn->subscribed_keyboard_nkro && !ble_hid_conn_keyboard_boot(conn);
+}
+
+static esp_err_t ble_hid_conn_queue_keyboard(ble_hid_conn_t *conn, const void *arg)
+{
+    const keyboard_state_t *state = arg;
+    esp_err_t err = ESP_OK;
+
+    portENTER_CRITICAL(&s_conn_lock);
+    conn->queue_group++;
+    conn->keyboard_state = *state;
+    // The 6KRO report always tracks the state because the boot report is
+    // served out of it.
+    keyboard_build_report(state, &conn->keyboard_report);
+
+    if (ble_hid_conn_keyboard_boot(conn))
     {
-        return ESP_ERR_INVALID_STATE;
+        if (conn->subscribed_keyboard_boot)
+        {
+            ble_hid_conn_queue_push(conn, s_handles.keyboard_boot_input_handle,
+                                    BOOT_KEYBOARD_REPORT(conn), BOOT_KEYBOARD_REPORT_LEN);
+        }
+        else
+        {
+            err = ESP_ERR_INVALID_STATE;
+        }
     }
+    else if (ble_hid_conn_keyboard_nkro_active(conn))
+    {
+        keyboard_build_nkro_report(state, &conn->keyboard_nkro_report);
+        ble_hid_conn_queue_push(conn, s_handles.keyboard_nkro_input_handle,
+                                &conn->keyboard_nkro_report, sizeof(conn->keyboard_nkro_report));
+    }
+    else if (conn->subscribed_keyboard)
+    {
+        ble_hid_conn_queue_push(conn, s_handles.keyboard_input_handle,
+                                &conn->keyboard_report, sizeof(conn->keyboard_report));
+    }
+    else
+    {
+        err = ESP_ERR_INVALID_STATE;
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
 
-    // Update report storage
-    s_keyboard_report[0] = 0x02; // Report ID
-    s_keyboard_report[1] = state->modifiers;
-    s_keyboard_report[2] = state->reserved;
-    memcpy(&s_keyboard_report[3], state->keys, 6);
+    return err;
+}
 
-    // Boot report (no Report ID)
-    s_boot_keyboard_report[0] = state->modifiers;
-    s_boot_keyboard_report[1] = state->reserved;
-    memcpy(&s_boot_keyboard_report[2], state->keys, 6);
+esp_err_t ble_hid_notify_keyboard(const keyboard_state_t *state)
+{
+    return ble_hid_route_report(ble_hid_conn_queue_keyboard, state);
+}
 
-    esp_err_t result = ESP_OK;
+// Hosts whose keyboard report changes with the NKRO setting get the held
+// keys released on the old report (ID 6 or 2) and replayed on the new one,
+// so no key stays down on the report that stops being sent.
+void ble_hid_set_keyboard_nkro(bool enable)
+{
+    if (enable == s_keyboard_nkro)
+    {
+        return;
+    }
 
-    if (s_handles.subscribed_keyboard)
+    static const keyboard_state_t released = {0};
+    keyboard_state_t held[BLE_HID_MAX_CONNECTIONS];
+    bool switched[BLE_HID_MAX_CONNECTIONS] = {0};
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
     {
-        esp_err_t err = ble_hid_send_notification(s_handles.keyboard_input_handle,
-                                                  s_keyboard_report,
-                                                  sizeof(s_keyboard_report));
-        if (err != ESP_OK)
+        ble_hid_conn_t *conn = &s_conns[i];
+        portENTER_CRITICAL(&s_conn_lock);
+        switched[i] = conn->in_use && conn->subscribed_keyboard_nkro && !ble_hid_conn_keyboard_boot(conn);
+        held[i] = conn->keyboard_state;
+        portEXIT_CRITICAL(&s_conn_lock);
+        if (switched[i])
         {
-            result = err;
+            ble_hid_conn_queue_keyboard(conn, &released);
         }
     }
 
-    if (s_handles.subscribed_keyboard_boot)
+    s_keyboard_nkro = enable;
+
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
     {
-        esp_err_t err = ble_hid_send_notification(s_handles.keyboard_boot_input_handle,
-                                                  s_boot_keyboard_report,
-                                                  sizeof(s_boot_keyboard_report));
-        if (err != ESP_OK && result == ESP_OK)
+        if (switched[i])
         {
-            result = err;
+            ble_hid_conn_queue_keyboard(&s_conns[i], &held[i]);
         }
     }
+    ble_hid_schedule_drain();
+    ESP_LOGI(TAG, "Keyboard report mode: %s", enable ? "nkro" : "6kro");
+}
 
-    return result;
+bool ble_hid_get_keyboard_nkro(void)
+{
+    return s_keyboard_nkro;
 }
 
-esp_err_t ble_hid_notify_consumer(uint16_t usage_mask)
+static esp_err_t ble_hid_conn_queue_consumer(ble_hid_conn_t *conn, const void *arg)
 {
-    if (!s_handles.connected || !s_handles.subscribed_consumer)
+    uint16_t report_mask = *(const uint16_t *)arg;
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+
+    uint8_t report[HID_CONSUMER_INPUT_REPORT_LEN];
+    report[0] = HID_REPORT_ID_CONSUMER;
+    ble_hid_consumer_mask_to_report(report_mask, &report[HID_CONSUMER_INPUT_USAGES_OFFSET]);
+
+    // Consumer Control has no boot characteristic; the state is kept so the
+    // host gets it back when it returns to report protocol.
+    portENTER_CRITICAL(&s_conn_lock);
+    conn->queue_group++;
+    conn->consumer_report = report_mask;
+    if (conn->subscribed_consumer && conn->protocol_mode == BLE_HID_PROTOCOL_MODE_REPORT)
     {
-        return ESP_ERR_INVALID_STATE;
+        ble_hid_conn_queue_push(conn, s_handles.consumer_input_handle, report, sizeof(report));
+        err = ESP_OK;
     }
+    portEXIT_CRITICAL(&s_conn_lock);
 
+    return err;
+}
+
+esp_err_t ble_hid_notify_consumer(uint16_t usage_mask)
+{
     uint16_t report_mask = ble_hid_consumer_usage_to_mask(usage_mask);
 
     if (usage_mask != 0 && report_mask == 0)
@@ -1338,27 +2292,149 @@ esp_err_t ble_hid_notify_consumer(uint16_t usage_mask)
         ESP_LOGW(TAG, "Unsupported consumer usage: 0x%04X", usage_mask);
     }
 
-    s_consumer_report = report_mask;
+    return ble_hid_route_report(ble_hid_conn_queue_consumer, &report_mask);
+}
 
-    uint8_t payload[2];
-    ble_hid_consumer_mask_to_report(report_mask, payload);
+static esp_err_t ble_hid_conn_queue_pointer(ble_hid_conn_t *conn, const void *arg)
+{
+    const pointer_abs_state_t *state = arg;
 
-    uint8_t report[3];
-    report[0] = 0x03; // Report ID
-    report[1] = payload[0];
-    report[2] = payload[1];
+    if (!conn->subscribed_pointer || conn->protocol_mode != BLE_HID_PROTOCOL_MODE_REPORT)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&s_conn_lock);
+    conn->queue_group++;
+    pointer_abs_build_report(state, conn->pointer_report);
+    ble_hid_conn_queue_push(conn, s_handles.pointer_input_handle,
+                            conn->pointer_report, sizeof(conn->pointer_report));
+    portEXIT_CRITICAL(&s_conn_lock);
 
-    return ble_hid_send_notification(s_handles.consumer_input_handle, report, sizeof(report));
+    return ESP_OK;
+}
+
+// Replays the held keys and buttons on the characteristics of the host's new
+// protocol mode, so nothing held across the switch is lost or stuck.
+static void ble_hid_conn_resync(ble_hid_conn_t *conn)
+{
+    portENTER_CRITICAL(&s_conn_lock);
+    keyboard_state_t keyboard = conn->keyboard_state;
+    mouse_state_t mouse = {.buttons = conn->mouse_buttons};
+    uint16_t consumer = conn->consumer_report;
+    portEXIT_CRITICAL(&s_conn_lock);
+
+    ble_hid_conn_queue_keyboard(conn, &keyboard);
+    ble_hid_conn_queue_mouse(conn, &mouse);
+    ble_hid_conn_queue_consumer(conn, &consumer);
+
+    // Called from a GATT access callback: send from the drain task instead
+    ble_hid_schedule_drain();
+}
+
+esp_err_t ble_hid_notify_pointer(const pointer_abs_state_t *state)
+{
+    return ble_hid_route_report(ble_hid_conn_queue_pointer, state);
 }
 
 bool ble_hid_is_connected(void)
 {
-    return s_handles.connected;
+    return ble_hid_connection_count() > 0;
+}
+
+size_t ble_hid_connection_count(void)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+    {
+        if (s_conns[i].in_use)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// The routed host, or the longest-connected one while broadcasting
+static const ble_hid_conn_t *ble_hid_primary_conn(void)
+{
+    const ble_hid_conn_t *primary = NULL;
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+    {
+        const ble_hid_conn_t *conn = &s_conns[i];
+        if (!conn->in_use)
+        {
+            continue;
+        }
+        if (conn->conn_handle == s_route)
+        {
+            return conn;
+        }
+        if (!primary || conn->connect_seq < primary->connect_seq)
+        {
+            primary = conn;
+        }
+    }
+    return primary;
 }
 
 uint16_t ble_hid_get_conn_handle(void)
 {
-    return s_handles.conn_handle;
+    const ble_hid_conn_t *conn = ble_hid_primary_conn();
+    return conn ? conn->conn_handle : BLE_HS_CONN_HANDLE_NONE;
+}
+
+// Releases everything that may be held on a host that no longer gets input.
+// The absolute pointer is left alone: a zeroed report would also move it.
+static void ble_hid_conn_release_all(ble_hid_conn_t *conn)
+{
+    static const mouse_state_t mouse_released = {0};
+    static const keyboard_state_t keyboard_released = {0};
+    static const uint16_t consumer_released = 0;
+
+    ble_hid_conn_queue_mouse(conn, &mouse_released);
+    ble_hid_conn_queue_keyboard(conn, &keyboard_released);
+    ble_hid_conn_queue_consumer(conn, &consumer_released);
+}
+
+esp_err_t ble_hid_set_route(uint16_t conn_handle)
+{
+    if (conn_handle != BLE_HID_ROUTE_ALL && !ble_hid_conn_find(conn_handle))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint16_t previous = s_route;
+    s_route = conn_handle;
+
+    if (conn_handle != BLE_HID_ROUTE_ALL && conn_handle != previous)
+    {
+        for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+        {
+            ble_hid_conn_t *conn = &s_conns[i];
+            if (conn->in_use && conn->conn_handle != conn_handle &&
+                (previous == BLE_HID_ROUTE_ALL || previous == conn->conn_handle))
+            {
+                ble_hid_conn_release_all(conn);
+            }
+        }
+        ble_hid_drain_all();
+    }
+
+    if (conn_handle == BLE_HID_ROUTE_ALL)
+    {
+        ESP_LOGI(TAG, "Routing input to all hosts");
+    }
+    else
+    {
+        ESP_LOGI(TAG, "Routing input to host %u", conn_handle);
+    }
+    return ESP_OK;
+}
+
+uint16_t ble_hid_get_route(void)
+{
+    return s_route;
 }
 
 void ble_hid_set_state_callback(void (*callback)(hid_device_state_t state))
@@ -1368,11 +2444,22 @@ void ble_hid_set_state_callback(void (*callback)(hid_device_state_t state))
 
 bool ble_hid_is_bonded(void)
 {
-    return nvs_keystore_has_bonds();
+    return ble_bond_cache_count() > 0;
 }
 
 esp_err_t ble_hid_clear_bonds(void)
 {
+    // The NimBLE store holds the keys; ble_hid_store_delete reloads the
+    // cache as they go
+    ble_hid_select_set(NULL);
+    int rc = ble_store_clear();
+    if (rc != 0)
+    {
+        ESP_LOGE(TAG, "Failed to clear bond store; rc=%d", rc);
+        ble_hid_reload_bonds();
+        return ESP_FAIL;
+    }
+
     esp_err_t err = nvs_keystore_clear();
     if (err == ESP_OK)
     {
@@ -1381,6 +2468,193 @@ esp_err_t ble_hid_clear_bonds(void)
     return err;
 }
 
+// Looks up a bonded host by its displayed address; BLE_HID_ADDR_TYPE_ANY
+// takes the first bond with those address bytes
+static bool ble_hid_find_bond(uint8_t addr_type, const uint8_t addr[6], ble_addr_t *peer)
+{
+    peer->type = addr_type;
+    for (int i = 0; i < 6; ++i)
+    {
+        peer->val[i] = addr[5 - i];
+    }
+    if (addr_type != BLE_HID_ADDR_TYPE_ANY)
+    {
+        return ble_bond_cache_contains(peer->type, peer->val);
+    }
+
+    ble_bond_entry_t bonds[BLE_BOND_CACHE_MAX];
+    size_t count = ble_bond_cache_list(bonds, BLE_BOND_CACHE_MAX);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (memcmp(bonds[i].addr, peer->val, sizeof(peer->val)) == 0)
+        {
+            peer->type = bonds[i].addr_type;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ble_hid_get_bonds(ble_bond_info_t *infos, size_t max)
+{
+    ble_bond_entry_t bonds[BLE_BOND_CACHE_MAX];
+    size_t count = ble_bond_cache_list_recent(bonds, max < BLE_BOND_CACHE_MAX ? max : BLE_BOND_CACHE_MAX);
+    ble_addr_t selected;
+    bool selecting = ble_hid_selected_peer(&selected);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ble_addr_t peer = {.type = bonds[i].addr_type};
+        memcpy(peer.val, bonds[i].addr, sizeof(peer.val));
+
+        ble_bond_info_t *info = &infos[i];
+        info->addr_type = peer.type;
+        for (int b = 0; b < 6; ++b)
+        {
+            info->addr[b] = peer.val[5 - b];
+        }
+        info->conn_handle = ble_hid_peer_conn_handle(&peer);
+        info->connected = info->conn_handle != BLE_HS_CONN_HANDLE_NONE;
+        info->selected = selecting && ble_addr_cmp(&selected, &peer) == 0;
+        info->last_seen_us = bonds[i].last_seen_us;
+    }
+    return count;
+}
+
+esp_err_t ble_hid_forget_bond(uint8_t addr_type, const uint8_t addr[6])
+{
+    ble_addr_t peer;
+    if (!ble_hid_find_bond(addr_type, addr, &peer))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    ble_hid_select_take(&peer);
+    // Disconnects the host if needed, then deletes its keys and CCCDs;
+    // ble_hid_store_delete drops it from the cache
+    int rc = ble_gap_unpair(&peer);
+    if (rc != 0)
+    {
+        ESP_LOGE(TAG, "Failed to delete bond; rc=%d", rc);
+        return ESP_FAIL;
+    }
+    nvs_keystore_forget_peer(peer.type, peer.val);
+
+    ESP_LOGI(TAG, "Bond deleted (%u left)", (unsigned)ble_bond_cache_count());
+    return ESP_OK;
+}
+
+// Connected host to drop when a selected host needs a slot: the least
+// recently used bonded one, or any host that is not bonded
+static uint16_t ble_hid_lru_conn_handle(void)
+{
+    ble_bond_entry_t bonds[BLE_BOND_CACHE_MAX];
+    size_t count = ble_bond_cache_list_recent(bonds, BLE_BOND_CACHE_MAX);
+
+    uint16_t conn_handle = BLE_HS_CONN_HANDLE_NONE;
+    portENTER_CRITICAL(&s_conn_lock);
+    size_t best = count;
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS; ++i)
+    {
+        if (!s_conns[i].in_use)
+        {
+            continue;
+        }
+        ble_addr_t addr;
+        ble_hid_conn_peer(&s_conns[i], &addr);
+        size_t rank = 0;
+        while (rank < count && (bonds[rank].addr_type != addr.type ||
+                                memcmp(bonds[rank].addr, addr.val, sizeof(addr.val)) != 0))
+        {
+            ++rank;
+        }
+        // An unbonded host ranks past the last bond
+        if (conn_handle == BLE_HS_CONN_HANDLE_NONE || rank >= best)
+        {
+            conn_handle = s_conns[i].conn_handle;
+            best = rank;
+        }
+    }
+    portEXIT_CRITICAL(&s_conn_lock);
+    return conn_handle;
+}
+
+esp_err_t ble_hid_select_bond(uint8_t addr_type, const uint8_t addr[6])
+{
+    ble_addr_t peer;
+    if (!ble_hid_find_bond(addr_type, addr, &peer))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Most recent from now on, so it is also the next directed target
+    nvs_keystore_set_last_peer(peer.type, peer.val);
+    ble_bond_cache_promote(peer.type, peer.val);
+
+    uint16_t conn_handle = ble_hid_peer_conn_handle(&peer);
+    if (conn_handle != BLE_HS_CONN_HANDLE_NONE)
+    {
+        ble_hid_select_set(NULL);
+        return ble_hid_connection_count() > 1 ? ble_hid_set_route(conn_handle) : ESP_OK;
+    }
+
+    ble_hid_select_set(&peer);
+    if (ble_hid_connection_count() >= BLE_HID_MAX_CONNECTIONS)
+    {
+        // The disconnect frees a slot and advertising restarts with the
+        // selection (device_state_changed in main.c)
+        conn_handle = ble_hid_lru_conn_handle();
+        ESP_LOGI(TAG, "All host slots in use; disconnecting host %u for the selected one", conn_handle);
+        int rc = ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
+        if (rc != 0)
+        {
+            ESP_LOGE(TAG, "Failed to disconnect host %u; rc=%d", conn_handle, rc);
+            ble_hid_select_set(NULL);
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    }
+
+    // Restart so the sequence begins with the selected host
+    if (ble_gap_adv_active())
+    {
+        ble_gap_adv_stop();
+    }
+    ble_reconnect_stop();
+    return ble_hid_start_advertising();
+}
+
+static void ble_hid_conn_fill_info(const ble_hid_conn_t *conn, ble_connection_info_t *info)
+{
+    portENTER_CRITICAL(&s_conn_lock);
+    *info = conn->info;
+    info->protocol_mode = conn->protocol_mode;
+    info->keyboard_leds = conn->keyboard_leds;
+    info->routed = ble_hid_conn_routed(conn);
+    info->queued = (uint8_t)conn->queue_count;
+    info->dropped = conn->dropped;
+    info->congested = conn->congested;
+    portEXIT_CRITICAL(&s_conn_lock);
+
+    ble_conn_params_t params;
+    if (ble_conn_params_get_accepted(info->conn_handle, &params))
+    {
+        info->conn_interval = params.interval;
+        info->conn_latency = params.latency;
+        info->supervision_timeout = params.supervision_timeout;
+        info->conn_profile = (uint8_t)ble_conn_params_get_profile(info->conn_handle);
+    }
+
+    ble_conn_link_t link;
+    if (ble_conn_params_get_link(info->conn_handle, &link))
+    {
+        info->tx_phy = link.tx_phy;
+        info->rx_phy = link.rx_phy;
+        info->max_tx_octets = link.max_tx_octets;
+        info->max_rx_octets = link.max_rx_octets;
+    }
+}
+
 bool ble_hid_get_connection_info(ble_connection_info_t *info)
 {
     if (!info)
@@ -1388,6 +2662,27 @@ bool ble_hid_get_connection_info(ble_connection_info_t *info)
         return false;
     }
 
-    *info = s_conn_info;
-    return s_conn_info.connected;
+    const ble_hid_conn_t *conn = ble_hid_primary_conn();
+    if (!conn)
+    {
+        memset(info, 0, sizeof(*info));
+        info->conn_handle = BLE_HS_CONN_HANDLE_NONE;
+        return false;
+    }
+
+    ble_hid_conn_fill_info(conn, info);
+    return info->connected;
+}
+
+size_t ble_hid_get_connections(ble_connection_info_t *infos, size_t max)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < BLE_HID_MAX_CONNECTIONS && count < max; ++i)
+    {
+        if (s_conns[i].in_use)
+        {
+            ble_hid_conn_fill_info(&s_conns[i], &infos[count++]);
+        }
+    }
+    return count;
 }
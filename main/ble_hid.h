@@ -3,11 +3,48 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
 #include "esp_err.h"
+#include "host/ble_hs.h"
 #include "host/ble_gap.h"
 #include "hid_device.h"
 
-// BLE HID service handles
+// One slot per central NimBLE will accept
+#ifdef CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#define BLE_HID_MAX_CONNECTIONS CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#else
+#define BLE_HID_MAX_CONNECTIONS 1
+#endif
+
+// Bonds the NimBLE store keeps; bonding another host evicts the least
+// recently used one that is not connected
+#ifdef CONFIG_BT_NIMBLE_MAX_BONDS
+#define BLE_HID_MAX_BONDS CONFIG_BT_NIMBLE_MAX_BONDS
+#else
+#define BLE_HID_MAX_BONDS 3
+#endif
+
+// Notify characteristics in the HID service (input reports, boot reports
+// and battery level); every bond can store a CCCD for each
+#define BLE_HID_NOTIFY_CHRS 9
+
+#ifdef CONFIG_BT_NIMBLE_MAX_CCCDS
+_Static_assert(CONFIG_BT_NIMBLE_MAX_CCCDS >= BLE_HID_NOTIFY_CHRS * BLE_HID_MAX_BONDS,
+               "CONFIG_BT_NIMBLE_MAX_CCCDS must hold every subscription of every bond");
+#endif
+
+// Matches a bonded host whatever its address type
+#define BLE_HID_ADDR_TYPE_ANY 0xFF
+
+// Route target that sends reports to every connected host
+#define BLE_HID_ROUTE_ALL BLE_HS_CONN_HANDLE_NONE
+
+// Protocol Mode characteristic values
+#define BLE_HID_PROTOCOL_MODE_BOOT 0
+#define BLE_HID_PROTOCOL_MODE_REPORT 1
+
+// GATT attribute handles, shared by every connection
 typedef struct
 {
     // Report handles
@@ -18,30 +55,50 @@ typedef struct
     uint16_t keyboard_boot_output_handle;
     uint16_t keyboard_output_handle;
     uint16_t consumer_input_handle;
+    uint16_t pointer_input_handle;
+    uint16_t hires_mouse_input_handle;
+    uint16_t keyboard_nkro_input_handle;
     uint16_t battery_level_handle;
-
-    // Connection state
-    uint16_t conn_handle;
-    bool connected;
-
-    // Subscription state
-    bool subscribed_mouse;
-    bool subscribed_mouse_boot;
-    bool subscribed_keyboard;
-    bool subscribed_keyboard_boot;
-    bool subscribed_consumer;
 } ble_hid_handles_t;
 
 typedef struct
 {
     bool connected;
+    uint16_t conn_handle;
     bool bonded;
     bool encrypted;
     bool authenticated;
     uint8_t peer_addr[6];
     uint8_t peer_addr_type;
+    // Parameters the controller is currently using (see ble_conn_params.h)
+    uint16_t conn_interval;       // 1.25 ms units
+    uint16_t conn_latency;
+    uint16_t supervision_timeout; // 10 ms units
+    uint8_t conn_profile;         // ble_conn_profile_t last accepted
+    uint8_t tx_phy;               // BLE_GAP_LE_PHY_*
+    uint8_t rx_phy;
+    uint16_t max_tx_octets;       // link-layer PDU payload (27 without DLE)
+    uint16_t max_rx_octets;
+    // HID state the host has written
+    uint8_t protocol_mode;        // BLE_HID_PROTOCOL_MODE_*
+    uint8_t keyboard_leds;
+    // Routing and flow control
+    bool routed;                  // receives input under the current route
+    uint8_t queued;               // reports waiting for link buffers
+    uint32_t dropped;             // oldest reports discarded while congested
+    uint32_t congested;           // sends refused for lack of buffers
 } ble_connection_info_t;
 
+typedef struct
+{
+    uint8_t addr_type;
+    uint8_t addr[6];      // identity address, most significant byte first like peer_addr
+    bool connected;
+    uint16_t conn_handle; // valid while connected
+    bool selected;        // bond_select target that has not reconnected yet
+    int64_t last_seen_us; // last secured connection, 0 if none since boot
+} ble_bond_info_t;
+
 // Initialize BLE HID stack
 esp_err_t ble_hid_init(const char *device_name);
 esp_err_t ble_hid_deinit(void);
@@ -52,16 +109,31 @@ esp_err_t ble_hid_stop_advertising(void);
 
 // Send HID reports
 esp_err_t ble_hid_notify_mouse(const mouse_state_t *state);
+void ble_hid_set_mouse_high_resolution(bool enable);
+bool ble_hid_get_mouse_high_resolution(void);
+int16_t ble_hid_mouse_max_delta(void);
 esp_err_t ble_hid_notify_keyboard(const keyboard_state_t *state);
+void ble_hid_set_keyboard_nkro(bool enable);
+bool ble_hid_get_keyboard_nkro(void);
 uint16_t ble_hid_consumer_usage_to_mask(uint16_t usage);
 uint16_t ble_hid_consumer_mask_to_usage(uint16_t mask);
 void ble_hid_consumer_mask_to_report(uint16_t mask, uint8_t report[2]);
 esp_err_t ble_hid_notify_consumer(uint16_t usage_mask);
+esp_err_t ble_hid_notify_pointer(const pointer_abs_state_t *state);
 
-// Connection state
+// Connection state. The single-connection getters describe the primary
+// host: the routed one, or the longest-connected one when broadcasting.
 bool ble_hid_is_connected(void);
+size_t ble_hid_connection_count(void);
 uint16_t ble_hid_get_conn_handle(void);
 bool ble_hid_get_connection_info(ble_connection_info_t *info);
+size_t ble_hid_get_connections(ble_connection_info_t *infos, size_t max);
+
+// Routing: send input to one host (by connection handle) or to all of them
+// with BLE_HID_ROUTE_ALL. Hosts that lose the route get a release report so
+// no keys or buttons stay held there.
+esp_err_t ble_hid_set_route(uint16_t conn_handle);
+uint16_t ble_hid_get_route(void);
 
 // State change callback
 void ble_hid_set_state_callback(void (*callback)(hid_device_state_t state));
@@ -69,5 +141,16 @@ void ble_hid_set_state_callback(void (*callback)(hid_device_state_t state));
 // Bonding management
 bool ble_hid_is_bonded(void);
 esp_err_t ble_hid_clear_bonds(void);
+// Bonded hosts, most recently used first
+size_t ble_hid_get_bonds(ble_bond_info_t *infos, size_t max);
+// Removes one host's bond, disconnecting it first. ESP_ERR_NOT_FOUND if the
+// host is not bonded.
+esp_err_t ble_hid_forget_bond(uint8_t addr_type, const uint8_t addr[6]);
+// Makes a bonded host the one to reconnect: a reconnect sequence starts with
+// directed advertising to it and an accept list of only it. If it is already
+// connected, input is routed to it instead. When every slot is taken the
+// least recently used other host is disconnected to make room. Once the
+// host connects, input is routed to it.
+esp_err_t ble_hid_select_bond(uint8_t addr_type, const uint8_t addr[6]);
 
 #endif // BLE_HID_H
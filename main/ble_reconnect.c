@@ -0,0 +1,210 @@
+#include "ble_reconnect.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static ble_reconnect_config_t s_config = {
+    .directed_ms = BLE_RECONNECT_DIRECTED_MS_DEFAULT,
+    .accept_list_ms = BLE_RECONNECT_ACCEPT_LIST_MS_DEFAULT,
+    .fast_ms = BLE_RECONNECT_FAST_MS_DEFAULT,
+    .slow_ms = BLE_RECONNECT_SLOW_MS_DEFAULT,
+};
+static ble_adv_phase_t s_phase = BLE_ADV_PHASE_IDLE;
+static bool s_sequence_active = false;
+static int64_t s_sequence_start_us = 0;
+static ble_reconnect_stats_t s_stats;
+// The host task walks the phases; control commands read stats and config
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Upper bounds of all but the last histogram bucket
+static const uint32_t s_bucket_limits_ms[BLE_RECONNECT_BUCKETS - 1] = {
+    250, 500, 1000, 2000, 5000, 10000, 30000,
+};
+
+static const char *const s_phase_names[BLE_ADV_PHASE_COUNT] = {
+    [BLE_ADV_PHASE_IDLE] = "idle",
+    [BLE_ADV_PHASE_DIRECTED] = "directed",
+    [BLE_ADV_PHASE_ACCEPT_LIST] = "accept_list",
+    [BLE_ADV_PHASE_FAST] = "fast",
+    [BLE_ADV_PHASE_SLOW] = "slow",
+    [BLE_ADV_PHASE_OFF] = "off",
+};
+
+bool ble_reconnect_set_config(const ble_reconnect_config_t *config)
+{
+    if (!config || config->directed_ms > BLE_RECONNECT_DIRECTED_MS_MAX ||
+        config->accept_list_ms > BLE_RECONNECT_PHASE_MS_MAX || config->fast_ms > BLE_RECONNECT_PHASE_MS_MAX ||
+        config->slow_ms > BLE_RECONNECT_SLOW_MS_MAX)
+    {
+        return false;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_config = *config;
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+void ble_reconnect_get_config(ble_reconnect_config_t *config)
+{
+    portENTER_CRITICAL(&s_lock);
+    *config = s_config;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// First enabled phase of a reconnect sequence at or after the given one.
+// Called with s_lock held.
+static ble_adv_phase_t ble_reconnect_from(ble_adv_phase_t phase, bool have_last_peer)
+{
+    if (phase == BLE_ADV_PHASE_DIRECTED && (!have_last_peer || s_config.directed_ms == 0))
+    {
+        phase = BLE_ADV_PHASE_ACCEPT_LIST;
+    }
+    if (phase == BLE_ADV_PHASE_ACCEPT_LIST && s_config.accept_list_ms == 0)
+    {
+        phase = BLE_ADV_PHASE_SLOW;
+    }
+    return phase;
+}
+
+ble_adv_phase_t ble_reconnect_start(bool reconnect, bool have_last_peer, int64_t now_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (reconnect)
+    {
+        s_sequence_active = true;
+        s_sequence_start_us = now_us;
+        s_stats.attempts++;
+        s_phase = ble_reconnect_from(BLE_ADV_PHASE_DIRECTED, have_last_peer);
+    }
+    else
+    {
+        s_sequence_active = false;
+        s_phase = BLE_ADV_PHASE_FAST;
+    }
+    ble_adv_phase_t phase = s_phase;
+    portEXIT_CRITICAL(&s_lock);
+    return phase;
+}
+
+ble_adv_phase_t ble_reconnect_next(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    switch (s_phase)
+    {
+    case BLE_ADV_PHASE_DIRECTED:
+        s_phase = ble_reconnect_from(BLE_ADV_PHASE_ACCEPT_LIST, false);
+        break;
+    case BLE_ADV_PHASE_ACCEPT_LIST:
+    case BLE_ADV_PHASE_FAST:
+        s_phase = BLE_ADV_PHASE_SLOW;
+        break;
+    case BLE_ADV_PHASE_SLOW:
+        if (s_sequence_active)
+        {
+            s_stats.expired++;
+        }
+        s_sequence_active = false;
+        s_phase = BLE_ADV_PHASE_OFF;
+        break;
+    default:
+        break;
+    }
+    ble_adv_phase_t phase = s_phase;
+    portEXIT_CRITICAL(&s_lock);
+    return phase;
+}
+
+size_t ble_reconnect_bucket(uint32_t elapsed_ms)
+{
+    size_t bucket = 0;
+    while (bucket < BLE_RECONNECT_BUCKETS - 1 && elapsed_ms >= s_bucket_limits_ms[bucket])
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+void ble_reconnect_on_connect(int64_t now_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (s_sequence_active)
+    {
+        int64_t elapsed_us = now_us - s_sequence_start_us;
+        uint32_t elapsed_ms = elapsed_us > 0 ? (uint32_t)(elapsed_us / 1000) : 0;
+
+        if (s_stats.reconnects == 0 || elapsed_ms < s_stats.min_ms)
+        {
+            s_stats.min_ms = elapsed_ms;
+        }
+        if (elapsed_ms > s_stats.max_ms)
+        {
+            s_stats.max_ms = elapsed_ms;
+        }
+        s_stats.reconnects++;
+        s_stats.by_phase[s_phase]++;
+        s_stats.last_ms = elapsed_ms;
+        s_stats.total_ms += elapsed_ms;
+        s_stats.buckets[ble_reconnect_bucket(elapsed_ms)]++;
+    }
+    s_sequence_active = false;
+    s_phase = BLE_ADV_PHASE_IDLE;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void ble_reconnect_stop(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_sequence_active = false;
+    s_phase = BLE_ADV_PHASE_IDLE;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+ble_adv_phase_t ble_reconnect_phase(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    ble_adv_phase_t phase = s_phase;
+    portEXIT_CRITICAL(&s_lock);
+    return phase;
+}
+
+uint32_t ble_reconnect_phase_duration_ms(ble_adv_phase_t phase)
+{
+    uint32_t duration_ms = 0;
+    portENTER_CRITICAL(&s_lock);
+    if (phase == BLE_ADV_PHASE_DIRECTED)
+    {
+        duration_ms = s_config.directed_ms;
+    }
+    else if (phase == BLE_ADV_PHASE_ACCEPT_LIST)
+    {
+        duration_ms = s_config.accept_list_ms;
+    }
+    else if (phase == BLE_ADV_PHASE_FAST)
+    {
+        duration_ms = s_config.fast_ms;
+    }
+    else if (phase == BLE_ADV_PHASE_SLOW)
+    {
+        duration_ms = s_config.slow_ms;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return duration_ms;
+}
+
+const char *ble_adv_phase_name(ble_adv_phase_t phase)
+{
+    return (unsigned)phase < BLE_ADV_PHASE_COUNT ? s_phase_names[phase] : "unknown";
+}
+
+void ble_reconnect_get_stats(ble_reconnect_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void ble_reconnect_reset_stats(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    portEXIT_CRITICAL(&s_lock);
+}
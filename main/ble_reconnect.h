@@ -0,0 +1,88 @@
+#ifndef BLE_RECONNECT_H
+#define BLE_RECONNECT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Advertising phases. A bonded device walks DIRECTED -> ACCEPT_LIST -> SLOW
+// after boot or a disconnect; without bonds it goes FAST -> SLOW for
+// pairing. Both end in OFF until ble_hid_start_advertising runs again.
+typedef enum
+{
+    BLE_ADV_PHASE_IDLE = 0,    // not advertising
+    BLE_ADV_PHASE_DIRECTED,    // high-duty directed to the last bonded host
+    BLE_ADV_PHASE_ACCEPT_LIST, // fast, only bonded hosts may connect
+    BLE_ADV_PHASE_FAST,        // fast undirected, any host may connect
+    BLE_ADV_PHASE_SLOW,        // slow undirected, any host may connect
+    BLE_ADV_PHASE_OFF,         // schedule ran out; radio idle until woken
+    BLE_ADV_PHASE_COUNT
+} ble_adv_phase_t;
+
+// Phase lengths. 0 skips the directed and accept-list phases, and keeps the
+// fast and slow phases running until stopped. The controller ends high-duty
+// directed advertising after 1.28 s whatever is asked for.
+#define BLE_RECONNECT_DIRECTED_MS_DEFAULT 1280
+#define BLE_RECONNECT_ACCEPT_LIST_MS_DEFAULT 10000
+#define BLE_RECONNECT_FAST_MS_DEFAULT 30000
+#define BLE_RECONNECT_SLOW_MS_DEFAULT 300000
+#define BLE_RECONNECT_DIRECTED_MS_MAX 1280
+#define BLE_RECONNECT_PHASE_MS_MAX 600000
+#define BLE_RECONNECT_SLOW_MS_MAX 3600000
+
+// Time-to-reconnect histogram: <250 ms, <500 ms, <1 s, <2 s, <5 s, <10 s,
+// <30 s, then everything slower
+#define BLE_RECONNECT_BUCKETS 8
+
+typedef struct
+{
+    uint32_t directed_ms;
+    uint32_t accept_list_ms;
+    uint32_t fast_ms;
+    uint32_t slow_ms;
+} ble_reconnect_config_t;
+
+typedef struct
+{
+    uint32_t attempts;   // reconnect sequences started
+    uint32_t reconnects; // sequences ended by a host connecting
+    uint32_t expired;    // sequences that ran into OFF
+    uint32_t by_phase[BLE_ADV_PHASE_COUNT]; // phase the host connected in
+    uint32_t last_ms;
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint64_t total_ms;   // divided by reconnects for the mean
+    uint32_t buckets[BLE_RECONNECT_BUCKETS];
+} ble_reconnect_stats_t;
+
+// Rejects (returns false) phase lengths above the limits
+bool ble_reconnect_set_config(const ble_reconnect_config_t *config);
+void ble_reconnect_get_config(ble_reconnect_config_t *config);
+
+// Begins advertising. reconnect (bonds, and no host connected) starts a
+// reconnect sequence and its time-to-reconnect clock; otherwise advertising
+// is plain FAST. have_last_peer allows the directed phase.
+ble_adv_phase_t ble_reconnect_start(bool reconnect, bool have_last_peer, int64_t now_us);
+
+// The current phase timed out without a connection; returns the phase to
+// run next, BLE_ADV_PHASE_OFF at the end of the schedule.
+ble_adv_phase_t ble_reconnect_next(void);
+
+// A host connected while advertising; ends the sequence and records its
+// time-to-reconnect.
+void ble_reconnect_on_connect(int64_t now_us);
+
+// Advertising was stopped on purpose, or is to be restarted; the sequence
+// is abandoned unrecorded and the phase goes back to IDLE.
+void ble_reconnect_stop(void);
+
+ble_adv_phase_t ble_reconnect_phase(void);
+// How long a phase runs in milliseconds; 0 means until stopped
+uint32_t ble_reconnect_phase_duration_ms(ble_adv_phase_t phase);
+size_t ble_reconnect_bucket(uint32_t elapsed_ms);
+const char *ble_adv_phase_name(ble_adv_phase_t phase);
+
+void ble_reconnect_get_stats(ble_reconnect_stats_t *stats);
+void ble_reconnect_reset_stats(void);
+
+#endif // BLE_RECONNECT_H
@@ -4,6 +4,7 @@
 #include "lwip/netdb.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "task_topology.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
@@ -158,7 +159,8 @@ esp_err_t dns_server_start(void)
     }
 
     s_running = true;
-    xTaskCreate(dns_server_task, "dns_server", 4096, NULL, 5, &s_task_handle);
+    xTaskCreatePinnedToCore(dns_server_task, "dns_server", TASK_STACK_DNS, NULL, TASK_PRIO_DNS, &s_task_handle,
+                            TASK_CORE_NET);
 
     ESP_LOGI(TAG, "DNS server started on port %d", DNS_PORT);
     return ESP_OK;
@@ -1,17 +1,19 @@
 #include "hid_device.h"
 #include "ble_hid.h"
+#include "ble_conn_params.h"
+#include "hid_input_state.h"
 #include "esp_log.h"
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/timers.h"
+#include <inttypes.h>
 #include <string.h>
 #include <stdlib.h>
 
 static const char *TAG = "HID_DEVICE";
 
 #define HID_FLUSH_RETRY_DELAY_MS 30
-#define HID_MOUSE_MAX_DELTA 127
 
 typedef struct
 {
@@ -39,23 +41,61 @@ static TimerHandle_t s_retry_timer = NULL;
 static StaticTimer_t s_retry_timer_buffer;
 static portMUX_TYPE s_retry_lock = portMUX_INITIALIZER_UNLOCKED;
 
-static inline int8_t clamp_mouse_delta(int16_t value)
+static inline bool mouse_delta_fits(int32_t value, int32_t limit)
 {
-    if (value > HID_MOUSE_MAX_DELTA)
-    {
-        return HID_MOUSE_MAX_DELTA;
-    }
-    if (value < -HID_MOUSE_MAX_DELTA)
+    return value <= limit && value >= -limit;
+}
+
+static int16_t mouse_delta_step(int32_t value, int32_t limit)
+{
+    return (int16_t)(value > limit ? limit : (value < -limit ? -limit : value));
+}
+
+// Takes a slot without folding, evicting the oldest entry when full
+static void hid_device_mouse_queue_append(device_state_t *state, const mouse_state_t *value)
+{
+    if (state->mouse_queue.count == HID_MOUSE_QUEUE_DEPTH)
     {
-        return -HID_MOUSE_MAX_DELTA;
+        ESP_LOGW(TAG, "Mouse queue full, dropping oldest report");
+        state->mouse_queue.head = (state->mouse_queue.head + 1) % HID_MOUSE_QUEUE_DEPTH;
+        state->mouse_queue.count--;
     }
-    return (int8_t)value;
+
+    size_t tail = (state->mouse_queue.head + state->mouse_queue.count) % HID_MOUSE_QUEUE_DEPTH;
+    state->mouse_queue.entries[tail] = *value;
+    state->mouse_queue.count++;
+    state->mouse_updated = true;
 }
 
-static bool mouse_states_equal(const mouse_state_t *a, const mouse_state_t *b)
+// Motion wider than the report the host receives (8-bit for legacy and boot
+// hosts) is split into limit-sized entries. The first carries the button and
+// wheel change and the rest are pure motion. Once the queue is full the
+// remaining motion is dropped rather than evicting queued reports.
+static void hid_device_mouse_queue_split(device_state_t *state, const mouse_state_t *value, int32_t limit)
 {
-    return a->x == b->x && a->y == b->y && a->wheel == b->wheel &&
-           a->hwheel == b->hwheel && a->buttons == b->buttons;
+    int32_t rest_x = value->x;
+    int32_t rest_y = value->y;
+    mouse_state_t step = *value;
+    bool first = true;
+
+    while (rest_x != 0 || rest_y != 0)
+    {
+        if (!first && state->mouse_queue.count == HID_MOUSE_QUEUE_DEPTH)
+        {
+            ESP_LOGW(TAG, "Mouse queue full, dropping motion (%" PRId32 ", %" PRId32 ")", rest_x, rest_y);
+            return;
+        }
+
+        step.x = mouse_delta_step(rest_x, limit);
+        step.y = mouse_delta_step(rest_y, limit);
+        hid_device_mouse_queue_append(state, &step);
+        rest_x -= step.x;
+        rest_y -= step.y;
+
+        first = false;
+        step.wheel = 0;
+        step.hwheel = 0;
+    }
 }
 
 static void hid_device_mouse_queue_push(device_state_t *state, const mouse_state_t *value)
@@ -65,42 +105,44 @@ static void hid_device_mouse_queue_push(device_state_t *state, const mouse_state
         return;
     }
 
+    int32_t limit = ble_hid_mouse_max_delta();
+    if (!mouse_delta_fits(value->x, limit) || !mouse_delta_fits(value->y, limit))
+    {
+        hid_device_mouse_queue_split(state, value, limit);
+        return;
+    }
+
     if (state->mouse_queue.count > 0)
     {
         size_t last_index = (state->mouse_queue.head + state->mouse_queue.count - 1) %
                             HID_MOUSE_QUEUE_DEPTH;
         mouse_state_t *last = &state->mouse_queue.entries[last_index];
+        uint8_t dirty = hid_mouse_dirty_mask(last, value);
 
-        if (mouse_states_equal(last, value))
+        if (dirty == 0)
         {
             return;
         }
 
-        if (last->buttons == value->buttons &&
-            last->wheel == value->wheel &&
-            last->hwheel == value->hwheel)
+        // Pure motion updates fold into the tail entry instead of taking a
+        // slot, as long as the sum still fits the report the host receives
+        // (16-bit in high-resolution mode, 8-bit otherwise).
+        if ((dirty & ~HID_MOUSE_DIRTY_MOTION) == 0)
         {
-            int16_t sum_x = (int16_t)last->x + (int16_t)value->x;
-            int16_t sum_y = (int16_t)last->y + (int16_t)value->y;
+            int32_t sum_x = (int32_t)last->x + value->x;
+            int32_t sum_y = (int32_t)last->y + value->y;
 
-            last->x = clamp_mouse_delta(sum_x);
-            last->y = clamp_mouse_delta(sum_y);
-            state->mouse_updated = true;
-            return;
+            if (mouse_delta_fits(sum_x, limit) && mouse_delta_fits(sum_y, limit))
+            {
+                last->x = (int16_t)sum_x;
+                last->y = (int16_t)sum_y;
+                state->mouse_updated = true;
+                return;
+            }
         }
     }
 
-    if (state->mouse_queue.count == HID_MOUSE_QUEUE_DEPTH)
-    {
-        ESP_LOGW(TAG, "Mouse queue full, dropping oldest report");
-        state->mouse_queue.head = (state->mouse_queue.head + 1) % HID_MOUSE_QUEUE_DEPTH;
-        state->mouse_queue.count--;
-    }
-
-    size_t tail = (state->mouse_queue.head + state->mouse_queue.count) % HID_MOUSE_QUEUE_DEPTH;
-    state->mouse_queue.entries[tail] = *value;
-    state->mouse_queue.count++;
-    state->mouse_updated = true;
+    hid_device_mouse_queue_append(state, value);
 }
 
 static mouse_state_t *hid_device_mouse_queue_peek(device_state_t *state)
@@ -128,7 +170,8 @@ static void hid_device_mouse_queue_pop(device_state_t *state)
 static bool keyboard_states_equal(const keyboard_state_t *a, const keyboard_state_t *b)
 {
     return a->modifiers == b->modifiers && a->reserved == b->reserved &&
-           memcmp(a->keys, b->keys, sizeof(a->keys)) == 0;
+           memcmp(a->keys, b->keys, sizeof(a->keys)) == 0 &&
+           memcmp(a->bitmap, b->bitmap, sizeof(a->bitmap)) == 0;
 }
 
 static void hid_device_keyboard_queue_push(device_state_t *state, const keyboard_state_t *value)
@@ -237,6 +280,67 @@ static void hid_device_consumer_queue_pop(device_state_t *state)
     state->consumer_updated = (state->consumer_queue.count > 0);
 }
 
+static void hid_device_pointer_queue_push(device_state_t *state, const pointer_abs_state_t *value)
+{
+    if (!state || !value)
+    {
+        return;
+    }
+
+    if (state->pointer_queue.count > 0)
+    {
+        size_t last_index = (state->pointer_queue.head + state->pointer_queue.count - 1) %
+                            HID_POINTER_QUEUE_DEPTH;
+        pointer_abs_state_t *last = &state->pointer_queue.entries[last_index];
+
+        // Positions are absolute, so a move that keeps the button state only
+        // needs the newest target; button edges keep their own slot so clicks
+        // land where they were issued.
+        if (last->buttons == value->buttons)
+        {
+            last->x = value->x;
+            last->y = value->y;
+            state->pointer_updated = true;
+            return;
+        }
+    }
+
+    if (state->pointer_queue.count == HID_POINTER_QUEUE_DEPTH)
+    {
+        ESP_LOGW(TAG, "Pointer queue full, dropping oldest report");
+        state->pointer_queue.head = (state->pointer_queue.head + 1) % HID_POINTER_QUEUE_DEPTH;
+        state->pointer_queue.count--;
+    }
+
+    size_t tail = (state->pointer_queue.head + state->pointer_queue.count) %
+                  HID_POINTER_QUEUE_DEPTH;
+    state->pointer_queue.entries[tail] = *value;
+    state->pointer_queue.count++;
+    state->pointer_updated = true;
+}
+
+static pointer_abs_state_t *hid_device_pointer_queue_peek(device_state_t *state)
+{
+    if (!state || state->pointer_queue.count == 0)
+    {
+        return NULL;
+    }
+
+    return &state->pointer_queue.entries[state->pointer_queue.head];
+}
+
+static void hid_device_pointer_queue_pop(device_state_t *state)
+{
+    if (!state || state->pointer_queue.count == 0)
+    {
+        return;
+    }
+
+    state->pointer_queue.head = (state->pointer_queue.head + 1) % HID_POINTER_QUEUE_DEPTH;
+    state->pointer_queue.count--;
+    state->pointer_updated = (state->pointer_queue.count > 0);
+}
+
 hid_device_t *hid_device_create(const char *device_name)
 {
     hid_device_t *device = calloc(1, sizeof(hid_device_t));
@@ -380,6 +484,7 @@ void hid_device_set_mouse_state(hid_device_t *device, const mouse_state_t *state
     {
         device->state.mouse = *state;
         hid_device_mouse_queue_push(&device->state, state);
+        ble_conn_params_note_activity(ble_hid_get_route());
         hid_device_flush_reports(device, true, false, false);
     }
 }
@@ -390,6 +495,7 @@ void hid_device_set_keyboard_state(hid_device_t *device, const keyboard_state_t
     {
         device->state.keyboard = *state;
         hid_device_keyboard_queue_push(&device->state, state);
+        ble_conn_params_note_activity(ble_hid_get_route());
         hid_device_flush_reports(device, false, true, false);
     }
 }
@@ -399,6 +505,7 @@ void hid_device_set_consumer_state(hid_device_t *device, const consumer_state_t
     if (device && state)
     {
         device->state.consumer = *state;
+        ble_conn_params_note_activity(ble_hid_get_route());
         if (state->active && state->usage != 0)
         {
             uint16_t mask = ble_hid_consumer_usage_to_mask(state->usage);
@@ -440,6 +547,17 @@ void hid_device_set_consumer_state(hid_device_t *device, const consumer_state_t
     }
 }
 
+void hid_device_set_pointer_state(hid_device_t *device, const pointer_abs_state_t *state)
+{
+    if (device && state)
+    {
+        device->state.pointer = *state;
+        hid_device_pointer_queue_push(&device->state, state);
+        ble_conn_params_note_activity(ble_hid_get_route());
+        hid_device_flush_reports(device, true, false, false);
+    }
+}
+
 void hid_device_request_notify(hid_device_t *device, bool mouse, bool keyboard, bool consumer)
 {
     hid_device_flush_reports(device, mouse, keyboard, consumer);
@@ -521,6 +639,29 @@ esp_err_t hid_device_notify_consumer(hid_device_t *device)
     return ESP_OK;
 }
 
+esp_err_t hid_device_notify_pointer(hid_device_t *device)
+{
+    if (!device)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pointer_abs_state_t *pending = hid_device_pointer_queue_peek(&device->state);
+    if (!pending)
+    {
+        device->state.pointer_updated = false;
+        return ESP_OK;
+    }
+
+    esp_err_t err = ble_hid_notify_pointer(pending);
+    if (err == ESP_OK)
+    {
+        hid_device_pointer_queue_pop(&device->state);
+    }
+
+    return err;
+}
+
 bool hid_device_is_bonded(hid_device_t *device)
 {
     if (!device)
@@ -666,6 +807,27 @@ static void hid_device_flush_reports(hid_device_t *device, bool mouse, bool keyb
             }
             break;
         }
+
+        // Absolute pointer reports share the mouse lane and its retry slot.
+        while (device->state.pointer_updated)
+        {
+            esp_err_t err = hid_device_notify_pointer(device);
+            if (err == ESP_OK)
+            {
+                continue;
+            }
+
+            if (err == ESP_ERR_NO_MEM)
+            {
+                ESP_LOGW(TAG, "Pointer notify out of memory, scheduling retry");
+                hid_device_schedule_retry(device, true, false, false);
+            }
+            else if (err != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Failed to notify pointer report: %s", esp_err_to_name(err));
+            }
+            break;
+        }
     }
 
     if (keyboard)
@@ -10,6 +10,7 @@
 #define HID_MOUSE_QUEUE_DEPTH 8
 #define HID_KEYBOARD_QUEUE_DEPTH 32
 #define HID_CONSUMER_QUEUE_DEPTH 16
+#define HID_POINTER_QUEUE_DEPTH 8
 
 // Device states
 typedef enum
@@ -20,16 +21,28 @@ typedef enum
     DEVICE_STATE_CONNECTED
 } hid_device_state_t;
 
+// Wheel travel is tracked in fractions of a detent so the high-resolution
+// report can scroll smoothly; one detent is HID_MOUSE_WHEEL_RESOLUTION units.
+#define HID_MOUSE_WHEEL_RESOLUTION 8
+
 // Mouse state
 typedef struct
 {
-    int8_t x;
-    int8_t y;
-    int8_t wheel;
-    int8_t hwheel;
+    int16_t x;
+    int16_t y;
+    int16_t wheel;  // 1/HID_MOUSE_WHEEL_RESOLUTION detent units
+    int16_t hwheel; // 1/HID_MOUSE_WHEEL_RESOLUTION detent units
     uint8_t buttons; // bits: 0=left, 1=right, 2=middle, 3=back, 4=forward
 } mouse_state_t;
 
+// Absolute pointer state; x/y span the descriptor's logical range (0-32767)
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t buttons; // bits: 0=left, 1=right, 2=middle
+} pointer_abs_state_t;
+
 typedef struct
 {
     uint16_t usage;
@@ -47,6 +60,8 @@ typedef struct
     consumer_state_t consumer;
     bool consumer_updated;
     bool consumer_pending_release;
+    pointer_abs_state_t pointer;
+    bool pointer_updated;
     struct
     {
         mouse_state_t entries[HID_MOUSE_QUEUE_DEPTH];
@@ -65,6 +80,12 @@ typedef struct
         size_t head;
         size_t count;
     } consumer_queue;
+    struct
+    {
+        pointer_abs_state_t entries[HID_POINTER_QUEUE_DEPTH];
+        size_t head;
+        size_t count;
+    } pointer_queue;
 } device_state_t;
 
 // Device control
@@ -83,7 +104,8 @@ esp_err_t hid_device_stop(hid_device_t *device);
 hid_device_state_t hid_device_get_state(hid_device_t *device);
 void hid_device_set_state_callback(hid_device_t *device, state_change_callback_t callback);
 
-// Advertising control
+// Advertising control. Starting runs the advertising schedule from its
+// first phase (see ble_reconnect.h); it ends in OFF until started again.
 esp_err_t hid_device_start_advertising(hid_device_t *device);
 esp_err_t hid_device_stop_advertising(hid_device_t *device);
 
@@ -91,10 +113,12 @@ esp_err_t hid_device_stop_advertising(hid_device_t *device);
 void hid_device_set_mouse_state(hid_device_t *device, const mouse_state_t *state);
 void hid_device_set_keyboard_state(hid_device_t *device, const keyboard_state_t *state);
 void hid_device_set_consumer_state(hid_device_t *device, const consumer_state_t *state);
+void hid_device_set_pointer_state(hid_device_t *device, const pointer_abs_state_t *state);
 void hid_device_request_notify(hid_device_t *device, bool mouse, bool keyboard, bool consumer);
 esp_err_t hid_device_notify_mouse(hid_device_t *device);
 esp_err_t hid_device_notify_keyboard(hid_device_t *device);
 esp_err_t hid_device_notify_consumer(hid_device_t *device);
+esp_err_t hid_device_notify_pointer(hid_device_t *device);
 
 // Bonding management
 bool hid_device_is_bonded(hid_device_t *device);
@@ -0,0 +1,211 @@
+#include "hid_event_log.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_topology.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "HID_EVENTS";
+
+#define HID_EVENT_LOG_RING_MASK (HID_EVENT_LOG_RING_SIZE - 1)
+#define HID_EVENT_LOG_TASK_STACK 3072
+
+_Static_assert((HID_EVENT_LOG_RING_SIZE & HID_EVENT_LOG_RING_MASK) == 0,
+               "HID_EVENT_LOG_RING_SIZE must be a power of two");
+
+// Bounded multi-producer, single-consumer ring. Each slot's seq holds the
+// ring lap (position with the index bits cleared) it is free for; the writer
+// publishes it as lap + 1 and the reader hands it back as lap + size. With
+// lap 0 meaning free, the zero-initialised ring needs no setup.
+typedef struct
+{
+    atomic_uint_least32_t seq;
+    hid_event_entry_t entry;
+} hid_event_slot_t;
+
+static hid_event_slot_t s_ring[HID_EVENT_LOG_RING_SIZE];
+static atomic_uint_least32_t s_head;
+static atomic_uint_least32_t s_lost;
+static uint32_t s_tail; // consumer only
+static TaskHandle_t s_task = NULL;
+
+bool hid_event_log_record(hid_event_t event, hid_metrics_report_t report_type,
+                          uint16_t conn_handle, int32_t rc)
+{
+    uint32_t pos = atomic_load_explicit(&s_head, memory_order_relaxed);
+    hid_event_slot_t *slot;
+
+    for (;;)
+    {
+        slot = &s_ring[pos & HID_EVENT_LOG_RING_MASK];
+        uint32_t lap = pos & ~(uint32_t)HID_EVENT_LOG_RING_MASK;
+        int32_t diff = (int32_t)(atomic_load_explicit(&slot->seq, memory_order_acquire) - lap);
+
+        if (diff == 0)
+        {
+            // Free for this lap: claim it (a failed CAS reloads pos)
+            if (atomic_compare_exchange_weak_explicit(&s_head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Still holds last lap's event: the consumer is behind
+            atomic_fetch_add_explicit(&s_lost, 1, memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            // Another producer took this position first
+            pos = atomic_load_explicit(&s_head, memory_order_relaxed);
+        }
+    }
+
+    slot->entry.event = (uint8_t)event;
+    slot->entry.report_type = (uint8_t)report_type;
+    slot->entry.conn_handle = conn_handle;
+    slot->entry.rc = rc;
+    atomic_store_explicit(&slot->seq, (pos & ~(uint32_t)HID_EVENT_LOG_RING_MASK) + 1,
+                          memory_order_release);
+    return true;
+}
+
+static bool hid_event_log_pop(hid_event_entry_t *out)
+{
+    hid_event_slot_t *slot = &s_ring[s_tail & HID_EVENT_LOG_RING_MASK];
+    uint32_t lap = s_tail & ~(uint32_t)HID_EVENT_LOG_RING_MASK;
+
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != lap + 1)
+    {
+        return false;
+    }
+
+    *out = slot->entry;
+    atomic_store_explicit(&slot->seq, lap + HID_EVENT_LOG_RING_SIZE, memory_order_release);
+    s_tail++;
+    return true;
+}
+
+uint32_t hid_event_log_collect(hid_event_summary_t *summary)
+{
+    if (!summary)
+    {
+        return 0;
+    }
+
+    uint32_t taken = 0;
+    hid_event_entry_t entry;
+    while (hid_event_log_pop(&entry))
+    {
+        taken++;
+        if (entry.event >= HID_EVENT_COUNT || entry.report_type >= HID_METRICS_REPORT_COUNT)
+        {
+            continue;
+        }
+        summary->counts[entry.event][entry.report_type]++;
+        if (entry.conn_handle < 32)
+        {
+            summary->conn_mask |= 1u << entry.conn_handle;
+        }
+        if (entry.event == HID_EVENT_NOTIFY_FAILED)
+        {
+            summary->last_rc = entry.rc;
+        }
+    }
+
+    summary->lost += atomic_exchange_explicit(&s_lost, 0, memory_order_relaxed);
+    summary->total += taken;
+    return taken;
+}
+
+static void hid_event_log_emit(const hid_event_summary_t *summary, uint32_t window_ms)
+{
+    for (size_t t = 0; t < HID_METRICS_REPORT_COUNT; ++t)
+    {
+        uint32_t alloc = summary->counts[HID_EVENT_ENOMEM_ALLOC][t];
+        uint32_t notify = summary->counts[HID_EVENT_ENOMEM_NOTIFY][t];
+        uint32_t failed = summary->counts[HID_EVENT_NOTIFY_FAILED][t];
+        uint32_t dropped = summary->counts[HID_EVENT_QUEUE_DROP][t];
+        if (alloc + notify + failed + dropped == 0)
+        {
+            continue;
+        }
+
+        // Overall rate since the last stats reset, for context
+        hid_metrics_counters_t counters;
+        hid_metrics_get((hid_metrics_report_t)t, &counters);
+        uint32_t rate_bp = hid_metrics_enomem_rate_bp(&counters);
+
+        ESP_LOGW(TAG,
+                 "%s in %" PRIu32 " ms: ENOMEM alloc=%" PRIu32 " notify=%" PRIu32
+                 ", failed=%" PRIu32 ", dropped=%" PRIu32 " (ENOMEM rate %" PRIu32 ".%02" PRIu32 "%%)",
+                 hid_metrics_report_name((hid_metrics_report_t)t), window_ms, alloc, notify,
+                 failed, dropped, rate_bp / 100, rate_bp % 100);
+    }
+
+    uint32_t failed_total = 0;
+    for (size_t t = 0; t < HID_METRICS_REPORT_COUNT; ++t)
+    {
+        failed_total += summary->counts[HID_EVENT_NOTIFY_FAILED][t];
+    }
+    if (failed_total > 0 || summary->lost > 0)
+    {
+        ESP_LOGW(TAG, "Hosts 0x%02" PRIx32 ": last notify error rc=%" PRId32 ", %" PRIu32 " event(s) not logged",
+                 summary->conn_mask, summary->last_rc, summary->lost);
+    }
+}
+
+static void hid_event_log_task(void *arg)
+{
+    (void)arg;
+    hid_event_summary_t summary = {0};
+    const TickType_t interval = pdMS_TO_TICKS(HID_EVENT_LOG_SUMMARY_MS);
+    TickType_t last_emit = xTaskGetTickCount() - interval;
+    TickType_t first_event = 0;
+    bool pending = false;
+
+    for (;;)
+    {
+        vTaskDelay(pdMS_TO_TICKS(HID_EVENT_LOG_DRAIN_MS));
+
+        TickType_t now = xTaskGetTickCount();
+        hid_event_log_collect(&summary);
+        if (!pending && (summary.total > 0 || summary.lost > 0))
+        {
+            pending = true;
+            first_event = now;
+        }
+
+        // The first event after a quiet spell is logged at once; a storm is
+        // folded into at most one summary per interval
+        if (pending && (TickType_t)(now - last_emit) >= interval)
+        {
+            uint32_t window_ms = (uint32_t)(now - first_event) * portTICK_PERIOD_MS + HID_EVENT_LOG_DRAIN_MS;
+            hid_event_log_emit(&summary, window_ms);
+            memset(&summary, 0, sizeof(summary));
+            pending = false;
+            last_emit = now;
+        }
+    }
+}
+
+esp_err_t hid_event_log_start(void)
+{
+    if (s_task)
+    {
+        return ESP_OK;
+    }
+
+    if (xTaskCreatePinnedToCore(hid_event_log_task, "hid_events", HID_EVENT_LOG_TASK_STACK, NULL,
+                                TASK_PRIO_HID_EVENTS, &s_task, TASK_CORE_NET) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to start event log task");
+        s_task = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
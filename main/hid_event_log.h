@@ -0,0 +1,56 @@
+#ifndef HID_EVENT_LOG_H
+#define HID_EVENT_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "hid_metrics.h"
+
+// Notification path events that used to be logged inline. They are queued
+// here instead and summarised by a low-priority task, so a congested link
+// does not also pay for UART log output on every failed send.
+typedef enum
+{
+    HID_EVENT_ENOMEM_ALLOC = 0, // mbuf allocation failed
+    HID_EVENT_ENOMEM_NOTIFY,    // stack refused the notification for lack of buffers
+    HID_EVENT_NOTIFY_FAILED,    // any other notify error (rc kept as the last error)
+    HID_EVENT_QUEUE_DROP,       // oldest report discarded from a full host queue
+    HID_EVENT_COUNT
+} hid_event_t;
+
+// Power of two; sized for several drain periods of worst-case congestion
+#define HID_EVENT_LOG_RING_SIZE 128
+// How often the task empties the ring, and how often it may log a summary
+#define HID_EVENT_LOG_DRAIN_MS 100
+#define HID_EVENT_LOG_SUMMARY_MS 5000
+
+typedef struct
+{
+    uint8_t event;       // hid_event_t
+    uint8_t report_type; // hid_metrics_report_t
+    uint16_t conn_handle;
+    int32_t rc;
+} hid_event_entry_t;
+
+typedef struct
+{
+    uint32_t counts[HID_EVENT_COUNT][HID_METRICS_REPORT_COUNT];
+    uint32_t conn_mask; // bit per connection handle below 32 that saw an event
+    int32_t last_rc;    // most recent HID_EVENT_NOTIFY_FAILED code
+    uint32_t lost;      // events that found the ring full
+    uint32_t total;
+} hid_event_summary_t;
+
+// Records an event without locking or blocking; safe from any task or timer
+// callback. Returns false (and counts it as lost) when the ring is full.
+bool hid_event_log_record(hid_event_t event, hid_metrics_report_t report_type,
+                          uint16_t conn_handle, int32_t rc);
+
+// Moves every queued event into summary, adding to what it already holds.
+// Single consumer only. Returns the number of events taken.
+uint32_t hid_event_log_collect(hid_event_summary_t *summary);
+
+// Starts the summary task; safe to call more than once
+esp_err_t hid_event_log_start(void);
+
+#endif // HID_EVENT_LOG_H
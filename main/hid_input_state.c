@@ -0,0 +1,77 @@
+#include "hid_input_state.h"
+
+#include <string.h>
+
+uint8_t hid_mouse_dirty_mask(const mouse_state_t *current, const mouse_state_t *next)
+{
+    if (!current || !next)
+    {
+        return 0;
+    }
+
+    uint8_t dirty = 0;
+    if (current->x != next->x || current->y != next->y)
+    {
+        dirty |= HID_MOUSE_DIRTY_MOTION;
+    }
+    if (current->wheel != next->wheel)
+    {
+        dirty |= HID_MOUSE_DIRTY_WHEEL;
+    }
+    if (current->hwheel != next->hwheel)
+    {
+        dirty |= HID_MOUSE_DIRTY_HWHEEL;
+    }
+    if (current->buttons != next->buttons)
+    {
+        dirty |= HID_MOUSE_DIRTY_BUTTONS;
+    }
+    return dirty;
+}
+
+uint8_t hid_mouse_merge(mouse_state_t *current, const mouse_state_t *next)
+{
+    uint8_t dirty = hid_mouse_dirty_mask(current, next);
+    if (dirty)
+    {
+        // Untouched fields are equal by definition, so a whole-struct copy is
+        // cheaper than patching the dirty fields one by one.
+        *current = *next;
+    }
+    return dirty;
+}
+
+uint8_t hid_keyboard_dirty_mask(const keyboard_state_t *current, const keyboard_state_t *next)
+{
+    if (!current || !next)
+    {
+        return 0;
+    }
+
+    uint8_t dirty = 0;
+    if (current->modifiers != next->modifiers)
+    {
+        dirty |= HID_KEYBOARD_DIRTY_MODIFIERS;
+    }
+    if (memcmp(current->keys, next->keys, sizeof(current->keys)) != 0 ||
+        memcmp(current->bitmap, next->bitmap, sizeof(current->bitmap)) != 0)
+    {
+        dirty |= HID_KEYBOARD_DIRTY_KEYS;
+    }
+    return dirty;
+}
+
+uint8_t hid_keyboard_merge(keyboard_state_t *current, const keyboard_state_t *next)
+{
+    uint8_t dirty = hid_keyboard_dirty_mask(current, next);
+    if (dirty & HID_KEYBOARD_DIRTY_MODIFIERS)
+    {
+        current->modifiers = next->modifiers;
+    }
+    if (dirty & HID_KEYBOARD_DIRTY_KEYS)
+    {
+        memcpy(current->keys, next->keys, sizeof(current->keys));
+        memcpy(current->bitmap, next->bitmap, sizeof(current->bitmap));
+    }
+    return dirty;
+}
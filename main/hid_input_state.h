@@ -0,0 +1,23 @@
+#ifndef HID_INPUT_STATE_H
+#define HID_INPUT_STATE_H
+
+#include <stdint.h>
+#include "hid_device.h"
+
+// Per-field dirty bits produced when merging a transport update into the
+// remote input state. A zero mask means the update carried no change.
+#define HID_MOUSE_DIRTY_MOTION 0x01
+#define HID_MOUSE_DIRTY_WHEEL 0x02
+#define HID_MOUSE_DIRTY_HWHEEL 0x04
+#define HID_MOUSE_DIRTY_BUTTONS 0x08
+
+#define HID_KEYBOARD_DIRTY_MODIFIERS 0x01
+#define HID_KEYBOARD_DIRTY_KEYS 0x02
+
+uint8_t hid_mouse_dirty_mask(const mouse_state_t *current, const mouse_state_t *next);
+uint8_t hid_mouse_merge(mouse_state_t *current, const mouse_state_t *next);
+
+uint8_t hid_keyboard_dirty_mask(const keyboard_state_t *current, const keyboard_state_t *next);
+uint8_t hid_keyboard_merge(keyboard_state_t *current, const keyboard_state_t *next);
+
+#endif // HID_INPUT_STATE_H
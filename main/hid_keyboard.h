@@ -3,12 +3,18 @@
 
 #include <stdint.h>
 
-// Keyboard state used for HID reports
+#define HID_KEYBOARD_ROLLOVER_KEYS 6
+// N-key rollover bitmap: bit n of the array is key usage n (0x00-0x77)
+#define HID_KEYBOARD_BITMAP_BYTES 15
+
+// Keyboard state used for HID reports. A key is held if it appears in keys[]
+// or its bit is set in bitmap; 6KRO sources only fill keys[].
 typedef struct
 {
     uint8_t modifiers;
     uint8_t reserved;
-    uint8_t keys[6];
+    uint8_t keys[HID_KEYBOARD_ROLLOVER_KEYS];
+    uint8_t bitmap[HID_KEYBOARD_BITMAP_BYTES];
 } keyboard_state_t;
 
 #endif // HID_KEYBOARD_H
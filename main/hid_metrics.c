@@ -0,0 +1,214 @@
+#include "hid_metrics.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// Mirrors hid_metrics_counters_t field for field
+typedef struct
+{
+    atomic_uint_fast32_t attempts;
+    atomic_uint_fast32_t sent;
+    atomic_uint_fast32_t bytes;
+    atomic_uint_fast32_t enomem_alloc;
+    atomic_uint_fast32_t enomem_notify;
+    atomic_uint_fast32_t dropped;
+    atomic_uint_fast32_t queue_latency[HID_METRICS_LATENCY_BUCKETS];
+    atomic_uint_fast32_t tx_latency[HID_METRICS_LATENCY_BUCKETS];
+    atomic_uint_fast32_t retries[HID_METRICS_RETRY_BUCKETS];
+} hid_metrics_atomic_counters_t;
+
+static hid_metrics_atomic_counters_t s_counters[HID_METRICS_REPORT_COUNT];
+static int64_t s_reset_us = 0;
+
+static inline void counter_add(atomic_uint_fast32_t *counter, uint32_t value)
+{
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+static inline uint32_t counter_take(atomic_uint_fast32_t *counter, bool reset)
+{
+    return reset ? (uint32_t)atomic_exchange_explicit(counter, 0, memory_order_relaxed)
+                 : (uint32_t)atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static hid_metrics_atomic_counters_t *counters_for(hid_metrics_report_t type)
+{
+    return (unsigned)type < HID_METRICS_REPORT_COUNT ? &s_counters[type] : NULL;
+}
+
+size_t hid_metrics_latency_bucket(uint32_t latency_us)
+{
+    size_t bucket = 0;
+    uint32_t limit = HID_METRICS_LATENCY_FIRST_US;
+    while (bucket < HID_METRICS_LATENCY_BUCKETS - 1 && latency_us >= limit)
+    {
+        limit <<= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+size_t hid_metrics_retry_bucket(uint32_t retries)
+{
+    if (retries <= 2)
+    {
+        return retries;
+    }
+    if (retries <= 4)
+    {
+        return 3;
+    }
+    return retries <= 8 ? 4 : 5;
+}
+
+void hid_metrics_record_attempt(hid_metrics_report_t type)
+{
+    hid_metrics_atomic_counters_t *c = counters_for(type);
+    if (c)
+    {
+        counter_add(&c->attempts, 1);
+    }
+}
+
+void hid_metrics_record_enomem(hid_metrics_report_t type, bool during_alloc)
+{
+    hid_metrics_atomic_counters_t *c = counters_for(type);
+    if (c)
+    {
+        counter_add(during_alloc ? &c->enomem_alloc : &c->enomem_notify, 1);
+    }
+}
+
+void hid_metrics_record_sent(hid_metrics_report_t type, size_t payload_len,
+                             uint32_t queue_latency_us, uint32_t retries)
+{
+    hid_metrics_atomic_counters_t *c = counters_for(type);
+    if (!c)
+    {
+        return;
+    }
+
+    counter_add(&c->sent, 1);
+    counter_add(&c->bytes, (uint32_t)(payload_len + HID_METRICS_ATT_HEADER_LEN));
+    counter_add(&c->queue_latency[hid_metrics_latency_bucket(queue_latency_us)], 1);
+    counter_add(&c->retries[hid_metrics_retry_bucket(retries)], 1);
+}
+
+void hid_metrics_record_tx_latency(hid_metrics_report_t type, uint32_t latency_us)
+{
+    hid_metrics_atomic_counters_t *c = counters_for(type);
+    if (c)
+    {
+        counter_add(&c->tx_latency[hid_metrics_latency_bucket(latency_us)], 1);
+    }
+}
+
+void hid_metrics_record_dropped(hid_metrics_report_t type)
+{
+    hid_metrics_atomic_counters_t *c = counters_for(type);
+    if (c)
+    {
+        counter_add(&c->dropped, 1);
+    }
+}
+
+static void hid_metrics_collect_one(hid_metrics_atomic_counters_t *c, hid_metrics_counters_t *o, bool reset)
+{
+    o->attempts = counter_take(&c->attempts, reset);
+    o->sent = counter_take(&c->sent, reset);
+    o->bytes = counter_take(&c->bytes, reset);
+    o->enomem_alloc = counter_take(&c->enomem_alloc, reset);
+    o->enomem_notify = counter_take(&c->enomem_notify, reset);
+    o->dropped = counter_take(&c->dropped, reset);
+    for (size_t i = 0; i < HID_METRICS_LATENCY_BUCKETS; ++i)
+    {
+        o->queue_latency[i] = counter_take(&c->queue_latency[i], reset);
+        o->tx_latency[i] = counter_take(&c->tx_latency[i], reset);
+    }
+    for (size_t i = 0; i < HID_METRICS_RETRY_BUCKETS; ++i)
+    {
+        o->retries[i] = counter_take(&c->retries[i], reset);
+    }
+}
+
+void hid_metrics_snapshot(hid_metrics_snapshot_t *out)
+{
+    if (!out)
+    {
+        return;
+    }
+
+    out->since_reset_us = esp_timer_get_time() - s_reset_us;
+    for (size_t t = 0; t < HID_METRICS_REPORT_COUNT; ++t)
+    {
+        hid_metrics_collect_one(&s_counters[t], &out->reports[t], false);
+    }
+}
+
+void hid_metrics_get(hid_metrics_report_t type, hid_metrics_counters_t *out)
+{
+    hid_metrics_atomic_counters_t *c = counters_for(type);
+    if (!out)
+    {
+        return;
+    }
+    if (!c)
+    {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    hid_metrics_collect_one(c, out, false);
+}
+
+void hid_metrics_reset(hid_metrics_snapshot_t *last)
+{
+    int64_t now = esp_timer_get_time();
+    hid_metrics_counters_t discarded;
+
+    for (size_t t = 0; t < HID_METRICS_REPORT_COUNT; ++t)
+    {
+        hid_metrics_collect_one(&s_counters[t], last ? &last->reports[t] : &discarded, true);
+    }
+    if (last)
+    {
+        last->since_reset_us = now - s_reset_us;
+    }
+    s_reset_us = now;
+}
+
+uint32_t hid_metrics_enomem_rate_bp(const hid_metrics_counters_t *counters)
+{
+    if (!counters || counters->attempts == 0)
+    {
+        return 0;
+    }
+
+    uint64_t events = (uint64_t)counters->enomem_alloc + counters->enomem_notify;
+    return (uint32_t)((events * 10000) / counters->attempts);
+}
+
+const char *hid_metrics_report_name(hid_metrics_report_t type)
+{
+    switch (type)
+    {
+    case HID_METRICS_REPORT_MOUSE:
+        return "mouse";
+    case HID_METRICS_REPORT_HIRES_MOUSE:
+        return "hires_mouse";
+    case HID_METRICS_REPORT_BOOT_MOUSE:
+        return "boot_mouse";
+    case HID_METRICS_REPORT_KEYBOARD:
+        return "keyboard";
+    case HID_METRICS_REPORT_KEYBOARD_NKRO:
+        return "keyboard_nkro";
+    case HID_METRICS_REPORT_BOOT_KEYBOARD:
+        return "boot_keyboard";
+    case HID_METRICS_REPORT_CONSUMER:
+        return "consumer";
+    case HID_METRICS_REPORT_POINTER:
+        return "pointer";
+    default:
+        return "unknown";
+    }
+}
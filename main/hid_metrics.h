@@ -0,0 +1,73 @@
+#ifndef HID_METRICS_H
+#define HID_METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Input report characteristics, counted separately regardless of which
+// connection they went out on.
+typedef enum
+{
+    HID_METRICS_REPORT_MOUSE = 0,
+    HID_METRICS_REPORT_HIRES_MOUSE,
+    HID_METRICS_REPORT_BOOT_MOUSE,
+    HID_METRICS_REPORT_KEYBOARD,
+    HID_METRICS_REPORT_KEYBOARD_NKRO,
+    HID_METRICS_REPORT_BOOT_KEYBOARD,
+    HID_METRICS_REPORT_CONSUMER,
+    HID_METRICS_REPORT_POINTER,
+    HID_METRICS_REPORT_COUNT
+} hid_metrics_report_t;
+
+// Latency buckets double from 250 us: <250 us, <500 us, <1 ms ... <256 ms,
+// and a final bucket for everything slower.
+#define HID_METRICS_LATENCY_BUCKETS 12
+#define HID_METRICS_LATENCY_FIRST_US 250
+// Retry buckets: 0, 1, 2, 3-4, 5-8, 9+ out-of-buffer retries before a send
+#define HID_METRICS_RETRY_BUCKETS 6
+
+// ATT notification header (opcode + attribute handle) added to each payload
+#define HID_METRICS_ATT_HEADER_LEN 3
+
+typedef struct
+{
+    uint32_t attempts;      // ble_gatts_notify_custom calls, including retries
+    uint32_t sent;          // notifications accepted by the stack
+    uint32_t bytes;         // ATT PDU bytes of the sent notifications
+    uint32_t enomem_alloc;  // mbuf allocation failed
+    uint32_t enomem_notify; // stack refused for lack of buffers
+    uint32_t dropped;       // discarded from a full per-host queue
+    uint32_t queue_latency[HID_METRICS_LATENCY_BUCKETS]; // enqueue -> notify accepted
+    uint32_t tx_latency[HID_METRICS_LATENCY_BUCKETS];    // notify -> NOTIFY_TX
+    uint32_t retries[HID_METRICS_RETRY_BUCKETS];
+} hid_metrics_counters_t;
+
+typedef struct
+{
+    int64_t since_reset_us;
+    hid_metrics_counters_t reports[HID_METRICS_REPORT_COUNT];
+} hid_metrics_snapshot_t;
+
+// Recording is lock-free (relaxed atomic increments) and safe from any task.
+void hid_metrics_record_attempt(hid_metrics_report_t type);
+void hid_metrics_record_enomem(hid_metrics_report_t type, bool during_alloc);
+void hid_metrics_record_sent(hid_metrics_report_t type, size_t payload_len,
+                             uint32_t queue_latency_us, uint32_t retries);
+void hid_metrics_record_tx_latency(hid_metrics_report_t type, uint32_t latency_us);
+void hid_metrics_record_dropped(hid_metrics_report_t type);
+
+// Counters are read (or swapped to zero) one at a time: an event racing with
+// a reset is counted either before or after it, exactly once. The reset
+// hands back the values it cleared when last is non-NULL.
+void hid_metrics_snapshot(hid_metrics_snapshot_t *out);
+void hid_metrics_get(hid_metrics_report_t type, hid_metrics_counters_t *out);
+void hid_metrics_reset(hid_metrics_snapshot_t *last);
+
+size_t hid_metrics_latency_bucket(uint32_t latency_us);
+size_t hid_metrics_retry_bucket(uint32_t retries);
+// ENOMEM events per 10000 attempts
+uint32_t hid_metrics_enomem_rate_bp(const hid_metrics_counters_t *counters);
+const char *hid_metrics_report_name(hid_metrics_report_t type);
+
+#endif // HID_METRICS_H
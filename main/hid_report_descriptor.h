@@ -0,0 +1,435 @@
+// Generated by tools/generate_hid_descriptor.py - do not edit by hand.
+#pragma once
+#include <stdint.h>
+
+#define HID_REPORT_ID_MOUSE 0x01
+#define HID_REPORT_ID_KEYBOARD 0x02
+#define HID_REPORT_ID_CONSUMER 0x03
+#define HID_REPORT_ID_POINTER 0x04
+#define HID_REPORT_ID_HIRES_MOUSE 0x05
+#define HID_REPORT_ID_KEYBOARD_NKRO 0x06
+
+// Combined HID Report Descriptor (generated from tools/generate_hid_descriptor.py)
+static const uint8_t hid_report_map[] = {
+    // Mouse (Report ID 1) — five buttons with vertical & horizontal scroll
+    0x05, 0x01,        // Usage Page (Generic Desktop)
+    0x09, 0x02,        // Usage (Mouse)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, 0x01,        //   Report ID (1)
+    0x09, 0x01,        //   Usage (Pointer)
+    0xA1, 0x00,        //   Collection (Physical)
+    0x05, 0x09,        //     Usage Page (Buttons)
+    0x19, 0x01,        //     Usage Minimum (Button 1)
+    0x29, 0x05,        //     Usage Maximum (Button 5)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x25, 0x01,        //     Logical Maximum (1)
+    0x95, 0x05,        //     Report Count (5)
+    0x75, 0x01,        //     Report Size (1)
+    0x81, 0x02,        //     Input (Data, Variable, Absolute)
+    0x95, 0x01,        //     Report Count (1) - padding
+    0x75, 0x03,        //     Report Size (3)
+    0x81, 0x03,        //     Input (Constant, Variable, Absolute)
+    0x05, 0x01,        //     Usage Page (Generic Desktop)
+    0x09, 0x30,        //     Usage (X)
+    0x09, 0x31,        //     Usage (Y)
+    0x09, 0x38,        //     Usage (Wheel)
+    0x15, 0x81,        //     Logical Minimum (-127)
+    0x25, 0x7F,        //     Logical Maximum (127)
+    0x75, 0x08,        //     Report Size (8)
+    0x95, 0x03,        //     Report Count (3)
+    0x81, 0x06,        //     Input (Data, Variable, Relative)
+    0x05, 0x0C,        //     Usage Page (Consumer)
+    0x0A, 0x38, 0x02,  //     Usage (AC Pan) - horizontal scroll
+    0x15, 0x81,        //     Logical Minimum (-127)
+    0x25, 0x7F,        //     Logical Maximum (127)
+    0x75, 0x08,        //     Report Size (8)
+    0x95, 0x01,        //     Report Count (1)
+    0x81, 0x06,        //     Input (Data, Variable, Relative)
+    0xC0,              //   End Collection
+    0xC0,              // End Collection
+
+    // Keyboard (Report ID 2) — byte-for-byte match with reference
+    0x05, 0x01,        // Usage Page (Generic Desktop)
+    0x09, 0x06,        // Usage (Keyboard)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, 0x02,        //   Report ID (2)
+    0x75, 0x01,        //   Report Size (1)
+    0x95, 0x08,        //   Report Count (8)
+    0x05, 0x07,        //   Usage Page (Key Codes)
+    0x19, 0xE0,        //   Usage Minimum (224)
+    0x29, 0xE7,        //   Usage Maximum (231)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x01,        //   Logical Maximum (1)
+    0x81, 0x02,        //   Input (Data, Variable, Absolute)
+    0x95, 0x01,        //   Report Count (1)
+    0x75, 0x08,        //   Report Size (8)
+    0x81, 0x01,        //   Input (Constant)
+    0x95, 0x05,        //   Report Count (5)
+    0x75, 0x01,        //   Report Size (1)
+    0x05, 0x08,        //   Usage Page (LEDs)
+    0x19, 0x01,        //   Usage Minimum (1)
+    0x29, 0x05,        //   Usage Maximum (5)
+    0x91, 0x02,        //   Output (Data, Variable, Absolute)
+    0x95, 0x01,        //   Report Count (1)
+    0x75, 0x03,        //   Report Size (3)
+    0x91, 0x01,        //   Output (Constant)
+    0x95, 0x06,        //   Report Count (6)
+    0x75, 0x08,        //   Report Size (8)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x65,        //   Logical Maximum (101)
+    0x05, 0x07,        //   Usage Page (Key Codes)
+    0x19, 0x00,        //   Usage Minimum (0)
+    0x29, 0x65,        //   Usage Maximum (101)
+    0x81, 0x00,        //   Input (Data, Array)
+    0xC0,              // End Collection
+
+    // Consumer Control (Report ID 3) — ESP32 combo bitfield layout
+    0x05, 0x0C,        // Usage Page (Consumer)
+    0x09, 0x01,        // Usage (Consumer Control)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, 0x03,        //   Report ID (3)
+    0x05, 0x0C,        //   Usage Page (Consumer)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x01,        //   Logical Maximum (1)
+    0x75, 0x01,        //   Report Size (1)
+    0x95, 0x10,        //   Report Count (16)
+    0x09, 0xB5,        //   Usage (Scan Next Track)
+    0x09, 0xB6,        //   Usage (Scan Previous Track)
+    0x09, 0xB7,        //   Usage (Stop)
+    0x09, 0xCD,        //   Usage (Play/Pause)
+    0x09, 0xE2,        //   Usage (Mute)
+    0x09, 0xE9,        //   Usage (Volume Up)
+    0x09, 0xEA,        //   Usage (Volume Down)
+    0x0A, 0x23, 0x02,  //   Usage (AC Home / WWW Home)
+    0x0A, 0x94, 0x01,  //   Usage (AL My Computer)
+    0x0A, 0x92, 0x01,  //   Usage (AL Calculator)
+    0x0A, 0x2A, 0x02,  //   Usage (AC Bookmarks)
+    0x0A, 0x21, 0x02,  //   Usage (AC Search)
+    0x0A, 0x26, 0x02,  //   Usage (AC Stop)
+    0x0A, 0x24, 0x02,  //   Usage (AC Back)
+    0x0A, 0x83, 0x01,  //   Usage (AL Consumer Control Configuration / Media Select)
+    0x0A, 0x8A, 0x01,  //   Usage (AL Email Reader / Mail)
+    0x81, 0x02,        //   Input (Data, Variable, Absolute)
+    0xC0,              // End Collection
+
+    // Absolute Pointer (Report ID 4) — three buttons with 16-bit absolute X/Y
+    0x05, 0x01,        // Usage Page (Generic Desktop)
+    0x09, 0x02,        // Usage (Mouse)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, 0x04,        //   Report ID (4)
+    0x09, 0x01,        //   Usage (Pointer)
+    0xA1, 0x00,        //   Collection (Physical)
+    0x05, 0x09,        //     Usage Page (Buttons)
+    0x19, 0x01,        //     Usage Minimum (Button 1)
+    0x29, 0x03,        //     Usage Maximum (Button 3)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x25, 0x01,        //     Logical Maximum (1)
+    0x95, 0x03,        //     Report Count (3)
+    0x75, 0x01,        //     Report Size (1)
+    0x81, 0x02,        //     Input (Data, Variable, Absolute)
+    0x95, 0x01,        //     Report Count (1) - padding
+    0x75, 0x05,        //     Report Size (5)
+    0x81, 0x03,        //     Input (Constant, Variable, Absolute)
+    0x05, 0x01,        //     Usage Page (Generic Desktop)
+    0x09, 0x30,        //     Usage (X)
+    0x09, 0x31,        //     Usage (Y)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x26, 0xFF, 0x7F,  //     Logical Maximum (32767)
+    0x75, 0x10,        //     Report Size (16)
+    0x95, 0x02,        //     Report Count (2)
+    0x81, 0x02,        //     Input (Data, Variable, Absolute)
+    0xC0,              //   End Collection
+    0xC0,              // End Collection
+
+    // High-Resolution Mouse (Report ID 5) — 16-bit X/Y, wheels with Resolution Multiplier
+    0x05, 0x01,        // Usage Page (Generic Desktop)
+    0x09, 0x02,        // Usage (Mouse)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, 0x05,        //   Report ID (5)
+    0x09, 0x01,        //   Usage (Pointer)
+    0xA1, 0x00,        //   Collection (Physical)
+    0x05, 0x09,        //     Usage Page (Buttons)
+    0x19, 0x01,        //     Usage Minimum (Button 1)
+    0x29, 0x05,        //     Usage Maximum (Button 5)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x25, 0x01,        //     Logical Maximum (1)
+    0x95, 0x05,        //     Report Count (5)
+    0x75, 0x01,        //     Report Size (1)
+    0x81, 0x02,        //     Input (Data, Variable, Absolute)
+    0x95, 0x01,        //     Report Count (1) - padding
+    0x75, 0x03,        //     Report Size (3)
+    0x81, 0x03,        //     Input (Constant, Variable, Absolute)
+    0x05, 0x01,        //     Usage Page (Generic Desktop)
+    0x09, 0x30,        //     Usage (X)
+    0x09, 0x31,        //     Usage (Y)
+    0x16, 0x01, 0x80,  //     Logical Minimum (-32767)
+    0x26, 0xFF, 0x7F,  //     Logical Maximum (32767)
+    0x75, 0x10,        //     Report Size (16)
+    0x95, 0x02,        //     Report Count (2)
+    0x81, 0x06,        //     Input (Data, Variable, Relative)
+    0xA1, 0x02,        //     Collection (Logical)
+    0x09, 0x48,        //       Usage (Resolution Multiplier)
+    0x15, 0x00,        //       Logical Minimum (0)
+    0x25, 0x01,        //       Logical Maximum (1)
+    0x35, 0x01,        //       Physical Minimum (1)
+    0x45, 0x08,        //       Physical Maximum (8)
+    0x75, 0x02,        //       Report Size (2)
+    0x95, 0x01,        //       Report Count (1)
+    0xB1, 0x02,        //       Feature (Data, Variable, Absolute)
+    0x75, 0x06,        //       Report Size (6) - padding
+    0xB1, 0x03,        //       Feature (Constant, Variable, Absolute)
+    0x09, 0x38,        //       Usage (Wheel)
+    0x15, 0x81,        //       Logical Minimum (-127)
+    0x25, 0x7F,        //       Logical Maximum (127)
+    0x35, 0x00,        //       Physical Minimum (0)
+    0x45, 0x00,        //       Physical Maximum (0)
+    0x75, 0x08,        //       Report Size (8)
+    0x81, 0x06,        //       Input (Data, Variable, Relative)
+    0xC0,              //     End Collection
+    0xA1, 0x02,        //     Collection (Logical)
+    0x09, 0x48,        //       Usage (Resolution Multiplier)
+    0x15, 0x00,        //       Logical Minimum (0)
+    0x25, 0x01,        //       Logical Maximum (1)
+    0x35, 0x01,        //       Physical Minimum (1)
+    0x45, 0x08,        //       Physical Maximum (8)
+    0x75, 0x02,        //       Report Size (2)
+    0xB1, 0x02,        //       Feature (Data, Variable, Absolute)
+    0x75, 0x06,        //       Report Size (6) - padding
+    0xB1, 0x03,        //       Feature (Constant, Variable, Absolute)
+    0x05, 0x0C,        //       Usage Page (Consumer)
+    0x0A, 0x38, 0x02,  //       Usage (AC Pan) - horizontal scroll
+    0x15, 0x81,        //       Logical Minimum (-127)
+    0x25, 0x7F,        //       Logical Maximum (127)
+    0x35, 0x00,        //       Physical Minimum (0)
+    0x45, 0x00,        //       Physical Maximum (0)
+    0x75, 0x08,        //       Report Size (8)
+    0x81, 0x06,        //       Input (Data, Variable, Relative)
+    0xC0,              //     End Collection
+    0xC0,              //   End Collection
+    0xC0,              // End Collection
+
+    // N-Key Rollover Keyboard (Report ID 6) — modifiers plus a 120-key usage bitmap
+    0x05, 0x01,        // Usage Page (Generic Desktop)
+    0x09, 0x06,        // Usage (Keyboard)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, 0x06,        //   Report ID (6)
+    0x05, 0x07,        //   Usage Page (Key Codes)
+    0x19, 0xE0,        //   Usage Minimum (224)
+    0x29, 0xE7,        //   Usage Maximum (231)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x01,        //   Logical Maximum (1)
+    0x75, 0x01,        //   Report Size (1)
+    0x95, 0x08,        //   Report Count (8)
+    0x81, 0x02,        //   Input (Data, Variable, Absolute)
+    0x19, 0x00,        //   Usage Minimum (0)
+    0x29, 0x77,        //   Usage Maximum (119)
+    0x95, 0x78,        //   Report Count (120)
+    0x81, 0x02,        //   Input (Data, Variable, Absolute)
+    0xC0,              // End Collection
+};
+
+// Report ID 1 input
+#define HID_MOUSE_INPUT_REPORT_LEN 6
+#define HID_MOUSE_INPUT_BUTTONS_OFFSET 1
+#define HID_MOUSE_INPUT_BUTTONS_BITS 5
+#define HID_MOUSE_INPUT_BUTTONS_MASK 0x1F
+#define HID_MOUSE_INPUT_X_OFFSET 2
+#define HID_MOUSE_INPUT_X_LOGICAL_MIN (-127)
+#define HID_MOUSE_INPUT_X_LOGICAL_MAX (127)
+#define HID_MOUSE_INPUT_Y_OFFSET 3
+#define HID_MOUSE_INPUT_Y_LOGICAL_MIN (-127)
+#define HID_MOUSE_INPUT_Y_LOGICAL_MAX (127)
+#define HID_MOUSE_INPUT_WHEEL_OFFSET 4
+#define HID_MOUSE_INPUT_WHEEL_LOGICAL_MIN (-127)
+#define HID_MOUSE_INPUT_WHEEL_LOGICAL_MAX (127)
+#define HID_MOUSE_INPUT_HWHEEL_OFFSET 5
+#define HID_MOUSE_INPUT_HWHEEL_LOGICAL_MIN (-127)
+#define HID_MOUSE_INPUT_HWHEEL_LOGICAL_MAX (127)
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t buttons;
+    int8_t x;
+    int8_t y;
+    int8_t wheel;
+    int8_t hwheel;
+} hid_mouse_input_report_t;
+_Static_assert(sizeof(hid_mouse_input_report_t) == HID_MOUSE_INPUT_REPORT_LEN,
+               "hid_mouse_input_report_t does not match the report map");
+
+static const uint8_t hid_mouse_input_report_ref[] = {0x01, 0x01};
+
+// Report ID 2 input
+#define HID_KEYBOARD_INPUT_REPORT_LEN 9
+#define HID_KEYBOARD_INPUT_MODIFIERS_OFFSET 1
+#define HID_KEYBOARD_INPUT_MODIFIERS_BITS 8
+#define HID_KEYBOARD_INPUT_MODIFIERS_MASK 0xFF
+#define HID_KEYBOARD_INPUT_RESERVED_OFFSET 2
+#define HID_KEYBOARD_INPUT_KEYS_OFFSET 3
+#define HID_KEYBOARD_INPUT_KEYS_LOGICAL_MIN (0)
+#define HID_KEYBOARD_INPUT_KEYS_LOGICAL_MAX (101)
+#define HID_KEYBOARD_INPUT_KEYS_COUNT 6
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[6];
+} hid_keyboard_input_report_t;
+_Static_assert(sizeof(hid_keyboard_input_report_t) == HID_KEYBOARD_INPUT_REPORT_LEN,
+               "hid_keyboard_input_report_t does not match the report map");
+
+static const uint8_t hid_keyboard_input_report_ref[] = {0x02, 0x01};
+
+// Report ID 2 output
+#define HID_KEYBOARD_OUTPUT_REPORT_LEN 2
+#define HID_KEYBOARD_OUTPUT_LEDS_OFFSET 1
+#define HID_KEYBOARD_OUTPUT_LEDS_BITS 5
+#define HID_KEYBOARD_OUTPUT_LEDS_MASK 0x1F
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t leds;
+} hid_keyboard_output_report_t;
+_Static_assert(sizeof(hid_keyboard_output_report_t) == HID_KEYBOARD_OUTPUT_REPORT_LEN,
+               "hid_keyboard_output_report_t does not match the report map");
+
+static const uint8_t hid_keyboard_output_report_ref[] = {0x02, 0x02};
+
+// Report ID 3 input
+#define HID_CONSUMER_INPUT_REPORT_LEN 3
+#define HID_CONSUMER_INPUT_USAGES_OFFSET 1
+#define HID_CONSUMER_INPUT_USAGES_BITS 16
+#define HID_CONSUMER_INPUT_USAGES_MASK 0xFFFF
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint16_t usages;
+} hid_consumer_input_report_t;
+_Static_assert(sizeof(hid_consumer_input_report_t) == HID_CONSUMER_INPUT_REPORT_LEN,
+               "hid_consumer_input_report_t does not match the report map");
+
+static const uint8_t hid_consumer_input_report_ref[] = {0x03, 0x01};
+
+// Consumer usages: bit n of the field maps to entry n
+static const uint16_t hid_consumer_usages[] = {
+    0x00B5, // Scan Next Track
+    0x00B6, // Scan Previous Track
+    0x00B7, // Stop
+    0x00CD, // Play/Pause
+    0x00E2, // Mute
+    0x00E9, // Volume Up
+    0x00EA, // Volume Down
+    0x0223, // AC Home / WWW Home
+    0x0194, // AL My Computer
+    0x0192, // AL Calculator
+    0x022A, // AC Bookmarks
+    0x0221, // AC Search
+    0x0226, // AC Stop
+    0x0224, // AC Back
+    0x0183, // AL Consumer Control Configuration / Media Select
+    0x018A, // AL Email Reader / Mail
+};
+
+// Report ID 4 input
+#define HID_POINTER_INPUT_REPORT_LEN 6
+#define HID_POINTER_INPUT_BUTTONS_OFFSET 1
+#define HID_POINTER_INPUT_BUTTONS_BITS 3
+#define HID_POINTER_INPUT_BUTTONS_MASK 0x07
+#define HID_POINTER_INPUT_X_OFFSET 2
+#define HID_POINTER_INPUT_X_LOGICAL_MIN (0)
+#define HID_POINTER_INPUT_X_LOGICAL_MAX (32767)
+#define HID_POINTER_INPUT_Y_OFFSET 4
+#define HID_POINTER_INPUT_Y_LOGICAL_MIN (0)
+#define HID_POINTER_INPUT_Y_LOGICAL_MAX (32767)
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t buttons;
+    uint16_t x;
+    uint16_t y;
+} hid_pointer_input_report_t;
+_Static_assert(sizeof(hid_pointer_input_report_t) == HID_POINTER_INPUT_REPORT_LEN,
+               "hid_pointer_input_report_t does not match the report map");
+
+static const uint8_t hid_pointer_input_report_ref[] = {0x04, 0x01};
+
+// Report ID 5 input
+#define HID_HIRES_MOUSE_INPUT_REPORT_LEN 8
+#define HID_HIRES_MOUSE_INPUT_BUTTONS_OFFSET 1
+#define HID_HIRES_MOUSE_INPUT_BUTTONS_BITS 5
+#define HID_HIRES_MOUSE_INPUT_BUTTONS_MASK 0x1F
+#define HID_HIRES_MOUSE_INPUT_X_OFFSET 2
+#define HID_HIRES_MOUSE_INPUT_X_LOGICAL_MIN (-32767)
+#define HID_HIRES_MOUSE_INPUT_X_LOGICAL_MAX (32767)
+#define HID_HIRES_MOUSE_INPUT_Y_OFFSET 4
+#define HID_HIRES_MOUSE_INPUT_Y_LOGICAL_MIN (-32767)
+#define HID_HIRES_MOUSE_INPUT_Y_LOGICAL_MAX (32767)
+#define HID_HIRES_MOUSE_INPUT_WHEEL_OFFSET 6
+#define HID_HIRES_MOUSE_INPUT_WHEEL_LOGICAL_MIN (-127)
+#define HID_HIRES_MOUSE_INPUT_WHEEL_LOGICAL_MAX (127)
+#define HID_HIRES_MOUSE_INPUT_HWHEEL_OFFSET 7
+#define HID_HIRES_MOUSE_INPUT_HWHEEL_LOGICAL_MIN (-127)
+#define HID_HIRES_MOUSE_INPUT_HWHEEL_LOGICAL_MAX (127)
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t buttons;
+    int16_t x;
+    int16_t y;
+    int8_t wheel;
+    int8_t hwheel;
+} hid_hires_mouse_input_report_t;
+_Static_assert(sizeof(hid_hires_mouse_input_report_t) == HID_HIRES_MOUSE_INPUT_REPORT_LEN,
+               "hid_hires_mouse_input_report_t does not match the report map");
+
+static const uint8_t hid_hires_mouse_input_report_ref[] = {0x05, 0x01};
+
+// Report ID 5 feature
+#define HID_HIRES_MOUSE_FEATURE_REPORT_LEN 3
+#define HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_OFFSET 1
+#define HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_LOGICAL_MIN (0)
+#define HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_LOGICAL_MAX (1)
+#define HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_PHYSICAL_MIN (1)
+#define HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_PHYSICAL_MAX (8)
+#define HID_HIRES_MOUSE_FEATURE_HWHEEL_MULTIPLIER_OFFSET 2
+#define HID_HIRES_MOUSE_FEATURE_HWHEEL_MULTIPLIER_LOGICAL_MIN (0)
+#define HID_HIRES_MOUSE_FEATURE_HWHEEL_MULTIPLIER_LOGICAL_MAX (1)
+#define HID_HIRES_MOUSE_FEATURE_HWHEEL_MULTIPLIER_PHYSICAL_MIN (1)
+#define HID_HIRES_MOUSE_FEATURE_HWHEEL_MULTIPLIER_PHYSICAL_MAX (8)
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t wheel_multiplier;
+    uint8_t hwheel_multiplier;
+} hid_hires_mouse_feature_report_t;
+_Static_assert(sizeof(hid_hires_mouse_feature_report_t) == HID_HIRES_MOUSE_FEATURE_REPORT_LEN,
+               "hid_hires_mouse_feature_report_t does not match the report map");
+
+static const uint8_t hid_hires_mouse_feature_report_ref[] = {0x05, 0x03};
+
+// Report ID 6 input
+#define HID_KEYBOARD_NKRO_INPUT_REPORT_LEN 17
+#define HID_KEYBOARD_NKRO_INPUT_MODIFIERS_OFFSET 1
+#define HID_KEYBOARD_NKRO_INPUT_MODIFIERS_BITS 8
+#define HID_KEYBOARD_NKRO_INPUT_MODIFIERS_MASK 0xFF
+#define HID_KEYBOARD_NKRO_INPUT_KEYS_OFFSET 2
+#define HID_KEYBOARD_NKRO_INPUT_KEYS_BITS 120
+
+typedef struct __attribute__((packed))
+{
+    uint8_t report_id;
+    uint8_t modifiers;
+    uint8_t keys[15];
+} hid_keyboard_nkro_input_report_t;
+_Static_assert(sizeof(hid_keyboard_nkro_input_report_t) == HID_KEYBOARD_NKRO_INPUT_REPORT_LEN,
+               "hid_keyboard_nkro_input_report_t does not match the report map");
+
+static const uint8_t hid_keyboard_nkro_input_report_ref[] = {0x06, 0x01};
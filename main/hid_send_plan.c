@@ -0,0 +1,205 @@
+#include "hid_send_plan.h"
+#include "hid_event_log.h"
+#include "esp_timer.h"
+#include "host/ble_hs.h"
+#include <string.h>
+
+uint8_t hid_send_plan_priority(hid_metrics_report_t type)
+{
+    switch (type)
+    {
+    case HID_METRICS_REPORT_KEYBOARD:
+    case HID_METRICS_REPORT_KEYBOARD_NKRO:
+        return 0;
+    case HID_METRICS_REPORT_CONSUMER:
+        return 1;
+    case HID_METRICS_REPORT_POINTER:
+        return 2;
+    case HID_METRICS_REPORT_MOUSE:
+    case HID_METRICS_REPORT_HIRES_MOUSE:
+        return 3;
+    case HID_METRICS_REPORT_BOOT_KEYBOARD:
+        return 4;
+    case HID_METRICS_REPORT_BOOT_MOUSE:
+        return 5;
+    default:
+        return 6;
+    }
+}
+
+// The report-protocol characteristic a boot report duplicates
+static bool hid_send_plan_duplicates(hid_metrics_report_t boot, hid_metrics_report_t type)
+{
+    switch (boot)
+    {
+    case HID_METRICS_REPORT_BOOT_KEYBOARD:
+        return type == HID_METRICS_REPORT_KEYBOARD || type == HID_METRICS_REPORT_KEYBOARD_NKRO;
+    case HID_METRICS_REPORT_BOOT_MOUSE:
+        return type == HID_METRICS_REPORT_MOUSE || type == HID_METRICS_REPORT_HIRES_MOUSE;
+    default:
+        return false;
+    }
+}
+
+// Reports that carry the whole state, so a repeat of the last one is a no-op.
+// Relative mouse reports are not: the same bytes mean the same motion again.
+static bool hid_send_plan_is_state(hid_metrics_report_t type)
+{
+    return type == HID_METRICS_REPORT_KEYBOARD || type == HID_METRICS_REPORT_KEYBOARD_NKRO ||
+           type == HID_METRICS_REPORT_BOOT_KEYBOARD || type == HID_METRICS_REPORT_CONSUMER ||
+           type == HID_METRICS_REPORT_POINTER;
+}
+
+static bool hid_send_plan_same(const hid_pending_report_t *a, const hid_pending_report_t *b)
+{
+    return a->attr_handle == b->attr_handle && a->len == b->len && memcmp(a->data, b->data, a->len) == 0;
+}
+
+void hid_send_plan_build(const hid_pending_report_t *reports, size_t count,
+                         bool report_protocol, hid_send_plan_t *plan)
+{
+    memset(plan, 0, sizeof(*plan));
+    if (count > HID_SEND_PLAN_MAX)
+    {
+        count = HID_SEND_PLAN_MAX;
+    }
+
+    // Last report planned on each characteristic, for the repeat check
+    const hid_pending_report_t *last[HID_METRICS_REPORT_COUNT] = {0};
+
+    size_t start = 0;
+    while (start < count)
+    {
+        // One update: a run of reports sharing a group
+        size_t end = start + 1;
+        while (end < count && reports[end].group == reports[start].group)
+        {
+            end++;
+        }
+
+        for (size_t i = start; i < end; ++i)
+        {
+            const hid_pending_report_t *report = &reports[i];
+            if (report->done)
+            {
+                continue;
+            }
+
+            bool redundant = false;
+            if (report_protocol)
+            {
+                for (size_t j = start; j < end && !redundant; ++j)
+                {
+                    redundant = j != i && !reports[j].done &&
+                                hid_send_plan_duplicates(report->type, reports[j].type);
+                }
+            }
+            if (!redundant && (unsigned)report->type < HID_METRICS_REPORT_COUNT &&
+                hid_send_plan_is_state(report->type) && last[report->type] &&
+                hid_send_plan_same(last[report->type], report))
+            {
+                redundant = true;
+            }
+
+            if (redundant)
+            {
+                plan->skip[i] = true;
+                plan->skipped++;
+                continue;
+            }
+
+            // Insertion sort by priority; stable, so equal priorities keep
+            // their queue order
+            size_t pos = plan->count;
+            uint8_t priority = hid_send_plan_priority(report->type);
+            while (pos > 0 && plan->order[pos - 1] >= start &&
+                   hid_send_plan_priority(reports[plan->order[pos - 1]].type) > priority)
+            {
+                plan->order[pos] = plan->order[pos - 1];
+                pos--;
+            }
+            plan->order[pos] = (uint8_t)i;
+            plan->count++;
+
+            if ((unsigned)report->type < HID_METRICS_REPORT_COUNT)
+            {
+                last[report->type] = report;
+            }
+        }
+
+        start = end;
+    }
+}
+
+// A single attempt that never blocks: a host that is out of buffers keeps
+// the report queued for the next cycle, so other hosts are not held up
+// behind it. Failures are only counted and queued for hid_event_log;
+// nothing on this path formats or prints.
+static esp_err_t hid_send_notification(uint16_t conn_handle, const hid_pending_report_t *report)
+{
+    hid_metrics_record_attempt(report->type);
+
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(report->data, report->len);
+    if (!om)
+    {
+        hid_metrics_record_enomem(report->type, true);
+        hid_event_log_record(HID_EVENT_ENOMEM_ALLOC, report->type, conn_handle, BLE_HS_ENOMEM);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // The stack owns the mbuf from here, whether or not it succeeds
+    int rc = ble_gatts_notify_custom(conn_handle, report->attr_handle, om);
+    if (rc == 0)
+    {
+        return ESP_OK;
+    }
+
+    if (rc == BLE_HS_ENOMEM)
+    {
+        hid_metrics_record_enomem(report->type, false);
+        hid_event_log_record(HID_EVENT_ENOMEM_NOTIFY, report->type, conn_handle, rc);
+        return ESP_ERR_NO_MEM;
+    }
+
+    hid_event_log_record(HID_EVENT_NOTIFY_FAILED, report->type, conn_handle, rc);
+    return ESP_FAIL;
+}
+
+void hid_send_plan_submit(uint16_t conn_handle, hid_pending_report_t *reports,
+                          const hid_send_plan_t *plan, hid_send_plan_hook_t before_send,
+                          void *ctx, hid_send_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    for (size_t n = 0; n < plan->count; ++n)
+    {
+        hid_pending_report_t *report = &reports[plan->order[n]];
+        int64_t started_us = esp_timer_get_time();
+        if (before_send)
+        {
+            before_send(ctx, report, started_us);
+        }
+
+        esp_err_t err = hid_send_notification(conn_handle, report);
+        result->attempted++;
+        result->last_err = err;
+
+        if (err == ESP_ERR_NO_MEM)
+        {
+            if (report->retries < UINT8_MAX)
+            {
+                report->retries++;
+            }
+            return;
+        }
+
+        // Sent, or failed in a way retrying will not fix
+        report->done = true;
+        if (err == ESP_OK)
+        {
+            result->sent++;
+            hid_metrics_record_sent(report->type, report->len,
+                                    (uint32_t)(started_us - report->queued_us), report->retries);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef HID_SEND_PLAN_H
+#define HID_SEND_PLAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "hid_metrics.h"
+#include "hid_report_descriptor.h"
+
+// Largest input report payload (the NKRO bitmap report)
+#define HID_SEND_REPORT_MAX_LEN sizeof(hid_keyboard_nkro_input_report_t)
+// Most reports a single plan covers; ble_hid sizes its host queues to match
+#define HID_SEND_PLAN_MAX 8
+
+// One queued input report notification
+typedef struct
+{
+    uint16_t attr_handle;
+    hid_metrics_report_t type;
+    uint8_t group;      // reports queued by the same input update share a group
+    uint8_t len;
+    uint8_t retries;    // out-of-buffer attempts so far
+    bool done;          // sent (or failed for good) ahead of an older report
+    int64_t queued_us;  // esp_timer time it was queued, for latency stats
+    uint8_t data[HID_SEND_REPORT_MAX_LEN];
+} hid_pending_report_t;
+
+typedef struct
+{
+    uint8_t order[HID_SEND_PLAN_MAX]; // indexes into the reports, send order
+    size_t count;
+    bool skip[HID_SEND_PLAN_MAX];     // redundant; consumed without sending
+    size_t skipped;
+} hid_send_plan_t;
+
+typedef struct
+{
+    size_t sent;          // notifications the stack accepted
+    size_t attempted;     // plan entries tried, including the one that failed
+    esp_err_t last_err;   // ESP_ERR_NO_MEM when the link ran out of buffers
+} hid_send_result_t;
+
+// Called just before each notification; NimBLE may report NOTIFY_TX from
+// inside the send.
+typedef void (*hid_send_plan_hook_t)(void *ctx, const hid_pending_report_t *report, int64_t started_us);
+
+// Lower sends first within one input update
+uint8_t hid_send_plan_priority(hid_metrics_report_t type);
+
+// Plans one drain cycle over reports (oldest first). Updates go out in the
+// order they were queued; within an update, reports are ordered by priority.
+// A boot report is skipped when the host is in report protocol and the same
+// update also carries the report-protocol version, and a keyboard, consumer
+// or pointer report identical to the previous one planned on the same
+// characteristic is skipped as well. Reports already marked done are left out.
+void hid_send_plan_build(const hid_pending_report_t *reports, size_t count,
+                         bool report_protocol, hid_send_plan_t *plan);
+
+// Sends the plan back-to-back without blocking and marks each report that
+// is finished with as done. Stops at the first report the link has no
+// buffers for (counting a retry on it); other errors drop that report and
+// carry on.
+void hid_send_plan_submit(uint16_t conn_handle, hid_pending_report_t *reports,
+                          const hid_send_plan_t *plan, hid_send_plan_hook_t before_send,
+                          void *ctx, hid_send_result_t *result);
+
+#endif // HID_SEND_PLAN_H
@@ -4,7 +4,13 @@
 #include "dns_server.h"
 #include "wifi_manager.h"
 #include "transport_ws.h"
+#include "transport_http.h"
 #include "cJSON.h"
+#include "task_topology.h"
+#include "status_publisher.h"
+#include "json_out.h"
+#include "wifi_scan_results.h"
+#include "web_assets.h"
 #include <string.h>
 #include <stdlib.h>
 #include <sys/param.h>
@@ -14,8 +20,34 @@ static const char *TAG = "HTTP_SERVER";
 
 static httpd_handle_t s_server = NULL;
 static bool s_captive_portal_enabled = false;
-extern const char html_start[] asm("_binary_index_html_start");
-extern const char html_end[] asm("_binary_index_html_end");
+
+// One scan runs at a time and its callback comes from the Wi-Fi event
+// task, so a single page buffer serves every scan
+#define SCAN_PAGE_SIZE 1024
+static char s_scan_page[SCAN_PAGE_SIZE];
+static uint32_t s_scan_id = 0;
+static bool s_scan_sort = true;
+static bool s_scan_dedup = true;
+
+// Longest Accept-Encoding / If-None-Match value looked at; longer ones are
+// treated as absent, which only costs a full response
+#define WEB_HDR_VALUE_LEN 128
+#define WEB_CACHE_CONTROL "no-cache"
+
+// With /ws hosted here the pool is shared: WebSocket clients hold up to
+// WS_MAX_CLIENTS sockets and page loads get the rest
+#ifdef CONFIG_HID_WS_DEDICATED_SERVER
+#define HTTP_MAX_OPEN_SOCKETS 7
+#elif defined(CONFIG_HID_HTTPD_MAX_SOCKETS)
+#define HTTP_MAX_OPEN_SOCKETS CONFIG_HID_HTTPD_MAX_SOCKETS
+#else
+#define HTTP_MAX_OPEN_SOCKETS 11
+#endif
+
+#ifndef CONFIG_HID_WS_DEDICATED_SERVER
+_Static_assert(HTTP_MAX_OPEN_SOCKETS > WS_MAX_CLIENTS,
+               "CONFIG_HID_HTTPD_MAX_SOCKETS must leave sockets for page loads");
+#endif
 
 static void populate_wifi_status_json(cJSON *obj)
 {
@@ -104,84 +136,155 @@ static void populate_wifi_status_json(cJSON *obj)
 
 void http_server_publish_wifi_status(void)
 {
-    cJSON *msg = cJSON_CreateObject();
-    if (!msg)
-    {
-        return;
-    }
+    status_publisher_mark(STATUS_TOPIC_WIFI);
+}
 
-    cJSON_AddStringToObject(msg, "type", "wifi_status");
-    populate_wifi_status_json(msg);
+void http_server_set_scan_options(bool sort_by_rssi, bool dedup_ssid)
+{
+    s_scan_sort = sort_by_rssi;
+    s_scan_dedup = dedup_ssid;
+}
 
-    char *payload = cJSON_PrintUnformatted(msg);
-    if (payload)
+void http_server_publish_scan_results(wifi_ap_record_t *records, uint16_t count)
+{
+    size_t total = wifi_scan_results_compact(records, count, s_scan_dedup, s_scan_sort);
+    uint32_t scan_id = ++s_scan_id;
+    size_t offset = 0;
+    unsigned pages = 0;
+
+    // At least one page, so an empty scan still reports "last"
+    do
     {
-        esp_err_t err = transport_websocket_send(payload);
+        size_t len = 0;
+        size_t written = wifi_scan_results_page(s_scan_page, sizeof(s_scan_page), scan_id, records, total,
+                                                offset, &len);
+        if (len == 0 || (written == 0 && offset < total))
+        {
+            ESP_LOGW(TAG, "Scan result %u does not fit a page", (unsigned)offset);
+            break;
+        }
+
+        esp_err_t err = transport_websocket_send(s_scan_page);
         if (err != ESP_OK)
         {
-            ESP_LOGD(TAG, "Failed to broadcast wifi_status: %s", esp_err_to_name(err));
+            ESP_LOGD(TAG, "Failed to broadcast scan_results: %s", esp_err_to_name(err));
+            break;
         }
-        free(payload);
-    }
-    cJSON_Delete(msg);
+        offset += written;
+        ++pages;
+    } while (offset < total);
+
+    ESP_LOGI(TAG, "Scan %lu: %u of %u networks in %u pages", (unsigned long)scan_id, (unsigned)total,
+             (unsigned)count, pages);
 }
 
-void http_server_publish_scan_results(const wifi_ap_record_t *records, uint16_t count)
+// Copies a request header into buf; false when missing or too long
+static bool get_request_header(httpd_req_t *req, const char *field, char *buf, size_t size)
 {
-    cJSON *msg = cJSON_CreateObject();
-    if (!msg)
+    size_t len = httpd_req_get_hdr_value_len(req, field);
+    if (len == 0 || len >= size)
     {
-        return;
-    }
-
-    cJSON_AddStringToObject(msg, "type", "scan_results");
-    cJSON *array = cJSON_CreateArray();
-    if (!array)
-    {
-        cJSON_Delete(msg);
-        return;
+        return false;
     }
-    cJSON_AddItemToObject(msg, "networks", array);
+    return httpd_req_get_hdr_value_str(req, field, buf, size) == ESP_OK;
+}
 
-    for (uint16_t i = 0; records && i < count; ++i)
+// Sends an embedded file gzipped when the client takes it, and answers a
+// matching If-None-Match with 304 so reloads skip the body entirely.
+// Every copy is revalidated (no-cache), so a firmware update shows at once.
+// A Range request gets a slice of the plain file; If-Range with a stale
+// ETag turns it back into a full response.
+static esp_err_t send_web_asset(httpd_req_t *req, const web_asset_t *asset)
+{
+    char value[WEB_HDR_VALUE_LEN];
+    size_t start = 0;
+    size_t len = 0;
+    web_range_t range = WEB_RANGE_NONE;
+    if (get_request_header(req, "Range", value, sizeof(value)))
     {
-        cJSON *entry = cJSON_CreateObject();
-        if (!entry)
+        range = web_assets_parse_range(value, asset->size, &start, &len);
+        if (range != WEB_RANGE_NONE && get_request_header(req, "If-Range", value, sizeof(value)) &&
+            strcmp(value, asset->etag) != 0)
         {
-            continue;
+            range = WEB_RANGE_NONE;
         }
+    }
 
-        char ssid[33] = {0};
-        memcpy(ssid, records[i].ssid, sizeof(records[i].ssid));
-        cJSON_AddStringToObject(entry, "ssid", ssid);
-        cJSON_AddNumberToObject(entry, "rssi", records[i].rssi);
-        cJSON_AddNumberToObject(entry, "channel", records[i].primary);
-        cJSON_AddNumberToObject(entry, "auth", records[i].authmode);
+    bool gzip = range == WEB_RANGE_NONE &&
+                get_request_header(req, "Accept-Encoding", value, sizeof(value)) &&
+                web_assets_accepts_gzip(value);
+    const char *etag = gzip ? asset->gz_etag : asset->etag;
 
-        cJSON_AddItemToArray(array, entry);
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", WEB_CACHE_CONTROL);
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    httpd_resp_set_hdr(req, "Accept-Ranges", "bytes");
+
+    if (get_request_header(req, "If-None-Match", value, sizeof(value)) &&
+        web_assets_etag_matches(value, etag))
+    {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
     }
 
-    char *payload = cJSON_PrintUnformatted(msg);
-    if (payload)
+    // Content-Range must outlive this call until the response is sent
+    char content_range[48];
+    if (range == WEB_RANGE_UNSATISFIABLE)
     {
-        esp_err_t err = transport_websocket_send(payload);
-        if (err != ESP_OK)
-        {
-            ESP_LOGD(TAG, "Failed to broadcast scan_results: %s", esp_err_to_name(err));
-        }
-        free(payload);
+        snprintf(content_range, sizeof(content_range), "bytes */%u", (unsigned)asset->size);
+        httpd_resp_set_status(req, "416 Range Not Satisfiable");
+        httpd_resp_set_hdr(req, "Content-Range", content_range);
+        return httpd_resp_send(req, NULL, 0);
     }
 
-    cJSON_Delete(msg);
+    httpd_resp_set_type(req, asset->content_type);
+    if (range == WEB_RANGE_OK)
+    {
+        snprintf(content_range, sizeof(content_range), "bytes %u-%u/%u", (unsigned)start,
+                 (unsigned)(start + len - 1), (unsigned)asset->size);
+        httpd_resp_set_status(req, "206 Partial Content");
+        httpd_resp_set_hdr(req, "Content-Range", content_range);
+        return httpd_resp_send(req, (const char *)asset->data + start, len);
+    }
+    if (gzip)
+    {
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        return httpd_resp_send(req, (const char *)asset->gz_data, asset->gz_size);
+    }
+    return httpd_resp_send(req, (const char *)asset->data, asset->size);
 }
 
-// Root handler - serves HTML
-static esp_err_t root_handler(httpd_req_t *req)
+// httpd has no idle timeout for keep-alive sockets, and LRU purge is off on
+// the shared server, so a page load's socket would stay in the pool until
+// the browser closed it. Page loads and portal probes answer with
+// "Connection: close" and give their socket back once sent; only WebSocket
+// clients hold one for long.
+static void close_after_response(httpd_req_t *req)
 {
-    const size_t html_size = (html_end - html_start);
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html_start, html_size);
-    return ESP_OK;
+    httpd_resp_set_hdr(req, "Connection", "close");
+}
+
+static void release_socket(httpd_req_t *req)
+{
+    httpd_sess_trigger_close(req->handle, httpd_req_to_sockfd(req));
+}
+
+// Serves every embedded web file; registered last as "/*" so the API and
+// captive portal URIs keep their own handlers
+static esp_err_t static_file_handler(httpd_req_t *req)
+{
+    close_after_response(req);
+    size_t path_len = strcspn(req->uri, "?#");
+    const web_asset_t *asset = web_assets_find(req->uri, path_len);
+    if (!asset)
+    {
+        httpd_resp_send_404(req);
+        release_socket(req);
+        return ESP_FAIL;
+    }
+    esp_err_t err = send_web_asset(req, asset);
+    release_socket(req);
+    return err;
 }
 
 // API handler for WiFi operations
@@ -247,11 +350,15 @@ static esp_err_t api_handler(httpd_req_t *req)
         }
     }
 
-    char *resp_str = cJSON_PrintUnformatted(response);
+    json_out_t out;
+    const char *resp_str = json_out_print(response, &out);
     httpd_resp_set_type(req, "application/json");
     httpd_resp_sendstr(req, resp_str);
 
-    free(resp_str);
+    if (resp_str)
+    {
+        json_out_release(&out);
+    }
     cJSON_Delete(response);
     cJSON_Delete(req_json);
 
@@ -282,6 +389,7 @@ static esp_err_t portal_page_handler(httpd_req_t *req)
     httpd_resp_set_status(req, "302 Found");
     httpd_resp_set_hdr(req, "Location", redirect_target);
     httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    close_after_response(req);
     httpd_resp_set_type(req, "text/html");
 
     httpd_resp_sendstr_chunk(req, "<!DOCTYPE html><html><head>"
@@ -307,6 +415,7 @@ static esp_err_t portal_page_handler(httpd_req_t *req)
     httpd_resp_sendstr_chunk(req, "</a>.</p></body></html>");
 
     httpd_resp_sendstr_chunk(req, NULL);
+    release_socket(req);
     return ESP_OK;
 }
 
@@ -315,8 +424,20 @@ esp_err_t http_server_start(uint16_t port)
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = port;
     config.ctrl_port = port + 1;
-    config.max_open_sockets = 7;
+    config.max_open_sockets = HTTP_MAX_OPEN_SOCKETS;
+#ifdef CONFIG_HID_WS_DEDICATED_SERVER
     config.lru_purge_enable = true;
+#else
+    // LRU purge cannot tell a quiet WebSocket client from an idle page
+    // socket and would close it; page loads close their own sockets instead
+    // (close_after_response), so a full pool means that many live clients
+    config.lru_purge_enable = false;
+#endif
+    config.core_id = TASK_CORE_NET;
+    config.task_priority = TASK_PRIO_HTTPD;
+    config.stack_size = TASK_STACK_HTTPD;
+    config.uri_match_fn = httpd_uri_match_wildcard;
+    config.max_uri_handlers = 12;
 
     if (httpd_start(&s_server, &config) != ESP_OK)
     {
@@ -324,14 +445,6 @@ esp_err_t http_server_start(uint16_t port)
         return ESP_FAIL;
     }
 
-    // Main page
-    httpd_uri_t root_uri = {
-        .uri = "/",
-        .method = HTTP_GET,
-        .handler = root_handler,
-    };
-    httpd_register_uri_handler(s_server, &root_uri);
-
     // API endpoint
     httpd_uri_t api_uri = {
         .uri = "/api",
@@ -369,6 +482,28 @@ esp_err_t http_server_start(uint16_t port)
     };
     httpd_register_uri_handler(s_server, &success_uri);
 
+#ifndef CONFIG_HID_WS_DEDICATED_SERVER
+    // WebSocket transport on this server, ahead of the catch-all below
+    if (transport_websocket_attach(s_server) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to host /ws");
+    }
+#endif
+
+    // HID input over plain HTTP
+    if (transport_http_attach(s_server) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to register HTTP input endpoints");
+    }
+
+    // Web UI files; must come after every exact URI
+    httpd_uri_t static_uri = {
+        .uri = "/*",
+        .method = HTTP_GET,
+        .handler = static_file_handler,
+    };
+    httpd_register_uri_handler(s_server, &static_uri);
+
     ESP_LOGI(TAG, "HTTP server started on port %d", port);
     s_captive_portal_enabled = false;
 
@@ -381,6 +516,9 @@ esp_err_t http_server_stop(void)
 
     if (s_server)
     {
+#ifndef CONFIG_HID_WS_DEDICATED_SERVER
+        transport_websocket_attach(NULL);
+#endif
         httpd_stop(s_server);
         s_server = NULL;
         ESP_LOGI(TAG, "HTTP server stopped");
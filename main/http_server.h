@@ -3,6 +3,7 @@
 
 #include "esp_err.h"
 #include "esp_wifi_types.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 #define DEFAULT_HTTP_PORT 80
@@ -10,7 +11,10 @@
 esp_err_t http_server_start(uint16_t port);
 esp_err_t http_server_stop(void);
 void http_server_publish_wifi_status(void);
-void http_server_publish_scan_results(const wifi_ap_record_t *records, uint16_t count);
+// Broadcasts a scan as scan_results pages (see wifi_scan_results.h),
+// compacted in place first per http_server_set_scan_options
+void http_server_publish_scan_results(wifi_ap_record_t *records, uint16_t count);
+void http_server_set_scan_options(bool sort_by_rssi, bool dedup_ssid);
 esp_err_t http_server_enable_captive_portal(void);
 esp_err_t http_server_disable_captive_portal(void);
 
@@ -0,0 +1,117 @@
+#include "input_batch.h"
+#include <string.h>
+
+void input_batch_init(input_batch_t *batch, input_batch_event_fn on_event, void *ctx)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->on_event = on_event;
+    batch->ctx = ctx;
+}
+
+static bool is_separator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == '[' || c == ']';
+}
+
+static void end_object(input_batch_t *batch)
+{
+    if (batch->oversized)
+    {
+        batch->dropped++;
+    }
+    else
+    {
+        batch->buf[batch->len] = '\0';
+        batch->events++;
+        if (batch->on_event)
+        {
+            batch->on_event(batch->buf, batch->len, batch->ctx);
+        }
+    }
+    batch->len = 0;
+    batch->oversized = false;
+}
+
+void input_batch_feed(input_batch_t *batch, const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        char c = data[i];
+
+        if (batch->depth == 0)
+        {
+            if (c == '{')
+            {
+                batch->depth = 1;
+                batch->buf[0] = c;
+                batch->len = 1;
+            }
+            else if (!is_separator(c))
+            {
+                batch->stray++;
+            }
+            continue;
+        }
+
+        if (batch->len < INPUT_BATCH_EVENT_MAX)
+        {
+            batch->buf[batch->len++] = c;
+        }
+        else
+        {
+            batch->oversized = true;
+        }
+
+        if (batch->in_string)
+        {
+            if (batch->escape)
+            {
+                batch->escape = false;
+            }
+            else if (c == '\\')
+            {
+                batch->escape = true;
+            }
+            else if (c == '"')
+            {
+                batch->in_string = false;
+            }
+            continue;
+        }
+
+        switch (c)
+        {
+        case '"':
+            batch->in_string = true;
+            break;
+        case '{':
+        case '[':
+            batch->depth++;
+            break;
+        case '}':
+        case ']':
+            if (--batch->depth == 0)
+            {
+                end_object(batch);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool input_batch_finish(input_batch_t *batch)
+{
+    if (batch->depth == 0)
+    {
+        return true;
+    }
+    batch->dropped++;
+    batch->depth = 0;
+    batch->len = 0;
+    batch->in_string = false;
+    batch->escape = false;
+    batch->oversized = false;
+    return false;
+}
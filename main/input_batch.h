@@ -0,0 +1,39 @@
+#ifndef INPUT_BATCH_H
+#define INPUT_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest single event; typing long text belongs in POST /api/type
+#define INPUT_BATCH_EVENT_MAX 512
+
+typedef void (*input_batch_event_fn)(const char *json, size_t len, void *ctx);
+
+// Splits a request body into its top-level JSON objects as it arrives, so
+// a batch never has to sit in RAM whole. Accepts one object, a JSON array
+// of objects, newline-delimited objects, or any mix; whitespace, commas
+// and brackets between objects are skipped. Only object boundaries are
+// found here (the caller parses each object), so strings and nesting are
+// tracked but values are not validated.
+typedef struct
+{
+    input_batch_event_fn on_event;
+    void *ctx;
+    char buf[INPUT_BATCH_EVENT_MAX + 1]; // event text, NUL-terminated
+    size_t len;
+    uint32_t depth;   // open braces/brackets of the current object
+    bool in_string;
+    bool escape;
+    bool oversized;   // current object outgrew buf; dropped at its end
+    uint32_t events;  // objects handed to on_event
+    uint32_t dropped; // objects longer than INPUT_BATCH_EVENT_MAX
+    uint32_t stray;   // bytes outside objects that are not separators
+} input_batch_t;
+
+void input_batch_init(input_batch_t *batch, input_batch_event_fn on_event, void *ctx);
+void input_batch_feed(input_batch_t *batch, const char *data, size_t len);
+// End of body. False when it cut an object short; that object is dropped.
+bool input_batch_finish(input_batch_t *batch);
+
+#endif // INPUT_BATCH_H
@@ -0,0 +1,101 @@
+#include "json_out.h"
+#include "freertos/FreeRTOS.h"
+#include <stdlib.h>
+#include <string.h>
+
+static char s_buffers[JSON_OUT_BUFFERS][JSON_OUT_BUFFER_SIZE];
+static bool s_in_use[JSON_OUT_BUFFERS];
+static json_out_stats_t s_stats = {0};
+// Claimed from the status, control, httpd and BLE host tasks
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int json_out_claim(void)
+{
+    int slot = -1;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < JSON_OUT_BUFFERS; ++i)
+    {
+        if (!s_in_use[i])
+        {
+            s_in_use[i] = true;
+            slot = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return slot;
+}
+
+static void json_out_unclaim(int slot)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_in_use[slot] = false;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void json_out_count(uint32_t *counter, size_t len)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_stats.prints++;
+    (*counter)++;
+    if (len > s_stats.largest)
+    {
+        s_stats.largest = (uint32_t)len;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+const char *json_out_print(cJSON *item, json_out_t *out)
+{
+    out->text = NULL;
+    out->slot = -1;
+    if (!item)
+    {
+        return NULL;
+    }
+
+    int slot = json_out_claim();
+    if (slot >= 0)
+    {
+        if (cJSON_PrintPreallocated(item, s_buffers[slot], JSON_OUT_BUFFER_SIZE, false))
+        {
+            out->text = s_buffers[slot];
+            out->slot = slot;
+            json_out_count(&s_stats.buffered, strlen(out->text));
+            return out->text;
+        }
+        json_out_unclaim(slot);
+    }
+
+    out->text = cJSON_PrintUnformatted(item);
+    if (!out->text)
+    {
+        portENTER_CRITICAL(&s_lock);
+        s_stats.failed++;
+        portEXIT_CRITICAL(&s_lock);
+        return NULL;
+    }
+    json_out_count(slot >= 0 ? &s_stats.overflow : &s_stats.busy, strlen(out->text));
+    return out->text;
+}
+
+void json_out_release(json_out_t *out)
+{
+    if (out->slot >= 0)
+    {
+        json_out_unclaim(out->slot);
+    }
+    else
+    {
+        free(out->text);
+    }
+    out->text = NULL;
+    out->slot = -1;
+}
+
+void json_out_get_stats(json_out_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,39 @@
+#ifndef JSON_OUT_H
+#define JSON_OUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cJSON.h"
+
+// Serializes outgoing JSON into one of a few static buffers instead of a
+// fresh heap string per message, so status and response floods do not
+// fragment the heap. A message that does not fit, or arrives while every
+// buffer is in use, falls back to cJSON_PrintUnformatted; it is never
+// truncated.
+#define JSON_OUT_BUFFERS 3
+#define JSON_OUT_BUFFER_SIZE 2048
+
+typedef struct
+{
+    char *text;
+    int slot; // buffer index, -1 when text came from the heap
+} json_out_t;
+
+typedef struct
+{
+    uint32_t prints;   // messages serialized
+    uint32_t buffered; // ... into a static buffer
+    uint32_t busy;     // heap fallbacks because every buffer was in use
+    uint32_t overflow; // heap fallbacks because the message did not fit
+    uint32_t failed;   // no memory for the fallback either
+    uint32_t largest;  // longest message, in bytes
+} json_out_stats_t;
+
+// Returns the serialized item, or NULL on failure. The text stays valid
+// until json_out_release; send it and release straight away.
+const char *json_out_print(cJSON *item, json_out_t *out);
+void json_out_release(json_out_t *out);
+
+void json_out_get_stats(json_out_stats_t *stats);
+
+#endif // JSON_OUT_H
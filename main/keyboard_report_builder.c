@@ -0,0 +1,158 @@
+#include "keyboard_report_builder.h"
+
+#include <string.h>
+
+#define KEYBOARD_BITMAP_USAGES (HID_KEYBOARD_BITMAP_BYTES * 8)
+
+static int hex_nibble(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool keyboard_state_press(keyboard_state_t *state, uint8_t usage)
+{
+    if (!state)
+    {
+        return false;
+    }
+    if (usage >= KEYBOARD_MODIFIER_USAGE_MIN && usage <= KEYBOARD_MODIFIER_USAGE_MAX)
+    {
+        state->modifiers |= (uint8_t)(1u << (usage - KEYBOARD_MODIFIER_USAGE_MIN));
+        return true;
+    }
+    if (usage >= KEYBOARD_BITMAP_USAGES)
+    {
+        return false;
+    }
+    state->bitmap[usage / 8] |= (uint8_t)(1u << (usage % 8));
+    return true;
+}
+
+bool keyboard_bitmap_test(const keyboard_state_t *state, uint8_t usage)
+{
+    if (!state || usage >= KEYBOARD_BITMAP_USAGES)
+    {
+        return false;
+    }
+    return (state->bitmap[usage / 8] & (1u << (usage % 8))) != 0;
+}
+
+bool keyboard_bitmap_from_hex(keyboard_state_t *state, const char *hex)
+{
+    if (!state || !hex)
+    {
+        return false;
+    }
+
+    size_t len = strlen(hex);
+    if (len % 2 != 0 || len / 2 > HID_KEYBOARD_BITMAP_BYTES)
+    {
+        return false;
+    }
+
+    uint8_t bytes[HID_KEYBOARD_BITMAP_BYTES] = {0};
+    for (size_t i = 0; i < len / 2; ++i)
+    {
+        int hi = hex_nibble(hex[2 * i]);
+        int lo = hex_nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+        {
+            return false;
+        }
+        bytes[i] = (uint8_t)((hi << 4) | lo);
+    }
+
+    for (size_t i = 0; i < HID_KEYBOARD_BITMAP_BYTES; ++i)
+    {
+        state->bitmap[i] |= bytes[i];
+    }
+    return true;
+}
+
+static bool keyboard_bitmap_empty(const keyboard_state_t *state)
+{
+    for (size_t i = 0; i < HID_KEYBOARD_BITMAP_BYTES; ++i)
+    {
+        if (state->bitmap[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void keyboard_build_report(const keyboard_state_t *state, hid_keyboard_input_report_t *report)
+{
+    report->report_id = HID_REPORT_ID_KEYBOARD;
+    report->modifiers = state->modifiers;
+    report->reserved = state->reserved;
+
+    // Plain 6KRO input is passed through untouched
+    memcpy(report->keys, state->keys, sizeof(report->keys));
+    if (keyboard_bitmap_empty(state))
+    {
+        return;
+    }
+
+    uint8_t keys[HID_KEYBOARD_ROLLOVER_KEYS] = {0};
+    size_t count = 0;
+    bool overflow = false;
+
+    for (size_t i = 0; i < HID_KEYBOARD_ROLLOVER_KEYS; ++i)
+    {
+        if (state->keys[i] != 0)
+        {
+            keys[count++] = state->keys[i];
+        }
+    }
+
+    // Usages above the 6KRO logical maximum have no slot in Report ID 2
+    for (unsigned usage = 1; usage <= HID_KEYBOARD_INPUT_KEYS_LOGICAL_MAX; ++usage)
+    {
+        if (!keyboard_bitmap_test(state, (uint8_t)usage) || memchr(keys, (int)usage, count))
+        {
+            continue;
+        }
+        if (count == HID_KEYBOARD_ROLLOVER_KEYS)
+        {
+            overflow = true;
+            break;
+        }
+        keys[count++] = (uint8_t)usage;
+    }
+
+    if (overflow)
+    {
+        memset(report->keys, HID_KEYBOARD_ERROR_ROLLOVER, sizeof(report->keys));
+        return;
+    }
+    memcpy(report->keys, keys, sizeof(report->keys));
+}
+
+void keyboard_build_nkro_report(const keyboard_state_t *state, hid_keyboard_nkro_input_report_t *report)
+{
+    report->report_id = HID_REPORT_ID_KEYBOARD_NKRO;
+    report->modifiers = state->modifiers;
+    memcpy(report->keys, state->bitmap, sizeof(report->keys));
+
+    for (size_t i = 0; i < HID_KEYBOARD_ROLLOVER_KEYS; ++i)
+    {
+        uint8_t usage = state->keys[i];
+        if (usage != 0 && usage < KEYBOARD_BITMAP_USAGES)
+        {
+            report->keys[usage / 8] |= (uint8_t)(1u << (usage % 8));
+        }
+    }
+}
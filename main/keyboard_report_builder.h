@@ -0,0 +1,33 @@
+#ifndef KEYBOARD_REPORT_BUILDER_H
+#define KEYBOARD_REPORT_BUILDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hid_keyboard.h"
+#include "hid_report_descriptor.h"
+
+#define HID_KEYBOARD_ERROR_ROLLOVER 0x01
+
+// Modifier usages; the highest keyboard usage the reports carry
+#define KEYBOARD_MODIFIER_USAGE_MIN 0xE0
+#define KEYBOARD_MODIFIER_USAGE_MAX 0xE7
+
+_Static_assert(HID_KEYBOARD_BITMAP_BYTES * 8 == HID_KEYBOARD_NKRO_INPUT_KEYS_BITS,
+               "keyboard_state_t bitmap must match the NKRO report");
+_Static_assert(HID_KEYBOARD_ROLLOVER_KEYS == HID_KEYBOARD_INPUT_KEYS_COUNT,
+               "keyboard_state_t keys must match the 6KRO report");
+
+// Mark a key usage as held in the bitmap. Modifier usages (0xE0-0xE7) set the
+// matching modifier bit; anything else outside the NKRO range is rejected.
+bool keyboard_state_press(keyboard_state_t *state, uint8_t usage);
+bool keyboard_bitmap_test(const keyboard_state_t *state, uint8_t usage);
+// Parse a little-endian hex bitmap ("byte 0" = usages 0x00-0x07). Returns false
+// if the string is malformed or longer than the bitmap.
+bool keyboard_bitmap_from_hex(keyboard_state_t *state, const char *hex);
+
+// Report ID 2 (and the boot report after it). Held keys beyond the six slots
+// put the report into the ErrorRollOver phantom state as HID 1.11 requires.
+void keyboard_build_report(const keyboard_state_t *state, hid_keyboard_input_report_t *report);
+void keyboard_build_nkro_report(const keyboard_state_t *state, hid_keyboard_nkro_input_report_t *report);
+
+#endif // KEYBOARD_REPORT_BUILDER_H
@@ -5,17 +5,28 @@
 #include "freertos/timers.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "nvs_flash.h"
 #include "cJSON.h"
 
 #include "hid_device.h"
 #include "ble_hid.h"
+#include "ble_conn_params.h"
+#include "hid_metrics.h"
+#include "ble_reconnect.h"
+#include "task_stats.h"
+#include "status_publisher.h"
+#include "json_out.h"
+#include "task_topology.h"
 #include "transport_uart.h"
 #include "transport_ws.h"
+#include "transport_http.h"
 #include "wifi_credentials.h"
 #include "wifi_manager.h"
 #include "http_server.h"
 #include "mouse_report_builder.h"
+#include "hid_input_state.h"
 
 static const char *TAG = "MAIN";
 
@@ -31,6 +42,7 @@ static struct
     mouse_state_t mouse;
     keyboard_state_t keyboard;
     consumer_state_t consumer;
+    pointer_abs_state_t pointer;
     bool mouse_hold;
     bool wheel_hold;
     bool hwheel_hold;
@@ -226,75 +238,335 @@ static void populate_wifi_status_json(cJSON *obj)
             cJSON_AddItemToObject(obj, "sta", sta);
         }
     }
+
+    // The MACs never change; look them up once
+    static char mac_ap[18];
+    static char mac_sta[18];
+    if (!mac_ap[0] && wifi_manager_get_mac_str(WIFI_IF_AP, mac_ap, sizeof(mac_ap)) != ESP_OK)
+    {
+        mac_ap[0] = '\0';
+    }
+    if (!mac_sta[0] && wifi_manager_get_mac_str(WIFI_IF_STA, mac_sta, sizeof(mac_sta)) != ESP_OK)
+    {
+        mac_sta[0] = '\0';
+    }
+    if (mac_ap[0])
+    {
+        cJSON_AddStringToObject(obj, "mac_ap", mac_ap);
+    }
+    if (mac_sta[0])
+    {
+        cJSON_AddStringToObject(obj, "mac_sta", mac_sta);
+    }
 }
 
 static void notify_wifi_status(void)
 {
-    http_server_publish_wifi_status();
+    status_publisher_mark(STATUS_TOPIC_WIFI);
+}
 
-    cJSON *msg = cJSON_CreateObject();
-    if (!msg)
+// Addresses are shown most significant byte first, "AA:BB:CC:DD:EE:FF"
+static void format_ble_addr(char out[18], const uint8_t addr[6])
+{
+    snprintf(out, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
+             addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+}
+
+static bool parse_ble_addr(const char *text, uint8_t addr[6])
+{
+    int consumed = 0;
+    return sscanf(text, "%2hhx:%2hhx:%2hhx:%2hhx:%2hhx:%2hhx%n",
+                  &addr[0], &addr[1], &addr[2], &addr[3], &addr[4], &addr[5], &consumed) == 6 &&
+           consumed == 17 && text[consumed] == '\0';
+}
+
+static void populate_ble_connection_json(cJSON *json, const ble_connection_info_t *info)
+{
+    cJSON_AddBoolToObject(json, "connected", info->connected);
+    cJSON_AddBoolToObject(json, "bonded", info->bonded);
+    cJSON_AddBoolToObject(json, "encrypted", info->encrypted);
+    cJSON_AddBoolToObject(json, "authenticated", info->authenticated);
+    cJSON_AddNumberToObject(json, "addr_type", info->peer_addr_type);
+
+    char addr_str[18] = "-";
+    bool has_addr = false;
+    for (int i = 0; i < 6; ++i)
     {
-        return;
+        if (info->peer_addr[i] != 0)
+        {
+            has_addr = true;
+            break;
+        }
     }
+    if (has_addr)
+    {
+        format_ble_addr(addr_str, info->peer_addr);
+    }
+    cJSON_AddStringToObject(json, "peer_addr", addr_str);
 
-    cJSON_AddStringToObject(msg, "type", "wifi_status");
-    populate_wifi_status_json(msg);
-
-    char *payload = cJSON_PrintUnformatted(msg);
-    if (payload)
+    if (info->connected)
     {
-        transport_uart_send(payload);
-        free(payload);
+        cJSON_AddNumberToObject(json, "conn_handle", info->conn_handle);
+        cJSON_AddNumberToObject(json, "conn_interval_ms", info->conn_interval * 1.25);
+        cJSON_AddNumberToObject(json, "conn_latency", info->conn_latency);
+        cJSON_AddNumberToObject(json, "supervision_timeout_ms", info->supervision_timeout * 10);
+        cJSON_AddStringToObject(json, "conn_profile",
+                                ble_conn_params_profile_name((ble_conn_profile_t)info->conn_profile));
+        cJSON_AddStringToObject(json, "tx_phy", ble_conn_params_phy_name(info->tx_phy));
+        cJSON_AddStringToObject(json, "rx_phy", ble_conn_params_phy_name(info->rx_phy));
+        cJSON_AddNumberToObject(json, "max_tx_octets", info->max_tx_octets);
+        cJSON_AddNumberToObject(json, "max_rx_octets", info->max_rx_octets);
+        cJSON_AddStringToObject(json, "protocol_mode", info->protocol_mode == 0 ? "boot" : "report");
+        cJSON_AddNumberToObject(json, "keyboard_leds", info->keyboard_leds);
+        cJSON_AddBoolToObject(json, "routed", info->routed);
+        cJSON_AddNumberToObject(json, "queued", info->queued);
+        cJSON_AddNumberToObject(json, "dropped", info->dropped);
+        cJSON_AddNumberToObject(json, "congested", info->congested);
     }
+}
 
-    cJSON_Delete(msg);
+static void add_ble_route_json(cJSON *json)
+{
+    uint16_t route = ble_hid_get_route();
+    if (route == BLE_HID_ROUTE_ALL)
+    {
+        cJSON_AddStringToObject(json, "route", "all");
+    }
+    else
+    {
+        cJSON_AddNumberToObject(json, "route", route);
+    }
 }
 
-static void broadcast_ble_status(void)
+// Top-level fields describe the primary host so single-host clients keep
+// working; "connections" lists every host.
+static void populate_ble_status_json(cJSON *json)
 {
     ble_connection_info_t info = {0};
     ble_hid_get_connection_info(&info);
 
-    cJSON *json = cJSON_CreateObject();
-    if (!json)
+    populate_ble_connection_json(json, &info);
+    add_ble_route_json(json);
+    cJSON_AddNumberToObject(json, "max_connections", BLE_HID_MAX_CONNECTIONS);
+    cJSON_AddStringToObject(json, "adv_phase", ble_adv_phase_name(ble_reconnect_phase()));
+
+    ble_connection_info_t hosts[BLE_HID_MAX_CONNECTIONS];
+    size_t host_count = ble_hid_get_connections(hosts, BLE_HID_MAX_CONNECTIONS);
+    cJSON *connections = cJSON_CreateArray();
+    if (connections)
+    {
+        for (size_t i = 0; i < host_count; ++i)
+        {
+            cJSON *host = cJSON_CreateObject();
+            if (host)
+            {
+                populate_ble_connection_json(host, &hosts[i]);
+                cJSON_AddItemToArray(connections, host);
+            }
+        }
+        cJSON_AddItemToObject(json, "connections", connections);
+    }
+}
+
+static void broadcast_ble_status(void)
+{
+    status_publisher_mark(STATUS_TOPIC_BLE);
+}
+
+static void send_status_message(const char *payload)
+{
+    transport_uart_send(payload);
+    transport_websocket_send(payload);
+}
+
+static cJSON *create_counter_array(const uint32_t *values, size_t count)
+{
+    cJSON *array = cJSON_CreateArray();
+    for (size_t i = 0; array && i < count; ++i)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(values[i]));
+    }
+    return array;
+}
+
+static void populate_stats_json(cJSON *json, const hid_metrics_snapshot_t *snapshot)
+{
+    cJSON_AddNumberToObject(json, "since_reset_ms", (double)(snapshot->since_reset_us / 1000));
+
+    // Upper bound of each latency bucket; the last one is open-ended.
+    uint32_t bounds[HID_METRICS_LATENCY_BUCKETS - 1];
+    for (size_t i = 0; i < HID_METRICS_LATENCY_BUCKETS - 1; ++i)
+    {
+        bounds[i] = (uint32_t)HID_METRICS_LATENCY_FIRST_US << i;
+    }
+    cJSON_AddItemToObject(json, "latency_buckets_us", create_counter_array(bounds, HID_METRICS_LATENCY_BUCKETS - 1));
+
+    cJSON *reports = cJSON_CreateObject();
+    if (!reports)
     {
         return;
     }
 
-    cJSON_AddStringToObject(json, "type", "ble_status");
-    cJSON_AddBoolToObject(json, "connected", info.connected);
-    cJSON_AddBoolToObject(json, "bonded", info.bonded);
-    cJSON_AddBoolToObject(json, "encrypted", info.encrypted);
-    cJSON_AddBoolToObject(json, "authenticated", info.authenticated);
-    cJSON_AddNumberToObject(json, "addr_type", info.peer_addr_type);
+    // Report types that never went out are left out to keep the reply short
+    for (size_t t = 0; t < HID_METRICS_REPORT_COUNT; ++t)
+    {
+        const hid_metrics_counters_t *c = &snapshot->reports[t];
+        if (c->attempts == 0 && c->dropped == 0)
+        {
+            continue;
+        }
 
-    char addr_str[18] = "-";
-    bool has_addr = false;
-    for (int i = 0; i < 6; ++i)
+        cJSON *report = cJSON_CreateObject();
+        if (!report)
+        {
+            continue;
+        }
+        cJSON_AddNumberToObject(report, "attempts", c->attempts);
+        cJSON_AddNumberToObject(report, "sent", c->sent);
+        cJSON_AddNumberToObject(report, "bytes", c->bytes);
+        cJSON_AddNumberToObject(report, "enomem_alloc", c->enomem_alloc);
+        cJSON_AddNumberToObject(report, "enomem_notify", c->enomem_notify);
+        cJSON_AddNumberToObject(report, "enomem_rate", hid_metrics_enomem_rate_bp(c) / 100.0);
+        cJSON_AddNumberToObject(report, "dropped", c->dropped);
+        cJSON_AddItemToObject(report, "queue_latency", create_counter_array(c->queue_latency, HID_METRICS_LATENCY_BUCKETS));
+        cJSON_AddItemToObject(report, "tx_latency", create_counter_array(c->tx_latency, HID_METRICS_LATENCY_BUCKETS));
+        cJSON_AddItemToObject(report, "retries", create_counter_array(c->retries, HID_METRICS_RETRY_BUCKETS));
+        cJSON_AddItemToObject(reports, hid_metrics_report_name((hid_metrics_report_t)t), report);
+    }
+    cJSON_AddItemToObject(json, "reports", reports);
+}
+
+static void populate_bonds_json(cJSON *json)
+{
+    ble_bond_info_t bonds[BLE_HID_MAX_BONDS];
+    size_t count = ble_hid_get_bonds(bonds, BLE_HID_MAX_BONDS);
+
+    cJSON_AddNumberToObject(json, "max_bonds", BLE_HID_MAX_BONDS);
+    cJSON *array = cJSON_CreateArray();
+    if (!array)
     {
-        if (info.peer_addr[i] != 0)
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    for (size_t i = 0; i < count; ++i)
+    {
+        cJSON *item = cJSON_CreateObject();
+        if (!item)
         {
-            has_addr = true;
-            break;
+            continue;
         }
+        char addr_str[18];
+        format_ble_addr(addr_str, bonds[i].addr);
+        cJSON_AddStringToObject(item, "addr", addr_str);
+        cJSON_AddNumberToObject(item, "addr_type", bonds[i].addr_type);
+        cJSON_AddBoolToObject(item, "connected", bonds[i].connected);
+        if (bonds[i].connected)
+        {
+            cJSON_AddNumberToObject(item, "conn_handle", bonds[i].conn_handle);
+        }
+        cJSON_AddBoolToObject(item, "selected", bonds[i].selected);
+        // Seconds since the host last connected; absent if not since boot
+        if (bonds[i].last_seen_us > 0)
+        {
+            cJSON_AddNumberToObject(item, "last_seen_s", (double)((now_us - bonds[i].last_seen_us) / 1000000));
+        }
+        cJSON_AddItemToArray(array, item);
     }
-    if (has_addr)
+    cJSON_AddItemToObject(json, "bonds", array);
+}
+
+// The host a bond_forget or bond_select names: "addr" as listed by
+// bonds_list, "addr_type" only needed if two bonds share the address bytes
+static bool parse_bond_target(const cJSON *msg, uint8_t *addr_type, uint8_t addr[6])
+{
+    cJSON *addr_item = cJSON_GetObjectItem(msg, "addr");
+    cJSON *type_item = cJSON_GetObjectItem(msg, "addr_type");
+    if (!addr_item || !cJSON_IsString(addr_item) || !parse_ble_addr(addr_item->valuestring, addr))
     {
-        snprintf(addr_str, sizeof(addr_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                 info.peer_addr[0], info.peer_addr[1], info.peer_addr[2],
-                 info.peer_addr[3], info.peer_addr[4], info.peer_addr[5]);
+        return false;
     }
-    cJSON_AddStringToObject(json, "peer_addr", addr_str);
+    *addr_type = BLE_HID_ADDR_TYPE_ANY;
+    if (type_item)
+    {
+        if (!cJSON_IsNumber(type_item) || type_item->valueint < 0 || type_item->valueint >= BLE_HID_ADDR_TYPE_ANY)
+        {
+            return false;
+        }
+        *addr_type = (uint8_t)type_item->valueint;
+    }
+    return true;
+}
 
-    char *payload = cJSON_PrintUnformatted(json);
-    if (payload)
+static void populate_reconnect_json(cJSON *json)
+{
+    ble_reconnect_config_t config;
+    ble_reconnect_get_config(&config);
+    cJSON_AddNumberToObject(json, "directed_ms", config.directed_ms);
+    cJSON_AddNumberToObject(json, "accept_list_ms", config.accept_list_ms);
+    cJSON_AddNumberToObject(json, "fast_ms", config.fast_ms);
+    cJSON_AddNumberToObject(json, "slow_ms", config.slow_ms);
+    cJSON_AddStringToObject(json, "phase", ble_adv_phase_name(ble_reconnect_phase()));
+
+    ble_reconnect_stats_t stats;
+    ble_reconnect_get_stats(&stats);
+    cJSON_AddNumberToObject(json, "attempts", stats.attempts);
+    cJSON_AddNumberToObject(json, "reconnects", stats.reconnects);
+    cJSON_AddNumberToObject(json, "expired", stats.expired);
+    cJSON_AddNumberToObject(json, "last_ms", stats.last_ms);
+    cJSON_AddNumberToObject(json, "min_ms", stats.min_ms);
+    cJSON_AddNumberToObject(json, "max_ms", stats.max_ms);
+    cJSON_AddNumberToObject(json, "mean_ms", stats.reconnects ? (double)(stats.total_ms / stats.reconnects) : 0);
+
+    static const uint32_t bounds[BLE_RECONNECT_BUCKETS - 1] = {250, 500, 1000, 2000, 5000, 10000, 30000};
+    cJSON_AddItemToObject(json, "buckets_ms", create_counter_array(bounds, BLE_RECONNECT_BUCKETS - 1));
+    cJSON_AddItemToObject(json, "histogram", create_counter_array(stats.buckets, BLE_RECONNECT_BUCKETS));
+
+    cJSON *by_phase = cJSON_CreateObject();
+    if (by_phase)
     {
-        transport_uart_send(payload);
-        transport_websocket_send(payload);
-        free(payload);
+        for (size_t p = BLE_ADV_PHASE_DIRECTED; p < BLE_ADV_PHASE_OFF; ++p)
+        {
+            cJSON_AddNumberToObject(by_phase, ble_adv_phase_name((ble_adv_phase_t)p), stats.by_phase[p]);
+        }
+        cJSON_AddItemToObject(json, "by_phase", by_phase);
     }
-    cJSON_Delete(json);
+}
+
+static void populate_task_stats_json(cJSON *json, const task_stats_t *stats)
+{
+    cJSON_AddNumberToObject(json, "window_ms", stats->window_us / 1000);
+    cJSON_AddNumberToObject(json, "ble_core", TASK_CORE_BLE);
+    cJSON_AddNumberToObject(json, "net_core", TASK_CORE_NET);
+    cJSON_AddNumberToObject(json, "dropped", stats->dropped);
+
+    cJSON *tasks = cJSON_CreateArray();
+    if (!tasks)
+    {
+        return;
+    }
+    for (size_t i = 0; i < stats->count; ++i)
+    {
+        const task_stats_entry_t *entry = &stats->tasks[i];
+        cJSON *task = cJSON_CreateObject();
+        if (!task)
+        {
+            continue;
+        }
+        cJSON_AddStringToObject(task, "name", entry->name);
+        cJSON_AddNumberToObject(task, "priority", entry->priority);
+        if (entry->core == TASK_STATS_NO_CORE)
+        {
+            cJSON_AddNullToObject(task, "core");
+        }
+        else
+        {
+            cJSON_AddNumberToObject(task, "core", entry->core);
+        }
+        cJSON_AddNumberToObject(task, "cpu", entry->cpu_permille / 10.0);
+        cJSON_AddNumberToObject(task, "stack_free", entry->stack_free);
+        cJSON_AddItemToArray(tasks, task);
+    }
+    cJSON_AddItemToObject(json, "tasks", tasks);
 }
 
 static void device_state_changed(hid_device_state_t state)
@@ -317,7 +589,12 @@ static void device_state_changed(hid_device_state_t state)
     }
     ESP_LOGI(TAG, "Device state changed: %s", state_str);
 
-    if (state == DEVICE_STATE_IDLE && g_advertising_enabled)
+    // Keep advertising while connected so further hosts can join, until
+    // every connection slot is taken. A finished schedule waits for input
+    // (wake_advertising) instead.
+    if ((state == DEVICE_STATE_IDLE ||
+         (state == DEVICE_STATE_CONNECTED && ble_hid_connection_count() < BLE_HID_MAX_CONNECTIONS)) &&
+        g_advertising_enabled && ble_reconnect_phase() != BLE_ADV_PHASE_OFF)
     {
         esp_err_t err = hid_device_start_advertising(g_device);
         if (err != ESP_OK)
@@ -332,81 +609,81 @@ static void device_state_changed(hid_device_state_t state)
     cJSON_AddStringToObject(json, "state", state_str);
     cJSON_AddBoolToObject(json, "bonded", hid_device_is_bonded(g_device));
 
-    char *json_str = cJSON_PrintUnformatted(json);
+    json_out_t out;
+    const char *json_str = json_out_print(json, &out);
     if (json_str)
     {
         transport_uart_send(json_str);
         transport_websocket_send(json_str);
-        free(json_str);
+        json_out_release(&out);
     }
     cJSON_Delete(json);
 
     broadcast_ble_status();
 }
 
-static void on_mouse_input(const mouse_state_t *state)
+#ifndef NDEBUG
+static int16_t clamp_report_axis(int16_t value, int16_t min, int16_t max)
 {
-    if (!state)
-        return;
+    return value < min ? min : (value > max ? max : value);
+}
 
+static void validate_mouse_report(const mouse_state_t *state)
+{
     uint8_t hid_report[HID_MOUSE_REPORT_LEN] = {0};
-    mouse_build_report(state, hid_report);
+    mouse_build_report(state, NULL, hid_report);
 
-    int8_t report_x = (int8_t)hid_report[2];
-    int8_t report_y = (int8_t)hid_report[3];
+    int8_t report_x = (int8_t)hid_report[HID_MOUSE_INPUT_X_OFFSET];
+    int8_t report_y = (int8_t)hid_report[HID_MOUSE_INPUT_Y_OFFSET];
+    int16_t expected_x = clamp_report_axis(state->x, HID_MOUSE_INPUT_X_LOGICAL_MIN, HID_MOUSE_INPUT_X_LOGICAL_MAX);
+    int16_t expected_y = clamp_report_axis(state->y, HID_MOUSE_INPUT_Y_LOGICAL_MIN, HID_MOUSE_INPUT_Y_LOGICAL_MAX);
     uint8_t masked_buttons = state->buttons & HID_MOUSE_BUTTON_MASK;
-    uint8_t report_buttons = hid_report[1] & HID_MOUSE_BUTTON_MASK;
-
-    ESP_LOGD(TAG,
-             "Mouse input state: x=%d y=%d buttons=0x%02X -> report x=%d y=%d buttons=0x%02X",
-             state->x,
-             state->y,
-             state->buttons,
-             report_x,
-             report_y,
-             report_buttons);
+    uint8_t report_buttons = hid_report[HID_MOUSE_INPUT_BUTTONS_OFFSET] & HID_MOUSE_BUTTON_MASK;
 
-    if (report_x != state->x || report_y != state->y || report_buttons != masked_buttons)
+    if (report_x != expected_x || report_y != expected_y || report_buttons != masked_buttons)
     {
         ESP_LOGW(TAG,
                  "Mouse report mismatch: expected x=%d y=%d buttons=0x%02X (masked)",
-                 state->x,
-                 state->y,
+                 expected_x,
+                 expected_y,
                  masked_buttons);
     }
+}
+#else
+#define validate_mouse_report(state) ((void)(state))
+#endif
 
-    bool changed = false;
-
-    if (state->x != g_remote_state.mouse.x || state->y != g_remote_state.mouse.y)
+// Input on any transport restarts advertising once its schedule has run
+// out, so an unattended device keeps its radio quiet until it is used.
+static void wake_advertising(void)
+{
+    if (g_advertising_enabled && g_device && ble_reconnect_phase() == BLE_ADV_PHASE_OFF)
     {
-        g_remote_state.mouse.x = state->x;
-        g_remote_state.mouse.y = state->y;
-        changed = true;
+        ESP_LOGI(TAG, "Input activity; restarting advertising");
+        esp_err_t err = hid_device_start_advertising(g_device);
+        if (err != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Failed to start advertising: %s", esp_err_to_name(err));
+        }
     }
+}
 
-    if (state->wheel != g_remote_state.mouse.wheel)
-    {
-        g_remote_state.mouse.wheel = state->wheel;
-        changed = true;
-    }
+static void on_mouse_input(const mouse_state_t *state)
+{
+    if (!state)
+        return;
 
-    if (state->hwheel != g_remote_state.mouse.hwheel)
-    {
-        g_remote_state.mouse.hwheel = state->hwheel;
-        changed = true;
-    }
+    wake_advertising();
 
-    if (state->buttons != g_remote_state.mouse.buttons)
+    // The report itself is built once, directly into the notification buffer
+    // in ble_hid.c; here we only track which fields moved.
+    if (hid_mouse_merge(&g_remote_state.mouse, state) == 0)
     {
-        g_remote_state.mouse.buttons = state->buttons;
-        changed = true;
+        return;
     }
 
-    if (changed)
-    {
-        hid_device_set_mouse_state(g_device, &g_remote_state.mouse);
-        hid_device_request_notify(g_device, true, false, false);
-    }
+    validate_mouse_report(&g_remote_state.mouse);
+    hid_device_set_mouse_state(g_device, &g_remote_state.mouse);
 }
 
 static void on_keyboard_input(const keyboard_state_t *state)
@@ -414,25 +691,14 @@ static void on_keyboard_input(const keyboard_state_t *state)
     if (!state)
         return;
 
-    bool changed = false;
-
-    if (state->modifiers != g_remote_state.keyboard.modifiers)
-    {
-        g_remote_state.keyboard.modifiers = state->modifiers;
-        changed = true;
-    }
+    wake_advertising();
 
-    if (memcmp(state->keys, g_remote_state.keyboard.keys, 6) != 0)
+    if (hid_keyboard_merge(&g_remote_state.keyboard, state) == 0)
     {
-        memcpy(g_remote_state.keyboard.keys, state->keys, 6);
-        changed = true;
+        return;
     }
 
-    if (changed)
-    {
-        hid_device_set_keyboard_state(g_device, &g_remote_state.keyboard);
-        hid_device_request_notify(g_device, false, true, false);
-    }
+    hid_device_set_keyboard_state(g_device, &g_remote_state.keyboard);
 }
 
 static void on_consumer_input(const consumer_state_t *state)
@@ -440,6 +706,8 @@ static void on_consumer_input(const consumer_state_t *state)
     if (!state || !g_device)
         return;
 
+    wake_advertising();
+
     consumer_state_t normalized = *state;
 
     uint16_t raw_usage = normalized.usage;
@@ -465,13 +733,29 @@ static void on_consumer_input(const consumer_state_t *state)
         g_remote_state.consumer.usage = 0;
         g_remote_state.consumer.hold = false;
         hid_device_set_consumer_state(g_device, &g_remote_state.consumer);
-        hid_device_request_notify(g_device, false, false, true);
         return;
     }
 
     g_remote_state.consumer = normalized;
     hid_device_set_consumer_state(g_device, &g_remote_state.consumer);
-    hid_device_request_notify(g_device, false, false, true);
+}
+
+static void on_pointer_abs_input(const pointer_abs_state_t *state)
+{
+    if (!state || !g_device)
+        return;
+
+    wake_advertising();
+
+    if (g_remote_state.pointer.x == state->x &&
+        g_remote_state.pointer.y == state->y &&
+        g_remote_state.pointer.buttons == state->buttons)
+    {
+        return;
+    }
+
+    g_remote_state.pointer = *state;
+    hid_device_set_pointer_state(g_device, &g_remote_state.pointer);
 }
 
 static void send_control_response(cJSON *response)
@@ -479,24 +763,25 @@ static void send_control_response(cJSON *response)
     if (!response)
         return;
 
-    char *json_str = cJSON_PrintUnformatted(response);
+    json_out_t out;
+    const char *json_str = json_out_print(response, &out);
     if (json_str)
     {
         transport_uart_send(json_str);
         transport_websocket_send(json_str);
-        free(json_str);
+        json_out_release(&out);
     }
 }
 
-static void on_control_message(cJSON *msg)
+static cJSON *handle_control_message(cJSON *msg)
 {
     if (!msg)
-        return;
+        return NULL;
 
     cJSON *cmd_item = cJSON_GetObjectItem(msg, "cmd");
     if (!cmd_item || !cJSON_IsString(cmd_item))
     {
-        return;
+        return NULL;
     }
 
     const char *cmd = cmd_item->valuestring;
@@ -539,6 +824,297 @@ static void on_control_message(cJSON *msg)
             cJSON_AddStringToObject(response, "err", esp_err_to_name(err));
         }
     }
+    else if (strcmp(cmd, "bonds_list") == 0)
+    {
+        cJSON_AddBoolToObject(response, "ok", true);
+        populate_bonds_json(response);
+    }
+    else if (strcmp(cmd, "bond_forget") == 0 || strcmp(cmd, "bond_select") == 0)
+    {
+        bool select = strcmp(cmd, "bond_select") == 0;
+        uint8_t addr_type;
+        uint8_t addr[6];
+        esp_err_t err = ESP_ERR_INVALID_ARG;
+        if (parse_bond_target(msg, &addr_type, addr))
+        {
+            if (select)
+            {
+                // Selecting a host is asking for it to reconnect
+                g_advertising_enabled = true;
+                err = ble_hid_select_bond(addr_type, addr);
+            }
+            else
+            {
+                err = ble_hid_forget_bond(addr_type, addr);
+            }
+        }
+
+        cJSON_AddBoolToObject(response, "ok", err == ESP_OK);
+        if (err != ESP_OK)
+        {
+            cJSON_AddStringToObject(response, "err",
+                                    err == ESP_ERR_INVALID_ARG  ? "invalid_addr"
+                                    : err == ESP_ERR_NOT_FOUND ? "unknown_bond"
+                                                               : esp_err_to_name(err));
+        }
+        populate_bonds_json(response);
+        if (err == ESP_OK)
+        {
+            broadcast_ble_status();
+        }
+    }
+    else if (strcmp(cmd, "conn_stats") == 0)
+    {
+        ble_conn_params_stats_t stats;
+        ble_conn_params_get_stats(&stats);
+
+        cJSON_AddBoolToObject(response, "ok", true);
+        cJSON_AddStringToObject(response, "profile",
+                                ble_conn_params_profile_name(ble_conn_params_get_profile(ble_hid_get_conn_handle())));
+        cJSON_AddNumberToObject(response, "requests", stats.requests);
+        cJSON_AddNumberToObject(response, "accepts", stats.accepts);
+        cJSON_AddNumberToObject(response, "rejects", stats.rejects);
+        cJSON_AddNumberToObject(response, "peer_updates", stats.peer_updates);
+        cJSON_AddNumberToObject(response, "deferred", stats.deferred);
+        cJSON_AddNumberToObject(response, "active_ms", (double)stats.time_ms[BLE_CONN_PROFILE_ACTIVE]);
+        cJSON_AddNumberToObject(response, "idle_ms", (double)stats.time_ms[BLE_CONN_PROFILE_IDLE]);
+        cJSON_AddNumberToObject(response, "unmanaged_ms", (double)stats.time_ms[BLE_CONN_PROFILE_NONE]);
+    }
+    else if (strcmp(cmd, "stats") == 0)
+    {
+        // "reset":true returns the counters and starts a new capture window
+        cJSON *reset_item = cJSON_GetObjectItem(msg, "reset");
+        bool reset = reset_item && cJSON_IsTrue(reset_item);
+        hid_metrics_snapshot_t *snapshot = malloc(sizeof(*snapshot));
+        if (snapshot)
+        {
+            if (reset)
+            {
+                hid_metrics_reset(snapshot);
+            }
+            else
+            {
+                hid_metrics_snapshot(snapshot);
+            }
+            cJSON_AddBoolToObject(response, "ok", true);
+            cJSON_AddBoolToObject(response, "reset", reset);
+            populate_stats_json(response, snapshot);
+            free(snapshot);
+        }
+        else
+        {
+            cJSON_AddBoolToObject(response, "ok", false);
+            cJSON_AddStringToObject(response, "err", esp_err_to_name(ESP_ERR_NO_MEM));
+        }
+    }
+    else if (strcmp(cmd, "status_snapshot") == 0)
+    {
+        // Every topic follows in full, with the publisher's counters here
+        status_publisher_request_snapshot();
+
+        status_publisher_stats_t stats;
+        status_publisher_get_stats(&stats);
+        cJSON_AddBoolToObject(response, "ok", true);
+        cJSON_AddNumberToObject(response, "wifi_version", stats.versions[STATUS_TOPIC_WIFI]);
+        cJSON_AddNumberToObject(response, "ble_version", stats.versions[STATUS_TOPIC_BLE]);
+        cJSON_AddNumberToObject(response, "marks", stats.marks);
+        cJSON_AddNumberToObject(response, "builds", stats.builds);
+        cJSON_AddNumberToObject(response, "deltas", stats.deltas);
+        cJSON_AddNumberToObject(response, "snapshots", stats.snapshots);
+        cJSON_AddNumberToObject(response, "unchanged", stats.unchanged);
+        cJSON_AddNumberToObject(response, "bytes", stats.bytes);
+    }
+    else if (strcmp(cmd, "heap") == 0)
+    {
+        // min_free is the low-water mark since boot; a largest_block well
+        // below free means the heap is fragmented
+        json_out_stats_t json;
+        json_out_get_stats(&json);
+        cJSON_AddBoolToObject(response, "ok", true);
+        cJSON_AddNumberToObject(response, "free", heap_caps_get_free_size(MALLOC_CAP_8BIT));
+        cJSON_AddNumberToObject(response, "min_free", heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+        cJSON_AddNumberToObject(response, "largest_block", heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+        cJSON *json_obj = cJSON_CreateObject();
+        if (json_obj)
+        {
+            cJSON_AddNumberToObject(json_obj, "prints", json.prints);
+            cJSON_AddNumberToObject(json_obj, "buffered", json.buffered);
+            cJSON_AddNumberToObject(json_obj, "busy", json.busy);
+            cJSON_AddNumberToObject(json_obj, "overflow", json.overflow);
+            cJSON_AddNumberToObject(json_obj, "failed", json.failed);
+            cJSON_AddNumberToObject(json_obj, "largest", json.largest);
+            cJSON_AddItemToObject(response, "json", json_obj);
+        }
+    }
+    else if (strcmp(cmd, "http_input") == 0)
+    {
+        // Totals for POST /api/input and /api/type since boot
+        transport_http_stats_t stats;
+        transport_http_get_stats(&stats);
+        cJSON_AddBoolToObject(response, "ok", true);
+        cJSON_AddNumberToObject(response, "batches", stats.batches);
+        cJSON_AddNumberToObject(response, "events", stats.events);
+        cJSON_AddNumberToObject(response, "rejected", stats.rejected);
+        cJSON_AddNumberToObject(response, "dropped", stats.dropped);
+        cJSON_AddNumberToObject(response, "bytes", (double)stats.bytes);
+        cJSON_AddNumberToObject(response, "busy_us", (double)stats.busy_us);
+        cJSON_AddNumberToObject(response, "last_events_per_s", stats.last_events_per_s);
+        cJSON_AddNumberToObject(response, "peak_events_per_s", stats.peak_events_per_s);
+        cJSON_AddNumberToObject(response, "type_requests", stats.type_requests);
+        cJSON_AddNumberToObject(response, "typed", stats.typed);
+    }
+    else if (strcmp(cmd, "tasks") == 0)
+    {
+        // CPU shares cover the time since the previous "tasks" command
+        task_stats_t *stats = malloc(sizeof(*stats));
+        esp_err_t err = stats ? task_stats_sample(stats) : ESP_ERR_NO_MEM;
+        cJSON_AddBoolToObject(response, "ok", err == ESP_OK);
+        if (err == ESP_OK)
+        {
+            populate_task_stats_json(response, stats);
+        }
+        else
+        {
+            cJSON_AddStringToObject(response, "err", esp_err_to_name(err));
+        }
+        free(stats);
+    }
+    else if (strcmp(cmd, "reconnect") == 0)
+    {
+        // "directed_ms", "accept_list_ms", "fast_ms" and "slow_ms" change the
+        // phase lengths for the next schedule; "reset":true clears the
+        // time-to-reconnect stats
+        ble_reconnect_config_t config;
+        ble_reconnect_get_config(&config);
+        struct
+        {
+            const char *key;
+            uint32_t *value;
+        } durations[] = {
+            {"directed_ms", &config.directed_ms},
+            {"accept_list_ms", &config.accept_list_ms},
+            {"fast_ms", &config.fast_ms},
+            {"slow_ms", &config.slow_ms},
+        };
+        cJSON *reset_item = cJSON_GetObjectItem(msg, "reset");
+        bool valid = true;
+        bool changed = false;
+        for (size_t i = 0; i < sizeof(durations) / sizeof(durations[0]) && valid; ++i)
+        {
+            cJSON *item = cJSON_GetObjectItem(msg, durations[i].key);
+            if (!item)
+            {
+                continue;
+            }
+            // Range checked again by ble_reconnect_set_config
+            valid = cJSON_IsNumber(item) && item->valuedouble >= 0 &&
+                    item->valuedouble <= BLE_RECONNECT_SLOW_MS_MAX;
+            if (valid)
+            {
+                *durations[i].value = (uint32_t)item->valuedouble;
+                changed = true;
+            }
+        }
+        if (valid && changed)
+        {
+            valid = ble_reconnect_set_config(&config);
+        }
+        if (valid && reset_item && cJSON_IsTrue(reset_item))
+        {
+            ble_reconnect_reset_stats();
+        }
+
+        cJSON_AddBoolToObject(response, "ok", valid);
+        if (!valid)
+        {
+            cJSON_AddStringToObject(response, "err", "invalid_duration");
+        }
+        populate_reconnect_json(response);
+    }
+    else if (strcmp(cmd, "route") == 0)
+    {
+        // "conn" selects one host by connection handle, "all" broadcasts;
+        // without it the current route is returned.
+        cJSON *conn_item = cJSON_GetObjectItem(msg, "conn");
+        esp_err_t err = ESP_OK;
+        if (conn_item && cJSON_IsString(conn_item) && strcmp(conn_item->valuestring, "all") == 0)
+        {
+            err = ble_hid_set_route(BLE_HID_ROUTE_ALL);
+        }
+        else if (conn_item && cJSON_IsNumber(conn_item) &&
+                 conn_item->valueint >= 0 && conn_item->valueint < BLE_HID_ROUTE_ALL)
+        {
+            err = ble_hid_set_route((uint16_t)conn_item->valueint);
+        }
+        else if (conn_item)
+        {
+            err = ESP_ERR_INVALID_ARG;
+        }
+
+        cJSON_AddBoolToObject(response, "ok", err == ESP_OK);
+        if (err != ESP_OK)
+        {
+            cJSON_AddStringToObject(response, "err", err == ESP_ERR_NOT_FOUND ? "unknown_conn" : "invalid_conn");
+        }
+        add_ble_route_json(response);
+        if (err == ESP_OK && conn_item)
+        {
+            broadcast_ble_status();
+        }
+    }
+    else if (strcmp(cmd, "mouse_mode") == 0)
+    {
+        cJSON *mode_item = cJSON_GetObjectItem(msg, "mode");
+        if (mode_item && cJSON_IsString(mode_item))
+        {
+            if (strcmp(mode_item->valuestring, "high_resolution") == 0)
+            {
+                ble_hid_set_mouse_high_resolution(true);
+            }
+            else if (strcmp(mode_item->valuestring, "legacy") == 0)
+            {
+                ble_hid_set_mouse_high_resolution(false);
+            }
+            else
+            {
+                cJSON_AddBoolToObject(response, "ok", false);
+                cJSON_AddStringToObject(response, "err", "invalid_mode");
+            }
+        }
+
+        if (!cJSON_GetObjectItem(response, "ok"))
+        {
+            cJSON_AddBoolToObject(response, "ok", true);
+        }
+        cJSON_AddStringToObject(response, "mode",
+                                ble_hid_get_mouse_high_resolution() ? "high_resolution" : "legacy");
+    }
+    else if (strcmp(cmd, "keyboard_mode") == 0)
+    {
+        cJSON *mode_item = cJSON_GetObjectItem(msg, "mode");
+        if (mode_item && cJSON_IsString(mode_item))
+        {
+            if (strcmp(mode_item->valuestring, "nkro") == 0)
+            {
+                ble_hid_set_keyboard_nkro(true);
+            }
+            else if (strcmp(mode_item->valuestring, "6kro") == 0)
+            {
+                ble_hid_set_keyboard_nkro(false);
+            }
+            else
+            {
+                cJSON_AddBoolToObject(response, "ok", false);
+                cJSON_AddStringToObject(response, "err", "invalid_mode");
+            }
+        }
+
+        if (!cJSON_GetObjectItem(response, "ok"))
+        {
+            cJSON_AddBoolToObject(response, "ok", true);
+        }
+        cJSON_AddStringToObject(response, "mode", ble_hid_get_keyboard_nkro() ? "nkro" : "6kro");
+    }
     else if (strcmp(cmd, "wifi_get") == 0)
     {
         cJSON *wifi_obj = cJSON_CreateObject();
@@ -661,6 +1237,11 @@ static void on_control_message(cJSON *msg)
     }
     else if (strcmp(cmd, "wifi_scan") == 0)
     {
+        // Results are sorted by RSSI and one entry kept per SSID unless
+        // "sort":false / "dedup":false
+        cJSON *sort_item = cJSON_GetObjectItem(msg, "sort");
+        cJSON *dedup_item = cJSON_GetObjectItem(msg, "dedup");
+        http_server_set_scan_options(!cJSON_IsFalse(sort_item), !cJSON_IsFalse(dedup_item));
         esp_err_t err = wifi_manager_start_scan(http_server_publish_scan_results);
         cJSON_AddBoolToObject(response, "ok", err == ESP_OK);
         if (err != ESP_OK)
@@ -703,6 +1284,12 @@ static void on_control_message(cJSON *msg)
         cJSON_AddStringToObject(response, "err", "unknown_cmd");
     }
 
+    return response;
+}
+
+static void on_control_message(cJSON *msg)
+{
+    cJSON *response = handle_control_message(msg);
     send_control_response(response);
     cJSON_Delete(response);
 }
@@ -723,7 +1310,6 @@ static void notify_timer_callback(TimerHandle_t timer)
     {
         g_remote_state.mouse.x = 0;
         g_remote_state.mouse.y = 0;
-        hid_device_set_mouse_state(g_device, &g_remote_state.mouse);
         updated = true;
     }
 
@@ -742,7 +1328,6 @@ static void notify_timer_callback(TimerHandle_t timer)
     if (updated)
     {
         hid_device_set_mouse_state(g_device, &g_remote_state.mouse);
-        hid_device_request_notify(g_device, true, false, false);
     }
 }
 
@@ -771,6 +1356,11 @@ void app_main(void)
 
     hid_device_set_state_callback(g_device, device_state_changed);
 
+    // Status broadcasts from here on are coalesced and sent as deltas
+    status_publisher_register(STATUS_TOPIC_WIFI, "wifi_status", populate_wifi_status_json);
+    status_publisher_register(STATUS_TOPIC_BLE, "ble_status", populate_ble_status_json);
+    ESP_ERROR_CHECK(status_publisher_start(send_status_message));
+
     // Start HID device
     if (hid_device_start(g_device) != ESP_OK)
     {
@@ -852,14 +1442,27 @@ void app_main(void)
         .on_mouse = on_mouse_input,
         .on_keyboard = on_keyboard_input,
         .on_consumer = on_consumer_input,
-        .on_control = on_control_message};
+        .on_pointer_abs = on_pointer_abs_input,
+        .on_control = on_control_message,
+        .on_control_request = handle_control_message};
 
     ESP_ERROR_CHECK(transport_uart_init(&callbacks));
 
+    esp_err_t http_input_err = transport_http_init(&callbacks);
+    if (http_input_err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to start HTTP input transport: %s", esp_err_to_name(http_input_err));
+    }
+
     // Wait a bit for WiFi to stabilize
     vTaskDelay(pdMS_TO_TICKS(1000));
 
+#ifdef CONFIG_HID_WS_DEDICATED_SERVER
     esp_err_t ws_err = transport_websocket_init(&callbacks, DEFAULT_WS_PORT);
+#else
+    // /ws is already an endpoint of the web UI server
+    esp_err_t ws_err = transport_websocket_init(&callbacks, 0);
+#endif
     if (ws_err != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to start WebSocket transport: %s", esp_err_to_name(ws_err));
@@ -881,6 +1484,10 @@ void app_main(void)
     if (wifi_manager_get_ip(ip, sizeof(ip)) == ESP_OK)
     {
         ESP_LOGI(TAG, "IP Address: %s", ip);
+#ifdef CONFIG_HID_WS_DEDICATED_SERVER
         ESP_LOGI(TAG, "WebSocket: ws://%s:%d/ws", ip, DEFAULT_WS_PORT);
+#else
+        ESP_LOGI(TAG, "WebSocket: ws://%s:%d/ws", ip, DEFAULT_HTTP_PORT);
+#endif
     }
 }
@@ -1,8 +1,73 @@
 #include "mouse_report_builder.h"
 
+#include <stdbool.h>
 #include <string.h>
 
-void mouse_build_report(const mouse_state_t *state, uint8_t report[HID_MOUSE_REPORT_LEN])
+static void write_le16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static int8_t clamp_int8(int32_t value, int32_t limit)
+{
+    if (value > limit)
+    {
+        return (int8_t)limit;
+    }
+    if (value < -limit)
+    {
+        return (int8_t)-limit;
+    }
+    return (int8_t)value;
+}
+
+int16_t mouse_clamp_delta(int32_t value)
+{
+    if (value > HID_HIRES_MOUSE_INPUT_X_LOGICAL_MAX)
+    {
+        return HID_HIRES_MOUSE_INPUT_X_LOGICAL_MAX;
+    }
+    if (value < HID_HIRES_MOUSE_INPUT_X_LOGICAL_MIN)
+    {
+        return HID_HIRES_MOUSE_INPUT_X_LOGICAL_MIN;
+    }
+    return (int16_t)value;
+}
+
+uint8_t mouse_wheel_multiplier(uint8_t feature_value)
+{
+    // Map the host's Resolution Multiplier selection onto its physical range
+    // (HID 1.11 Resolution Multiplier, linear between logical and physical).
+    if (feature_value <= HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_LOGICAL_MIN)
+    {
+        return HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_PHYSICAL_MIN;
+    }
+    return HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_PHYSICAL_MAX;
+}
+
+static int8_t wheel_to_report(int16_t wheel, uint8_t multiplier, int16_t *carry)
+{
+    // Wheel state is in 1/HID_MOUSE_WHEEL_RESOLUTION detents; hosts that have
+    // not raised the multiplier only understand whole detents, so the rest
+    // waits in carry. At full resolution the division is exact and an old
+    // carry is dropped.
+    int32_t total = (int32_t)wheel * multiplier;
+    bool coarse = multiplier < HID_MOUSE_WHEEL_RESOLUTION;
+    if (carry && coarse)
+    {
+        total += *carry;
+    }
+    int32_t units = total / HID_MOUSE_WHEEL_RESOLUTION;
+    if (carry)
+    {
+        *carry = coarse ? (int16_t)(total - units * HID_MOUSE_WHEEL_RESOLUTION) : 0;
+    }
+    return clamp_int8(units, HID_MOUSE_INPUT_WHEEL_LOGICAL_MAX);
+}
+
+void mouse_build_report(const mouse_state_t *state, mouse_wheel_carry_t *carry,
+                        uint8_t report[HID_MOUSE_REPORT_LEN])
 {
     if (!report)
     {
@@ -17,14 +82,95 @@ void mouse_build_report(const mouse_state_t *state, uint8_t report[HID_MOUSE_REP
     }
 
     report[0] = HID_MOUSE_REPORT_ID;
-    report[1] = (uint8_t)(state->buttons & HID_MOUSE_BUTTON_MASK);
+    report[HID_MOUSE_INPUT_BUTTONS_OFFSET] = (uint8_t)(state->buttons & HID_MOUSE_BUTTON_MASK);
     // HID mouse input reports use the third byte for the X axis and the
     // fourth byte for the Y axis. Some earlier builds intentionally swapped
     // these assignments for iOS compatibility, but that produced inverted
     // movement on standards-compliant hosts. Use the spec order so a positive
     // X delta updates byte 2 and a positive Y delta updates byte 3.
-    report[2] = (uint8_t)state->x;
-    report[3] = (uint8_t)state->y;
-    report[4] = (uint8_t)state->wheel;
-    report[5] = (uint8_t)state->hwheel;
+    report[HID_MOUSE_INPUT_X_OFFSET] = (uint8_t)clamp_int8(state->x, HID_MOUSE_INPUT_X_LOGICAL_MAX);
+    report[HID_MOUSE_INPUT_Y_OFFSET] = (uint8_t)clamp_int8(state->y, HID_MOUSE_INPUT_Y_LOGICAL_MAX);
+    report[HID_MOUSE_INPUT_WHEEL_OFFSET] = (uint8_t)wheel_to_report(state->wheel, 1, carry ? &carry->wheel : NULL);
+    report[HID_MOUSE_INPUT_HWHEEL_OFFSET] = (uint8_t)wheel_to_report(state->hwheel, 1, carry ? &carry->hwheel : NULL);
+}
+
+void mouse_build_hires_report(const mouse_state_t *state,
+                              const hid_hires_mouse_feature_report_t *feature,
+                              mouse_wheel_carry_t *carry,
+                              uint8_t report[HID_HIRES_MOUSE_INPUT_REPORT_LEN])
+{
+    if (!report)
+    {
+        return;
+    }
+
+    memset(report, 0, HID_HIRES_MOUSE_INPUT_REPORT_LEN);
+    report[0] = HID_REPORT_ID_HIRES_MOUSE;
+
+    if (!state)
+    {
+        return;
+    }
+
+    uint8_t wheel_multiplier = mouse_wheel_multiplier(feature ? feature->wheel_multiplier : 0);
+    uint8_t hwheel_multiplier = mouse_wheel_multiplier(feature ? feature->hwheel_multiplier : 0);
+
+    report[HID_HIRES_MOUSE_INPUT_BUTTONS_OFFSET] =
+        (uint8_t)(state->buttons & HID_HIRES_MOUSE_INPUT_BUTTONS_MASK);
+    write_le16(&report[HID_HIRES_MOUSE_INPUT_X_OFFSET], (uint16_t)mouse_clamp_delta(state->x));
+    write_le16(&report[HID_HIRES_MOUSE_INPUT_Y_OFFSET], (uint16_t)mouse_clamp_delta(state->y));
+    report[HID_HIRES_MOUSE_INPUT_WHEEL_OFFSET] =
+        (uint8_t)wheel_to_report(state->wheel, wheel_multiplier, carry ? &carry->wheel : NULL);
+    report[HID_HIRES_MOUSE_INPUT_HWHEEL_OFFSET] =
+        (uint8_t)wheel_to_report(state->hwheel, hwheel_multiplier, carry ? &carry->hwheel : NULL);
+}
+
+void mouse_build_boot_report(const mouse_state_t *state, uint8_t report[HID_BOOT_MOUSE_REPORT_LEN])
+{
+    if (!report)
+    {
+        return;
+    }
+
+    if (!state)
+    {
+        memset(report, 0, HID_BOOT_MOUSE_REPORT_LEN);
+        return;
+    }
+
+    // Boot protocol is fixed at three buttons and 8-bit X/Y with no wheel.
+    report[0] = (uint8_t)(state->buttons & HID_BOOT_MOUSE_BUTTON_MASK);
+    report[1] = (uint8_t)clamp_int8(state->x, HID_MOUSE_INPUT_X_LOGICAL_MAX);
+    report[2] = (uint8_t)clamp_int8(state->y, HID_MOUSE_INPUT_Y_LOGICAL_MAX);
+}
+
+
+static uint16_t clamp_pointer_axis(uint16_t value, uint16_t max)
+{
+    return value > max ? max : value;
+}
+
+void pointer_abs_build_report(const pointer_abs_state_t *state,
+                              uint8_t report[HID_POINTER_INPUT_REPORT_LEN])
+{
+    if (!report)
+    {
+        return;
+    }
+
+    memset(report, 0, HID_POINTER_INPUT_REPORT_LEN);
+    report[0] = HID_REPORT_ID_POINTER;
+
+    if (!state)
+    {
+        return;
+    }
+
+    report[HID_POINTER_INPUT_BUTTONS_OFFSET] = (uint8_t)(state->buttons & HID_POINTER_INPUT_BUTTONS_MASK);
+    // Axes are little-endian as required by the HID spec; values past the
+    // descriptor's logical maximum are pinned to the screen edge.
+    write_le16(&report[HID_POINTER_INPUT_X_OFFSET],
+               clamp_pointer_axis(state->x, HID_POINTER_INPUT_X_LOGICAL_MAX));
+    write_le16(&report[HID_POINTER_INPUT_Y_OFFSET],
+               clamp_pointer_axis(state->y, HID_POINTER_INPUT_Y_LOGICAL_MAX));
 }
@@ -3,11 +3,39 @@
 
 #include <stdint.h>
 #include "hid_device.h"
+#include "hid_report_descriptor.h"
 
-#define HID_MOUSE_REPORT_ID 0x01
-#define HID_MOUSE_BUTTON_MASK 0x1F
-#define HID_MOUSE_REPORT_LEN 6
+#define HID_MOUSE_REPORT_ID HID_REPORT_ID_MOUSE
+#define HID_MOUSE_BUTTON_MASK HID_MOUSE_INPUT_BUTTONS_MASK
+#define HID_MOUSE_REPORT_LEN HID_MOUSE_INPUT_REPORT_LEN
+#define HID_BOOT_MOUSE_REPORT_LEN 3
+#define HID_BOOT_MOUSE_BUTTON_MASK 0x07
 
-void mouse_build_report(const mouse_state_t *state, uint8_t report[HID_MOUSE_REPORT_LEN]);
+_Static_assert(HID_MOUSE_WHEEL_RESOLUTION == HID_HIRES_MOUSE_FEATURE_WHEEL_MULTIPLIER_PHYSICAL_MAX &&
+                   HID_MOUSE_WHEEL_RESOLUTION == HID_HIRES_MOUSE_FEATURE_HWHEEL_MULTIPLIER_PHYSICAL_MAX,
+               "mouse_state_t wheel units must match the descriptor's Resolution Multiplier");
+
+// Scrolling too small for one report unit, kept for the next report so that
+// sub-detent _hr scrolling still adds up on a host taking whole detents.
+// One per host; zero it to start over.
+typedef struct
+{
+    int16_t wheel;
+    int16_t hwheel;
+} mouse_wheel_carry_t;
+
+int16_t mouse_clamp_delta(int32_t value);
+uint8_t mouse_wheel_multiplier(uint8_t feature_value);
+
+// carry may be NULL, which drops any part of a report unit instead
+void mouse_build_report(const mouse_state_t *state, mouse_wheel_carry_t *carry,
+                        uint8_t report[HID_MOUSE_REPORT_LEN]);
+void mouse_build_hires_report(const mouse_state_t *state,
+                              const hid_hires_mouse_feature_report_t *feature,
+                              mouse_wheel_carry_t *carry,
+                              uint8_t report[HID_HIRES_MOUSE_INPUT_REPORT_LEN]);
+void mouse_build_boot_report(const mouse_state_t *state, uint8_t report[HID_BOOT_MOUSE_REPORT_LEN]);
+void pointer_abs_build_report(const pointer_abs_state_t *state,
+                              uint8_t report[HID_POINTER_INPUT_REPORT_LEN]);
 
 #endif // MOUSE_REPORT_BUILDER_H
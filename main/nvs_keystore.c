@@ -6,6 +6,9 @@
 
 static const char *TAG = "NVS_KEYSTORE";
 static const char *NVS_NAMESPACE = "ble_bonds";
+// Bonded hosts by recency, see nvs_keystore_set_last_peer
+static const char *LAST_PEER_NAMESPACE = "ble_last_peer";
+static const char *LAST_PEER_KEY = "peer";
 
 esp_err_t nvs_keystore_init(void)
 {
@@ -18,44 +21,149 @@ esp_err_t nvs_keystore_init(void)
     return err;
 }
 
-bool nvs_keystore_has_bonds(void)
+esp_err_t nvs_keystore_clear(void)
 {
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
     if (err != ESP_OK)
     {
-        return false;
+        return err;
     }
 
-    nvs_iterator_t it = NULL;
-    err = nvs_entry_find("nvs", NVS_NAMESPACE, NVS_TYPE_ANY, &it);
-    bool has_bonds = (err == ESP_OK && it != NULL);
-
-    if (it)
+    err = nvs_erase_all(handle);
+    if (err == ESP_OK)
     {
-        nvs_release_iterator(it);
+        err = nvs_commit(handle);
     }
+
     nvs_close(handle);
 
-    return has_bonds;
+    if (nvs_open(LAST_PEER_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK)
+    {
+        if (nvs_erase_all(handle) == ESP_OK)
+        {
+            nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+
+    ESP_LOGI(TAG, "Cleared all bonding information");
+    return err;
 }
 
-esp_err_t nvs_keystore_clear(void)
+// Reads the recency list; a blob from before the list held one peer
+static size_t nvs_keystore_read_peers(uint8_t peers[][NVS_KEYSTORE_PEER_LEN])
 {
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (nvs_open(LAST_PEER_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+    {
+        return 0;
+    }
+
+    size_t len = NVS_KEYSTORE_MAX_PEERS * NVS_KEYSTORE_PEER_LEN;
+    esp_err_t err = nvs_get_blob(handle, LAST_PEER_KEY, peers, &len);
+    nvs_close(handle);
+    if (err != ESP_OK || len % NVS_KEYSTORE_PEER_LEN != 0)
+    {
+        return 0;
+    }
+    return len / NVS_KEYSTORE_PEER_LEN;
+}
+
+static esp_err_t nvs_keystore_write_peers(uint8_t peers[][NVS_KEYSTORE_PEER_LEN], size_t count)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(LAST_PEER_NAMESPACE, NVS_READWRITE, &handle);
     if (err != ESP_OK)
     {
         return err;
     }
 
-    err = nvs_erase_all(handle);
+    err = count > 0 ? nvs_set_blob(handle, LAST_PEER_KEY, peers, count * NVS_KEYSTORE_PEER_LEN)
+                    : nvs_erase_key(handle, LAST_PEER_KEY);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        err = ESP_OK;
+    }
     if (err == ESP_OK)
     {
         err = nvs_commit(handle);
     }
 
     nvs_close(handle);
-    ESP_LOGI(TAG, "Cleared all bonding information");
     return err;
 }
+
+// Index of the peer in the list, or count when absent
+static size_t nvs_keystore_find_peer(uint8_t peers[][NVS_KEYSTORE_PEER_LEN], size_t count,
+                                     uint8_t addr_type, const uint8_t addr[6])
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (peers[i][0] == addr_type && memcmp(&peers[i][1], addr, 6) == 0)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+esp_err_t nvs_keystore_set_last_peer(uint8_t addr_type, const uint8_t addr[6])
+{
+    uint8_t peers[NVS_KEYSTORE_MAX_PEERS][NVS_KEYSTORE_PEER_LEN];
+    size_t count = nvs_keystore_read_peers(peers);
+    size_t index = nvs_keystore_find_peer(peers, count, addr_type, addr);
+
+    // Hosts reconnect often; skip the flash write when nothing changed
+    if (index == 0 && count > 0)
+    {
+        return ESP_OK;
+    }
+
+    // Move it to the front; a new peer pushes out the least recent one
+    if (index == count)
+    {
+        count = count < NVS_KEYSTORE_MAX_PEERS ? count + 1 : NVS_KEYSTORE_MAX_PEERS;
+        index = count - 1;
+    }
+    memmove(peers[1], peers[0], index * NVS_KEYSTORE_PEER_LEN);
+    peers[0][0] = addr_type;
+    memcpy(&peers[0][1], addr, 6);
+    return nvs_keystore_write_peers(peers, count);
+}
+
+bool nvs_keystore_get_last_peer(uint8_t *addr_type, uint8_t addr[6])
+{
+    uint8_t peers[NVS_KEYSTORE_MAX_PEERS][NVS_KEYSTORE_PEER_LEN];
+    if (nvs_keystore_read_peers(peers) == 0)
+    {
+        return false;
+    }
+
+    *addr_type = peers[0][0];
+    memcpy(addr, &peers[0][1], 6);
+    return true;
+}
+
+size_t nvs_keystore_get_peer_order(uint8_t peers[][NVS_KEYSTORE_PEER_LEN], size_t max)
+{
+    uint8_t stored[NVS_KEYSTORE_MAX_PEERS][NVS_KEYSTORE_PEER_LEN];
+    size_t count = nvs_keystore_read_peers(stored);
+    count = count < max ? count : max;
+    memcpy(peers, stored, count * NVS_KEYSTORE_PEER_LEN);
+    return count;
+}
+
+esp_err_t nvs_keystore_forget_peer(uint8_t addr_type, const uint8_t addr[6])
+{
+    uint8_t peers[NVS_KEYSTORE_MAX_PEERS][NVS_KEYSTORE_PEER_LEN];
+    size_t count = nvs_keystore_read_peers(peers);
+    size_t index = nvs_keystore_find_peer(peers, count, addr_type, addr);
+    if (index == count)
+    {
+        return ESP_OK;
+    }
+
+    memmove(peers[index], peers[index + 1], (count - index - 1) * NVS_KEYSTORE_PEER_LEN);
+    return nvs_keystore_write_peers(peers, count - 1);
+}
@@ -3,9 +3,22 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Recency list entries: address type, then the 6 address bytes
+#define NVS_KEYSTORE_PEER_LEN 7
+#define NVS_KEYSTORE_MAX_PEERS 8
 
 esp_err_t nvs_keystore_init(void);
-bool nvs_keystore_has_bonds(void);
 esp_err_t nvs_keystore_clear(void);
 
+// Bonded hosts by identity address (NimBLE byte order), most recently used
+// first. The first is the directed advertising target; the order survives a
+// reboot so bond eviction stays least recently used.
+esp_err_t nvs_keystore_set_last_peer(uint8_t addr_type, const uint8_t addr[6]);
+bool nvs_keystore_get_last_peer(uint8_t *addr_type, uint8_t addr[6]);
+size_t nvs_keystore_get_peer_order(uint8_t peers[][NVS_KEYSTORE_PEER_LEN], size_t max);
+esp_err_t nvs_keystore_forget_peer(uint8_t addr_type, const uint8_t addr[6]);
+
 #endif // NVS_KEYSTORE_H
@@ -0,0 +1,239 @@
+#include "status_publisher.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_topology.h"
+#include "json_out.h"
+#include <string.h>
+
+#define STATUS_PUBLISHER_TASK_STACK 4096
+
+static const char *TAG = "STATUS_PUB";
+
+typedef struct
+{
+    const char *type;
+    status_build_fn build;
+    cJSON *last;      // fields of the last message sent, NULL before the first
+    uint32_t version;
+} status_topic_state_t;
+
+static status_topic_state_t s_topics[STATUS_TOPIC_COUNT];
+static status_send_fn s_send = NULL;
+static TaskHandle_t s_task = NULL;
+
+// Marks and snapshot requests come from any task
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_dirty = 0; // bit per status_topic_t
+static bool s_snapshot = false;
+static status_publisher_stats_t s_stats = {0};
+
+static void status_publisher_count(uint32_t *counter, uint32_t amount)
+{
+    portENTER_CRITICAL(&s_lock);
+    *counter += amount;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// Top-level fields of next that differ from prev, and the names of those
+// that are gone
+static void status_publisher_add_delta(cJSON *msg, const cJSON *prev, const cJSON *next)
+{
+    const cJSON *item = NULL;
+    cJSON_ArrayForEach(item, next)
+    {
+        const cJSON *old = cJSON_GetObjectItemCaseSensitive(prev, item->string);
+        if (!old || !cJSON_Compare(old, item, true))
+        {
+            cJSON_AddItemToObject(msg, item->string, cJSON_Duplicate(item, true));
+        }
+    }
+
+    cJSON *removed = NULL;
+    cJSON_ArrayForEach(item, prev)
+    {
+        if (!cJSON_HasObjectItem(next, item->string))
+        {
+            if (!removed)
+            {
+                removed = cJSON_AddArrayToObject(msg, "removed");
+            }
+            cJSON_AddItemToArray(removed, cJSON_CreateString(item->string));
+        }
+    }
+}
+
+static void status_publisher_publish(status_topic_t topic, bool snapshot)
+{
+    status_topic_state_t *state = &s_topics[topic];
+    if (!state->build)
+    {
+        return;
+    }
+
+    cJSON *next = cJSON_CreateObject();
+    if (!next)
+    {
+        return;
+    }
+    state->build(next);
+    status_publisher_count(&s_stats.builds, 1);
+
+    bool changed = !state->last || !cJSON_Compare(state->last, next, true);
+    if (!changed && !snapshot)
+    {
+        status_publisher_count(&s_stats.unchanged, 1);
+        cJSON_Delete(next);
+        return;
+    }
+
+    // The first message of a topic is always whole
+    bool whole = snapshot || !state->last;
+    uint32_t version = state->version + (changed ? 1 : 0);
+    cJSON *msg = cJSON_CreateObject();
+    if (!msg)
+    {
+        cJSON_Delete(next);
+        return;
+    }
+    cJSON_AddStringToObject(msg, "type", state->type);
+    cJSON_AddNumberToObject(msg, "version", version);
+    if (whole)
+    {
+        const cJSON *item = NULL;
+        cJSON_ArrayForEach(item, next)
+        {
+            cJSON_AddItemToObject(msg, item->string, cJSON_Duplicate(item, true));
+        }
+    }
+    else
+    {
+        cJSON_AddTrueToObject(msg, "delta");
+        status_publisher_add_delta(msg, state->last, next);
+    }
+
+    json_out_t out;
+    const char *payload = json_out_print(msg, &out);
+    cJSON_Delete(msg);
+    if (!payload)
+    {
+        // Keep the old state so the change goes out next time
+        cJSON_Delete(next);
+        return;
+    }
+    s_send(payload);
+    status_publisher_count(whole ? &s_stats.snapshots : &s_stats.deltas, 1);
+    status_publisher_count(&s_stats.bytes, (uint32_t)strlen(payload));
+    json_out_release(&out);
+
+    if (changed)
+    {
+        cJSON_Delete(state->last);
+        state->last = next;
+        state->version = version;
+        portENTER_CRITICAL(&s_lock);
+        s_stats.versions[topic] = version;
+        portEXIT_CRITICAL(&s_lock);
+    }
+    else
+    {
+        cJSON_Delete(next);
+    }
+}
+
+static void status_publisher_task(void *arg)
+{
+    TickType_t last_publish = xTaskGetTickCount() - pdMS_TO_TICKS(STATUS_PUBLISH_WINDOW_MS);
+
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // A burst of marks costs one publish per window
+        TickType_t since = xTaskGetTickCount() - last_publish;
+        if (since < pdMS_TO_TICKS(STATUS_PUBLISH_WINDOW_MS))
+        {
+            vTaskDelay(pdMS_TO_TICKS(STATUS_PUBLISH_WINDOW_MS) - since);
+        }
+
+        portENTER_CRITICAL(&s_lock);
+        uint32_t dirty = s_dirty;
+        bool snapshot = s_snapshot;
+        s_dirty = 0;
+        s_snapshot = false;
+        portEXIT_CRITICAL(&s_lock);
+
+        for (int topic = 0; topic < STATUS_TOPIC_COUNT; ++topic)
+        {
+            if (snapshot || (dirty & (1u << topic)))
+            {
+                status_publisher_publish((status_topic_t)topic, snapshot);
+            }
+        }
+        last_publish = xTaskGetTickCount();
+    }
+}
+
+void status_publisher_register(status_topic_t topic, const char *type, status_build_fn build)
+{
+    if (topic >= STATUS_TOPIC_COUNT || s_task)
+    {
+        return;
+    }
+    s_topics[topic].type = type;
+    s_topics[topic].build = build;
+}
+
+esp_err_t status_publisher_start(status_send_fn send)
+{
+    if (s_task)
+    {
+        return ESP_OK;
+    }
+    if (!send)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_send = send;
+    if (xTaskCreatePinnedToCore(status_publisher_task, "status_pub", STATUS_PUBLISHER_TASK_STACK, NULL,
+                                TASK_PRIO_STATUS, &s_task, TASK_CORE_NET) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to start status publisher task");
+        s_task = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void status_publisher_mark(status_topic_t topic)
+{
+    if (!s_task || topic >= STATUS_TOPIC_COUNT)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_dirty |= 1u << topic;
+    s_stats.marks++;
+    portEXIT_CRITICAL(&s_lock);
+    xTaskNotifyGive(s_task);
+}
+
+void status_publisher_request_snapshot(void)
+{
+    if (!s_task)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_snapshot = true;
+    portEXIT_CRITICAL(&s_lock);
+    xTaskNotifyGive(s_task);
+}
+
+void status_publisher_get_stats(status_publisher_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,55 @@
+#ifndef STATUS_PUBLISHER_H
+#define STATUS_PUBLISHER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "cJSON.h"
+
+// Status broadcasts (wifi_status, ble_status). Producers only mark a topic
+// as changed; a low-priority task rebuilds it at most once per window,
+// compares it with the last one sent and broadcasts the fields that changed.
+//
+// Every message carries the topic's "version", which goes up by one per
+// change. A delta has "delta":true, the changed top-level fields and, if
+// any went away, "removed" with their names. A snapshot has every field.
+// A client that sees a version gap asks for a snapshot (status_snapshot).
+typedef enum
+{
+    STATUS_TOPIC_WIFI = 0,
+    STATUS_TOPIC_BLE,
+    STATUS_TOPIC_COUNT
+} status_topic_t;
+
+// Marks arriving within this long of the last publish wait for its end
+#define STATUS_PUBLISH_WINDOW_MS 100
+
+// Adds the topic's full status to obj
+typedef void (*status_build_fn)(cJSON *obj);
+// Sends one message to every client
+typedef void (*status_send_fn)(const char *payload);
+
+typedef struct
+{
+    uint32_t marks;     // change notifications from producers
+    uint32_t builds;    // statuses rebuilt
+    uint32_t deltas;    // delta messages sent
+    uint32_t snapshots; // full messages sent
+    uint32_t unchanged; // rebuilds that matched the last message
+    uint32_t bytes;     // payload bytes sent
+    uint32_t versions[STATUS_TOPIC_COUNT];
+} status_publisher_stats_t;
+
+// Registers each topic's message type and builder before starting
+void status_publisher_register(status_topic_t topic, const char *type, status_build_fn build);
+// Starts the publish task; safe to call more than once
+esp_err_t status_publisher_start(status_send_fn send);
+
+// The topic may have changed; safe from any task. Ignored before start.
+void status_publisher_mark(status_topic_t topic);
+// The next publish sends every topic whole
+void status_publisher_request_snapshot(void);
+
+void status_publisher_get_stats(status_publisher_stats_t *stats);
+
+#endif // STATUS_PUBLISHER_H
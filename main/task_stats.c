@@ -0,0 +1,108 @@
+#include "task_stats.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Room for tasks created between counting them and taking the snapshot
+#define TASK_STATS_SPARE_SLOTS 4
+
+typedef struct
+{
+    TaskHandle_t handle;
+    uint32_t runtime;
+} task_stats_prev_t;
+
+// Run time counters at the previous sample, to turn totals into a window
+static task_stats_prev_t s_prev[TASK_STATS_MAX_TASKS];
+static size_t s_prev_count = 0;
+static uint32_t s_prev_total = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+uint32_t task_stats_permille(uint32_t runtime, uint32_t window)
+{
+    if (window == 0)
+    {
+        return 0;
+    }
+    uint64_t permille = (uint64_t)runtime * 1000 / window;
+    return permille > 1000 ? 1000 : (uint32_t)permille;
+}
+
+#if defined(CONFIG_FREERTOS_USE_TRACE_FACILITY) && defined(CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+
+esp_err_t task_stats_sample(task_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + TASK_STATS_SPARE_SLOTS;
+    TaskStatus_t *status = malloc(capacity * sizeof(*status));
+    if (!status)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t n = uxTaskGetSystemState(status, capacity, &total);
+    if (n == 0)
+    {
+        free(status);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    task_stats_prev_t next[TASK_STATS_MAX_TASKS];
+
+    portENTER_CRITICAL(&s_lock);
+    // Counters are 32-bit microseconds by default; unsigned differences
+    // survive a wrap as long as samples are under ~71 minutes apart
+    stats->window_us = (uint32_t)total - s_prev_total;
+    for (UBaseType_t i = 0; i < n; ++i)
+    {
+        if (stats->count >= TASK_STATS_MAX_TASKS)
+        {
+            stats->dropped++;
+            continue;
+        }
+
+        uint32_t runtime = (uint32_t)status[i].ulRunTimeCounter;
+        uint32_t delta = runtime;
+        for (size_t j = 0; j < s_prev_count; ++j)
+        {
+            if (s_prev[j].handle == status[i].xHandle)
+            {
+                delta = runtime - s_prev[j].runtime;
+                break;
+            }
+        }
+
+        task_stats_entry_t *entry = &stats->tasks[stats->count];
+        strncpy(entry->name, status[i].pcTaskName, TASK_STATS_NAME_LEN - 1);
+        entry->priority = status[i].uxCurrentPriority;
+        BaseType_t core = xTaskGetCoreID(status[i].xHandle);
+        entry->core = core == tskNO_AFFINITY ? TASK_STATS_NO_CORE : (int)core;
+        entry->stack_free = status[i].usStackHighWaterMark;
+        entry->cpu_permille = task_stats_permille(delta, stats->window_us);
+
+        next[stats->count].handle = status[i].xHandle;
+        next[stats->count].runtime = runtime;
+        stats->count++;
+    }
+    memcpy(s_prev, next, stats->count * sizeof(next[0]));
+    s_prev_count = stats->count;
+    s_prev_total = (uint32_t)total;
+    portEXIT_CRITICAL(&s_lock);
+
+    free(status);
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t task_stats_sample(task_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
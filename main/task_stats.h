@@ -0,0 +1,39 @@
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define TASK_STATS_MAX_TASKS 32
+#define TASK_STATS_NAME_LEN 16
+#define TASK_STATS_NO_CORE (-1)
+
+typedef struct
+{
+    char name[TASK_STATS_NAME_LEN];
+    uint32_t priority;
+    int core;                // pinned core, TASK_STATS_NO_CORE when free to move
+    uint32_t stack_free;     // stack high-water mark: least ever left, in bytes
+    uint32_t cpu_permille;   // share of one core since the previous sample
+} task_stats_entry_t;
+
+typedef struct
+{
+    uint32_t window_us;      // time since the previous sample (or boot)
+    size_t count;
+    size_t dropped;          // tasks that did not fit in tasks[]
+    task_stats_entry_t tasks[TASK_STATS_MAX_TASKS];
+} task_stats_t;
+
+// Samples every task. CPU shares cover the time since the previous call,
+// so two calls bracket a load test; they are per core, so on a dual core
+// chip they add up to 2000 including the idle tasks. Needs
+// CONFIG_FREERTOS_USE_TRACE_FACILITY and
+// CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS, else ESP_ERR_NOT_SUPPORTED.
+esp_err_t task_stats_sample(task_stats_t *stats);
+
+// Share of a window, in permille, clamped to 1000
+uint32_t task_stats_permille(uint32_t runtime, uint32_t window);
+
+#endif // TASK_STATS_H
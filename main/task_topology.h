@@ -0,0 +1,70 @@
+#ifndef TASK_TOPOLOGY_H
+#define TASK_TOPOLOGY_H
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Where each task runs. The BLE core carries the controller, the NimBLE
+// host (CONFIG_BT_NIMBLE_PINNED_TO_CORE) and hid_drain, which retries the
+// notifications the links could not take. The network core carries Wi-Fi,
+// lwIP, httpd and the transports, so page loads and scans cannot preempt
+// notifications. The FreeRTOS timer service task keeps the IDF defaults,
+// so its callbacks must not block or do slow work.
+//
+//   task         core  prio  stack  notes
+//   NimBLE host  BLE   21    4096   IDF default priority; also runs the
+//                                   conn_params evaluation callout
+//   hid_drain    BLE   12    4096   notify retries and deferred sends
+//   wifi         NET   23    -      CONFIG_ESP_WIFI_TASK_PINNED_TO_CORE_1
+//   tiT (lwIP)   NET   18    3072   CONFIG_LWIP_TCPIP_TASK_AFFINITY_CPU1
+//   uart_task    NET   10    4096   input; above httpd so typing stays live
+//   httpd        NET   6     4096   web UI, /ws and parsing; a second one
+//                                   with CONFIG_HID_WS_DEDICATED_SERVER
+//   dns_server   NET   4     4096   captive portal
+//   status_pub   NET   3     4096   coalesced wifi/ble status broadcasts
+//   ws_ascii     NET   2     3072   bulk typing, yields to everything above
+//   http_type    NET   2     3072   feeds POST /api/type bodies to ws_ascii
+//   hid_events   NET   1     3072   failure log summaries
+//   Tmr Svc      any   1     4096   timers: notify (mouse auto-stop),
+//                                   hid_flush_retry, sta_retry
+#ifdef CONFIG_FREERTOS_UNICORE
+#define TASK_CORE_BLE 0
+#define TASK_CORE_NET 0
+#else
+// Follows the NimBLE host; the network core is the other one
+#ifdef CONFIG_BT_NIMBLE_PINNED_TO_CORE
+#define TASK_CORE_BLE CONFIG_BT_NIMBLE_PINNED_TO_CORE
+#else
+#define TASK_CORE_BLE 0
+#endif
+#define TASK_CORE_NET (1 - TASK_CORE_BLE)
+#endif
+
+#ifdef CONFIG_HID_TASK_UART_PRIORITY
+#define TASK_PRIO_UART CONFIG_HID_TASK_UART_PRIORITY
+#else
+#define TASK_PRIO_UART 10
+#endif
+
+#ifdef CONFIG_HID_TASK_HTTPD_PRIORITY
+#define TASK_PRIO_HTTPD CONFIG_HID_TASK_HTTPD_PRIORITY
+#else
+#define TASK_PRIO_HTTPD 6
+#endif
+
+#define TASK_PRIO_HID_DRAIN 12
+#define TASK_PRIO_DNS 4
+#define TASK_PRIO_STATUS 3
+#define TASK_PRIO_WS_ASCII (tskIDLE_PRIORITY + 2)
+#define TASK_PRIO_HTTP_TYPE (tskIDLE_PRIORITY + 2)
+#define TASK_PRIO_HID_EVENTS (tskIDLE_PRIORITY + 1)
+
+#define TASK_STACK_HID_DRAIN 4096
+#define TASK_STACK_UART 4096
+#define TASK_STACK_HTTPD 4096
+#define TASK_STACK_DNS 4096
+#define TASK_STACK_WS_ASCII 3072
+#define TASK_STACK_HTTP_TYPE 3072
+
+#endif // TASK_TOPOLOGY_H
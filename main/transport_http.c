@@ -0,0 +1,370 @@
+#include "transport_http.h"
+#include "transport_ws.h"
+#include "input_batch.h"
+#include "json_out.h"
+#include "task_topology.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <string.h>
+#include <sys/param.h>
+
+static const char *TAG = "HTTP_TRANSPORT";
+
+#define HTTP_RX_CHUNK 512
+// A typing request gives up when the queue has not moved for this long
+#define HTTP_TYPE_STALL_MS 2000
+// A body that stops arriving is dropped after this many receive timeouts in
+// a row (recv_wait_timeout each, 5 s by default), so it cannot hold the
+// shared httpd task or the typing task
+#define HTTP_RX_MAX_TIMEOUTS 3
+
+static transport_callbacks_t s_callbacks = {0};
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static transport_http_stats_t s_stats = {0};
+
+// Batches are decoded on the httpd task, one request at a time, so the
+// receive buffer and splitter state are static rather than on its stack
+static char s_batch_rx[HTTP_RX_CHUNK];
+static input_batch_t s_batch;
+
+// Typing runs on its own task with the request handed over through
+// httpd's async handler API; one typing request at a time
+static char s_type_rx[HTTP_RX_CHUNK];
+static QueueHandle_t s_type_queue = NULL;
+static TaskHandle_t s_type_task = NULL;
+static volatile bool s_type_active = false;
+
+typedef struct
+{
+    cJSON *responses;
+    uint32_t response_count;
+    uint32_t responses_dropped;
+    uint32_t rejected;
+} batch_ctx_t;
+
+static void on_batch_event(const char *json, size_t len, void *arg)
+{
+    batch_ctx_t *ctx = arg;
+    cJSON *msg = cJSON_Parse(json);
+    if (!msg)
+    {
+        ctx->rejected++;
+        return;
+    }
+
+    cJSON *type = cJSON_GetObjectItem(msg, "type");
+    if (cJSON_IsString(type) && strcmp(type->valuestring, "control") == 0 && s_callbacks.on_control_request)
+    {
+        cJSON *response = s_callbacks.on_control_request(msg);
+        if (!response)
+        {
+            ctx->rejected++;
+        }
+        else if (ctx->responses && ctx->response_count < HTTP_INPUT_MAX_RESPONSES)
+        {
+            cJSON_AddItemToArray(ctx->responses, response);
+            ctx->response_count++;
+        }
+        else
+        {
+            cJSON_Delete(response);
+            ctx->responses_dropped++;
+        }
+    }
+    else if (!transport_websocket_dispatch(msg))
+    {
+        ctx->rejected++;
+    }
+    cJSON_Delete(msg);
+}
+
+// No Content-Length: either an empty body or one this server cannot read
+static bool is_chunked(httpd_req_t *req)
+{
+    return req->content_len == 0 && httpd_req_get_hdr_value_len(req, "Transfer-Encoding") > 0;
+}
+
+static void send_json(httpd_req_t *req, cJSON *response)
+{
+    json_out_t out;
+    const char *str = json_out_print(response, &out);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, str ? str : "{\"ok\":false}");
+    if (str)
+    {
+        json_out_release(&out);
+    }
+}
+
+static esp_err_t input_handler(httpd_req_t *req)
+{
+    if (is_chunked(req))
+    {
+        httpd_resp_send_err(req, HTTPD_411_LENGTH_REQUIRED, "Content-Length required");
+        return ESP_FAIL;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    batch_ctx_t ctx = {.responses = cJSON_CreateArray()};
+    input_batch_init(&s_batch, on_batch_event, &ctx);
+
+    size_t remaining = req->content_len;
+    int timeouts = 0;
+    while (remaining > 0)
+    {
+        int ret = httpd_req_recv(req, s_batch_rx, MIN(remaining, sizeof(s_batch_rx)));
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            if (++timeouts < HTTP_RX_MAX_TIMEOUTS)
+            {
+                continue;
+            }
+            ESP_LOGW(TAG, "Batch body stalled after %u bytes", (unsigned)(req->content_len - remaining));
+            cJSON_Delete(ctx.responses);
+            httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "Request body stalled");
+            return ESP_FAIL;
+        }
+        timeouts = 0;
+        if (ret <= 0)
+        {
+            // The connection is gone; nothing to reply to
+            ESP_LOGW(TAG, "Batch receive failed after %u bytes", (unsigned)(req->content_len - remaining));
+            cJSON_Delete(ctx.responses);
+            return ESP_FAIL;
+        }
+        input_batch_feed(&s_batch, s_batch_rx, (size_t)ret);
+        remaining -= (size_t)ret;
+    }
+    bool complete = input_batch_finish(&s_batch);
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    uint32_t events = s_batch.events;
+    uint32_t rate = elapsed_us > 0 ? (uint32_t)((uint64_t)events * 1000000ULL / elapsed_us) : 0;
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.batches++;
+    s_stats.events += events;
+    s_stats.rejected += ctx.rejected;
+    s_stats.dropped += s_batch.dropped;
+    s_stats.bytes += req->content_len;
+    s_stats.busy_us += elapsed_us;
+    s_stats.last_events_per_s = rate;
+    if (rate > s_stats.peak_events_per_s)
+    {
+        s_stats.peak_events_per_s = rate;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    cJSON *response = cJSON_CreateObject();
+    if (!response)
+    {
+        cJSON_Delete(ctx.responses);
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    cJSON_AddBoolToObject(response, "ok", complete && ctx.rejected == 0 && s_batch.dropped == 0 && s_batch.stray == 0);
+    cJSON_AddNumberToObject(response, "events", events);
+    cJSON_AddNumberToObject(response, "rejected", ctx.rejected);
+    cJSON_AddNumberToObject(response, "dropped", s_batch.dropped);
+    if (s_batch.stray)
+    {
+        cJSON_AddNumberToObject(response, "stray_bytes", s_batch.stray);
+    }
+    cJSON_AddNumberToObject(response, "bytes", req->content_len);
+    cJSON_AddNumberToObject(response, "elapsed_us", elapsed_us);
+    cJSON_AddNumberToObject(response, "events_per_s", rate);
+    if (ctx.responses)
+    {
+        cJSON_AddItemToObject(response, "responses", ctx.responses);
+    }
+    if (ctx.responses_dropped)
+    {
+        cJSON_AddNumberToObject(response, "responses_dropped", ctx.responses_dropped);
+    }
+    send_json(req, response);
+    cJSON_Delete(response);
+    return ESP_OK;
+}
+
+static void type_request(httpd_req_t *req)
+{
+    int64_t start_us = esp_timer_get_time();
+    size_t remaining = req->content_len;
+    size_t typed = 0;
+    bool stalled = false;
+    int timeouts = 0;
+
+    while (remaining > 0)
+    {
+        int ret = httpd_req_recv(req, s_type_rx, MIN(remaining, sizeof(s_type_rx)));
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            if (++timeouts < HTTP_RX_MAX_TIMEOUTS)
+            {
+                continue;
+            }
+            ESP_LOGW(TAG, "Type body stalled after %u bytes", (unsigned)(req->content_len - remaining));
+            portENTER_CRITICAL(&s_lock);
+            s_stats.typed += typed;
+            portEXIT_CRITICAL(&s_lock);
+            httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "Request body stalled");
+            // An async handler's return value is not seen by httpd, so
+            // close the socket here instead
+            httpd_sess_trigger_close(req->handle, httpd_req_to_sockfd(req));
+            return;
+        }
+        timeouts = 0;
+        if (ret <= 0)
+        {
+            ESP_LOGW(TAG, "Type receive failed after %u bytes", (unsigned)(req->content_len - remaining));
+            break;
+        }
+        remaining -= (size_t)ret;
+
+        // Waiting on the queue holds back further reads, which is what
+        // paces a long text to the typing speed
+        size_t queued = transport_websocket_queue_text(s_type_rx, (size_t)ret, HTTP_TYPE_STALL_MS);
+        typed += queued;
+        if (queued < (size_t)ret)
+        {
+            stalled = true;
+            break;
+        }
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.typed += typed;
+    portEXIT_CRITICAL(&s_lock);
+
+    cJSON *response = cJSON_CreateObject();
+    if (response)
+    {
+        cJSON_AddBoolToObject(response, "ok", remaining == 0 && !stalled);
+        cJSON_AddNumberToObject(response, "typed", typed);
+        cJSON_AddNumberToObject(response, "bytes", req->content_len);
+        cJSON_AddNumberToObject(response, "elapsed_us", (double)(esp_timer_get_time() - start_us));
+        if (stalled)
+        {
+            cJSON_AddStringToObject(response, "err", "typing_stalled");
+        }
+        send_json(req, response);
+        cJSON_Delete(response);
+    }
+    else
+    {
+        httpd_resp_send_500(req);
+    }
+}
+
+static void type_task(void *arg)
+{
+    httpd_req_t *req = NULL;
+    while (true)
+    {
+        if (xQueueReceive(s_type_queue, &req, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+        type_request(req);
+        httpd_req_async_handler_complete(req);
+        s_type_active = false;
+    }
+}
+
+static esp_err_t type_handler(httpd_req_t *req)
+{
+    if (is_chunked(req))
+    {
+        httpd_resp_send_err(req, HTTPD_411_LENGTH_REQUIRED, "Content-Length required");
+        return ESP_FAIL;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.type_requests++;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!s_type_queue || s_type_active)
+    {
+        // httpd discards the unread body, so the connection stays usable
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_set_type(req, "application/json");
+        httpd_resp_sendstr(req, s_type_queue ? "{\"ok\":false,\"err\":\"busy\"}" : "{\"ok\":false,\"err\":\"no_typing\"}");
+        return ESP_OK;
+    }
+
+    httpd_req_t *async_req = NULL;
+    if (httpd_req_async_handler_begin(req, &async_req) != ESP_OK)
+    {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    s_type_active = true;
+    if (xQueueSend(s_type_queue, &async_req, 0) != pdPASS)
+    {
+        s_type_active = false;
+        httpd_resp_send_500(async_req);
+        httpd_req_async_handler_complete(async_req);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t transport_http_init(const transport_callbacks_t *callbacks)
+{
+    if (!callbacks)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_callbacks = *callbacks;
+
+    if (!s_type_queue)
+    {
+        s_type_queue = xQueueCreate(1, sizeof(httpd_req_t *));
+        if (!s_type_queue)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (!s_type_task &&
+        xTaskCreatePinnedToCore(type_task, "http_type", TASK_STACK_HTTP_TYPE, NULL, TASK_PRIO_HTTP_TYPE,
+                                &s_type_task, TASK_CORE_NET) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to start typing task");
+        vQueueDelete(s_type_queue);
+        s_type_queue = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t transport_http_attach(httpd_handle_t server)
+{
+    httpd_uri_t input_uri = {
+        .uri = "/api/input",
+        .method = HTTP_POST,
+        .handler = input_handler,
+    };
+    esp_err_t err = httpd_register_uri_handler(server, &input_uri);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    httpd_uri_t type_uri = {
+        .uri = "/api/type",
+        .method = HTTP_POST,
+        .handler = type_handler,
+    };
+    return httpd_register_uri_handler(server, &type_uri);
+}
+
+void transport_http_get_stats(transport_http_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
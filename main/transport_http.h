@@ -0,0 +1,43 @@
+#ifndef TRANSPORT_HTTP_H
+#define TRANSPORT_HTTP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "transport_uart.h"
+
+// HID input over plain HTTP, for tools that cannot hold a WebSocket open.
+//
+//   POST /api/input  a batch of the messages /ws takes: one JSON object,
+//                    an array of them, or one per line. The body is decoded
+//                    as it arrives, never held whole. Control responses
+//                    come back in the reply, together with the batch's
+//                    event count and throughput.
+//   POST /api/type   raw text to type; streamed into the typing queue from
+//                    a worker task, so a long text does not hold up httpd.
+//
+// Both need Content-Length; a chunked body gets 411.
+
+// Replies carry at most this many control responses; the rest are counted
+#define HTTP_INPUT_MAX_RESPONSES 8
+
+typedef struct
+{
+    uint32_t batches;           // POST /api/input requests
+    uint32_t events;            // events decoded
+    uint32_t rejected;          // events that did not parse or decode
+    uint32_t dropped;           // events too long, or cut off by the body end
+    uint64_t bytes;             // batch body bytes
+    uint64_t busy_us;           // time spent receiving and decoding batches
+    uint32_t last_events_per_s; // throughput of the latest batch
+    uint32_t peak_events_per_s;
+    uint32_t type_requests;     // POST /api/type requests
+    uint32_t typed;             // characters queued for typing
+} transport_http_stats_t;
+
+esp_err_t transport_http_init(const transport_callbacks_t *callbacks);
+// Registers the endpoints on the web UI server, before its catch-all
+esp_err_t transport_http_attach(httpd_handle_t server);
+void transport_http_get_stats(transport_http_stats_t *stats);
+
+#endif // TRANSPORT_HTTP_H
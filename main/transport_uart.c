@@ -4,7 +4,10 @@
 #include "driver/uart.h"
 #include "hid_keymap.h"
 #include "ble_hid.h"
+#include "mouse_report_builder.h"
+#include "keyboard_report_builder.h"
 #include "cJSON.h"
+#include "task_topology.h"
 #include <string.h>
 
 static const char *TAG = "UART_TRANSPORT";
@@ -47,7 +50,8 @@ esp_err_t transport_uart_init(const transport_callbacks_t *callbacks)
     ESP_ERROR_CHECK(uart_param_config(UART_NUM, &uart_config));
 
     s_running = true;
-    xTaskCreate(uart_event_task, "uart_task", 4096, NULL, 10, NULL);
+    xTaskCreatePinnedToCore(uart_event_task, "uart_task", TASK_STACK_UART, NULL, TASK_PRIO_UART, NULL,
+                            TASK_CORE_NET);
 
     ESP_LOGI(TAG, "UART transport initialized on UART%d @ %d baud", UART_NUM, UART_BAUD_RATE);
     return ESP_OK;
@@ -127,6 +131,32 @@ static void uart_send_ascii_text(const char *text)
     }
 }
 
+static uint8_t uart_parse_modifiers(const cJSON *modifiers)
+{
+    uint8_t mods = 0;
+    if (!modifiers || !cJSON_IsObject(modifiers))
+    {
+        return mods;
+    }
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_control")))
+        mods |= 0x01;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_shift")))
+        mods |= 0x02;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_alt")))
+        mods |= 0x04;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_gui")))
+        mods |= 0x08;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_control")))
+        mods |= 0x10;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_shift")))
+        mods |= 0x20;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_alt")))
+        mods |= 0x40;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_gui")))
+        mods |= 0x80;
+    return mods;
+}
+
 static void process_message(const char *line)
 {
     cJSON *json = cJSON_Parse(line);
@@ -153,16 +183,29 @@ static void process_message(const char *line)
         cJSON *dy = cJSON_GetObjectItem(json, "dy");
         cJSON *wheel = cJSON_GetObjectItem(json, "wheel");
         cJSON *hwheel = cJSON_GetObjectItem(json, "hwheel");
+        cJSON *wheel_hr = cJSON_GetObjectItem(json, "wheel_hr");
+        cJSON *hwheel_hr = cJSON_GetObjectItem(json, "hwheel_hr");
         cJSON *buttons = cJSON_GetObjectItem(json, "buttons");
 
+        // Deltas are 16-bit; "wheel"/"hwheel" count whole detents and the
+        // optional "_hr" fields add 1/HID_MOUSE_WHEEL_RESOLUTION steps.
+        int32_t wheel_units = 0;
+        int32_t hwheel_units = 0;
+
         if (dx && cJSON_IsNumber(dx))
-            state.x = (int8_t)dx->valueint;
+            state.x = mouse_clamp_delta(dx->valueint);
         if (dy && cJSON_IsNumber(dy))
-            state.y = (int8_t)dy->valueint;
+            state.y = mouse_clamp_delta(dy->valueint);
         if (wheel && cJSON_IsNumber(wheel))
-            state.wheel = (int8_t)wheel->valueint;
+            wheel_units += mouse_clamp_delta(wheel->valueint) * HID_MOUSE_WHEEL_RESOLUTION;
+        if (wheel_hr && cJSON_IsNumber(wheel_hr))
+            wheel_units += mouse_clamp_delta(wheel_hr->valueint);
         if (hwheel && cJSON_IsNumber(hwheel))
-            state.hwheel = (int8_t)hwheel->valueint;
+            hwheel_units += mouse_clamp_delta(hwheel->valueint) * HID_MOUSE_WHEEL_RESOLUTION;
+        if (hwheel_hr && cJSON_IsNumber(hwheel_hr))
+            hwheel_units += mouse_clamp_delta(hwheel_hr->valueint);
+        state.wheel = mouse_clamp_delta(wheel_units);
+        state.hwheel = mouse_clamp_delta(hwheel_units);
 
         if (buttons && cJSON_IsObject(buttons))
         {
@@ -187,6 +230,38 @@ static void process_message(const char *line)
 
         s_callbacks.on_mouse(&state);
     }
+    else if (strcmp(type, "pointer_abs") == 0 && s_callbacks.on_pointer_abs)
+    {
+        pointer_abs_state_t state = {0};
+
+        cJSON *x = cJSON_GetObjectItem(json, "x");
+        cJSON *y = cJSON_GetObjectItem(json, "y");
+        cJSON *buttons = cJSON_GetObjectItem(json, "buttons");
+
+        if (!x || !cJSON_IsNumber(x) || !y || !cJSON_IsNumber(y))
+        {
+            ESP_LOGW(TAG, "pointer_abs from UART requires numeric x and y");
+            cJSON_Delete(json);
+            return;
+        }
+
+        // Negative coordinates pin to the left/top edge; the report builder
+        // clamps the other end to the descriptor's logical maximum.
+        state.x = x->valueint < 0 ? 0 : (x->valueint > 0xFFFF ? 0xFFFF : (uint16_t)x->valueint);
+        state.y = y->valueint < 0 ? 0 : (y->valueint > 0xFFFF ? 0xFFFF : (uint16_t)y->valueint);
+
+        if (buttons && cJSON_IsObject(buttons))
+        {
+            if (cJSON_IsTrue(cJSON_GetObjectItem(buttons, "left")))
+                state.buttons |= 0x01;
+            if (cJSON_IsTrue(cJSON_GetObjectItem(buttons, "right")))
+                state.buttons |= 0x02;
+            if (cJSON_IsTrue(cJSON_GetObjectItem(buttons, "middle")))
+                state.buttons |= 0x04;
+        }
+
+        s_callbacks.on_pointer_abs(&state);
+    }
     else if (strcmp(type, "keyboard") == 0 && s_callbacks.on_keyboard)
     {
         cJSON *text_item = cJSON_GetObjectItem(json, "text");
@@ -207,28 +282,7 @@ static void process_message(const char *line)
 
         keyboard_state_t state = {0};
 
-        cJSON *modifiers = cJSON_GetObjectItem(json, "modifiers");
-        if (modifiers && cJSON_IsObject(modifiers))
-        {
-            uint8_t mods = 0;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_control")))
-                mods |= 0x01;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_shift")))
-                mods |= 0x02;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_alt")))
-                mods |= 0x04;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_gui")))
-                mods |= 0x08;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_control")))
-                mods |= 0x10;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_shift")))
-                mods |= 0x20;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_alt")))
-                mods |= 0x40;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_gui")))
-                mods |= 0x80;
-            state.modifiers = mods;
-        }
+        state.modifiers = uart_parse_modifiers(cJSON_GetObjectItem(json, "modifiers"));
 
         cJSON *keys = cJSON_GetObjectItem(json, "keys");
         if (keys && cJSON_IsArray(keys))
@@ -246,6 +300,36 @@ static void process_message(const char *line)
 
         s_callbacks.on_keyboard(&state);
     }
+    else if (strcmp(type, "keyboard_nkro") == 0 && s_callbacks.on_keyboard)
+    {
+        keyboard_state_t state = {0};
+        state.modifiers = uart_parse_modifiers(cJSON_GetObjectItem(json, "modifiers"));
+
+        cJSON *bitmap = cJSON_GetObjectItem(json, "bitmap");
+        if (bitmap && (!cJSON_IsString(bitmap) || !keyboard_bitmap_from_hex(&state, bitmap->valuestring)))
+        {
+            ESP_LOGW(TAG, "keyboard_nkro from UART has an invalid bitmap");
+            cJSON_Delete(json);
+            return;
+        }
+
+        cJSON *keys = cJSON_GetObjectItem(json, "keys");
+        if (keys && cJSON_IsArray(keys))
+        {
+            cJSON *key = NULL;
+            cJSON_ArrayForEach(key, keys)
+            {
+                if (cJSON_IsNumber(key) &&
+                    (key->valueint < 0 || key->valueint > KEYBOARD_MODIFIER_USAGE_MAX ||
+                     !keyboard_state_press(&state, (uint8_t)key->valueint)))
+                {
+                    ESP_LOGW(TAG, "keyboard_nkro from UART: usage 0x%02X out of range", key->valueint);
+                }
+            }
+        }
+
+        s_callbacks.on_keyboard(&state);
+    }
     else if (strcmp(type, "consumer") == 0 && s_callbacks.on_consumer)
     {
         consumer_state_t state = {
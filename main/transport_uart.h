@@ -10,7 +10,11 @@ typedef struct
     void (*on_mouse)(const mouse_state_t *state);
     void (*on_keyboard)(const keyboard_state_t *state);
     void (*on_consumer)(const consumer_state_t *state);
+    void (*on_pointer_abs)(const pointer_abs_state_t *state);
     void (*on_control)(cJSON *message);
+    // Runs a control command and returns its response instead of sending
+    // it, for request/response transports; the caller deletes the result
+    cJSON *(*on_control_request)(cJSON *message);
 } transport_callbacks_t;
 
 esp_err_t transport_uart_init(const transport_callbacks_t *callbacks);
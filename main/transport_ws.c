@@ -1,19 +1,21 @@
 #include "transport_ws.h"
 #include "esp_log.h"
 #include "esp_http_server.h"
-#include "http_server.h"
+#include "status_publisher.h"
 #include "ws_ascii.h"
 #include "ble_hid.h"
+#include "mouse_report_builder.h"
+#include "keyboard_report_builder.h"
 #include "cJSON.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "task_topology.h"
 #include <string.h>
 #include <stdlib.h>
 
 static const char *TAG = "WS_TRANSPORT";
 
-#define WS_MAX_CLIENTS 4
 #define WS_ASCII_QUEUE_LEN 64
 #define WS_ASCII_COMBO_STAGE_DELAY_MS 8
 #define WS_ASCII_RELEASE_DELAY_MS 12
@@ -21,6 +23,7 @@ static const char *TAG = "WS_TRANSPORT";
 #define WS_ASCII_SENTINEL 0xFFFF
 
 static httpd_handle_t s_server = NULL;
+static bool s_own_server = false; // started by us, rather than attached
 static transport_callbacks_t s_callbacks = {0};
 static QueueHandle_t s_ascii_queue = NULL;
 static TaskHandle_t s_ascii_task = NULL;
@@ -76,7 +79,8 @@ static esp_err_t ws_handler(httpd_req_t *req)
     {
         register_client(fd);
         ESP_LOGI(TAG, "WebSocket client connected (fd=%d)", fd);
-        http_server_publish_wifi_status();
+        // The new client has no base for deltas yet
+        status_publisher_request_snapshot();
         return ESP_OK;
     }
 
@@ -146,6 +150,32 @@ static esp_err_t ws_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+static uint8_t ws_parse_modifiers(const cJSON *modifiers)
+{
+    uint8_t mods = 0;
+    if (!modifiers || !cJSON_IsObject(modifiers))
+    {
+        return mods;
+    }
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_control")))
+        mods |= 0x01;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_shift")))
+        mods |= 0x02;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_alt")))
+        mods |= 0x04;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_gui")))
+        mods |= 0x08;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_control")))
+        mods |= 0x10;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_shift")))
+        mods |= 0x20;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_alt")))
+        mods |= 0x40;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_gui")))
+        mods |= 0x80;
+    return mods;
+}
+
 static void process_ws_message(const char *data, size_t len)
 {
     cJSON *json = cJSON_Parse(data);
@@ -155,11 +185,16 @@ static void process_ws_message(const char *data, size_t len)
         return;
     }
 
+    transport_websocket_dispatch(json);
+    cJSON_Delete(json);
+}
+
+bool transport_websocket_dispatch(cJSON *json)
+{
     cJSON *type_item = cJSON_GetObjectItem(json, "type");
     if (!type_item || !cJSON_IsString(type_item))
     {
-        cJSON_Delete(json);
-        return;
+        return false;
     }
 
     const char *type = type_item->valuestring;
@@ -172,16 +207,29 @@ static void process_ws_message(const char *data, size_t len)
         cJSON *dy = cJSON_GetObjectItem(json, "dy");
         cJSON *wheel = cJSON_GetObjectItem(json, "wheel");
         cJSON *hwheel = cJSON_GetObjectItem(json, "hwheel");
+        cJSON *wheel_hr = cJSON_GetObjectItem(json, "wheel_hr");
+        cJSON *hwheel_hr = cJSON_GetObjectItem(json, "hwheel_hr");
         cJSON *buttons = cJSON_GetObjectItem(json, "buttons");
 
+        // Deltas are 16-bit; "wheel"/"hwheel" count whole detents and the
+        // optional "_hr" fields add 1/HID_MOUSE_WHEEL_RESOLUTION steps.
+        int32_t wheel_units = 0;
+        int32_t hwheel_units = 0;
+
         if (dx && cJSON_IsNumber(dx))
-            state.x = (int8_t)dx->valueint;
+            state.x = mouse_clamp_delta(dx->valueint);
         if (dy && cJSON_IsNumber(dy))
-            state.y = (int8_t)dy->valueint;
+            state.y = mouse_clamp_delta(dy->valueint);
         if (wheel && cJSON_IsNumber(wheel))
-            state.wheel = (int8_t)wheel->valueint;
+            wheel_units += mouse_clamp_delta(wheel->valueint) * HID_MOUSE_WHEEL_RESOLUTION;
+        if (wheel_hr && cJSON_IsNumber(wheel_hr))
+            wheel_units += mouse_clamp_delta(wheel_hr->valueint);
         if (hwheel && cJSON_IsNumber(hwheel))
-            state.hwheel = (int8_t)hwheel->valueint;
+            hwheel_units += mouse_clamp_delta(hwheel->valueint) * HID_MOUSE_WHEEL_RESOLUTION;
+        if (hwheel_hr && cJSON_IsNumber(hwheel_hr))
+            hwheel_units += mouse_clamp_delta(hwheel_hr->valueint);
+        state.wheel = mouse_clamp_delta(wheel_units);
+        state.hwheel = mouse_clamp_delta(hwheel_units);
 
         if (buttons && cJSON_IsObject(buttons))
         {
@@ -206,54 +254,61 @@ static void process_ws_message(const char *data, size_t len)
 
         s_callbacks.on_mouse(&state);
     }
+    else if (strcmp(type, "pointer_abs") == 0 && s_callbacks.on_pointer_abs)
+    {
+        pointer_abs_state_t state = {0};
+
+        cJSON *x = cJSON_GetObjectItem(json, "x");
+        cJSON *y = cJSON_GetObjectItem(json, "y");
+        cJSON *buttons = cJSON_GetObjectItem(json, "buttons");
+
+        if (!x || !cJSON_IsNumber(x) || !y || !cJSON_IsNumber(y))
+        {
+            ESP_LOGW(TAG, "pointer_abs from WS requires numeric x and y");
+            return false;
+        }
+
+        // Negative coordinates pin to the left/top edge; the report builder
+        // clamps the other end to the descriptor's logical maximum.
+        state.x = x->valueint < 0 ? 0 : (x->valueint > 0xFFFF ? 0xFFFF : (uint16_t)x->valueint);
+        state.y = y->valueint < 0 ? 0 : (y->valueint > 0xFFFF ? 0xFFFF : (uint16_t)y->valueint);
+
+        if (buttons && cJSON_IsObject(buttons))
+        {
+            if (cJSON_IsTrue(cJSON_GetObjectItem(buttons, "left")))
+                state.buttons |= 0x01;
+            if (cJSON_IsTrue(cJSON_GetObjectItem(buttons, "right")))
+                state.buttons |= 0x02;
+            if (cJSON_IsTrue(cJSON_GetObjectItem(buttons, "middle")))
+                state.buttons |= 0x04;
+        }
+
+        s_callbacks.on_pointer_abs(&state);
+    }
     else if (strcmp(type, "keyboard") == 0)
     {
         cJSON *text_item = cJSON_GetObjectItem(json, "text");
         if (text_item && cJSON_IsString(text_item))
         {
             ws_send_ascii_text(text_item->valuestring);
-            cJSON_Delete(json);
-            return;
+            return true;
         }
 
         cJSON *ascii_item = cJSON_GetObjectItem(json, "ascii");
         if (ascii_item && cJSON_IsNumber(ascii_item))
         {
             ws_send_ascii_char((uint8_t)ascii_item->valueint);
-            cJSON_Delete(json);
-            return;
+            return true;
         }
 
         if (!s_callbacks.on_keyboard)
         {
-            cJSON_Delete(json);
-            return;
+            return false;
         }
 
         keyboard_state_t state = {0};
 
-        cJSON *modifiers = cJSON_GetObjectItem(json, "modifiers");
-        if (modifiers && cJSON_IsObject(modifiers))
-        {
-            uint8_t mods = 0;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_control")))
-                mods |= 0x01;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_shift")))
-                mods |= 0x02;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_alt")))
-                mods |= 0x04;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "left_gui")))
-                mods |= 0x08;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_control")))
-                mods |= 0x10;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_shift")))
-                mods |= 0x20;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_alt")))
-                mods |= 0x40;
-            if (cJSON_IsTrue(cJSON_GetObjectItem(modifiers, "right_gui")))
-                mods |= 0x80;
-            state.modifiers = mods;
-        }
+        state.modifiers = ws_parse_modifiers(cJSON_GetObjectItem(json, "modifiers"));
 
         cJSON *keys = cJSON_GetObjectItem(json, "keys");
         if (keys && cJSON_IsArray(keys))
@@ -271,6 +326,35 @@ static void process_ws_message(const char *data, size_t len)
 
         s_callbacks.on_keyboard(&state);
     }
+    else if (strcmp(type, "keyboard_nkro") == 0 && s_callbacks.on_keyboard)
+    {
+        keyboard_state_t state = {0};
+        state.modifiers = ws_parse_modifiers(cJSON_GetObjectItem(json, "modifiers"));
+
+        cJSON *bitmap = cJSON_GetObjectItem(json, "bitmap");
+        if (bitmap && (!cJSON_IsString(bitmap) || !keyboard_bitmap_from_hex(&state, bitmap->valuestring)))
+        {
+            ESP_LOGW(TAG, "keyboard_nkro from WS has an invalid bitmap");
+            return false;
+        }
+
+        cJSON *keys = cJSON_GetObjectItem(json, "keys");
+        if (keys && cJSON_IsArray(keys))
+        {
+            cJSON *key = NULL;
+            cJSON_ArrayForEach(key, keys)
+            {
+                if (cJSON_IsNumber(key) &&
+                    (key->valueint < 0 || key->valueint > KEYBOARD_MODIFIER_USAGE_MAX ||
+                     !keyboard_state_press(&state, (uint8_t)key->valueint)))
+                {
+                    ESP_LOGW(TAG, "keyboard_nkro from WS: usage 0x%02X out of range", key->valueint);
+                }
+            }
+        }
+
+        s_callbacks.on_keyboard(&state);
+    }
     else if (strcmp(type, "consumer") == 0 && s_callbacks.on_consumer)
     {
         consumer_state_t state = {
@@ -326,8 +410,12 @@ static void process_ws_message(const char *data, size_t len)
     {
         s_callbacks.on_control(json);
     }
+    else
+    {
+        return false;
+    }
 
-    cJSON_Delete(json);
+    return true;
 }
 
 static void ws_send_keyboard_state(const keyboard_state_t *state)
@@ -417,6 +505,24 @@ static void ws_send_ascii_text(const char *text)
     }
 }
 
+size_t transport_websocket_queue_text(const char *text, size_t len, uint32_t timeout_ms)
+{
+    if (!text || !s_ascii_queue || !s_callbacks.on_keyboard)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        uint16_t value = (uint8_t)text[i];
+        if (xQueueSend(s_ascii_queue, &value, pdMS_TO_TICKS(timeout_ms)) != pdPASS)
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
 static void ws_ascii_task(void *arg)
 {
     uint16_t ascii = 0;
@@ -461,11 +567,6 @@ esp_err_t transport_websocket_init(const transport_callbacks_t *callbacks, uint1
     }
 
     s_callbacks = *callbacks;
-    for (int i = 0; i < WS_MAX_CLIENTS; ++i)
-    {
-        s_clients[i].fd = -1;
-        s_clients[i].active = false;
-    }
 
     if (!s_ascii_queue)
     {
@@ -478,7 +579,8 @@ esp_err_t transport_websocket_init(const transport_callbacks_t *callbacks, uint1
 
     if (s_ascii_queue && !s_ascii_task)
     {
-        if (xTaskCreate(ws_ascii_task, "ws_ascii", 3072, NULL, tskIDLE_PRIORITY + 2, &s_ascii_task) != pdPASS)
+        if (xTaskCreatePinnedToCore(ws_ascii_task, "ws_ascii", TASK_STACK_WS_ASCII, NULL, TASK_PRIO_WS_ASCII,
+                                    &s_ascii_task, TASK_CORE_NET) != pdPASS)
         {
             ESP_LOGE(TAG, "Failed to start ASCII task");
             vQueueDelete(s_ascii_queue);
@@ -486,17 +588,58 @@ esp_err_t transport_websocket_init(const transport_callbacks_t *callbacks, uint1
         }
     }
 
+    if (port == 0)
+    {
+        if (!s_server)
+        {
+            ESP_LOGE(TAG, "No server to host /ws; attach one or give a port");
+            return ESP_ERR_INVALID_STATE;
+        }
+        return ESP_OK;
+    }
+
+    httpd_handle_t server = NULL;
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = port;
     config.ctrl_port = port + 1;
     config.max_open_sockets = WS_MAX_CLIENTS + 2;
+    config.core_id = TASK_CORE_NET;
+    config.task_priority = TASK_PRIO_HTTPD;
+    config.stack_size = TASK_STACK_HTTPD;
 
-    if (httpd_start(&s_server, &config) != ESP_OK)
+    if (httpd_start(&server, &config) != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to start HTTP server");
         return ESP_FAIL;
     }
 
+    esp_err_t err = transport_websocket_attach(server);
+    if (err != ESP_OK)
+    {
+        httpd_stop(server);
+        return err;
+    }
+    s_own_server = true;
+
+    ESP_LOGI(TAG, "WebSocket server started on port %d", port);
+    return ESP_OK;
+}
+
+esp_err_t transport_websocket_attach(httpd_handle_t server)
+{
+    for (int i = 0; i < WS_MAX_CLIENTS; ++i)
+    {
+        s_clients[i].fd = -1;
+        s_clients[i].active = false;
+    }
+    s_server = NULL;
+    s_own_server = false;
+
+    if (!server)
+    {
+        return ESP_OK;
+    }
+
     httpd_uri_t ws_uri = {
         .uri = "/ws",
         .method = HTTP_GET,
@@ -504,9 +647,14 @@ esp_err_t transport_websocket_init(const transport_callbacks_t *callbacks, uint1
         .user_ctx = NULL,
         .is_websocket = true};
 
-    httpd_register_uri_handler(s_server, &ws_uri);
+    esp_err_t err = httpd_register_uri_handler(server, &ws_uri);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to register /ws: %s", esp_err_to_name(err));
+        return err;
+    }
 
-    ESP_LOGI(TAG, "WebSocket server started on port %d", port);
+    s_server = server;
     return ESP_OK;
 }
 
@@ -528,10 +676,10 @@ esp_err_t transport_websocket_deinit(void)
         s_ascii_queue = NULL;
     }
 
-    if (s_server)
+    if (s_server && s_own_server)
     {
         httpd_stop(s_server);
-        s_server = NULL;
+        transport_websocket_attach(NULL);
         ESP_LOGI(TAG, "WebSocket server stopped");
     }
     return ESP_OK;
@@ -555,6 +703,13 @@ esp_err_t transport_websocket_send(const char *message)
     {
         if (s_clients[i].active)
         {
+            // On a shared server a closed client's fd can come back as a
+            // page load; never write frames to a plain HTTP socket
+            if (httpd_ws_get_fd_info(s_server, s_clients[i].fd) != HTTPD_WS_CLIENT_WEBSOCKET)
+            {
+                unregister_client(s_clients[i].fd);
+                continue;
+            }
             esp_err_t err = httpd_ws_send_frame_async(s_server, s_clients[i].fd, &ws_pkt);
             if (err != ESP_OK)
             {
@@ -1,13 +1,45 @@
 #ifndef TRANSPORT_WEBSOCKET_H
 #define TRANSPORT_WEBSOCKET_H
 
+#include "sdkconfig.h"
 #include "esp_err.h"
+#include "esp_http_server.h"
 #include "transport_uart.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
+#ifdef CONFIG_HID_WS_PORT
+#define DEFAULT_WS_PORT CONFIG_HID_WS_PORT
+#else
 #define DEFAULT_WS_PORT 8765
+#endif
 
+#ifdef CONFIG_HID_WS_MAX_CLIENTS
+#define WS_MAX_CLIENTS CONFIG_HID_WS_MAX_CLIENTS
+#else
+#define WS_MAX_CLIENTS 6
+#endif
+
+// Adds /ws to a running httpd so WebSocket clients share its task and
+// sockets; the web UI server calls this before its catch-all file handler.
+// NULL detaches again (the server is stopping) and drops every client.
+esp_err_t transport_websocket_attach(httpd_handle_t server);
+
+// Starts input handling. port != 0 also starts a dedicated WebSocket httpd
+// on that port (CONFIG_HID_WS_DEDICATED_SERVER); with 0 the endpoint is
+// the one added by transport_websocket_attach.
 esp_err_t transport_websocket_init(const transport_callbacks_t *callbacks, uint16_t port);
 esp_err_t transport_websocket_deinit(void);
 esp_err_t transport_websocket_send(const char *message);
 
+// Decodes one parsed input message (mouse, keyboard, consumer, control...)
+// exactly as if it had arrived on /ws; the HTTP transport shares it.
+// False for unknown types and invalid fields.
+bool transport_websocket_dispatch(cJSON *json);
+
+// Queues text for the ws_ascii typing task, waiting up to timeout_ms per
+// character for room; returns how many characters were queued
+size_t transport_websocket_queue_text(const char *text, size_t len, uint32_t timeout_ms);
+
 #endif // TRANSPORT_WEBSOCKET_H
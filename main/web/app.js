@@ -0,0 +1,931 @@
+// /ws lives on the page's own server; firmware built with
+// CONFIG_HID_WS_DEDICATED_SERVER serves it on LEGACY_WS_PORT instead
+const LEGACY_WS_PORT = 8765;
+const AUTH_MODES = {
+    0: 'Open',
+    1: 'WEP',
+    2: 'WPA-PSK',
+    3: 'WPA2-PSK',
+    4: 'WPA/WPA2',
+    5: 'WPA2-Ent',
+    6: 'WPA3-PSK',
+    7: 'WPA2/WPA3'
+};
+
+let ws = null;
+let reconnectTimer = null;
+let wsUseLegacyPort = false;
+let wsOpened = false;
+let statusPollTimer = null;
+const MOUSE_BUTTON_NAMES = ['left', 'right', 'middle', 'back', 'forward'];
+let mouseButtons = {
+    left: false,
+    right: false,
+    middle: false,
+    back: false,
+    forward: false
+};
+let lastSentMouseButtons = { ...mouseButtons };
+const pendingMouse = { dx: 0, dy: 0, wheel: 0, hwheel: 0 };
+let mouseFrameHandle = null;
+let pointerActive = false;
+let lastPointer = { x: 0, y: 0 };
+let selectedWifiItem = null;
+let lastBleStatus = {
+    connected: false,
+    bonded: false,
+    encrypted: false,
+    authenticated: false,
+    peer_addr: 'n/a',
+    addr_type: 0
+};
+// Last full status per message type, see applyStatusMessage
+let statusModels = {};
+let pendingScan = null;
+const KEYBOARD_RELEASE_DELAY_MS = 35;
+const ASCII_SEND_DELAY_MS = 20;
+const asciiQueue = [];
+let asciiProcessing = false;
+
+async function processAsciiQueue() {
+    while (asciiQueue.length > 0) {
+        const value = asciiQueue.shift();
+        if (!sendMessage({ type: 'keyboard', ascii: value })) {
+            asciiQueue.length = 0;
+            break;
+        }
+        await new Promise((resolve) => setTimeout(resolve, ASCII_SEND_DELAY_MS));
+    }
+    asciiProcessing = false;
+}
+
+function enqueueAscii(codePoint) {
+    asciiQueue.push(codePoint);
+    if (!asciiProcessing) {
+        asciiProcessing = true;
+        processAsciiQueue();
+    }
+}
+
+const requestMouseFrame = (callback) => {
+    if (typeof window.requestAnimationFrame === 'function') {
+        return window.requestAnimationFrame(callback);
+    }
+    return window.setTimeout(callback, 16);
+};
+
+const cancelMouseFrame = (handle) => {
+    if (handle === null) {
+        return;
+    }
+    if (typeof window.cancelAnimationFrame === 'function') {
+        window.cancelAnimationFrame(handle);
+    } else {
+        clearTimeout(handle);
+    }
+};
+
+const MAX_ACCUMULATED_MOUSE_DELTA = 32767;
+
+const normalizeMouseDelta = (value) => {
+    if (!Number.isFinite(value)) {
+        return 0;
+    }
+    if (value > MAX_ACCUMULATED_MOUSE_DELTA) return MAX_ACCUMULATED_MOUSE_DELTA;
+    if (value < -MAX_ACCUMULATED_MOUSE_DELTA) return -MAX_ACCUMULATED_MOUSE_DELTA;
+    return Math.trunc(value);
+};
+
+const clampMouseValue = (value) => {
+    if (!Number.isFinite(value)) {
+        return 0;
+    }
+    if (value > 127) return 127;
+    if (value < -127) return -127;
+    return Math.trunc(value);
+};
+
+function buildMouseButtonPayload() {
+    const payload = {};
+    for (const name of MOUSE_BUTTON_NAMES) {
+        payload[name] = !!mouseButtons[name];
+    }
+    return payload;
+}
+
+function resetPendingMouse() {
+    pendingMouse.dx = 0;
+    pendingMouse.dy = 0;
+    pendingMouse.wheel = 0;
+    pendingMouse.hwheel = 0;
+}
+
+function flushMouse() {
+    const buttonPayload = buildMouseButtonPayload();
+    const accumulated = {
+        dx: normalizeMouseDelta(pendingMouse.dx),
+        dy: normalizeMouseDelta(pendingMouse.dy),
+        wheel: normalizeMouseDelta(pendingMouse.wheel),
+        hwheel: normalizeMouseDelta(pendingMouse.hwheel)
+    };
+    const hasDelta = accumulated.dx !== 0 || accumulated.dy !== 0 ||
+        accumulated.wheel !== 0 || accumulated.hwheel !== 0;
+    const buttonsChanged = MOUSE_BUTTON_NAMES.some(
+        (name) => buttonPayload[name] !== lastSentMouseButtons[name]
+    );
+
+    if (!hasDelta && !buttonsChanged) {
+        return;
+    }
+
+    let remaining = { ...accumulated };
+    let firstReport = true;
+    let sentAny = false;
+
+    while (firstReport || remaining.dx !== 0 || remaining.dy !== 0 ||
+        remaining.wheel !== 0 || remaining.hwheel !== 0) {
+        const dxChunk = clampMouseValue(remaining.dx);
+        const dyChunk = clampMouseValue(remaining.dy);
+        const wheelChunk = clampMouseValue(remaining.wheel);
+        const hwheelChunk = clampMouseValue(remaining.hwheel);
+
+        remaining.dx -= dxChunk;
+        remaining.dy -= dyChunk;
+        remaining.wheel -= wheelChunk;
+        remaining.hwheel -= hwheelChunk;
+
+        const payload = {
+            type: 'mouse',
+            dx: dxChunk,
+            dy: dyChunk,
+            wheel: wheelChunk,
+            buttons: {
+                left: buttonPayload.left,
+                right: buttonPayload.right,
+                middle: buttonPayload.middle
+            }
+        };
+
+        if (buttonPayload.back || buttonPayload.forward) {
+            payload.buttons.back = buttonPayload.back;
+            payload.buttons.forward = buttonPayload.forward;
+        }
+
+        if (hwheelChunk !== 0) {
+            payload.hwheel = hwheelChunk;
+        }
+
+        const sent = sendMessage(payload);
+        sentAny = sentAny || sent;
+        firstReport = false;
+    }
+    resetPendingMouse();
+
+    if (sentAny) {
+        lastSentMouseButtons = { ...buttonPayload };
+    }
+}
+
+function scheduleMouseFlush() {
+    if (mouseFrameHandle !== null) {
+        return;
+    }
+    mouseFrameHandle = requestMouseFrame(() => {
+        mouseFrameHandle = null;
+        flushMouse();
+    });
+}
+
+function markFieldDirty(event) {
+    event.target.dataset.userEdited = '1';
+}
+
+function resetFieldDirty(field) {
+    if (field) {
+        delete field.dataset.userEdited;
+    }
+}
+
+function setScanStatus(message) {
+    const label = document.getElementById('scanStatus');
+    if (label) {
+        label.textContent = message;
+    }
+}
+
+function updateBleStatus(data = {}) {
+    lastBleStatus = Object.assign({}, lastBleStatus, data);
+
+    const chip = document.getElementById('bleStatusChip');
+    if (!chip) {
+        return;
+    }
+
+    const connected = !!lastBleStatus.connected;
+    chip.textContent = connected ? 'Connected' : 'Not Connected';
+    chip.className = `status-chip ${connected ? 'chip-on' : 'chip-off'}`;
+
+    const peerAddrEl = document.getElementById('blePeerAddress');
+    if (peerAddrEl) {
+        const addr = connected && lastBleStatus.peer_addr && lastBleStatus.peer_addr.toLowerCase() !== 'n/a'
+            ? lastBleStatus.peer_addr
+            : 'n/a';
+        peerAddrEl.textContent = addr;
+    }
+
+    const securityEl = document.getElementById('bleSecurity');
+    if (securityEl) {
+        if (!connected) {
+            securityEl.textContent = 'n/a';
+        } else {
+            const flags = [];
+            flags.push(lastBleStatus.bonded ? 'Bonded' : 'Not Bonded');
+            flags.push(lastBleStatus.encrypted ? 'Encrypted' : 'Not Encrypted');
+            if (lastBleStatus.authenticated) {
+                flags.push('Authenticated');
+            }
+            securityEl.textContent = flags.join(' • ');
+        }
+    }
+
+    const timingEl = document.getElementById('bleLinkTiming');
+    if (timingEl) {
+        timingEl.textContent = connected && typeof lastBleStatus.conn_interval_ms === 'number'
+            ? `${lastBleStatus.conn_interval_ms} ms • latency ${lastBleStatus.conn_latency} • ${lastBleStatus.conn_profile}`
+                + (lastBleStatus.tx_phy ? ` • ${lastBleStatus.tx_phy} PHY • ${lastBleStatus.max_tx_octets} B PDU` : '')
+            : 'n/a';
+    }
+}
+
+function log(message, type = 'info') {
+    const container = document.getElementById('logContainer');
+    if (!container) {
+        return;
+    }
+
+    const entry = document.createElement('div');
+    entry.className = `log-entry ${type}`;
+    entry.textContent = `[${new Date().toLocaleTimeString()}] ${message}`;
+    container.appendChild(entry);
+    container.scrollTop = container.scrollHeight;
+
+    while (container.children.length > 100) {
+        container.removeChild(container.firstChild);
+    }
+}
+
+function clearLog() {
+    const container = document.getElementById('logContainer');
+    if (container) {
+        container.innerHTML = '';
+    }
+}
+
+function setScanningState(active) {
+    const button = document.getElementById('scanBtn');
+    if (!button) {
+        return;
+    }
+
+    if (active) {
+        button.disabled = true;
+        button.innerHTML = '<span class="spinner"></span> Scanning...';
+        setScanStatus('Scanning for nearby networks...');
+    } else {
+        button.disabled = false;
+        button.textContent = '🔍 Scan';
+    }
+}
+
+function connectWS() {
+    clearTimeout(reconnectTimer);
+
+    const hostname = window.location.hostname || '192.168.4.1';
+    const wsUrl = wsUseLegacyPort
+        ? `ws://${hostname}:${LEGACY_WS_PORT}/ws`
+        : `ws://${window.location.host || hostname}/ws`;
+    wsOpened = false;
+
+    log(`Connecting to ${wsUrl}...`);
+
+    ws = new WebSocket(wsUrl);
+
+    ws.onopen = () => {
+        wsOpened = true;
+        log('WebSocket connected', 'success');
+        document.getElementById('wsIndicator').className = 'status-indicator connected';
+        document.getElementById('wsStatus').textContent = 'Connected';
+
+        if (statusPollTimer) {
+            clearInterval(statusPollTimer);
+        }
+
+        getStatus();
+        statusPollTimer = setInterval(getStatus, 5000);
+    };
+
+    ws.onclose = () => {
+        log('WebSocket disconnected', 'error');
+        document.getElementById('wsIndicator').className = 'status-indicator disconnected';
+        document.getElementById('wsStatus').textContent = 'Disconnected';
+        ws = null;
+        statusModels = {};
+
+        if (statusPollTimer) {
+            clearInterval(statusPollTimer);
+            statusPollTimer = null;
+        }
+
+        // Never got through: try the other endpoint next time
+        if (!wsOpened) {
+            wsUseLegacyPort = !wsUseLegacyPort;
+        }
+        reconnectTimer = setTimeout(connectWS, 3000);
+    };
+
+    ws.onerror = () => {
+        log('WebSocket error', 'error');
+    };
+
+    ws.onmessage = (event) => {
+        try {
+            const msg = JSON.parse(event.data);
+            handleMessage(msg);
+        } catch (err) {
+            log(`Parse error: ${err}`, 'error');
+        }
+    };
+}
+
+function handleMessage(msg) {
+    if (!msg || !msg.type) {
+        return;
+    }
+
+    if (msg.type === 'state') {
+        document.getElementById('bleState').textContent = msg.state || 'Unknown';
+        if (msg.state === 'CONNECTED') {
+            log('BLE device connected', 'success');
+        }
+        const stateUpdate = { connected: msg.state === 'CONNECTED' };
+        if (typeof msg.bonded === 'boolean') {
+            stateUpdate.bonded = msg.bonded;
+        }
+        updateBleStatus(stateUpdate);
+    } else if (msg.type === 'control_response') {
+        if (msg.ok) {
+            log(`Command '${msg.cmd}' successful`, 'success');
+            if (msg.cmd === 'wifi_get' && msg.wifi) {
+                updateWifiStatus(msg.wifi);
+            } else if ((msg.cmd === 'wifi_set' || msg.cmd === 'wifi_clear') && msg.ok) {
+                getStatus();
+            }
+        } else {
+            log(`Command '${msg.cmd}' failed: ${msg.err || 'error'}`, 'error');
+            if (msg.cmd === 'wifi_scan') {
+                setScanningState(false);
+                setScanStatus(`Scan failed: ${msg.err || 'Unknown error'}`);
+            }
+        }
+    } else if (msg.type === 'scan_results') {
+        collectScanPage(msg);
+    } else if (msg.type === 'wifi_status') {
+        const status = applyStatusMessage(msg);
+        if (status) {
+            updateWifiStatus(status);
+        }
+    } else if (msg.type === 'ble_status') {
+        const status = applyStatusMessage(msg);
+        if (status) {
+            updateBleStatus(status);
+        }
+    }
+}
+
+// A scan arrives as pages sharing a scan_id; show it once the last
+// one is in. A page from a newer scan drops the partial older one.
+function collectScanPage(msg) {
+    const networks = Array.isArray(msg.networks) ? msg.networks : [];
+    if (msg.scan_id === undefined) {
+        displayScanResults(networks);
+        return;
+    }
+    if (!pendingScan || pendingScan.id !== msg.scan_id) {
+        if (msg.offset !== 0) {
+            return;
+        }
+        pendingScan = { id: msg.scan_id, networks: [] };
+    }
+    if (msg.offset !== pendingScan.networks.length) {
+        pendingScan = null;
+        setScanningState(false);
+        setScanStatus('Scan results incomplete. Try scanning again.');
+        return;
+    }
+    pendingScan.networks.push(...networks);
+    if (msg.last) {
+        displayScanResults(pendingScan.networks);
+        pendingScan = null;
+    }
+}
+
+// Status messages are versioned; a delta only carries the fields
+// that changed since the previous version, and "removed" names the
+// ones that went away. A gap means a missed message, so ask for a
+// full snapshot instead of guessing.
+function applyStatusMessage(msg) {
+    const { type, version, delta, removed, ...fields } = msg;
+    const current = statusModels[type];
+    if (delta) {
+        if (!current || current.version + 1 !== version) {
+            sendControl('status_snapshot');
+            return null;
+        }
+        const next = Object.assign({}, current.fields, fields);
+        (removed || []).forEach((key) => delete next[key]);
+        statusModels[type] = { version, fields: next };
+    } else {
+        statusModels[type] = { version, fields };
+    }
+    return statusModels[type].fields;
+}
+
+function sendMessage(payload) {
+    if (!ws || ws.readyState !== WebSocket.OPEN) {
+        log('WebSocket not connected', 'error');
+        return false;
+    }
+    ws.send(JSON.stringify(payload));
+    return true;
+}
+
+function sendControl(cmd, extra = {}) {
+    return sendMessage({ type: 'control', cmd, ...extra });
+}
+
+function getStatus() {
+    sendControl('wifi_get');
+}
+
+async function fetchHttpStatus() {
+    try {
+        const response = await fetch('/api', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify({ cmd: 'get_status' })
+        });
+
+        if (!response.ok) {
+            return;
+        }
+
+        const data = await response.json();
+        if (data && data.ok) {
+            updateWifiStatus(data);
+        }
+    } catch (err) {
+        log(`Status fetch failed: ${err}`, 'error');
+    }
+}
+
+function updateWifiStatus(status) {
+    if (!status) {
+        return;
+    }
+
+    const hostname = status.hostname || 'ESP32 HID';
+    const mode = (status.mode || 'unknown').toUpperCase();
+    const ip = status.ip || '-';
+    const connected = !!status.connected;
+
+    document.getElementById('deviceTitle').textContent = hostname.toUpperCase();
+    document.getElementById('wifiMode').textContent = mode;
+    document.getElementById('ipAddress').textContent = ip;
+
+    const hostDisplay = document.getElementById('infoHostname');
+    if (hostDisplay) {
+        hostDisplay.textContent = `${hostname}.local`;
+    }
+
+    const ipDisplay = document.getElementById('infoIp');
+    if (ipDisplay) {
+        ipDisplay.textContent = ip;
+    }
+
+    const apMacDisplay = document.getElementById('infoApMac');
+    if (apMacDisplay) {
+        apMacDisplay.textContent = status.mac_ap || 'N/A';
+    }
+
+    const staMacDisplay = document.getElementById('infoStaMac');
+    if (staMacDisplay) {
+        staMacDisplay.textContent = status.mac_sta || 'N/A';
+    }
+
+    const urlBox = document.getElementById('urlBox');
+    const hostnameUrl = document.getElementById('hostnameUrl');
+    const ipUrl = document.getElementById('ipUrl');
+
+    if ((hostname && hostname !== '') || (ip && ip !== '-')) {
+        urlBox.style.display = 'block';
+        if (hostnameUrl) {
+            hostnameUrl.textContent = `${hostname}.local`;
+            hostnameUrl.href = `http://${hostname}.local/`;
+        }
+        if (ipUrl) {
+            ipUrl.textContent = ip;
+            ipUrl.href = `http://${ip}/`;
+        }
+    } else {
+        urlBox.style.display = 'none';
+    }
+
+    setScanningState(!!status.scanning);
+
+    const ssidField = document.getElementById('wifiSsid');
+    const passField = document.getElementById('wifiPass');
+
+    if (status.creds && ssidField) {
+        if (!ssidField.dataset.userEdited) {
+            ssidField.value = status.creds.ssid || '';
+            delete ssidField.dataset.userEdited;
+        }
+    }
+
+    if (passField) {
+        const hasStoredPsk = !!(status.creds && status.creds.has_psk);
+        passField.placeholder = hasStoredPsk ? 'Saved password (leave blank to keep)' : 'WiFi password';
+
+        if (!passField.dataset.userEdited) {
+            if (!hasStoredPsk) {
+                passField.value = '';
+            }
+            else if (!passField.value) {
+                passField.value = '';
+            }
+            if (passField.dataset.userEdited && !passField.value) {
+                delete passField.dataset.userEdited;
+            }
+        }
+    }
+
+    const indicator = document.getElementById('wsIndicator');
+    if (connected && indicator.classList.contains('disconnected')) {
+        indicator.className = 'status-indicator connected';
+    }
+}
+
+function displayScanResults(networks) {
+    setScanningState(false);
+
+    const list = document.getElementById('wifiList');
+    if (!list) {
+        return;
+    }
+
+    list.innerHTML = '';
+    selectedWifiItem = null;
+
+    setScanStatus(networks.length ? `Found ${networks.length} network${networks.length === 1 ? '' : 's'}.` : 'No networks found. Try scanning again.');
+
+    if (!networks.length) {
+        const empty = document.createElement('div');
+        empty.className = 'wifi-item';
+        empty.textContent = 'No networks found.';
+        list.appendChild(empty);
+        list.style.display = 'block';
+        return;
+    }
+
+    const ssidField = document.getElementById('wifiSsid');
+    const passField = document.getElementById('wifiPass');
+
+    networks
+        .slice()
+        .sort((a, b) => (b.rssi ?? -100) - (a.rssi ?? -100))
+        .forEach((network) => {
+            const option = document.createElement('label');
+            option.className = 'wifi-item';
+
+            const radio = document.createElement('input');
+            radio.type = 'radio';
+            radio.name = 'wifiNetwork';
+            radio.value = network.ssid || '';
+            radio.style.marginRight = '12px';
+
+            const info = document.createElement('div');
+            info.innerHTML = `<strong>${network.ssid || '(hidden)'}</strong><br><small>${AUTH_MODES[network.auth] || 'Unknown'} • ${network.rssi} dBm</small>`;
+
+            const signal = document.createElement('div');
+            signal.className = 'wifi-signal';
+            signal.innerHTML = `<span class="signal-strength">📶</span>${network.channel}`;
+
+            const content = document.createElement('div');
+            content.style.display = 'flex';
+            content.style.justifyContent = 'space-between';
+            content.style.alignItems = 'center';
+            content.style.width = '100%';
+            content.appendChild(info);
+            content.appendChild(signal);
+
+            radio.addEventListener('change', () => {
+                if (!radio.checked) {
+                    return;
+                }
+
+                if (selectedWifiItem) {
+                    selectedWifiItem.classList.remove('selected');
+                }
+                selectedWifiItem = option;
+                option.classList.add('selected');
+
+                if (ssidField) {
+                    ssidField.value = network.ssid || '';
+                    ssidField.dataset.userEdited = '1';
+                }
+                if (passField) {
+                    passField.focus();
+                }
+            });
+
+            option.appendChild(radio);
+            option.appendChild(content);
+            list.appendChild(option);
+
+            if (ssidField && ssidField.value && ssidField.value === network.ssid) {
+                radio.checked = true;
+                radio.dispatchEvent(new Event('change'));
+            }
+        });
+
+    list.style.display = 'block';
+}
+
+function scanWifi() {
+    if (sendControl('wifi_scan')) {
+        log('WiFi scan requested...');
+        setScanningState(true);
+    }
+}
+
+function connectToWifi() {
+    const ssidField = document.getElementById('wifiSsid');
+    const passField = document.getElementById('wifiPass');
+
+    if (!ssidField || !passField) {
+        return;
+    }
+
+    const ssid = ssidField.value.trim();
+    const password = passField.value;
+
+    if (!ssid) {
+        log('Please enter an SSID.', 'error');
+        ssidField.focus();
+        return;
+    }
+
+    if (sendControl('wifi_set', { ssid, psk: password })) {
+        log(`Connecting to '${ssid}'...`);
+        resetFieldDirty(ssidField);
+        resetFieldDirty(passField);
+    }
+}
+
+function clearWifiConfig() {
+    if (sendControl('wifi_clear')) {
+        log('Clearing stored WiFi configuration...');
+        const ssidField = document.getElementById('wifiSsid');
+        const passField = document.getElementById('wifiPass');
+        if (ssidField) {
+            ssidField.value = '';
+            resetFieldDirty(ssidField);
+        }
+        if (passField) {
+            passField.value = '';
+            resetFieldDirty(passField);
+        }
+    }
+}
+
+function setMouseButton(button, pressed) {
+    if (!(button in mouseButtons)) {
+        return;
+    }
+    mouseButtons[button] = !!pressed;
+    sendMouseUpdate(0, 0, 0, 0, { force: true });
+}
+
+function sendMouseUpdate(dx = 0, dy = 0, wheel = 0, hwheel = 0, options = {}) {
+    const opts = (typeof options === 'object' && options !== null) ? options : {};
+
+    const dxDelta = normalizeMouseDelta(dx);
+    const dyDelta = normalizeMouseDelta(dy);
+    const wheelDelta = normalizeMouseDelta(wheel);
+    const hwheelDelta = normalizeMouseDelta(hwheel);
+
+    pendingMouse.dx = normalizeMouseDelta(pendingMouse.dx + dxDelta);
+    pendingMouse.dy = normalizeMouseDelta(pendingMouse.dy + dyDelta);
+    pendingMouse.wheel = normalizeMouseDelta(pendingMouse.wheel + wheelDelta);
+    pendingMouse.hwheel = normalizeMouseDelta(pendingMouse.hwheel + hwheelDelta);
+
+    if (opts.force) {
+        cancelMouseFrame(mouseFrameHandle);
+        mouseFrameHandle = null;
+        flushMouse();
+        return;
+    }
+
+    scheduleMouseFlush();
+}
+
+function scrollWheel(direction) {
+    if (!direction) {
+        return;
+    }
+    const step = direction > 0 ? 1 : -1;
+    sendMouseUpdate(0, 0, step, 0, { force: true });
+}
+
+function initMousePad() {
+    const pad = document.getElementById('mousePad');
+    if (!pad) {
+        return;
+    }
+
+    pad.addEventListener('contextmenu', (event) => event.preventDefault());
+
+    pad.addEventListener('pointerdown', (event) => {
+        if (event.button !== 0) {
+            return;
+        }
+        pointerActive = true;
+        lastPointer = { x: event.clientX, y: event.clientY };
+        pad.setPointerCapture(event.pointerId);
+        mouseButtons.left = true;
+        sendMouseUpdate(0, 0, 0, 0, { force: true });
+        event.preventDefault();
+    });
+
+    pad.addEventListener('pointermove', (event) => {
+        if (!pointerActive) {
+            return;
+        }
+
+        const rawDx = (typeof event.movementX === 'number') ? event.movementX
+            : (event.clientX - lastPointer.x);
+        const rawDy = (typeof event.movementY === 'number') ? event.movementY
+            : (event.clientY - lastPointer.y);
+
+        const dx = Math.round(rawDx * 0.8);
+        const dy = Math.round(rawDy * 0.8);
+
+        lastPointer = { x: event.clientX, y: event.clientY };
+
+        if (dx !== 0 || dy !== 0) {
+            sendMouseUpdate(dx, dy);
+        }
+
+        event.preventDefault();
+    });
+
+    const releasePointer = (event) => {
+        pointerActive = false;
+        try {
+            pad.releasePointerCapture(event.pointerId);
+        } catch (_) {
+            /* ignore */
+        }
+        if (event.type === 'pointerup' && event.button === 0) {
+            mouseButtons.left = false;
+        }
+        if (event.type === 'pointerleave' || event.type === 'pointercancel') {
+            mouseButtons.left = false;
+        }
+        sendMouseUpdate(0, 0, 0, 0, { force: true });
+        event.preventDefault();
+    };
+
+    pad.addEventListener('pointerup', releasePointer);
+    pad.addEventListener('pointerleave', releasePointer);
+    pad.addEventListener('pointercancel', releasePointer);
+
+    pad.addEventListener('wheel', (event) => {
+        event.preventDefault();
+        const direction = event.deltaY < 0 ? 1 : -1;
+        scrollWheel(direction);
+    }, { passive: false });
+}
+
+function pressKey(key) {
+    if (typeof key === 'string' && key.length > 0) {
+        sendKeyboardAscii(key[0]);
+        return;
+    }
+    if (Number.isInteger(key)) {
+        sendKeyboardSpecial(key);
+    }
+}
+
+function sendKeyboardSpecial(code, modifiers = {}) {
+    if (!Number.isInteger(code)) {
+        return;
+    }
+
+    const payload = { type: 'keyboard', keys: [code] };
+    if (modifiers && Object.keys(modifiers).length > 0) {
+        payload.modifiers = modifiers;
+    }
+
+    sendMessage(payload);
+    setTimeout(() => {
+        sendMessage({ type: 'keyboard', keys: [], modifiers: {} });
+    }, KEYBOARD_RELEASE_DELAY_MS);
+}
+
+function sendKeyboardAscii(ch) {
+    if (!ch) {
+        return;
+    }
+
+    const codePoint = ch.codePointAt(0);
+    if (!Number.isInteger(codePoint) || codePoint > 0xFF) {
+        return;
+    }
+
+    enqueueAscii(codePoint);
+}
+
+function sendKeyboardText(text) {
+    if (!text) {
+        return;
+    }
+    sendMessage({ type: 'keyboard', text });
+}
+
+async function typeText() {
+    const textarea = document.getElementById('textToType');
+    if (!textarea) {
+        return;
+    }
+
+    const text = textarea.value || '';
+    if (!text) {
+        return;
+    }
+
+    sendKeyboardText(text);
+}
+
+async function testKeyboardSequence() {
+    log('Testing keyboard sequence', 'info');
+
+    const sequence = [0x04, 0x05, 0x06, 0x2C, 0x1E, 0x1F, 0x20];
+    for (const code of sequence) {
+        pressKey(code);
+        await new Promise((resolve) => setTimeout(resolve, 150));
+    }
+
+    log('Keyboard sequence test complete', 'success');
+}
+
+function sendConsumer(usage) {
+    if (!Number.isInteger(usage)) {
+        return;
+    }
+
+    if (sendMessage({ type: 'consumer', usage, pressed: true })) {
+        setTimeout(() => {
+            sendMessage({ type: 'consumer', usage: 0, pressed: false });
+        }, 80);
+    }
+}
+
+window.addEventListener('load', () => {
+    const ssidField = document.getElementById('wifiSsid');
+    const passField = document.getElementById('wifiPass');
+
+    [ssidField, passField].forEach((field) => {
+        if (!field) {
+            return;
+        }
+        field.addEventListener('input', markFieldDirty);
+        field.addEventListener('blur', () => {
+            if (!field.value) {
+                resetFieldDirty(field);
+            }
+        });
+    });
+
+    initMousePad();
+    connectWS();
+    fetchHttpStatus();
+    updateBleStatus(lastBleStatus);
+    setScanStatus('Ready to scan for Wi-Fi networks.');
+});
+
+window.addEventListener('beforeunload', () => {
+    if (ws) {
+        ws.close();
+    }
+});
@@ -0,0 +1,277 @@
+#include "web_assets.h"
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+// strcmp of a NUL-terminated table path against path[0..len)
+static int compare_path(const char *entry, const char *path, size_t len)
+{
+    int cmp = strncmp(entry, path, len);
+    if (cmp != 0)
+    {
+        return cmp;
+    }
+    return entry[len] == '\0' ? 0 : 1;
+}
+
+const web_asset_t *web_assets_find(const char *path, size_t len)
+{
+    if (!path || memchr(path, '\0', len))
+    {
+        return NULL;
+    }
+
+    size_t lo = 0;
+    size_t hi = g_web_asset_count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = compare_path(g_web_assets[mid].path, path, len);
+        if (cmp == 0)
+        {
+            return &g_web_assets[mid];
+        }
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+// Parses digits up to the first non-digit; saturates instead of wrapping.
+// Returns false when there are no digits.
+static bool parse_size(const char **p, size_t *value)
+{
+    const char *s = *p;
+    size_t v = 0;
+    while (*s >= '0' && *s <= '9')
+    {
+        size_t digit = (size_t)(*s - '0');
+        v = (v > (SIZE_MAX - digit) / 10) ? SIZE_MAX : v * 10 + digit;
+        s++;
+    }
+    if (s == *p)
+    {
+        return false;
+    }
+    *p = s;
+    *value = v;
+    return true;
+}
+
+web_range_t web_assets_parse_range(const char *range, size_t size, size_t *start, size_t *len)
+{
+    if (!range || strncasecmp(range, "bytes=", 6) != 0 || strchr(range, ','))
+    {
+        return WEB_RANGE_NONE;
+    }
+
+    const char *p = range + 6;
+    while (is_space(*p))
+    {
+        p++;
+    }
+
+    size_t first = 0;
+    size_t last = SIZE_MAX;
+    if (*p == '-')
+    {
+        // Suffix: the last n bytes
+        p++;
+        size_t suffix;
+        if (!parse_size(&p, &suffix))
+        {
+            return WEB_RANGE_NONE;
+        }
+        while (is_space(*p))
+        {
+            p++;
+        }
+        if (*p != '\0')
+        {
+            return WEB_RANGE_NONE;
+        }
+        if (suffix == 0 || size == 0)
+        {
+            return WEB_RANGE_UNSATISFIABLE;
+        }
+        first = suffix >= size ? 0 : size - suffix;
+    }
+    else
+    {
+        if (!parse_size(&p, &first) || *p++ != '-')
+        {
+            return WEB_RANGE_NONE;
+        }
+        if (*p >= '0' && *p <= '9')
+        {
+            parse_size(&p, &last);
+        }
+        while (is_space(*p))
+        {
+            p++;
+        }
+        if (*p != '\0' || last < first)
+        {
+            return WEB_RANGE_NONE;
+        }
+        if (first >= size)
+        {
+            return WEB_RANGE_UNSATISFIABLE;
+        }
+    }
+
+    if (last >= size)
+    {
+        last = size - 1;
+    }
+    *start = first;
+    *len = last - first + 1;
+    return WEB_RANGE_OK;
+}
+
+// q values are at most three decimals, so anything but 0[.000] is nonzero
+static bool q_is_zero(const char *q, size_t len)
+{
+    if (len == 0 || q[0] != '0')
+    {
+        return false;
+    }
+    for (size_t i = 1; i < len; i++)
+    {
+        if (q[i] != '.' && q[i] != '0')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool web_assets_accepts_gzip(const char *accept_encoding)
+{
+    if (!accept_encoding)
+    {
+        return false;
+    }
+
+    int gzip = -1; // -1 not listed, else 0/1
+    int star = -1;
+    const char *p = accept_encoding;
+    while (*p)
+    {
+        while (*p == ',' || is_space(*p))
+        {
+            p++;
+        }
+        const char *name = p;
+        while (*p && *p != ',' && *p != ';' && !is_space(*p))
+        {
+            p++;
+        }
+        size_t name_len = (size_t)(p - name);
+
+        bool allowed = true;
+        while (*p && *p != ',')
+        {
+            // Parameters: only q matters
+            while (*p == ';' || is_space(*p))
+            {
+                p++;
+            }
+            if ((p[0] == 'q' || p[0] == 'Q') && p[1] == '=')
+            {
+                const char *q = p + 2;
+                p = q;
+                while (*p && *p != ',' && *p != ';' && !is_space(*p))
+                {
+                    p++;
+                }
+                allowed = !q_is_zero(q, (size_t)(p - q));
+            }
+            else
+            {
+                while (*p && *p != ',' && *p != ';')
+                {
+                    p++;
+                }
+            }
+        }
+
+        if ((name_len == 4 && strncasecmp(name, "gzip", 4) == 0) ||
+            (name_len == 6 && strncasecmp(name, "x-gzip", 6) == 0))
+        {
+            gzip = allowed;
+        }
+        else if (name_len == 1 && name[0] == '*')
+        {
+            star = allowed;
+        }
+    }
+
+    if (gzip >= 0)
+    {
+        return gzip;
+    }
+    return star > 0;
+}
+
+bool web_assets_etag_matches(const char *if_none_match, const char *etag)
+{
+    if (!if_none_match || !etag)
+    {
+        return false;
+    }
+
+    size_t etag_len = strlen(etag);
+    const char *p = if_none_match;
+    while (*p)
+    {
+        while (*p == ',' || is_space(*p))
+        {
+            p++;
+        }
+        if (*p == '*')
+        {
+            return true;
+        }
+        if (p[0] == 'W' && p[1] == '/')
+        {
+            p += 2;
+        }
+        if (*p != '"')
+        {
+            // Not an entity tag; skip to the next list element
+            while (*p && *p != ',')
+            {
+                p++;
+            }
+            continue;
+        }
+        const char *tag = p++;
+        while (*p && *p != '"')
+        {
+            p++;
+        }
+        if (*p != '"')
+        {
+            return false;
+        }
+        p++;
+        size_t tag_len = (size_t)(p - tag);
+        if (tag_len == etag_len && memcmp(tag, etag, tag_len) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One embedded web file. The table lives in web_assets_data.c, which
+// tools/compress_web_assets.py writes into the build directory: every file
+// is stored as-is and gzipped, each with a strong ETag over its own bytes.
+// Entries are sorted by path in strcmp order.
+typedef struct
+{
+    const char *path;         // request URI, e.g. "/"
+    const char *content_type;
+    const uint8_t *data;      // identity encoding
+    size_t size;
+    const char *etag;         // quoted, e.g. "\"3f2a...\""
+    const uint8_t *gz_data;   // gzip encoding
+    size_t gz_size;
+    const char *gz_etag;
+} web_asset_t;
+
+extern const web_asset_t g_web_assets[];
+extern const size_t g_web_asset_count;
+
+typedef enum
+{
+    WEB_RANGE_NONE = 0,       // no usable Range; send the whole file
+    WEB_RANGE_OK,             // send [start, start + len)
+    WEB_RANGE_UNSATISFIABLE,  // answer 416
+} web_range_t;
+
+// Binary search on the first len bytes of path (so a query string can be
+// left off without copying), NULL when the file is not embedded
+const web_asset_t *web_assets_find(const char *path, size_t len);
+
+// Parses a single "bytes=" range against a file of size bytes. Other units,
+// multiple ranges and malformed values give WEB_RANGE_NONE, which RFC 9110
+// allows a server to answer with the whole file.
+web_range_t web_assets_parse_range(const char *range, size_t size, size_t *start, size_t *len);
+
+// True when an Accept-Encoding value allows gzip (a q=0 refuses it)
+bool web_assets_accepts_gzip(const char *accept_encoding);
+
+// True when an If-None-Match value lists etag or is "*". Uses the weak
+// comparison RFC 9110 asks for, so W/"x" matches "x".
+bool web_assets_etag_matches(const char *if_none_match, const char *etag);
+
+#endif // WEB_ASSETS_H
@@ -247,11 +247,14 @@ static void sta_retry_timer_callback(TimerHandle_t xTimer)
         return;
     }
 
+    // Runs in the timer service task, which must never block; a full event
+    // queue just pushes the retry back by another period
     esp_err_t err = esp_event_post(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_RETRY_CONNECT,
-                                   NULL, 0, portMAX_DELAY);
+                                   NULL, 0, 0);
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to post retry event: %s", esp_err_to_name(err));
+        ESP_LOGW(TAG, "Failed to post retry event: %s; retrying later", esp_err_to_name(err));
+        xTimerStart(xTimer, 0);
     }
 }
 
@@ -20,7 +20,9 @@ typedef struct
     int retry_count;
 } wifi_manager_sta_info_t;
 
-typedef void (*wifi_scan_callback_t)(const wifi_ap_record_t *records, uint16_t count);
+// records belong to the scan and are freed after the callback returns;
+// the callback may reorder or overwrite them in place
+typedef void (*wifi_scan_callback_t)(wifi_ap_record_t *records, uint16_t count);
 
 typedef struct
 {
@@ -0,0 +1,194 @@
+#include "wifi_scan_results.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Room kept for closing a page: ],"last":false} and the terminator
+#define SCAN_PAGE_TAIL_LEN 16
+
+typedef struct
+{
+    char *buf;
+    size_t size;
+    size_t len;
+    bool full; // something did not fit; len is no longer meaningful
+} scan_writer_t;
+
+static void scan_writer_printf(scan_writer_t *w, const char *fmt, ...)
+{
+    if (w->full)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(w->buf + w->len, w->size - w->len, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= w->size - w->len)
+    {
+        w->full = true;
+        return;
+    }
+    w->len += (size_t)n;
+}
+
+static size_t scan_ssid_len(const wifi_ap_record_t *record)
+{
+    const uint8_t *end = memchr(record->ssid, '\0', sizeof(record->ssid));
+    return end ? (size_t)(end - record->ssid) : sizeof(record->ssid);
+}
+
+// Length of the UTF-8 sequence at s, 0 if it is not valid
+static size_t scan_utf8_len(const uint8_t *s, size_t avail)
+{
+    size_t len = s[0] < 0x80 ? 1 : s[0] >= 0xC2 && s[0] <= 0xDF ? 2 : s[0] >= 0xE0 && s[0] <= 0xEF ? 3
+                                 : s[0] >= 0xF0 && s[0] <= 0xF4 ? 4 : 0;
+    if (len == 0 || len > avail)
+    {
+        return 0;
+    }
+    for (size_t i = 1; i < len; ++i)
+    {
+        if ((s[i] & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+    }
+    return len;
+}
+
+// SSIDs are raw bytes; escape what JSON needs and replace bytes that are
+// not UTF-8, which a browser would otherwise reject with the whole frame
+static void scan_writer_ssid(scan_writer_t *w, const wifi_ap_record_t *record)
+{
+    const uint8_t *ssid = record->ssid;
+    size_t len = scan_ssid_len(record);
+    scan_writer_printf(w, "\"");
+    for (size_t i = 0; i < len && !w->full;)
+    {
+        size_t seq = scan_utf8_len(&ssid[i], len - i);
+        if (seq == 0)
+        {
+            scan_writer_printf(w, "\\ufffd");
+            ++i;
+        }
+        else if (ssid[i] == '"' || ssid[i] == '\\')
+        {
+            scan_writer_printf(w, "\\%c", ssid[i]);
+            ++i;
+        }
+        else if (ssid[i] < 0x20)
+        {
+            scan_writer_printf(w, "\\u%04x", ssid[i]);
+            ++i;
+        }
+        else
+        {
+            scan_writer_printf(w, "%.*s", (int)seq, (const char *)&ssid[i]);
+            i += seq;
+        }
+    }
+    scan_writer_printf(w, "\"");
+}
+
+size_t wifi_scan_results_compact(wifi_ap_record_t *records, size_t count, bool dedup_ssid, bool sort_by_rssi)
+{
+    if (!records)
+    {
+        return 0;
+    }
+
+    size_t kept = count;
+    if (dedup_ssid)
+    {
+        kept = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t len = scan_ssid_len(&records[i]);
+            size_t match = kept;
+            for (size_t j = 0; len > 0 && j < kept; ++j)
+            {
+                if (scan_ssid_len(&records[j]) == len && memcmp(records[j].ssid, records[i].ssid, len) == 0)
+                {
+                    match = j;
+                    break;
+                }
+            }
+            if (match == kept)
+            {
+                if (kept != i)
+                {
+                    records[kept] = records[i];
+                }
+                ++kept;
+            }
+            else if (records[i].rssi > records[match].rssi)
+            {
+                records[match] = records[i];
+            }
+        }
+    }
+
+    if (sort_by_rssi)
+    {
+        // Insertion sort: scans are short and it keeps equal RSSIs in order
+        for (size_t i = 1; i < kept; ++i)
+        {
+            wifi_ap_record_t record = records[i];
+            size_t j = i;
+            while (j > 0 && records[j - 1].rssi < record.rssi)
+            {
+                records[j] = records[j - 1];
+                --j;
+            }
+            records[j] = record;
+        }
+    }
+    return kept;
+}
+
+size_t wifi_scan_results_page(char *buf, size_t size, uint32_t scan_id, const wifi_ap_record_t *records,
+                              size_t total, size_t offset, size_t *len)
+{
+    *len = 0;
+    if (!buf || size < SCAN_PAGE_TAIL_LEN)
+    {
+        return 0;
+    }
+
+    // Networks are written against a size that leaves room for the tail
+    scan_writer_t w = {.buf = buf, .size = size - SCAN_PAGE_TAIL_LEN + 1};
+    scan_writer_printf(&w, "{\"type\":\"scan_results\",\"scan_id\":%lu,\"offset\":%u,\"total\":%u,\"networks\":[",
+                       (unsigned long)scan_id, (unsigned)offset, (unsigned)total);
+    if (w.full)
+    {
+        return 0;
+    }
+
+    size_t written = 0;
+    for (size_t i = offset; records && i < total; ++i)
+    {
+        size_t start = w.len;
+        scan_writer_printf(&w, "%s{\"ssid\":", written > 0 ? "," : "");
+        scan_writer_ssid(&w, &records[i]);
+        scan_writer_printf(&w, ",\"rssi\":%d,\"channel\":%u,\"auth\":%d}",
+                           records[i].rssi, records[i].primary, (int)records[i].authmode);
+        if (w.full)
+        {
+            // Leave it for the next page
+            w.len = start;
+            w.full = false;
+            break;
+        }
+        ++written;
+    }
+
+    w.size = size;
+    scan_writer_printf(&w, "],\"last\":%s}", offset + written >= total ? "true" : "false");
+    if (w.full)
+    {
+        return 0;
+    }
+    *len = w.len;
+    return written;
+}
@@ -0,0 +1,27 @@
+#ifndef WIFI_SCAN_RESULTS_H
+#define WIFI_SCAN_RESULTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_wifi_types.h"
+
+// Scan results go out as a series of scan_results pages, written straight
+// from the AP records into a fixed buffer:
+//   {"type":"scan_results","scan_id":3,"offset":0,"total":14,
+//    "networks":[{"ssid":"...","rssi":-48,"channel":6,"auth":3},...],
+//    "last":false}
+// offset is the index of the page's first network in the whole scan.
+
+// Drops repeated SSIDs, keeping the strongest one, and/or orders by RSSI,
+// strongest first, all in place. Hidden (empty) SSIDs are never merged.
+// Returns the number of records left.
+size_t wifi_scan_results_compact(wifi_ap_record_t *records, size_t count, bool dedup_ssid, bool sort_by_rssi);
+
+// Writes the page that starts at records[offset], with as many networks as
+// fit in size bytes (including the terminator). Returns how many it holds;
+// *len is the page length, 0 if not even an empty page fits.
+size_t wifi_scan_results_page(char *buf, size_t size, uint32_t scan_id, const wifi_ap_record_t *records,
+                              size_t total, size_t offset, size_t *len);
+
+#endif // WIFI_SCAN_RESULTS_H
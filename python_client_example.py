@@ -110,7 +110,7 @@ class UARTClient(HIDClient):
 class WebSocketClient(HIDClient):
     """WebSocket-based HID client"""
     
-    def __init__(self, host, port=8765):
+    def __init__(self, host, port=80):
         self.ws = websocket.WebSocket()
         url = f"ws://{host}:{port}/ws"
         print(f"Connecting to {url}...")
@@ -244,7 +244,7 @@ def main():
                        help='Serial port (for UART)')
     parser.add_argument('--host', default='192.168.4.1',
                        help='WebSocket host (for WS)')
-    parser.add_argument('--ws-port', type=int, default=8765,
+    parser.add_argument('--ws-port', type=int, default=80,
                        help='WebSocket port')
     parser.add_argument('--demo', choices=['mouse', 'keyboard', 'all'], default='all',
                        help='Demo to run')
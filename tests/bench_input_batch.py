@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Host microbenchmark for splitting POST /api/input batch bodies.
+
+Compiles the firmware's input_batch.c with a small C driver that feeds a
+batch of mouse/keyboard events through the splitter in receive-sized
+chunks, as input_handler does, and reports the cost per event and per byte.
+cJSON parsing and the BLE path are not included, so this is the ceiling the
+batch framing itself puts on throughput; tools/bench_http_input.py measures
+the whole path against a device.
+"""
+from __future__ import annotations
+
+import argparse
+import subprocess
+import tempfile
+import textwrap
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+
+DRIVER = textwrap.dedent(
+    r"""
+    #define _POSIX_C_SOURCE 199309L
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <time.h>
+    #include "input_batch.h"
+
+    static volatile size_t s_sink;
+
+    static void on_event(const char *json, size_t len, void *ctx)
+    {
+        (void)ctx;
+        s_sink += len + (size_t)json[len - 1];
+    }
+
+    static double now_ns(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+    }
+
+    #define EVENTS 256
+
+    int main(int argc, char **argv)
+    {
+        long rounds = argc > 1 ? strtol(argv[1], NULL, 10) : 2000;
+        static char body[EVENTS * 96];
+        size_t len = 0;
+        srand(1234);
+        len += (size_t)sprintf(body + len, "[");
+        for (int i = 0; i < EVENTS; ++i)
+        {
+            if (i % 4 == 3)
+            {
+                len += (size_t)sprintf(body + len, "{\"type\":\"keyboard\",\"keys\":[%d],\"modifiers\":{}},\n",
+                                       4 + rand() % 26);
+            }
+            else
+            {
+                len += (size_t)sprintf(body + len, "{\"type\":\"mouse\",\"dx\":%d,\"dy\":%d,\"buttons\":{\"left\":%s}},\n",
+                                       rand() % 21 - 10, rand() % 21 - 10, rand() % 16 ? "false" : "true");
+            }
+        }
+        body[len - 2] = ']';
+        len--;
+
+        const size_t chunks[] = {64, 512, 1460};
+        static input_batch_t batch;
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c)
+        {
+            double start = now_ns();
+            unsigned long events = 0;
+            for (long r = 0; r < rounds; ++r)
+            {
+                input_batch_init(&batch, on_event, NULL);
+                for (size_t off = 0; off < len; off += chunks[c])
+                {
+                    size_t n = len - off < chunks[c] ? len - off : chunks[c];
+                    input_batch_feed(&batch, body + off, n);
+                }
+                input_batch_finish(&batch);
+                events += batch.events;
+            }
+            double elapsed = now_ns() - start;
+            printf("chunk %4u  %7.2f ns/event  %6.2f ns/byte  %5.1f MB/s\n", (unsigned)chunks[c],
+                   elapsed / (double)events, elapsed / ((double)len * rounds), (double)len * rounds * 1e3 / elapsed);
+        }
+        return 0;
+    }
+    """
+)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--rounds", type=int, default=2000)
+    parser.add_argument("--opt", default="-O2", help="compiler optimisation flag")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        driver_path = Path(tmpdir) / "bench_input_batch.c"
+        binary_path = Path(tmpdir) / "bench_input_batch"
+        driver_path.write_text(DRIVER, encoding="utf-8")
+        subprocess.check_call(
+            [
+                "gcc",
+                "-std=c11",
+                args.opt,
+                "-DNDEBUG",
+                "-I",
+                str(MAIN_DIR),
+                str(driver_path),
+                str(MAIN_DIR / "input_batch.c"),
+                "-o",
+                str(binary_path),
+            ]
+        )
+        subprocess.check_call([str(binary_path), str(args.rounds)])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""Host microbenchmark for the transport -> hid_device mouse/keyboard ingest path.
+
+Compiles the firmware's hid_input_state.c and mouse_report_builder.c together
+with a small C driver that replays the same event stream through the legacy
+field-by-field ingest (throwaway report build, double flush) and through the
+dirty-mask ingest used by main.c. Flushes are counted through a stub so the
+comparison reflects work done per event rather than BLE timing.
+"""
+from __future__ import annotations
+
+import argparse
+import subprocess
+import tempfile
+import textwrap
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+
+DRIVER = textwrap.dedent(
+    r"""
+    #define _POSIX_C_SOURCE 199309L
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <time.h>
+    #include "hid_input_state.h"
+    #include "mouse_report_builder.h"
+
+    static volatile unsigned s_flushes;
+    static volatile int s_log_level;
+
+    __attribute__((noinline)) static void stub_flush(const void *state)
+    {
+        (void)state;
+        s_flushes++;
+    }
+
+    static mouse_state_t s_mouse;
+    static keyboard_state_t s_keyboard;
+
+    static void legacy_on_mouse_input(const mouse_state_t *state)
+    {
+        uint8_t hid_report[HID_MOUSE_REPORT_LEN] = {0};
+        mouse_build_report(state, NULL, hid_report);
+        int8_t report_x = (int8_t)hid_report[2];
+        int8_t report_y = (int8_t)hid_report[3];
+        uint8_t masked_buttons = state->buttons & HID_MOUSE_BUTTON_MASK;
+        uint8_t report_buttons = hid_report[1] & HID_MOUSE_BUTTON_MASK;
+        if (s_log_level > 3)
+        {
+            printf("%d %d %d\n", report_x, report_y, report_buttons);
+        }
+        if (report_x != state->x || report_y != state->y || report_buttons != masked_buttons)
+        {
+            printf("mismatch\n");
+        }
+        int changed = 0;
+        if (state->x != s_mouse.x || state->y != s_mouse.y)
+        {
+            s_mouse.x = state->x;
+            s_mouse.y = state->y;
+            changed = 1;
+        }
+        if (state->wheel != s_mouse.wheel)
+        {
+            s_mouse.wheel = state->wheel;
+            changed = 1;
+        }
+        if (state->hwheel != s_mouse.hwheel)
+        {
+            s_mouse.hwheel = state->hwheel;
+            changed = 1;
+        }
+        if (state->buttons != s_mouse.buttons)
+        {
+            s_mouse.buttons = state->buttons;
+            changed = 1;
+        }
+        if (changed)
+        {
+            stub_flush(&s_mouse); // hid_device_set_mouse_state
+            stub_flush(&s_mouse); // hid_device_request_notify
+        }
+    }
+
+    static void legacy_on_keyboard_input(const keyboard_state_t *state)
+    {
+        int changed = 0;
+        if (state->modifiers != s_keyboard.modifiers)
+        {
+            s_keyboard.modifiers = state->modifiers;
+            changed = 1;
+        }
+        if (memcmp(state->keys, s_keyboard.keys, 6) != 0)
+        {
+            memcpy(s_keyboard.keys, state->keys, 6);
+            changed = 1;
+        }
+        if (changed)
+        {
+            stub_flush(&s_keyboard);
+            stub_flush(&s_keyboard);
+        }
+    }
+
+    static void dirty_on_mouse_input(const mouse_state_t *state)
+    {
+        if (hid_mouse_merge(&s_mouse, state) == 0)
+        {
+            return;
+        }
+        stub_flush(&s_mouse);
+    }
+
+    static void dirty_on_keyboard_input(const keyboard_state_t *state)
+    {
+        if (hid_keyboard_merge(&s_keyboard, state) == 0)
+        {
+            return;
+        }
+        stub_flush(&s_keyboard);
+    }
+
+    static double now_ns(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+    }
+
+    #define EVENTS 1024
+
+    int main(int argc, char **argv)
+    {
+        long rounds = argc > 1 ? strtol(argv[1], NULL, 10) : 20000;
+        static mouse_state_t mice[EVENTS];
+        static keyboard_state_t keys[EVENTS];
+        srand(1234);
+        for (int i = 0; i < EVENTS; ++i)
+        {
+            // Mostly motion with occasional button/wheel changes and repeats.
+            mice[i].x = (int8_t)((rand() % 21) - 10);
+            mice[i].y = (int8_t)((rand() % 21) - 10);
+            mice[i].wheel = (rand() % 8 == 0) ? 1 : 0;
+            mice[i].buttons = (rand() % 16 == 0) ? 0x01 : 0;
+            if (i > 0 && rand() % 4 == 0)
+            {
+                mice[i] = mice[i - 1];
+            }
+            keys[i].modifiers = (rand() % 5 == 0) ? 0x02 : 0;
+            keys[i].keys[0] = (i % 2) ? (uint8_t)(4 + rand() % 26) : 0;
+        }
+
+        struct
+        {
+            const char *name;
+            void (*mouse)(const mouse_state_t *);
+            void (*keyboard)(const keyboard_state_t *);
+        } variants[] = {
+            {"legacy", legacy_on_mouse_input, legacy_on_keyboard_input},
+            {"dirty_mask", dirty_on_mouse_input, dirty_on_keyboard_input},
+        };
+
+        for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v)
+        {
+            memset(&s_mouse, 0, sizeof(s_mouse));
+            memset(&s_keyboard, 0, sizeof(s_keyboard));
+            s_flushes = 0;
+            double start = now_ns();
+            for (long r = 0; r < rounds; ++r)
+            {
+                for (int i = 0; i < EVENTS; ++i)
+                {
+                    variants[v].mouse(&mice[i]);
+                    variants[v].keyboard(&keys[i]);
+                }
+            }
+            double elapsed = now_ns() - start;
+            double events = (double)rounds * EVENTS * 2.0;
+            printf("%-10s %7.2f ns/event  %.3f flushes/event\n",
+                   variants[v].name, elapsed / events, s_flushes / events);
+        }
+        return 0;
+    }
+    """
+)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--rounds", type=int, default=20000)
+    parser.add_argument("--opt", default="-O2", help="compiler optimisation flag")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        driver_path = Path(tmpdir) / "bench_input_ingest.c"
+        binary_path = Path(tmpdir) / "bench_input_ingest"
+        driver_path.write_text(DRIVER, encoding="utf-8")
+        subprocess.check_call(
+            [
+                "gcc",
+                "-std=c11",
+                args.opt,
+                "-DNDEBUG",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(driver_path),
+                str(MAIN_DIR / "hid_input_state.c"),
+                str(MAIN_DIR / "mouse_report_builder.c"),
+                "-o",
+                str(binary_path),
+            ]
+        )
+        subprocess.check_call([str(binary_path), str(args.rounds)])
+
+
+if __name__ == "__main__":
+    main()
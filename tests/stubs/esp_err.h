@@ -10,6 +10,8 @@ typedef int esp_err_t;
 #define ESP_ERR_NO_MEM 0x101
 #define ESP_ERR_INVALID_ARG 0x102
 #define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_SUPPORTED 0x106
 #define ESP_ERR_WIFI_NOT_INIT 0x200
 #define ESP_ERR_WIFI_NOT_STARTED 0x201
 #define ESP_ERR_WIFI_NOT_STOPPED 0x202
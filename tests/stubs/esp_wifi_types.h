@@ -87,7 +87,8 @@ typedef struct
 typedef struct
 {
     uint8_t bssid[6];
-    uint8_t ssid[32];
+    uint8_t ssid[33];
+    uint8_t primary;
     int8_t rssi;
     wifi_auth_mode_t authmode;
 } wifi_ap_record_t;
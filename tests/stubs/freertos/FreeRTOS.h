@@ -8,9 +8,24 @@
 #define pdPASS 1
 
 typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define configRUN_TIME_COUNTER_TYPE uint32_t
+#define tskNO_AFFINITY 0x7FFFFFFF
 
 #define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portTICK_PERIOD_MS 1
 
 #define portMAX_DELAY 0xFFFFFFFF
 
+typedef struct
+{
+    int owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
 #endif // FREERTOS_FREERTOS_H
@@ -3,6 +3,40 @@
 
 #include "freertos/FreeRTOS.h"
 
+#define tskIDLE_PRIORITY 0
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *pvParameters);
+
+typedef enum
+{
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted
+} eTaskState;
+
+typedef struct
+{
+    TaskHandle_t xHandle;
+    const char *pcTaskName;
+    UBaseType_t xTaskNumber;
+    eTaskState eCurrentState;
+    UBaseType_t uxCurrentPriority;
+    UBaseType_t uxBasePriority;
+    configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;
+    void *pxStackBase;
+    uint32_t usStackHighWaterMark;
+} TaskStatus_t;
+
+int xTaskCreate(TaskFunction_t pxTaskCode, const char *pcName, uint32_t usStackDepth, void *pvParameters, uint32_t uxPriority, TaskHandle_t *pxCreatedTask);
+int xTaskCreatePinnedToCore(TaskFunction_t pxTaskCode, const char *pcName, uint32_t usStackDepth, void *pvParameters,
+                            uint32_t uxPriority, TaskHandle_t *pxCreatedTask, BaseType_t xCoreID);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *pxTaskStatusArray, UBaseType_t uxArraySize,
+                                 configRUN_TIME_COUNTER_TYPE *pulTotalRunTime);
+BaseType_t xTaskGetCoreID(TaskHandle_t xTask);
 TickType_t xTaskGetTickCount(void);
 void vTaskDelay(TickType_t xTicksToDelay);
 
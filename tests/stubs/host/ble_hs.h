@@ -0,0 +1,22 @@
+#ifndef H_BLE_HS_
+#define H_BLE_HS_
+
+#include <stdint.h>
+
+// Just enough of NimBLE for the notification send path
+
+#define BLE_HS_ENOMEM 6
+#define BLE_HS_ENOTCONN 7
+#define BLE_HS_CONN_HANDLE_NONE 0xffff
+
+struct os_mbuf
+{
+    uint16_t om_len;
+    uint8_t om_data[32];
+};
+
+struct os_mbuf *ble_hs_mbuf_from_flat(const void *buf, uint16_t len);
+int os_mbuf_free_chain(struct os_mbuf *om);
+int ble_gatts_notify_custom(uint16_t conn_handle, uint16_t att_handle, struct os_mbuf *om);
+
+#endif // H_BLE_HS_
@@ -307,7 +307,7 @@ void http_server_publish_wifi_status(void)
 {
 }
 
-void http_server_publish_scan_results(const wifi_ap_record_t *records, uint16_t count)
+void http_server_publish_scan_results(wifi_ap_record_t *records, uint16_t count)
 {
     (void)records;
     (void)count;
@@ -0,0 +1,172 @@
+import ctypes
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+CACHE_MAX = 8
+
+
+class Entry(ctypes.Structure):
+    _fields_ = [
+        ("addr_type", ctypes.c_uint8),
+        ("addr", ctypes.c_uint8 * 6),
+        ("last_seen_us", ctypes.c_int64),
+        ("last_used", ctypes.c_uint32),
+    ]
+
+
+def make_entry(addr_type: int, last_byte: int, last_seen_us: int = 0) -> Entry:
+    entry = Entry()
+    entry.addr_type = addr_type
+    entry.addr[:] = [last_byte, 2, 3, 4, 5, 6]
+    entry.last_seen_us = last_seen_us
+    return entry
+
+
+class BleBondCacheTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.ble_bond_cache_load.argtypes = [ctypes.POINTER(Entry), ctypes.c_size_t]
+        cls._lib.ble_bond_cache_load.restype = ctypes.c_bool
+        cls._lib.ble_bond_cache_touch.argtypes = [ctypes.c_uint8, ctypes.POINTER(ctypes.c_uint8), ctypes.c_int64]
+        cls._lib.ble_bond_cache_touch.restype = ctypes.c_bool
+        cls._lib.ble_bond_cache_count.restype = ctypes.c_size_t
+        cls._lib.ble_bond_cache_contains.argtypes = [ctypes.c_uint8, ctypes.POINTER(ctypes.c_uint8)]
+        cls._lib.ble_bond_cache_contains.restype = ctypes.c_bool
+        cls._lib.ble_bond_cache_list.argtypes = [ctypes.POINTER(Entry), ctypes.c_size_t]
+        cls._lib.ble_bond_cache_list.restype = ctypes.c_size_t
+        cls._lib.ble_bond_cache_promote.argtypes = [ctypes.c_uint8, ctypes.POINTER(ctypes.c_uint8)]
+        cls._lib.ble_bond_cache_promote.restype = ctypes.c_bool
+        cls._lib.ble_bond_cache_list_recent.argtypes = [ctypes.POINTER(Entry), ctypes.c_size_t]
+        cls._lib.ble_bond_cache_list_recent.restype = ctypes.c_size_t
+        cls._lib.ble_bond_cache_lru.argtypes = [ctypes.POINTER(Entry), ctypes.POINTER(Entry), ctypes.c_size_t]
+        cls._lib.ble_bond_cache_lru.restype = ctypes.c_bool
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library_path = Path(tmpdir) / "libble_bond_cache.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "ble_bond_cache.c"),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def setUp(self) -> None:
+        self._load([])
+
+    def _load(self, entries: list) -> bool:
+        array = (Entry * max(len(entries), 1))(*entries)
+        return self._lib.ble_bond_cache_load(array, len(entries))
+
+    def _list(self) -> list:
+        out = (Entry * CACHE_MAX)()
+        count = self._lib.ble_bond_cache_list(out, CACHE_MAX)
+        return list(out[:count])
+
+    def _recent(self) -> list:
+        out = (Entry * CACHE_MAX)()
+        count = self._lib.ble_bond_cache_list_recent(out, CACHE_MAX)
+        return [e.addr[0] for e in out[:count]]
+
+    def _lru(self, keep: list):
+        victim = Entry()
+        array = (Entry * max(len(keep), 1))(*keep)
+        if not self._lib.ble_bond_cache_lru(ctypes.byref(victim), array, len(keep)):
+            return None
+        return victim.addr[0]
+
+    def _use(self, *last_bytes: int) -> None:
+        for last_byte in last_bytes:
+            self.assertTrue(self._lib.ble_bond_cache_promote(0, make_entry(0, last_byte).addr))
+
+    def test_load_and_lookup(self) -> None:
+        self.assertTrue(self._load([make_entry(0, 1), make_entry(1, 2)]))
+        self.assertEqual(self._lib.ble_bond_cache_count(), 2)
+        self.assertTrue(self._lib.ble_bond_cache_contains(1, make_entry(1, 2).addr))
+        # Same bytes with another address type is a different host
+        self.assertFalse(self._lib.ble_bond_cache_contains(0, make_entry(1, 2).addr))
+        self.assertFalse(self._lib.ble_bond_cache_contains(0, make_entry(0, 9).addr))
+
+    def test_touch_records_last_seen(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2)])
+        self.assertTrue(self._lib.ble_bond_cache_touch(0, make_entry(0, 2).addr, 5_000))
+        self.assertFalse(self._lib.ble_bond_cache_touch(0, make_entry(0, 3).addr, 6_000))
+        entries = self._list()
+        self.assertEqual([e.last_seen_us for e in entries], [0, 5_000])
+
+    def test_reload_keeps_last_seen_of_remaining_peers(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2)])
+        self._lib.ble_bond_cache_touch(0, make_entry(0, 1).addr, 1_000)
+        self._lib.ble_bond_cache_touch(0, make_entry(0, 2).addr, 2_000)
+
+        # Peer 1 was deleted from the store, peer 3 bonded
+        self._load([make_entry(0, 2), make_entry(0, 3)])
+        entries = self._list()
+        self.assertEqual([e.addr[0] for e in entries], [2, 3])
+        self.assertEqual([e.last_seen_us for e in entries], [2_000, 0])
+
+    def test_clear_empties_cache(self) -> None:
+        self._load([make_entry(0, 1)])
+        self._load([])
+        self.assertEqual(self._lib.ble_bond_cache_count(), 0)
+        self.assertEqual(self._list(), [])
+
+    def test_overflow_keeps_first_entries(self) -> None:
+        entries = [make_entry(0, i) for i in range(CACHE_MAX + 2)]
+        self.assertFalse(self._load(entries))
+        self.assertEqual(self._lib.ble_bond_cache_count(), CACHE_MAX)
+        self.assertEqual(self._list()[-1].addr[0], CACHE_MAX - 1)
+
+    def test_recent_order(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2), make_entry(0, 3), make_entry(0, 4)])
+        self._use(3, 1)
+        self._lib.ble_bond_cache_touch(0, make_entry(0, 2).addr, 7_000)
+        # Never-used hosts follow in store order
+        self.assertEqual(self._recent(), [2, 1, 3, 4])
+        self.assertFalse(self._lib.ble_bond_cache_promote(0, make_entry(0, 9).addr))
+
+    def test_reload_keeps_recency(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2)])
+        self._use(2, 1)
+        self._load([make_entry(0, 1), make_entry(0, 2), make_entry(0, 3)])
+        self.assertEqual(self._recent(), [1, 2, 3])
+
+    def test_lru_prefers_never_used_oldest_bond(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2), make_entry(0, 3)])
+        self._use(1)
+        self.assertEqual(self._lru([]), 2)
+        self._use(2, 3)
+        self.assertEqual(self._lru([]), 1)
+
+    def test_lru_skips_kept_hosts(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2), make_entry(0, 3)])
+        self._use(1, 2, 3)
+        self.assertEqual(self._lru([make_entry(0, 1)]), 2)
+        self.assertEqual(self._lru([make_entry(0, 1), make_entry(0, 2)]), 3)
+        # Same address bytes with another type is not kept
+        self.assertEqual(self._lru([make_entry(1, 1)]), 1)
+        self.assertIsNone(self._lru([make_entry(0, 1), make_entry(0, 2), make_entry(0, 3)]))
+
+    def test_list_respects_max(self) -> None:
+        self._load([make_entry(0, 1), make_entry(0, 2), make_entry(0, 3)])
+        out = (Entry * 2)()
+        self.assertEqual(self._lib.ble_bond_cache_list(out, 2), 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,190 @@
+import ctypes
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+
+PHASE_IDLE = 0
+PHASE_DIRECTED = 1
+PHASE_ACCEPT_LIST = 2
+PHASE_FAST = 3
+PHASE_SLOW = 4
+PHASE_OFF = 5
+PHASE_COUNT = 6
+BUCKETS = 8
+
+
+class Config(ctypes.Structure):
+    _fields_ = [
+        ("directed_ms", ctypes.c_uint32),
+        ("accept_list_ms", ctypes.c_uint32),
+        ("fast_ms", ctypes.c_uint32),
+        ("slow_ms", ctypes.c_uint32),
+    ]
+
+
+class Stats(ctypes.Structure):
+    _fields_ = [
+        ("attempts", ctypes.c_uint32),
+        ("reconnects", ctypes.c_uint32),
+        ("expired", ctypes.c_uint32),
+        ("by_phase", ctypes.c_uint32 * PHASE_COUNT),
+        ("last_ms", ctypes.c_uint32),
+        ("min_ms", ctypes.c_uint32),
+        ("max_ms", ctypes.c_uint32),
+        ("total_ms", ctypes.c_uint64),
+        ("buckets", ctypes.c_uint32 * BUCKETS),
+    ]
+
+
+class BleReconnectTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.ble_reconnect_set_config.argtypes = [ctypes.POINTER(Config)]
+        cls._lib.ble_reconnect_set_config.restype = ctypes.c_bool
+        cls._lib.ble_reconnect_start.argtypes = [ctypes.c_bool, ctypes.c_bool, ctypes.c_int64]
+        cls._lib.ble_reconnect_start.restype = ctypes.c_int
+        cls._lib.ble_reconnect_next.restype = ctypes.c_int
+        cls._lib.ble_reconnect_phase.restype = ctypes.c_int
+        cls._lib.ble_reconnect_on_connect.argtypes = [ctypes.c_int64]
+        cls._lib.ble_reconnect_phase_duration_ms.argtypes = [ctypes.c_int]
+        cls._lib.ble_reconnect_phase_duration_ms.restype = ctypes.c_uint32
+        cls._lib.ble_reconnect_bucket.argtypes = [ctypes.c_uint32]
+        cls._lib.ble_reconnect_bucket.restype = ctypes.c_size_t
+        cls._lib.ble_adv_phase_name.argtypes = [ctypes.c_int]
+        cls._lib.ble_adv_phase_name.restype = ctypes.c_char_p
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library_path = Path(tmpdir) / "libble_reconnect.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "ble_reconnect.c"),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def setUp(self) -> None:
+        self._configure(1280, 10000, 30000, 300000)
+        self._lib.ble_reconnect_stop()
+        self._lib.ble_reconnect_reset_stats()
+
+    def _configure(self, directed_ms: int, accept_list_ms: int, fast_ms: int = 30000, slow_ms: int = 300000) -> bool:
+        config = Config(directed_ms, accept_list_ms, fast_ms, slow_ms)
+        return self._lib.ble_reconnect_set_config(ctypes.byref(config))
+
+    def _stats(self) -> Stats:
+        stats = Stats()
+        self._lib.ble_reconnect_get_stats(ctypes.byref(stats))
+        return stats
+
+    def test_bonded_sequence_walks_directed_accept_list_slow_off(self) -> None:
+        self.assertEqual(self._lib.ble_reconnect_start(True, True, 0), PHASE_DIRECTED)
+        self.assertEqual(self._lib.ble_reconnect_phase_duration_ms(PHASE_DIRECTED), 1280)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_ACCEPT_LIST)
+        self.assertEqual(self._lib.ble_reconnect_phase_duration_ms(PHASE_ACCEPT_LIST), 10000)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_SLOW)
+        self.assertEqual(self._lib.ble_reconnect_phase_duration_ms(PHASE_SLOW), 300000)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_OFF)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_OFF)
+        self.assertEqual(self._stats().expired, 1)
+
+    def test_pairing_schedule_walks_fast_slow_off(self) -> None:
+        self.assertEqual(self._lib.ble_reconnect_start(False, False, 0), PHASE_FAST)
+        self.assertEqual(self._lib.ble_reconnect_phase_duration_ms(PHASE_FAST), 30000)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_SLOW)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_OFF)
+        self.assertEqual(self._stats().expired, 0)
+
+    def test_restart_after_off(self) -> None:
+        self._lib.ble_reconnect_start(True, False, 0)
+        self._lib.ble_reconnect_next()
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_OFF)
+        self.assertEqual(self._lib.ble_reconnect_start(True, False, 0), PHASE_ACCEPT_LIST)
+        self.assertEqual(self._stats().attempts, 2)
+
+    def test_without_last_peer_starts_on_accept_list(self) -> None:
+        self.assertEqual(self._lib.ble_reconnect_start(True, False, 0), PHASE_ACCEPT_LIST)
+
+    def test_zero_length_phases_are_skipped(self) -> None:
+        self.assertTrue(self._configure(0, 0))
+        self.assertEqual(self._lib.ble_reconnect_start(True, True, 0), PHASE_SLOW)
+        self.assertTrue(self._configure(1280, 0))
+        self.assertEqual(self._lib.ble_reconnect_start(True, True, 0), PHASE_DIRECTED)
+        self.assertEqual(self._lib.ble_reconnect_next(), PHASE_SLOW)
+
+    def test_config_limits(self) -> None:
+        self.assertFalse(self._configure(1281, 10000))
+        self.assertFalse(self._configure(1280, 600001))
+        self.assertFalse(self._configure(1280, 10000, 600001))
+        self.assertFalse(self._configure(1280, 10000, 30000, 3600001))
+        self.assertTrue(self._configure(1280, 10000, 0, 3600000))
+        config = Config()
+        self._lib.ble_reconnect_get_config(ctypes.byref(config))
+        self.assertEqual(
+            (config.directed_ms, config.accept_list_ms, config.fast_ms, config.slow_ms),
+            (1280, 10000, 0, 3600000),
+        )
+
+    def test_pairing_advertising_is_not_a_reconnect(self) -> None:
+        self.assertEqual(self._lib.ble_reconnect_start(False, True, 0), PHASE_FAST)
+        self._lib.ble_reconnect_on_connect(5_000_000)
+        stats = self._stats()
+        self.assertEqual(stats.attempts, 0)
+        self.assertEqual(stats.reconnects, 0)
+        self.assertEqual(self._lib.ble_reconnect_phase(), PHASE_IDLE)
+
+    def test_connect_records_time_to_reconnect(self) -> None:
+        self._lib.ble_reconnect_start(True, True, 1_000_000)
+        self._lib.ble_reconnect_on_connect(1_300_000)
+        self._lib.ble_reconnect_start(True, True, 10_000_000)
+        self._lib.ble_reconnect_next()
+        self._lib.ble_reconnect_on_connect(13_000_000)
+
+        stats = self._stats()
+        self.assertEqual(stats.attempts, 2)
+        self.assertEqual(stats.reconnects, 2)
+        self.assertEqual(stats.by_phase[PHASE_DIRECTED], 1)
+        self.assertEqual(stats.by_phase[PHASE_ACCEPT_LIST], 1)
+        self.assertEqual((stats.last_ms, stats.min_ms, stats.max_ms), (3000, 300, 3000))
+        self.assertEqual(stats.total_ms, 3300)
+        self.assertEqual(stats.buckets[1], 1)
+        self.assertEqual(stats.buckets[4], 1)
+
+    def test_stopped_sequence_is_not_recorded(self) -> None:
+        self._lib.ble_reconnect_start(True, True, 0)
+        self._lib.ble_reconnect_stop()
+        self._lib.ble_reconnect_on_connect(1_000_000)
+        stats = self._stats()
+        self.assertEqual(stats.attempts, 1)
+        self.assertEqual(stats.reconnects, 0)
+
+    def test_bucket_edges(self) -> None:
+        self.assertEqual(self._lib.ble_reconnect_bucket(0), 0)
+        self.assertEqual(self._lib.ble_reconnect_bucket(249), 0)
+        self.assertEqual(self._lib.ble_reconnect_bucket(250), 1)
+        self.assertEqual(self._lib.ble_reconnect_bucket(29999), 6)
+        self.assertEqual(self._lib.ble_reconnect_bucket(30000), 7)
+
+    def test_phase_names(self) -> None:
+        self.assertEqual(self._lib.ble_adv_phase_name(PHASE_ACCEPT_LIST), b"accept_list")
+        self.assertEqual(self._lib.ble_adv_phase_name(PHASE_OFF), b"off")
+        self.assertEqual(self._lib.ble_adv_phase_name(PHASE_COUNT), b"unknown")
+
+
+if __name__ == "__main__":
+    unittest.main()
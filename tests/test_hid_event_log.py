@@ -0,0 +1,165 @@
+import ctypes
+import subprocess
+import tempfile
+import threading
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+RING_SIZE = 128
+REPORT_COUNT = 8
+REPORT_KEYBOARD = 3
+REPORT_POINTER = 7
+
+EVENT_ENOMEM_ALLOC = 0
+EVENT_ENOMEM_NOTIFY = 1
+EVENT_NOTIFY_FAILED = 2
+EVENT_QUEUE_DROP = 3
+EVENT_COUNT = 4
+
+RTOS_SHIM = """
+#include <stdint.h>
+#include "freertos/task.h"
+int64_t esp_timer_get_time(void) { return 0; }
+TickType_t xTaskGetTickCount(void) { return 0; }
+void vTaskDelay(TickType_t ticks) { (void)ticks; }
+int xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                            uint32_t prio, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)fn; (void)name; (void)stack; (void)arg; (void)prio; (void)core;
+    *handle = (TaskHandle_t)1;
+    return pdPASS;
+}
+"""
+
+
+class Summary(ctypes.Structure):
+    _fields_ = [
+        ("counts", (ctypes.c_uint32 * REPORT_COUNT) * EVENT_COUNT),
+        ("conn_mask", ctypes.c_uint32),
+        ("last_rc", ctypes.c_int32),
+        ("lost", ctypes.c_uint32),
+        ("total", ctypes.c_uint32),
+    ]
+
+
+class HidEventLogTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.hid_event_log_record.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_uint16, ctypes.c_int32]
+        cls._lib.hid_event_log_record.restype = ctypes.c_bool
+        cls._lib.hid_event_log_collect.argtypes = [ctypes.POINTER(Summary)]
+        cls._lib.hid_event_log_collect.restype = ctypes.c_uint32
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            shim_path = Path(tmpdir) / "rtos_shim.c"
+            shim_path.write_text(RTOS_SHIM)
+            library_path = Path(tmpdir) / "libhid_event_log.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "hid_event_log.c"),
+                str(MAIN_DIR / "hid_metrics.c"),
+                str(shim_path),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def setUp(self) -> None:
+        self._collect()
+
+    def _record(self, event: int, report_type: int, conn: int = 0, rc: int = 0) -> bool:
+        return self._lib.hid_event_log_record(event, report_type, conn, rc)
+
+    def _collect(self, summary: Summary = None) -> Summary:
+        summary = summary or Summary()
+        self._lib.hid_event_log_collect(ctypes.byref(summary))
+        return summary
+
+    def test_collect_aggregates_by_event_and_report(self) -> None:
+        self.assertTrue(self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD, conn=1))
+        self.assertTrue(self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD, conn=1))
+        self.assertTrue(self._record(EVENT_ENOMEM_ALLOC, REPORT_POINTER, conn=2))
+        self.assertTrue(self._record(EVENT_NOTIFY_FAILED, REPORT_KEYBOARD, conn=1, rc=-7))
+        self.assertTrue(self._record(EVENT_QUEUE_DROP, REPORT_POINTER, conn=2))
+
+        summary = self._collect()
+        self.assertEqual(summary.total, 5)
+        self.assertEqual(summary.counts[EVENT_ENOMEM_NOTIFY][REPORT_KEYBOARD], 2)
+        self.assertEqual(summary.counts[EVENT_ENOMEM_ALLOC][REPORT_POINTER], 1)
+        self.assertEqual(summary.counts[EVENT_QUEUE_DROP][REPORT_POINTER], 1)
+        self.assertEqual(summary.last_rc, -7)
+        self.assertEqual(summary.conn_mask, 0b110)
+        self.assertEqual(self._collect().total, 0)
+
+    def test_collect_adds_to_existing_summary(self) -> None:
+        summary = Summary()
+        self._record(EVENT_QUEUE_DROP, REPORT_KEYBOARD)
+        self._collect(summary)
+        self._record(EVENT_QUEUE_DROP, REPORT_KEYBOARD)
+        self._collect(summary)
+        self.assertEqual(summary.counts[EVENT_QUEUE_DROP][REPORT_KEYBOARD], 2)
+        self.assertEqual(summary.total, 2)
+
+    def test_full_ring_counts_lost_events(self) -> None:
+        for _ in range(RING_SIZE):
+            self.assertTrue(self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD))
+        self.assertFalse(self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD))
+        self.assertFalse(self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD))
+
+        summary = self._collect()
+        self.assertEqual(summary.total, RING_SIZE)
+        self.assertEqual(summary.lost, 2)
+        self.assertTrue(self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD))
+
+    def test_ring_reuses_slots_across_laps(self) -> None:
+        for lap in range(5):
+            for _ in range(RING_SIZE - 1):
+                self.assertTrue(self._record(EVENT_QUEUE_DROP, REPORT_KEYBOARD, conn=lap))
+            summary = self._collect()
+            self.assertEqual(summary.total, RING_SIZE - 1)
+            self.assertEqual(summary.lost, 0)
+
+    def test_out_of_range_entries_are_skipped(self) -> None:
+        self._record(EVENT_COUNT, REPORT_KEYBOARD)
+        self._record(EVENT_QUEUE_DROP, REPORT_COUNT)
+        summary = self._collect()
+        self.assertEqual(summary.total, 2)
+        self.assertEqual(sum(sum(row) for row in summary.counts), 0)
+
+    def test_concurrent_producers_lose_nothing_silently(self) -> None:
+        producers = 4
+        per_producer = 2000
+        summary = Summary()
+
+        def produce(conn: int) -> None:
+            for _ in range(per_producer):
+                self._record(EVENT_ENOMEM_NOTIFY, REPORT_KEYBOARD, conn=conn)
+
+        threads = [threading.Thread(target=produce, args=(i,)) for i in range(producers)]
+        for thread in threads:
+            thread.start()
+        # Single consumer draining while the producers run
+        while any(thread.is_alive() for thread in threads):
+            self._collect(summary)
+        self._collect(summary)
+
+        counted = summary.counts[EVENT_ENOMEM_NOTIFY][REPORT_KEYBOARD]
+        self.assertEqual(counted, summary.total)
+        self.assertEqual(counted + summary.lost, producers * per_producer)
+
+
+if __name__ == "__main__":
+    unittest.main()
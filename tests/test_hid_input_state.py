@@ -0,0 +1,138 @@
+import ctypes
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+
+HID_MOUSE_DIRTY_MOTION = 0x01
+HID_MOUSE_DIRTY_WHEEL = 0x02
+HID_MOUSE_DIRTY_HWHEEL = 0x04
+HID_MOUSE_DIRTY_BUTTONS = 0x08
+HID_KEYBOARD_DIRTY_MODIFIERS = 0x01
+HID_KEYBOARD_DIRTY_KEYS = 0x02
+
+
+class MouseState(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_int16),
+        ("y", ctypes.c_int16),
+        ("wheel", ctypes.c_int16),
+        ("hwheel", ctypes.c_int16),
+        ("buttons", ctypes.c_uint8),
+    ]
+
+
+class KeyboardState(ctypes.Structure):
+    _fields_ = [
+        ("modifiers", ctypes.c_uint8),
+        ("reserved", ctypes.c_uint8),
+        ("keys", ctypes.c_uint8 * 6),
+        ("bitmap", ctypes.c_uint8 * 15),
+    ]
+
+
+class HidInputStateTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        for name, state_type in (
+            ("hid_mouse_dirty_mask", MouseState),
+            ("hid_mouse_merge", MouseState),
+            ("hid_keyboard_dirty_mask", KeyboardState),
+            ("hid_keyboard_merge", KeyboardState),
+        ):
+            func = getattr(cls._lib, name)
+            func.argtypes = [ctypes.POINTER(state_type), ctypes.POINTER(state_type)]
+            func.restype = ctypes.c_uint8
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library_path = Path(tmpdir) / "libhid_input_state.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "hid_input_state.c"),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def test_identical_mouse_state_is_clean(self) -> None:
+        current = MouseState(3, -2, 1, 0, 0x01)
+        update = MouseState(3, -2, 1, 0, 0x01)
+        self.assertEqual(self._lib.hid_mouse_dirty_mask(current, update), 0)
+
+    def test_mouse_fields_map_to_individual_bits(self) -> None:
+        scenarios = [
+            (MouseState(5, 0, 0, 0, 0), HID_MOUSE_DIRTY_MOTION),
+            (MouseState(0, -5, 0, 0, 0), HID_MOUSE_DIRTY_MOTION),
+            (MouseState(0, 0, 2, 0, 0), HID_MOUSE_DIRTY_WHEEL),
+            (MouseState(0, 0, 0, -1, 0), HID_MOUSE_DIRTY_HWHEEL),
+            (MouseState(0, 0, 0, 0, 0x04), HID_MOUSE_DIRTY_BUTTONS),
+            (
+                MouseState(1, 1, 1, 1, 0x01),
+                HID_MOUSE_DIRTY_MOTION
+                | HID_MOUSE_DIRTY_WHEEL
+                | HID_MOUSE_DIRTY_HWHEEL
+                | HID_MOUSE_DIRTY_BUTTONS,
+            ),
+        ]
+        for update, expected in scenarios:
+            with self.subTest(expected=expected):
+                current = MouseState()
+                self.assertEqual(self._lib.hid_mouse_dirty_mask(current, update), expected)
+
+    def test_mouse_merge_applies_update(self) -> None:
+        current = MouseState(1, 2, 0, 0, 0x02)
+        update = MouseState(1, 2, 4, 0, 0x03)
+        dirty = self._lib.hid_mouse_merge(current, update)
+        self.assertEqual(dirty, HID_MOUSE_DIRTY_WHEEL | HID_MOUSE_DIRTY_BUTTONS)
+        self.assertEqual(
+            (current.x, current.y, current.wheel, current.hwheel, current.buttons),
+            (1, 2, 4, 0, 0x03),
+        )
+
+    def test_keyboard_merge_ignores_reserved_byte(self) -> None:
+        current = KeyboardState()
+        update = KeyboardState()
+        update.reserved = 0x55
+        self.assertEqual(self._lib.hid_keyboard_merge(current, update), 0)
+        self.assertEqual(current.reserved, 0)
+
+    def test_keyboard_merge_reports_modifier_and_key_bits(self) -> None:
+        current = KeyboardState()
+        update = KeyboardState()
+        update.modifiers = 0x02
+        update.keys[0] = 0x04
+        dirty = self._lib.hid_keyboard_merge(current, update)
+        self.assertEqual(dirty, HID_KEYBOARD_DIRTY_MODIFIERS | HID_KEYBOARD_DIRTY_KEYS)
+        self.assertEqual(current.modifiers, 0x02)
+        self.assertEqual(list(current.keys), [0x04, 0, 0, 0, 0, 0])
+
+        release = KeyboardState()
+        release.modifiers = 0x02
+        self.assertEqual(self._lib.hid_keyboard_merge(current, release), HID_KEYBOARD_DIRTY_KEYS)
+
+    def test_keyboard_merge_tracks_nkro_bitmap(self) -> None:
+        current = KeyboardState()
+        chord = KeyboardState()
+        chord.bitmap[0] = 0xF0  # A-D
+        chord.bitmap[1] = 0xFF  # E-L
+        self.assertEqual(self._lib.hid_keyboard_merge(current, chord), HID_KEYBOARD_DIRTY_KEYS)
+        self.assertEqual(list(current.bitmap[:2]), [0xF0, 0xFF])
+        self.assertEqual(self._lib.hid_keyboard_merge(current, chord), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,172 @@
+import ctypes
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+LATENCY_BUCKETS = 12
+RETRY_BUCKETS = 6
+REPORT_COUNT = 8
+REPORT_KEYBOARD = 3
+REPORT_CONSUMER = 6
+ATT_HEADER_LEN = 3
+
+TIMER_SHIM = """
+#include <stdint.h>
+int64_t test_now_us;
+int64_t esp_timer_get_time(void) { return test_now_us; }
+"""
+
+
+class Counters(ctypes.Structure):
+    _fields_ = [
+        ("attempts", ctypes.c_uint32),
+        ("sent", ctypes.c_uint32),
+        ("bytes", ctypes.c_uint32),
+        ("enomem_alloc", ctypes.c_uint32),
+        ("enomem_notify", ctypes.c_uint32),
+        ("dropped", ctypes.c_uint32),
+        ("queue_latency", ctypes.c_uint32 * LATENCY_BUCKETS),
+        ("tx_latency", ctypes.c_uint32 * LATENCY_BUCKETS),
+        ("retries", ctypes.c_uint32 * RETRY_BUCKETS),
+    ]
+
+
+class Snapshot(ctypes.Structure):
+    _fields_ = [
+        ("since_reset_us", ctypes.c_int64),
+        ("reports", Counters * REPORT_COUNT),
+    ]
+
+
+class HidMetricsTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        lib = cls._lib
+        lib.hid_metrics_latency_bucket.argtypes = [ctypes.c_uint32]
+        lib.hid_metrics_latency_bucket.restype = ctypes.c_size_t
+        lib.hid_metrics_retry_bucket.argtypes = [ctypes.c_uint32]
+        lib.hid_metrics_retry_bucket.restype = ctypes.c_size_t
+        lib.hid_metrics_record_attempt.argtypes = [ctypes.c_int]
+        lib.hid_metrics_record_enomem.argtypes = [ctypes.c_int, ctypes.c_bool]
+        lib.hid_metrics_record_sent.argtypes = [ctypes.c_int, ctypes.c_size_t, ctypes.c_uint32, ctypes.c_uint32]
+        lib.hid_metrics_record_tx_latency.argtypes = [ctypes.c_int, ctypes.c_uint32]
+        lib.hid_metrics_record_dropped.argtypes = [ctypes.c_int]
+        lib.hid_metrics_get.argtypes = [ctypes.c_int, ctypes.POINTER(Counters)]
+        lib.hid_metrics_snapshot.argtypes = [ctypes.POINTER(Snapshot)]
+        lib.hid_metrics_reset.argtypes = [ctypes.POINTER(Snapshot)]
+        lib.hid_metrics_enomem_rate_bp.argtypes = [ctypes.POINTER(Counters)]
+        lib.hid_metrics_enomem_rate_bp.restype = ctypes.c_uint32
+        lib.hid_metrics_report_name.argtypes = [ctypes.c_int]
+        lib.hid_metrics_report_name.restype = ctypes.c_char_p
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            shim_path = Path(tmpdir) / "esp_timer_shim.c"
+            shim_path.write_text(TIMER_SHIM)
+            library_path = Path(tmpdir) / "libhid_metrics.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "hid_metrics.c"),
+                str(shim_path),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def setUp(self) -> None:
+        self._set_time(0)
+        self._lib.hid_metrics_reset(None)
+
+    def _set_time(self, now_us: int) -> None:
+        ctypes.c_int64.in_dll(self._lib, "test_now_us").value = now_us
+
+    def _get(self, report_type: int) -> Counters:
+        counters = Counters()
+        self._lib.hid_metrics_get(report_type, ctypes.byref(counters))
+        return counters
+
+    def test_latency_buckets_double_from_250_us(self) -> None:
+        bucket = self._lib.hid_metrics_latency_bucket
+        self.assertEqual(bucket(0), 0)
+        self.assertEqual(bucket(249), 0)
+        self.assertEqual(bucket(250), 1)
+        self.assertEqual(bucket(499), 1)
+        self.assertEqual(bucket(500), 2)
+        self.assertEqual(bucket(255_999), 10)
+        self.assertEqual(bucket(256_000), 11)
+        self.assertEqual(bucket(0xFFFFFFFF), LATENCY_BUCKETS - 1)
+
+    def test_retry_buckets(self) -> None:
+        expected = {0: 0, 1: 1, 2: 2, 3: 3, 4: 3, 5: 4, 8: 4, 9: 5, 1000: 5}
+        for retries, bucket in expected.items():
+            self.assertEqual(self._lib.hid_metrics_retry_bucket(retries), bucket, retries)
+
+    def test_sent_counts_att_bytes_and_histograms(self) -> None:
+        self._lib.hid_metrics_record_attempt(REPORT_KEYBOARD)
+        self._lib.hid_metrics_record_sent(REPORT_KEYBOARD, 9, 300, 0)
+        self._lib.hid_metrics_record_attempt(REPORT_KEYBOARD)
+        self._lib.hid_metrics_record_sent(REPORT_KEYBOARD, 17, 3000, 4)
+        self._lib.hid_metrics_record_tx_latency(REPORT_KEYBOARD, 100)
+
+        counters = self._get(REPORT_KEYBOARD)
+        self.assertEqual(counters.attempts, 2)
+        self.assertEqual(counters.sent, 2)
+        self.assertEqual(counters.bytes, 9 + 17 + 2 * ATT_HEADER_LEN)
+        self.assertEqual(counters.queue_latency[1], 1)
+        self.assertEqual(counters.queue_latency[4], 1)
+        self.assertEqual(counters.tx_latency[0], 1)
+        self.assertEqual(list(counters.retries), [1, 0, 0, 1, 0, 0])
+        self.assertEqual(self._get(REPORT_CONSUMER).sent, 0)
+
+    def test_enomem_rate_in_basis_points(self) -> None:
+        for _ in range(4):
+            self._lib.hid_metrics_record_attempt(REPORT_CONSUMER)
+        self._lib.hid_metrics_record_enomem(REPORT_CONSUMER, True)
+        self._lib.hid_metrics_record_dropped(REPORT_CONSUMER)
+
+        counters = self._get(REPORT_CONSUMER)
+        self.assertEqual(counters.enomem_alloc, 1)
+        self.assertEqual(counters.enomem_notify, 0)
+        self.assertEqual(counters.dropped, 1)
+        self.assertEqual(self._lib.hid_metrics_enomem_rate_bp(ctypes.byref(counters)), 2500)
+        self.assertEqual(self._lib.hid_metrics_enomem_rate_bp(ctypes.byref(Counters())), 0)
+
+    def test_reset_returns_cleared_counters(self) -> None:
+        self._set_time(1_000)
+        self._lib.hid_metrics_reset(None)
+        self._lib.hid_metrics_record_attempt(REPORT_KEYBOARD)
+        self._set_time(5_000)
+
+        last = Snapshot()
+        self._lib.hid_metrics_reset(ctypes.byref(last))
+        self.assertEqual(last.since_reset_us, 4_000)
+        self.assertEqual(last.reports[REPORT_KEYBOARD].attempts, 1)
+
+        snapshot = Snapshot()
+        self._lib.hid_metrics_snapshot(ctypes.byref(snapshot))
+        self.assertEqual(snapshot.since_reset_us, 0)
+        self.assertEqual(snapshot.reports[REPORT_KEYBOARD].attempts, 0)
+
+    def test_out_of_range_type_is_ignored(self) -> None:
+        self._lib.hid_metrics_record_attempt(REPORT_COUNT)
+        snapshot = Snapshot()
+        self._lib.hid_metrics_snapshot(ctypes.byref(snapshot))
+        self.assertTrue(all(r.attempts == 0 for r in snapshot.reports))
+        self.assertEqual(self._lib.hid_metrics_report_name(REPORT_KEYBOARD), b"keyboard")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -1,6 +1,7 @@
 import ctypes
 import re
 import subprocess
+import sys
 import tempfile
 import textwrap
 import unittest
@@ -8,6 +9,8 @@ from pathlib import Path
 
 ROOT = Path(__file__).resolve().parents[1]
 BLE_HID_C = ROOT / "main" / "ble_hid.c"
+DESCRIPTOR_H = ROOT / "main" / "hid_report_descriptor.h"
+GENERATOR = ROOT / "tools" / "generate_hid_descriptor.py"
 REFERENCE_PY = ROOT / "tmp_composite_example.py"
 
 
@@ -19,7 +22,7 @@ def _extract_hex_values(text: str, pattern: str) -> list[int]:
 
 
 def _load_c_descriptor() -> list[int]:
-    text = BLE_HID_C.read_text(encoding="utf-8")
+    text = DESCRIPTOR_H.read_text(encoding="utf-8")
     return _extract_hex_values(text, r"hid_report_map\[]\s*=\s*\{([^}]*)\}")
 
 
@@ -110,7 +113,31 @@ class HidReportMapTest(unittest.TestCase):
 
     def test_consumer_descriptor_has_expected_structure(self) -> None:
         start = len(self.mouse_reference) + len(self.keyboard_reference)
-        self.assertListEqual(self.c_descriptor[start:], self.consumer_reference)
+        end = start + len(self.consumer_reference)
+        self.assertListEqual(self.c_descriptor[start:end], self.consumer_reference)
+
+    def test_pointer_descriptor_reports_absolute_16_bit_axes(self) -> None:
+        start = (
+            len(self.mouse_reference)
+            + len(self.keyboard_reference)
+            + len(self.consumer_reference)
+        )
+        pointer = self.c_descriptor[start:]
+        pointer = pointer[: pointer.index(0x85, 8) - 6]
+        self.assertListEqual(pointer[:8], [0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x04])
+        axes = [0x09, 0x30, 0x09, 0x31, 0x15, 0x00, 0x26, 0xFF, 0x7F,
+                0x75, 0x10, 0x95, 0x02, 0x81, 0x02]
+        joined = bytes(pointer)
+        self.assertIn(bytes(axes), joined)
+        self.assertListEqual(pointer[-2:], [0xC0, 0xC0])
+
+    def test_generated_header_is_current(self) -> None:
+        result = subprocess.run(
+            [sys.executable, str(GENERATOR), "--check"],
+            capture_output=True,
+            text=True,
+        )
+        self.assertEqual(result.returncode, 0, msg=result.stderr)
 
     def test_report_ids_are_contiguous(self) -> None:
         ids = [
@@ -118,20 +145,50 @@ class HidReportMapTest(unittest.TestCase):
             for index, value in enumerate(self.c_descriptor)
             if value == 0x85
         ]
-        self.assertListEqual(ids, [1, 2, 3])
+        self.assertListEqual(ids, [1, 2, 3, 4, 5, 6])
+
+    def _application_section(self, report_id: int) -> bytes:
+        # Each top-level section opens with Usage Page, Usage, Collection
+        # (Application) and then its Report ID.
+        descriptor = bytes(self.c_descriptor)
+        start = descriptor.index(bytes([0xA1, 0x01, 0x85, report_id])) - 4
+        try:
+            end = descriptor.index(bytes([0xA1, 0x01, 0x85, report_id + 1])) - 4
+        except ValueError:
+            end = len(descriptor)
+        return descriptor[start:end]
+
+    def test_hires_mouse_declares_resolution_multipliers(self) -> None:
+        hires = self._application_section(5)
+        # 16-bit relative X/Y
+        self.assertIn(bytes([0x16, 0x01, 0x80, 0x26, 0xFF, 0x7F, 0x75, 0x10,
+                             0x95, 0x02, 0x81, 0x06]), hires)
+        # Usage (Resolution Multiplier) followed by a 2-bit feature mapped to 1..8
+        multiplier = bytes([0x09, 0x48, 0x15, 0x00, 0x25, 0x01, 0x35, 0x01,
+                            0x45, 0x08, 0x75, 0x02])
+        self.assertEqual(hires.count(multiplier), 2)
+        self.assertEqual(hires.count(bytes([0xB1, 0x02])), 2)
+
+    def test_nkro_keyboard_declares_120_key_bitmap(self) -> None:
+        nkro = self._application_section(6)
+        self.assertEqual(nkro[:4], bytes([0x05, 0x01, 0x09, 0x06]))
+        # Usage Minimum (0), Usage Maximum (119), Report Count (120), Input (Data, Variable, Absolute)
+        self.assertIn(bytes([0x19, 0x00, 0x29, 0x77, 0x95, 0x78, 0x81, 0x02]), nkro)
+        self.assertEqual(nkro[-1], 0xC0)
 
 
 class ConsumerUsageMaskTest(unittest.TestCase):
     @classmethod
     def setUpClass(cls) -> None:
         cls.source_text = BLE_HID_C.read_text(encoding="utf-8")
+        descriptor_text = DESCRIPTOR_H.read_text(encoding="utf-8")
         cls.consumer_usages = _extract_hex_values(
-            cls.source_text, r"s_consumer_usages\[]\s*=\s*\{([^}]*)\}"
+            descriptor_text, r"hid_consumer_usages\[]\s*=\s*\{([^}]*)\}"
         )
 
         array_src = re.search(
-            r"static const uint16_t s_consumer_usages\[] = \{[^}]*\};",
-            cls.source_text,
+            r"static const uint16_t hid_consumer_usages\[] = \{[^}]*\};",
+            descriptor_text,
             re.DOTALL,
         )
         if array_src is None:
@@ -265,5 +322,6 @@ class ConsumerUsageMaskTest(unittest.TestCase):
             self.assertEqual(report[0], expected_mask & 0xFF)
             self.assertEqual(report[1], (expected_mask >> 8) & 0xFF)
 
+
 if __name__ == "__main__":
     unittest.main()
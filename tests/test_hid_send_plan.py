@@ -0,0 +1,353 @@
+import ctypes
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+REPORT_MAX_LEN = 17
+PLAN_MAX = 8
+
+ESP_OK = 0
+ESP_FAIL = -1
+ESP_ERR_NO_MEM = 0x101
+
+REPORT_MOUSE = 0
+REPORT_HIRES_MOUSE = 1
+REPORT_BOOT_MOUSE = 2
+REPORT_KEYBOARD = 3
+REPORT_KEYBOARD_NKRO = 4
+REPORT_BOOT_KEYBOARD = 5
+REPORT_CONSUMER = 6
+REPORT_POINTER = 7
+
+# Attribute handles used by the stubbed GATT table, one per report type
+HANDLES = {t: 0x20 + t for t in range(8)}
+
+# Records what reaches the NimBLE stub, and lets a test run it out of buffers
+NIMBLE_STUB = """
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/task.h"
+#include "host/ble_hs.h"
+#include "hid_send_plan.h"
+
+#define TEST_MAX_NOTIFY 32
+
+int64_t esp_timer_get_time(void) { return 1000; }
+TickType_t xTaskGetTickCount(void) { return 0; }
+void vTaskDelay(TickType_t ticks) { (void)ticks; }
+int xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                            uint32_t prio, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)fn; (void)name; (void)stack; (void)arg; (void)prio; (void)handle; (void)core;
+    return pdPASS;
+}
+
+int test_notify_budget = -1;
+int test_notify_rc = 0;
+int test_alloc_fail = 0;
+int test_live_mbufs = 0;
+int test_notify_count = 0;
+uint16_t test_notify_handles[TEST_MAX_NOTIFY];
+uint16_t test_notify_conn[TEST_MAX_NOTIFY];
+int test_hook_count = 0;
+uint16_t test_hook_handles[TEST_MAX_NOTIFY];
+
+struct os_mbuf *ble_hs_mbuf_from_flat(const void *buf, uint16_t len)
+{
+    if (test_alloc_fail || len > sizeof(((struct os_mbuf *)0)->om_data))
+    {
+        return NULL;
+    }
+    struct os_mbuf *om = calloc(1, sizeof(*om));
+    om->om_len = len;
+    memcpy(om->om_data, buf, len);
+    test_live_mbufs++;
+    return om;
+}
+
+int os_mbuf_free_chain(struct os_mbuf *om)
+{
+    if (om)
+    {
+        test_live_mbufs--;
+        free(om);
+    }
+    return 0;
+}
+
+// Like NimBLE, the mbuf is consumed whatever the outcome
+int ble_gatts_notify_custom(uint16_t conn_handle, uint16_t att_handle, struct os_mbuf *om)
+{
+    os_mbuf_free_chain(om);
+    if (test_notify_rc != 0)
+    {
+        return test_notify_rc;
+    }
+    if (test_notify_budget == 0)
+    {
+        return BLE_HS_ENOMEM;
+    }
+    if (test_notify_budget > 0)
+    {
+        test_notify_budget--;
+    }
+    if (test_notify_count < TEST_MAX_NOTIFY)
+    {
+        test_notify_conn[test_notify_count] = conn_handle;
+        test_notify_handles[test_notify_count] = att_handle;
+    }
+    test_notify_count++;
+    return 0;
+}
+
+void test_before_send(void *ctx, const hid_pending_report_t *report, int64_t started_us)
+{
+    (void)ctx;
+    (void)started_us;
+    if (test_hook_count < TEST_MAX_NOTIFY)
+    {
+        test_hook_handles[test_hook_count] = report->attr_handle;
+    }
+    test_hook_count++;
+}
+"""
+
+
+class PendingReport(ctypes.Structure):
+    _fields_ = [
+        ("attr_handle", ctypes.c_uint16),
+        ("type", ctypes.c_int),
+        ("group", ctypes.c_uint8),
+        ("len", ctypes.c_uint8),
+        ("retries", ctypes.c_uint8),
+        ("done", ctypes.c_bool),
+        ("queued_us", ctypes.c_int64),
+        ("data", ctypes.c_uint8 * REPORT_MAX_LEN),
+    ]
+
+
+class SendPlan(ctypes.Structure):
+    _fields_ = [
+        ("order", ctypes.c_uint8 * PLAN_MAX),
+        ("count", ctypes.c_size_t),
+        ("skip", ctypes.c_bool * PLAN_MAX),
+        ("skipped", ctypes.c_size_t),
+    ]
+
+
+class SendResult(ctypes.Structure):
+    _fields_ = [
+        ("sent", ctypes.c_size_t),
+        ("attempted", ctypes.c_size_t),
+        ("last_err", ctypes.c_int),
+    ]
+
+
+class HidSendPlanTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.hid_send_plan_build.argtypes = [
+            ctypes.POINTER(PendingReport),
+            ctypes.c_size_t,
+            ctypes.c_bool,
+            ctypes.POINTER(SendPlan),
+        ]
+        cls._lib.hid_send_plan_build.restype = None
+        cls._lib.hid_send_plan_submit.argtypes = [
+            ctypes.c_uint16,
+            ctypes.POINTER(PendingReport),
+            ctypes.POINTER(SendPlan),
+            ctypes.c_void_p,
+            ctypes.c_void_p,
+            ctypes.POINTER(SendResult),
+        ]
+        cls._lib.hid_send_plan_submit.restype = None
+        cls._hook = ctypes.cast(cls._lib.test_before_send, ctypes.c_void_p)
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            stub_path = Path(tmpdir) / "nimble_stub.c"
+            stub_path.write_text(NIMBLE_STUB)
+            library_path = Path(tmpdir) / "libhid_send_plan.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "hid_send_plan.c"),
+                str(MAIN_DIR / "hid_metrics.c"),
+                str(MAIN_DIR / "hid_event_log.c"),
+                str(stub_path),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def setUp(self) -> None:
+        for name, value in (
+            ("test_notify_budget", -1),
+            ("test_notify_rc", 0),
+            ("test_alloc_fail", 0),
+            ("test_notify_count", 0),
+            ("test_hook_count", 0),
+        ):
+            self._set(name, value)
+
+    def _set(self, name: str, value: int) -> None:
+        ctypes.c_int.in_dll(self._lib, name).value = value
+
+    def _get(self, name: str) -> int:
+        return ctypes.c_int.in_dll(self._lib, name).value
+
+    @staticmethod
+    def _queue(*entries):
+        """entries: (report type, group, payload bytes)"""
+        reports = (PendingReport * PLAN_MAX)()
+        for i, (report_type, group, payload) in enumerate(entries):
+            reports[i].attr_handle = HANDLES[report_type]
+            reports[i].type = report_type
+            reports[i].group = group
+            reports[i].len = len(payload)
+            for j, byte in enumerate(payload):
+                reports[i].data[j] = byte
+        return reports, len(entries)
+
+    def _plan(self, reports, count, report_protocol=True) -> SendPlan:
+        plan = SendPlan()
+        self._lib.hid_send_plan_build(reports, count, report_protocol, ctypes.byref(plan))
+        return plan
+
+    def _submit(self, reports, plan, conn_handle=1) -> SendResult:
+        result = SendResult()
+        self._lib.hid_send_plan_submit(conn_handle, reports, ctypes.byref(plan), self._hook, None,
+                                       ctypes.byref(result))
+        return result
+
+    def _notified(self):
+        handles = (ctypes.c_uint16 * 32).in_dll(self._lib, "test_notify_handles")
+        return [handles[i] for i in range(self._get("test_notify_count"))]
+
+    def _order(self, plan, reports):
+        return [reports[plan.order[i]].type for i in range(plan.count)]
+
+    def test_report_protocol_skips_boot_duplicates(self) -> None:
+        reports, count = self._queue(
+            (REPORT_HIRES_MOUSE, 1, b"\x05\x01\x00\x02\x00\x00\x00"),
+            (REPORT_BOOT_MOUSE, 1, b"\x01\x01\x02"),
+            (REPORT_KEYBOARD_NKRO, 2, b"\x06" + bytes(16)),
+            (REPORT_BOOT_KEYBOARD, 2, bytes(8)),
+        )
+        plan = self._plan(reports, count)
+        self.assertEqual(self._order(plan, reports), [REPORT_HIRES_MOUSE, REPORT_KEYBOARD_NKRO])
+        self.assertEqual(plan.skipped, 2)
+        self.assertTrue(plan.skip[1] and plan.skip[3])
+
+        result = self._submit(reports, plan)
+        self.assertEqual(result.sent, 2)
+        self.assertEqual(result.last_err, ESP_OK)
+        self.assertEqual(self._notified(), [HANDLES[REPORT_HIRES_MOUSE], HANDLES[REPORT_KEYBOARD_NKRO]])
+        self.assertEqual(self._get("test_live_mbufs"), 0)
+
+    def test_boot_report_without_counterpart_is_sent(self) -> None:
+        # The report-protocol half of this update was dropped from the queue
+        reports, count = self._queue((REPORT_BOOT_KEYBOARD, 4, bytes(8)))
+        plan = self._plan(reports, count)
+        self.assertEqual(self._order(plan, reports), [REPORT_BOOT_KEYBOARD])
+
+    def test_boot_protocol_keeps_boot_reports(self) -> None:
+        reports, count = self._queue(
+            (REPORT_BOOT_KEYBOARD, 1, bytes(8)),
+            (REPORT_KEYBOARD, 1, b"\x02" + bytes(8)),
+        )
+        plan = self._plan(reports, count, report_protocol=False)
+        self.assertEqual(plan.skipped, 0)
+        # Priority within the update: report-protocol characteristic first
+        self.assertEqual(self._order(plan, reports), [REPORT_KEYBOARD, REPORT_BOOT_KEYBOARD])
+
+    def test_updates_keep_queue_order(self) -> None:
+        # A click queued before a modifier release must stay before it
+        reports, count = self._queue(
+            (REPORT_KEYBOARD, 1, b"\x02\x02" + bytes(7)),
+            (REPORT_HIRES_MOUSE, 2, b"\x05\x01" + bytes(5)),
+            (REPORT_KEYBOARD, 3, b"\x02" + bytes(8)),
+            (REPORT_CONSUMER, 4, b"\x03\x01\x00"),
+        )
+        plan = self._plan(reports, count)
+        self.assertEqual(list(plan.order[: plan.count]), [0, 1, 2, 3])
+
+    def test_repeated_state_reports_are_coalesced(self) -> None:
+        released = b"\x02" + bytes(8)
+        reports, count = self._queue(
+            (REPORT_KEYBOARD, 1, released),
+            (REPORT_KEYBOARD, 2, released),
+            (REPORT_HIRES_MOUSE, 3, b"\x05\x00\x01\x00" + bytes(3)),
+            (REPORT_HIRES_MOUSE, 4, b"\x05\x00\x01\x00" + bytes(3)),
+            (REPORT_KEYBOARD, 5, released),
+        )
+        plan = self._plan(reports, count)
+        # Identical relative motion is new motion, so both mouse reports stay
+        self.assertEqual(list(plan.order[: plan.count]), [0, 2, 3])
+        self.assertEqual(plan.skipped, 2)
+
+    def test_done_reports_are_left_out(self) -> None:
+        reports, count = self._queue(
+            (REPORT_KEYBOARD, 1, b"\x02\x00\x00\x04" + bytes(5)),
+            (REPORT_CONSUMER, 2, b"\x03\x01\x00"),
+        )
+        reports[1].done = True
+        plan = self._plan(reports, count)
+        self.assertEqual(list(plan.order[: plan.count]), [0])
+        self.assertEqual(plan.skipped, 0)
+
+    def test_submit_stops_when_link_runs_out_of_buffers(self) -> None:
+        reports, count = self._queue(
+            (REPORT_KEYBOARD, 1, b"\x02\x00\x00\x04" + bytes(5)),
+            (REPORT_KEYBOARD, 2, b"\x02" + bytes(8)),
+            (REPORT_CONSUMER, 3, b"\x03\x01\x00"),
+        )
+        self._set("test_notify_budget", 1)
+        plan = self._plan(reports, count)
+        result = self._submit(reports, plan)
+
+        self.assertEqual(result.sent, 1)
+        self.assertEqual(result.attempted, 2)
+        self.assertEqual(result.last_err, ESP_ERR_NO_MEM)
+        self.assertEqual([reports[i].done for i in range(count)], [True, False, False])
+        self.assertEqual(reports[1].retries, 1)
+        self.assertEqual(self._get("test_hook_count"), 2)
+        self.assertEqual(self._get("test_live_mbufs"), 0)
+
+    def test_allocation_failure_is_out_of_buffers(self) -> None:
+        reports, count = self._queue((REPORT_CONSUMER, 1, b"\x03\x01\x00"))
+        self._set("test_alloc_fail", 1)
+        result = self._submit(reports, self._plan(reports, count))
+        self.assertEqual(result.last_err, ESP_ERR_NO_MEM)
+        self.assertEqual(self._get("test_notify_count"), 0)
+        self.assertFalse(reports[0].done)
+
+    def test_other_errors_drop_the_report_and_continue(self) -> None:
+        reports, count = self._queue(
+            (REPORT_POINTER, 1, b"\x04" + bytes(5)),
+            (REPORT_CONSUMER, 2, b"\x03\x01\x00"),
+        )
+        self._set("test_notify_rc", 7)  # BLE_HS_ENOTCONN
+        result = self._submit(reports, self._plan(reports, count))
+        self.assertEqual(result.sent, 0)
+        self.assertEqual(result.attempted, 2)
+        self.assertEqual(result.last_err, ESP_FAIL)
+        self.assertTrue(reports[0].done and reports[1].done)
+        self.assertEqual(self._get("test_live_mbufs"), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
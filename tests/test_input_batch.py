@@ -0,0 +1,137 @@
+import ctypes
+import json
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+
+EVENT_MAX = 512
+
+EVENT_FN = ctypes.CFUNCTYPE(None, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_void_p)
+
+
+class InputBatch(ctypes.Structure):
+    # Mirrors input_batch_t in main/input_batch.h
+    _fields_ = [
+        ("on_event", EVENT_FN),
+        ("ctx", ctypes.c_void_p),
+        ("buf", ctypes.c_char * (EVENT_MAX + 1)),
+        ("len", ctypes.c_size_t),
+        ("depth", ctypes.c_uint32),
+        ("in_string", ctypes.c_bool),
+        ("escape", ctypes.c_bool),
+        ("oversized", ctypes.c_bool),
+        ("events", ctypes.c_uint32),
+        ("dropped", ctypes.c_uint32),
+        ("stray", ctypes.c_uint32),
+    ]
+
+
+class InputBatchTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.input_batch_init.argtypes = [ctypes.POINTER(InputBatch), EVENT_FN, ctypes.c_void_p]
+        cls._lib.input_batch_init.restype = None
+        cls._lib.input_batch_feed.argtypes = [ctypes.POINTER(InputBatch), ctypes.c_char_p, ctypes.c_size_t]
+        cls._lib.input_batch_feed.restype = None
+        cls._lib.input_batch_finish.argtypes = [ctypes.POINTER(InputBatch)]
+        cls._lib.input_batch_finish.restype = ctypes.c_bool
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library_path = Path(tmpdir) / "libinput_batch.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "input_batch.c"),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def _split(self, body: bytes, chunk: int = 0):
+        events = []
+
+        def on_event(json_text, length, _ctx):
+            self.assertEqual(len(json_text), length)
+            events.append(json_text.decode())
+
+        callback = EVENT_FN(on_event)
+        batch = InputBatch()
+        self._lib.input_batch_init(ctypes.byref(batch), callback, None)
+        step = chunk or max(len(body), 1)
+        for i in range(0, len(body), step):
+            piece = body[i:i + step]
+            self._lib.input_batch_feed(ctypes.byref(batch), piece, len(piece))
+        complete = self._lib.input_batch_finish(ctypes.byref(batch))
+        return events, batch, complete
+
+    def test_single_object(self) -> None:
+        events, batch, complete = self._split(b'{"type":"mouse","dx":5}')
+        self.assertEqual(events, ['{"type":"mouse","dx":5}'])
+        self.assertTrue(complete)
+        self.assertEqual((batch.events, batch.dropped, batch.stray), (1, 0, 0))
+
+    def test_array_and_ndjson_give_same_events(self) -> None:
+        messages = [
+            {"type": "mouse", "dx": 3, "buttons": {"left": True}},
+            {"type": "keyboard", "keys": [4, 5], "modifiers": {"left_shift": True}},
+            {"type": "control", "cmd": "hid_stats"},
+        ]
+        array_body = json.dumps(messages).encode()
+        ndjson_body = b"\r\n".join(json.dumps(m).encode() for m in messages) + b"\n"
+        for body in (array_body, ndjson_body):
+            events, batch, complete = self._split(body)
+            self.assertEqual([json.loads(e) for e in events], messages)
+            self.assertTrue(complete)
+            self.assertEqual(batch.stray, 0)
+
+    def test_every_chunk_size_splits_the_same(self) -> None:
+        messages = [{"type": "keyboard", "text": 'brace } and "quote" \\ and {'}, {"type": "mouse", "dx": -1}]
+        body = ("[" + ",\n".join(json.dumps(m) for m in messages) + "]").encode()
+        for chunk in range(1, len(body) + 1):
+            events, _, complete = self._split(body, chunk)
+            self.assertEqual([json.loads(e) for e in events], messages, chunk)
+            self.assertTrue(complete)
+
+    def test_oversized_event_is_dropped_and_next_survives(self) -> None:
+        big = json.dumps({"type": "keyboard", "text": "x" * EVENT_MAX}).encode()
+        events, batch, complete = self._split(big + b'\n{"type":"mouse","dx":1}', 64)
+        self.assertEqual(events, ['{"type":"mouse","dx":1}'])
+        self.assertEqual((batch.events, batch.dropped), (1, 1))
+        self.assertTrue(complete)
+
+    def test_event_of_exactly_max_length_fits(self) -> None:
+        prefix = b'{"t":"'
+        body = prefix + b"y" * (EVENT_MAX - len(prefix) - 2) + b'"}'
+        self.assertEqual(len(body), EVENT_MAX)
+        events, batch, _ = self._split(body)
+        self.assertEqual(len(events), 1)
+        self.assertEqual(batch.dropped, 0)
+
+    def test_truncated_body_and_stray_bytes(self) -> None:
+        events, batch, complete = self._split(b'{"type":"mouse"} junk {"type":"mo')
+        self.assertEqual(events, ['{"type":"mouse"}'])
+        self.assertFalse(complete)
+        self.assertEqual(batch.dropped, 1)
+        self.assertEqual(batch.stray, 4)
+
+    def test_empty_body(self) -> None:
+        events, batch, complete = self._split(b"")
+        self.assertEqual(events, [])
+        self.assertTrue(complete)
+        self.assertEqual(batch.events, 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
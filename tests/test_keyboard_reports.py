@@ -0,0 +1,110 @@
+import ctypes
+import json
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+HID_KEYBOARD_REPORT_LEN = 9
+HID_KEYBOARD_NKRO_REPORT_LEN = 17
+HID_KEYBOARD_ERROR_ROLLOVER = 0x01
+
+
+class KeyboardState(ctypes.Structure):
+    _fields_ = [
+        ("modifiers", ctypes.c_uint8),
+        ("reserved", ctypes.c_uint8),
+        ("keys", ctypes.c_uint8 * 6),
+        ("bitmap", ctypes.c_uint8 * 15),
+    ]
+
+
+class KeyboardReportTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        for name in ("keyboard_build_report", "keyboard_build_nkro_report"):
+            fn = getattr(cls._lib, name)
+            fn.argtypes = [ctypes.POINTER(KeyboardState), ctypes.POINTER(ctypes.c_uint8)]
+            fn.restype = None
+        cls._lib.keyboard_state_press.argtypes = [ctypes.POINTER(KeyboardState), ctypes.c_uint8]
+        cls._lib.keyboard_state_press.restype = ctypes.c_bool
+        cls._lib.keyboard_bitmap_from_hex.argtypes = [ctypes.POINTER(KeyboardState), ctypes.c_char_p]
+        cls._lib.keyboard_bitmap_from_hex.restype = ctypes.c_bool
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library_path = Path(tmpdir) / "libkeyboard_report.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "keyboard_report_builder.c"),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def _state_from_nkro_json(self, payload: str) -> KeyboardState:
+        message = json.loads(payload)
+        state = KeyboardState()
+        if "bitmap" in message:
+            self.assertTrue(self._lib.keyboard_bitmap_from_hex(state, message["bitmap"].encode()))
+        for usage in message.get("keys", []):
+            self.assertTrue(self._lib.keyboard_state_press(state, usage))
+        return state
+
+    def _reports(self, state: KeyboardState) -> tuple[list[int], list[int]]:
+        report = (ctypes.c_uint8 * HID_KEYBOARD_REPORT_LEN)()
+        nkro = (ctypes.c_uint8 * HID_KEYBOARD_NKRO_REPORT_LEN)()
+        self._lib.keyboard_build_report(ctypes.byref(state), report)
+        self._lib.keyboard_build_nkro_report(ctypes.byref(state), nkro)
+        return list(report), list(nkro)
+
+    def test_6kro_state_passes_through_unchanged(self) -> None:
+        state = KeyboardState()
+        state.modifiers = 0x02
+        state.keys[0] = 0x04
+        state.keys[2] = 0x05
+        report, nkro = self._reports(state)
+        self.assertEqual(report, [2, 0x02, 0, 0x04, 0, 0x05, 0, 0, 0])
+        self.assertEqual(nkro[:3], [6, 0x02, 0b00110000])
+        self.assertEqual(nkro[3:], [0] * 14)
+
+    def test_large_chord_fits_one_nkro_report(self) -> None:
+        # A through J plus left shift
+        state = self._state_from_nkro_json(
+            '{"type":"keyboard_nkro","keys":[4,5,6,7,8,9,10,11,12,13,225]}'
+        )
+        report, nkro = self._reports(state)
+        self.assertEqual(nkro[:4], [6, 0x02, 0xF0, 0x3F])
+        # Ten keys cannot fit the six 6KRO slots
+        self.assertEqual(report[1:], [0x02, 0] + [HID_KEYBOARD_ERROR_ROLLOVER] * 6)
+
+    def test_small_bitmap_chord_is_compacted_for_6kro(self) -> None:
+        state = self._state_from_nkro_json('{"type":"keyboard_nkro","bitmap":"00000000000001"}')
+        report, nkro = self._reports(state)
+        # bit 48 is usage 0x30 (])
+        self.assertEqual(nkro[8], 0x01)
+        self.assertEqual(report, [2, 0, 0, 0x30, 0, 0, 0, 0, 0])
+
+    def test_rejects_malformed_bitmaps_and_out_of_range_usages(self) -> None:
+        state = KeyboardState()
+        self.assertFalse(self._lib.keyboard_bitmap_from_hex(state, b"0"))
+        self.assertFalse(self._lib.keyboard_bitmap_from_hex(state, b"zz"))
+        self.assertFalse(self._lib.keyboard_bitmap_from_hex(state, b"00" * 16))
+        self.assertFalse(self._lib.keyboard_state_press(state, 0x78))
+        self.assertEqual(list(state.bitmap), [0] * 15)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,194 @@
+import ctypes
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+MAX_TASKS = 32
+NAME_LEN = 16
+NO_CORE = -1
+
+RTOS_SHIM = """
+#include <stdint.h>
+#include "freertos/task.h"
+
+#define SHIM_MAX_TASKS 40
+
+const char *shim_names[SHIM_MAX_TASKS];
+uintptr_t shim_handles[SHIM_MAX_TASKS];
+uint32_t shim_runtime[SHIM_MAX_TASKS];
+uint32_t shim_stack[SHIM_MAX_TASKS];
+unsigned shim_priority[SHIM_MAX_TASKS];
+int shim_core[SHIM_MAX_TASKS];
+unsigned shim_count = 0;
+uint32_t shim_total = 0;
+
+UBaseType_t uxTaskGetNumberOfTasks(void) { return shim_count; }
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t size, uint32_t *total)
+{
+    if (size < shim_count)
+    {
+        return 0;
+    }
+    for (unsigned i = 0; i < shim_count; ++i)
+    {
+        status[i].xHandle = (TaskHandle_t)shim_handles[i];
+        status[i].pcTaskName = shim_names[i];
+        status[i].uxCurrentPriority = shim_priority[i];
+        status[i].ulRunTimeCounter = shim_runtime[i];
+        status[i].usStackHighWaterMark = shim_stack[i];
+    }
+    *total = shim_total;
+    return shim_count;
+}
+
+BaseType_t xTaskGetCoreID(TaskHandle_t task)
+{
+    for (unsigned i = 0; i < shim_count; ++i)
+    {
+        if (shim_handles[i] == (uintptr_t)task)
+        {
+            return shim_core[i] < 0 ? tskNO_AFFINITY : shim_core[i];
+        }
+    }
+    return tskNO_AFFINITY;
+}
+"""
+
+
+class Entry(ctypes.Structure):
+    _fields_ = [
+        ("name", ctypes.c_char * NAME_LEN),
+        ("priority", ctypes.c_uint32),
+        ("core", ctypes.c_int),
+        ("stack_free", ctypes.c_uint32),
+        ("cpu_permille", ctypes.c_uint32),
+    ]
+
+
+class Stats(ctypes.Structure):
+    _fields_ = [
+        ("window_us", ctypes.c_uint32),
+        ("count", ctypes.c_size_t),
+        ("dropped", ctypes.c_size_t),
+        ("tasks", Entry * MAX_TASKS),
+    ]
+
+
+class TaskStatsTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.task_stats_sample.argtypes = [ctypes.POINTER(Stats)]
+        cls._lib.task_stats_sample.restype = ctypes.c_int
+        cls._lib.task_stats_permille.argtypes = [ctypes.c_uint32, ctypes.c_uint32]
+        cls._lib.task_stats_permille.restype = ctypes.c_uint32
+        cls._names = []
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            shim_path = Path(tmpdir) / "rtos_shim.c"
+            shim_path.write_text(RTOS_SHIM)
+            library_path = Path(tmpdir) / "libtask_stats.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-DCONFIG_FREERTOS_USE_TRACE_FACILITY=1",
+                "-DCONFIG_FREERTOS_GENERATE_RUN_TIME_STATS=1",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "task_stats.c"),
+                str(shim_path),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def _set_tasks(self, total: int, tasks: list) -> None:
+        """tasks: (handle, name, runtime, priority, core, stack_free)"""
+        lib = self._lib
+        self._names = [ctypes.create_string_buffer(t[1].encode()) for t in tasks]
+        for i, (handle, _, runtime, priority, core, stack) in enumerate(tasks):
+            (ctypes.c_char_p * 40).in_dll(lib, "shim_names")[i] = ctypes.cast(self._names[i], ctypes.c_char_p)
+            (ctypes.c_size_t * 40).in_dll(lib, "shim_handles")[i] = handle
+            (ctypes.c_uint32 * 40).in_dll(lib, "shim_runtime")[i] = runtime
+            (ctypes.c_uint * 40).in_dll(lib, "shim_priority")[i] = priority
+            (ctypes.c_int * 40).in_dll(lib, "shim_core")[i] = core
+            (ctypes.c_uint32 * 40).in_dll(lib, "shim_stack")[i] = stack
+        ctypes.c_uint.in_dll(lib, "shim_count").value = len(tasks)
+        ctypes.c_uint32.in_dll(lib, "shim_total").value = total
+
+    def _sample(self) -> Stats:
+        stats = Stats()
+        self.assertEqual(self._lib.task_stats_sample(ctypes.byref(stats)), 0)
+        return stats
+
+    def _by_name(self, stats: Stats) -> dict:
+        return {stats.tasks[i].name.decode(): stats.tasks[i] for i in range(stats.count)}
+
+    def test_permille_clamps_and_handles_empty_window(self) -> None:
+        self.assertEqual(self._lib.task_stats_permille(250, 1000), 250)
+        self.assertEqual(self._lib.task_stats_permille(5000, 1000), 1000)
+        self.assertEqual(self._lib.task_stats_permille(5, 0), 0)
+        self.assertEqual(self._lib.task_stats_permille(0xFFFFFFFF, 0xFFFFFFFF), 1000)
+
+    def test_cpu_share_covers_window_since_previous_sample(self) -> None:
+        self._set_tasks(1_000_000, [
+            (0x10, "nimble_host", 100_000, 21, 0, 1200),
+            (0x20, "httpd", 300_000, 6, 1, 2000),
+            (0x30, "IDLE0", 600_000, 0, 0, 900),
+        ])
+        self._sample()
+
+        # 500 ms later: the host ran 250 ms, httpd 50 ms; a new task joined
+        self._set_tasks(1_500_000, [
+            (0x10, "nimble_host", 350_000, 21, 0, 1100),
+            (0x20, "httpd", 350_000, 6, 1, 1900),
+            (0x30, "IDLE0", 800_000, 0, 0, 900),
+            (0x40, "ws_ascii", 25_000, 2, NO_CORE, 2500),
+        ])
+        stats = self._sample()
+        self.assertEqual(stats.window_us, 500_000)
+        self.assertEqual(stats.count, 4)
+        tasks = self._by_name(stats)
+        self.assertEqual(tasks["nimble_host"].cpu_permille, 500)
+        self.assertEqual(tasks["httpd"].cpu_permille, 100)
+        self.assertEqual(tasks["IDLE0"].cpu_permille, 400)
+        self.assertEqual(tasks["ws_ascii"].cpu_permille, 50)
+        self.assertEqual(tasks["nimble_host"].core, 0)
+        self.assertEqual(tasks["ws_ascii"].core, NO_CORE)
+        self.assertEqual(tasks["nimble_host"].stack_free, 1100)
+        self.assertEqual(tasks["httpd"].priority, 6)
+
+    def test_counter_wrap(self) -> None:
+        self._set_tasks(0xFFFF_0000, [(0x10, "uart_task", 0xFFFF_0000, 10, 1, 3000)])
+        self._sample()
+        self._set_tasks(0x0000_FFFF, [(0x10, "uart_task", 0x0000_0FFF, 10, 1, 3000)])
+        stats = self._sample()
+        self.assertEqual(stats.window_us, 0x1FFFF)
+        self.assertEqual(stats.tasks[0].cpu_permille, 0x10FFF * 1000 // 0x1FFFF)
+
+    def test_tasks_beyond_capacity_are_counted(self) -> None:
+        tasks = [(0x100 + i, f"t{i}", 0, 1, 0, 100) for i in range(MAX_TASKS + 3)]
+        self._set_tasks(1000, tasks)
+        stats = self._sample()
+        self.assertEqual(stats.count, MAX_TASKS)
+        self.assertEqual(stats.dropped, 3)
+
+    def test_long_names_are_truncated(self) -> None:
+        self._set_tasks(1000, [(0x10, "a_very_long_task_name", 0, 1, 0, 100)])
+        stats = self._sample()
+        self.assertEqual(stats.tasks[0].name, b"a_very_long_tas")
+
+
+if __name__ == "__main__":
+    unittest.main()
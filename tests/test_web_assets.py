@@ -0,0 +1,202 @@
+import ctypes
+import gzip
+import hashlib
+import subprocess
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+GENERATOR = PROJECT_ROOT / "tools" / "compress_web_assets.py"
+
+INDEX_HTML = b"<!DOCTYPE html><html><body>" + b"<p>hello web ui</p>" * 200 + b"</body></html>"
+STYLE_CSS = b"body { color: #222; }\n"
+
+
+RANGE_NONE = 0
+RANGE_OK = 1
+RANGE_UNSATISFIABLE = 2
+
+
+class WebAsset(ctypes.Structure):
+    _fields_ = [
+        ("path", ctypes.c_char_p),
+        ("content_type", ctypes.c_char_p),
+        ("data", ctypes.POINTER(ctypes.c_uint8)),
+        ("size", ctypes.c_size_t),
+        ("etag", ctypes.c_char_p),
+        ("gz_data", ctypes.POINTER(ctypes.c_uint8)),
+        ("gz_size", ctypes.c_size_t),
+        ("gz_etag", ctypes.c_char_p),
+    ]
+
+
+APP_JS = b"console.log('app');\n"
+CONTROL_HTML = b"<html>control</html>"
+
+
+def generate(tmpdir: Path) -> Path:
+    web = tmpdir / "web"
+    (web / "js").mkdir(parents=True, exist_ok=True)
+    (web / "index.html").write_bytes(INDEX_HTML)
+    (web / "style.css").write_bytes(STYLE_CSS)
+    (web / "js" / "app.js").write_bytes(APP_JS)
+    (web / ".hidden").write_bytes(b"skip me")
+    (tmpdir / "control.html").write_bytes(CONTROL_HTML)
+    output = tmpdir / "web_assets_data.c"
+    subprocess.check_call([
+        sys.executable,
+        str(GENERATOR),
+        "--output",
+        str(output),
+        "--root",
+        str(web),
+        f"/control.html={tmpdir / 'control.html'}",
+    ])
+    return output
+
+
+class WebAssetsTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            tmp = Path(tmpdir)
+            data_c = generate(tmp)
+            cls.generated = data_c.read_text(encoding="utf-8")
+            cls.regenerated = generate(tmp).read_text(encoding="utf-8")
+            library_path = tmp / "libweb_assets.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "web_assets.c"),
+                str(data_c),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            cls._lib = ctypes.CDLL(str(library_path))
+        cls._lib.web_assets_find.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+        cls._lib.web_assets_find.restype = ctypes.POINTER(WebAsset)
+        cls._lib.web_assets_parse_range.argtypes = [
+            ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t), ctypes.POINTER(ctypes.c_size_t)]
+        cls._lib.web_assets_parse_range.restype = ctypes.c_int
+        cls.table = (WebAsset * ctypes.c_size_t.in_dll(cls._lib, "g_web_asset_count").value).in_dll(
+            cls._lib, "g_web_assets")
+        cls._lib.web_assets_accepts_gzip.argtypes = [ctypes.c_char_p]
+        cls._lib.web_assets_accepts_gzip.restype = ctypes.c_bool
+        cls._lib.web_assets_etag_matches.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+        cls._lib.web_assets_etag_matches.restype = ctypes.c_bool
+
+    def _find(self, path: bytes, length: int | None = None):
+        asset = self._lib.web_assets_find(path, len(path) if length is None else length)
+        return asset.contents if asset else None
+
+    def _range(self, header, size):
+        start = ctypes.c_size_t()
+        length = ctypes.c_size_t()
+        result = self._lib.web_assets_parse_range(header, size, ctypes.byref(start), ctypes.byref(length))
+        if result == RANGE_OK:
+            return start.value, length.value
+        return result
+
+    def test_table_is_sorted_with_aliases(self) -> None:
+        paths = [entry.path for entry in self.table]
+        self.assertEqual(paths, [b"/", b"/control.html", b"/index.html", b"/js/app.js", b"/style.css"])
+        self.assertEqual(paths, sorted(paths))
+        # "/" and "/index.html" share one copy of the page
+        self.assertEqual(ctypes.addressof(self.table[0].data.contents),
+                         ctypes.addressof(self.table[2].data.contents))
+        for entry in self.table:
+            self.assertEqual(self._find(entry.path).path, entry.path)
+
+    def test_find_ignores_query_string(self) -> None:
+        uri = b"/js/app.js?v=3"
+        self.assertEqual(self._find(uri, uri.index(b"?")).path, b"/js/app.js")
+        self.assertEqual(self._find(b"/?x", 1).path, b"/")
+        self.assertIsNone(self._find(b"/js/app.js?v=3"))
+        self.assertIsNone(self._find(b"/js/app"))
+        self.assertIsNone(self._find(b"/.hidden"))
+        self.assertIsNone(self._find(b""))
+
+    def test_assets_round_trip(self) -> None:
+        index = self._find(b"/")
+        self.assertIsNotNone(index)
+        self.assertEqual(index.content_type, b"text/html")
+        self.assertEqual(ctypes.string_at(index.data, index.size), INDEX_HTML)
+        packed = ctypes.string_at(index.gz_data, index.gz_size)
+        self.assertEqual(gzip.decompress(packed), INDEX_HTML)
+        self.assertLess(index.gz_size, index.size // 4)
+
+        app = self._find(b"/js/app.js")
+        self.assertEqual(app.content_type, b"application/javascript")
+        self.assertEqual(ctypes.string_at(app.data, app.size), APP_JS)
+        control = self._find(b"/control.html")
+        self.assertEqual(ctypes.string_at(control.data, control.size), CONTROL_HTML)
+
+        css = self._find(b"/style.css")
+        self.assertEqual(css.content_type, b"text/css")
+        self.assertEqual(ctypes.string_at(css.data, css.size), STYLE_CSS)
+        self.assertIsNone(self._find(b"/missing.js"))
+        self.assertIsNone(self._find(b"/style.cs"))
+
+    def test_etags_are_strong_and_deterministic(self) -> None:
+        index = self._find(b"/")
+        expected = '"' + hashlib.sha256(INDEX_HTML).hexdigest()[:16] + '"'
+        self.assertEqual(index.etag.decode(), expected)
+        self.assertTrue(index.gz_etag.startswith(b'"'))
+        self.assertNotEqual(index.etag, index.gz_etag)
+        self.assertEqual(self.generated, self.regenerated)
+
+    def test_parse_range(self) -> None:
+        self.assertEqual(self._range(b"bytes=0-99", 1000), (0, 100))
+        self.assertEqual(self._range(b"bytes=900-", 1000), (900, 100))
+        self.assertEqual(self._range(b"bytes=900-5000", 1000), (900, 100))
+        self.assertEqual(self._range(b"bytes=-100", 1000), (900, 100))
+        self.assertEqual(self._range(b"bytes=-5000", 1000), (0, 1000))
+        self.assertEqual(self._range(b"Bytes=5-5", 1000), (5, 1))
+        self.assertEqual(self._range(b"bytes=0-99999999999999999999999", 10), (0, 10))
+        self.assertEqual(self._range(b"bytes=1000-", 1000), RANGE_UNSATISFIABLE)
+        self.assertEqual(self._range(b"bytes=-0", 1000), RANGE_UNSATISFIABLE)
+        self.assertEqual(self._range(b"bytes=0-", 0), RANGE_UNSATISFIABLE)
+        self.assertEqual(self._range(b"bytes=5-4", 1000), RANGE_NONE)
+        self.assertEqual(self._range(b"bytes=0-1,5-9", 1000), RANGE_NONE)
+        self.assertEqual(self._range(b"items=0-1", 1000), RANGE_NONE)
+        self.assertEqual(self._range(b"bytes=a-1", 1000), RANGE_NONE)
+        self.assertEqual(self._range(b"bytes=-", 1000), RANGE_NONE)
+        self.assertEqual(self._range(None, 1000), RANGE_NONE)
+
+    def test_accepts_gzip(self) -> None:
+        accepts = self._lib.web_assets_accepts_gzip
+        self.assertTrue(accepts(b"gzip, deflate, br"))
+        self.assertTrue(accepts(b"deflate;q=1.0, GZIP;q=0.5"))
+        self.assertTrue(accepts(b"x-gzip"))
+        self.assertTrue(accepts(b"*"))
+        self.assertFalse(accepts(b"gzip;q=0"))
+        self.assertFalse(accepts(b"gzip; q=0.000, deflate"))
+        self.assertFalse(accepts(b"*, gzip;q=0"))
+        self.assertFalse(accepts(b"identity"))
+        self.assertFalse(accepts(b"gzipx, br"))
+        self.assertFalse(accepts(b""))
+        self.assertFalse(accepts(None))
+
+    def test_etag_matches(self) -> None:
+        matches = self._lib.web_assets_etag_matches
+        etag = b'"0123456789abcdef"'
+        self.assertTrue(matches(etag, etag))
+        self.assertTrue(matches(b'"other", W/"0123456789abcdef"', etag))
+        self.assertTrue(matches(b"*", etag))
+        self.assertFalse(matches(b'"0123456789abcdee"', etag))
+        self.assertFalse(matches(b'"0123456789abcdef', etag))
+        self.assertFalse(matches(b"0123456789abcdef", etag))
+        self.assertFalse(matches(b"", etag))
+        self.assertFalse(matches(None, etag))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,149 @@
+import ctypes
+import json
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+PROJECT_ROOT = Path(__file__).resolve().parents[1]
+MAIN_DIR = PROJECT_ROOT / "main"
+
+
+class ApRecord(ctypes.Structure):
+    # Mirrors wifi_ap_record_t in tests/stubs/esp_wifi_types.h
+    _fields_ = [
+        ("bssid", ctypes.c_uint8 * 6),
+        ("ssid", ctypes.c_uint8 * 33),
+        ("primary", ctypes.c_uint8),
+        ("rssi", ctypes.c_int8),
+        ("authmode", ctypes.c_int),
+    ]
+
+
+def make_records(*entries):
+    records = (ApRecord * max(len(entries), 1))()
+    for record, (ssid, rssi) in zip(records, entries):
+        raw = ssid if isinstance(ssid, bytes) else ssid.encode()
+        ctypes.memmove(record.ssid, raw, len(raw))
+        record.rssi = rssi
+        record.primary = 6
+        record.authmode = 4
+    return records
+
+
+def ssid_of(record) -> bytes:
+    return bytes(record.ssid).split(b"\0", 1)[0]
+
+
+class WifiScanResultsTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls._lib = cls._build_test_library()
+        cls._lib.wifi_scan_results_compact.argtypes = [
+            ctypes.POINTER(ApRecord), ctypes.c_size_t, ctypes.c_bool, ctypes.c_bool]
+        cls._lib.wifi_scan_results_compact.restype = ctypes.c_size_t
+        cls._lib.wifi_scan_results_page.argtypes = [
+            ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint32, ctypes.POINTER(ApRecord),
+            ctypes.c_size_t, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t)]
+        cls._lib.wifi_scan_results_page.restype = ctypes.c_size_t
+
+    @staticmethod
+    def _build_test_library() -> ctypes.CDLL:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library_path = Path(tmpdir) / "libwifi_scan_results.so"
+            compile_cmd = [
+                "gcc",
+                "-std=c11",
+                "-shared",
+                "-fPIC",
+                "-I",
+                str(PROJECT_ROOT / "tests" / "stubs"),
+                "-I",
+                str(MAIN_DIR),
+                str(MAIN_DIR / "wifi_scan_results.c"),
+                "-o",
+                str(library_path),
+            ]
+            subprocess.check_call(compile_cmd, cwd=PROJECT_ROOT)
+            return ctypes.CDLL(str(library_path))
+
+    def _compact(self, records, count, dedup=True, sort=True) -> list:
+        kept = self._lib.wifi_scan_results_compact(records, count, dedup, sort)
+        return [(ssid_of(r), r.rssi) for r in records[:kept]]
+
+    def _page(self, records, total, offset, size=1024, scan_id=1):
+        buf = ctypes.create_string_buffer(size)
+        length = ctypes.c_size_t()
+        written = self._lib.wifi_scan_results_page(buf, size, scan_id, records, total, offset, ctypes.byref(length))
+        if length.value == 0:
+            return written, None
+        self.assertEqual(len(buf.value), length.value)
+        return written, json.loads(buf.value.decode())
+
+    def _pages(self, records, total, size):
+        pages = []
+        offset = 0
+        while True:
+            written, page = self._page(records, total, offset, size)
+            self.assertIsNotNone(page)
+            pages.append(page)
+            offset += written
+            if page["last"]:
+                return pages
+
+    def test_sorts_by_rssi_keeping_ties_in_order(self) -> None:
+        records = make_records(("a", -70), ("b", -40), ("c", -70), ("d", -55))
+        self.assertEqual(self._compact(records, 4, dedup=False),
+                         [(b"b", -40), (b"d", -55), (b"a", -70), (b"c", -70)])
+
+    def test_dedup_keeps_strongest_per_ssid(self) -> None:
+        records = make_records(("home", -80), ("cafe", -60), ("home", -45), ("", -50), ("", -52), ("home", -90))
+        self.assertEqual(self._compact(records, 6, sort=False),
+                         [(b"home", -45), (b"cafe", -60), (b"", -50), (b"", -52)])
+
+    def test_compact_options_off_leave_records(self) -> None:
+        records = make_records(("x", -80), ("x", -40))
+        self.assertEqual(self._compact(records, 2, dedup=False, sort=False), [(b"x", -80), (b"x", -40)])
+
+    def test_single_page(self) -> None:
+        records = make_records(("home", -45), ("cafe", -60))
+        written, page = self._page(records, 2, 0, scan_id=7)
+        self.assertEqual(written, 2)
+        self.assertEqual(page["type"], "scan_results")
+        self.assertEqual(page["scan_id"], 7)
+        self.assertEqual((page["offset"], page["total"], page["last"]), (0, 2, True))
+        self.assertEqual(page["networks"][0], {"ssid": "home", "rssi": -45, "channel": 6, "auth": 4})
+
+    def test_empty_scan_is_one_last_page(self) -> None:
+        written, page = self._page(None, 0, 0)
+        self.assertEqual(written, 0)
+        self.assertEqual(page["networks"], [])
+        self.assertTrue(page["last"])
+
+    def test_splits_into_pages_that_fit(self) -> None:
+        entries = [("network-%02d" % i, -40 - i) for i in range(20)]
+        records = make_records(*entries)
+        pages = self._pages(records, 20, 300)
+        self.assertGreater(len(pages), 3)
+        names = [n["ssid"] for p in pages for n in p["networks"]]
+        self.assertEqual(names, [e[0] for e in entries])
+        offsets = [p["offset"] for p in pages]
+        self.assertEqual(offsets, sorted(offsets))
+        self.assertEqual([p["last"] for p in pages], [False] * (len(pages) - 1) + [True])
+
+    def test_buffer_too_small_for_any_page(self) -> None:
+        records = make_records(("home", -45))
+        written, page = self._page(records, 1, 0, size=40)
+        self.assertEqual(written, 0)
+        self.assertIsNone(page)
+
+    def test_escapes_and_replaces_invalid_utf8(self) -> None:
+        raw = b'a"b\\c\x01' + "é".encode() + b"\xff"
+        records = make_records((raw, -30), (b"x" * 32, -31))
+        _, page = self._page(records, 2, 0)
+        self.assertEqual(page["networks"][0]["ssid"], 'a"b\\c\x01é�')
+        self.assertEqual(page["networks"][1]["ssid"], "x" * 32)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -13,6 +13,7 @@ class KeyboardState(ctypes.Structure):
         ("modifiers", ctypes.c_uint8),
         ("reserved", ctypes.c_uint8),
         ("keys", ctypes.c_uint8 * 6),
+        ("bitmap", ctypes.c_uint8 * 15),
     ]
 
 
@@ -9,15 +9,42 @@ from pathlib import Path
 PROJECT_ROOT = Path(__file__).resolve().parents[1]
 MAIN_DIR = PROJECT_ROOT / "main"
 HID_MOUSE_REPORT_LEN = 6
+HID_HIRES_MOUSE_REPORT_LEN = 8
+HID_BOOT_MOUSE_REPORT_LEN = 3
+HID_POINTER_REPORT_LEN = 6
+HID_MOUSE_WHEEL_RESOLUTION = 8
 
 
 class MouseState(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_int16),
+        ("y", ctypes.c_int16),
+        ("wheel", ctypes.c_int16),
+        ("hwheel", ctypes.c_int16),
+        ("buttons", ctypes.c_uint8),
+    ]
+
+
+class HiresMouseFeature(ctypes.Structure):
     _pack_ = 1
     _fields_ = [
-        ("x", ctypes.c_int8),
-        ("y", ctypes.c_int8),
-        ("wheel", ctypes.c_int8),
-        ("hwheel", ctypes.c_int8),
+        ("report_id", ctypes.c_uint8),
+        ("wheel_multiplier", ctypes.c_uint8),
+        ("hwheel_multiplier", ctypes.c_uint8),
+    ]
+
+
+class WheelCarry(ctypes.Structure):
+    _fields_ = [
+        ("wheel", ctypes.c_int16),
+        ("hwheel", ctypes.c_int16),
+    ]
+
+
+class PointerAbsState(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_uint16),
+        ("y", ctypes.c_uint16),
         ("buttons", ctypes.c_uint8),
     ]
 
@@ -28,9 +55,27 @@ class WsMouseReportTest(unittest.TestCase):
         cls._lib = cls._build_test_library()
         cls._lib.mouse_build_report.argtypes = [
             ctypes.POINTER(MouseState),
+            ctypes.POINTER(WheelCarry),
             ctypes.POINTER(ctypes.c_uint8),
         ]
         cls._lib.mouse_build_report.restype = None
+        cls._lib.mouse_build_hires_report.argtypes = [
+            ctypes.POINTER(MouseState),
+            ctypes.POINTER(HiresMouseFeature),
+            ctypes.POINTER(WheelCarry),
+            ctypes.POINTER(ctypes.c_uint8),
+        ]
+        cls._lib.mouse_build_hires_report.restype = None
+        cls._lib.mouse_build_boot_report.argtypes = [
+            ctypes.POINTER(MouseState),
+            ctypes.POINTER(ctypes.c_uint8),
+        ]
+        cls._lib.mouse_build_boot_report.restype = None
+        cls._lib.pointer_abs_build_report.argtypes = [
+            ctypes.POINTER(PointerAbsState),
+            ctypes.POINTER(ctypes.c_uint8),
+        ]
+        cls._lib.pointer_abs_build_report.restype = None
 
     @staticmethod
     def _build_test_library() -> ctypes.CDLL:
@@ -60,8 +105,12 @@ class WsMouseReportTest(unittest.TestCase):
         state = MouseState()
         state.x = message.get("dx", 0)
         state.y = message.get("dy", 0)
-        state.wheel = message.get("wheel", 0)
-        state.hwheel = message.get("hwheel", 0)
+        state.wheel = (
+            message.get("wheel", 0) * HID_MOUSE_WHEEL_RESOLUTION + message.get("wheel_hr", 0)
+        )
+        state.hwheel = (
+            message.get("hwheel", 0) * HID_MOUSE_WHEEL_RESOLUTION + message.get("hwheel_hr", 0)
+        )
 
         buttons = message.get("buttons", {}) or {}
         state.buttons = 0
@@ -82,7 +131,7 @@ class WsMouseReportTest(unittest.TestCase):
         state = self._build_state_from_json(payload)
         report_buffer_type = ctypes.c_uint8 * HID_MOUSE_REPORT_LEN
         report_buffer = report_buffer_type()
-        self._lib.mouse_build_report(ctypes.byref(state), report_buffer)
+        self._lib.mouse_build_report(ctypes.byref(state), None, report_buffer)
         return list(report_buffer)
 
     def test_pure_x_delta_updates_third_axis_byte(self) -> None:
@@ -124,6 +173,91 @@ class WsMouseReportTest(unittest.TestCase):
         )
         self.assertEqual(report, [1, 0x01, 5, 0, 0, 0])
 
+    def test_legacy_report_saturates_wide_deltas(self) -> None:
+        report = self._report_for('{"type":"mouse","dx":300,"dy":-300}')
+        self.assertEqual(report, [1, 0x00, 0x7F, 0x81, 0, 0])
+
+    def _hires_report_for(self, payload: str, multiplier: int = 0) -> list[int]:
+        state = self._build_state_from_json(payload)
+        feature = HiresMouseFeature(5, multiplier, multiplier)
+        report_buffer = (ctypes.c_uint8 * HID_HIRES_MOUSE_REPORT_LEN)()
+        self._lib.mouse_build_hires_report(ctypes.byref(state), ctypes.byref(feature), None, report_buffer)
+        return list(report_buffer)
+
+    def test_hires_report_carries_16_bit_deltas(self) -> None:
+        report = self._hires_report_for('{"type":"mouse","dx":1000,"dy":-300}')
+        # 1000 = 0x03E8, -300 = 0xFED4, little-endian
+        self.assertEqual(report, [5, 0x00, 0xE8, 0x03, 0xD4, 0xFE, 0, 0])
+
+    def test_hires_wheel_uses_detents_until_multiplier_is_enabled(self) -> None:
+        payload = '{"type":"mouse","wheel":2,"hwheel_hr":3}'
+        self.assertEqual(self._hires_report_for(payload)[6:], [2, 0])
+        self.assertEqual(self._hires_report_for(payload, multiplier=1)[6:], [16, 3])
+
+    def test_legacy_wheel_carries_sub_detent_scroll(self) -> None:
+        carry = WheelCarry()
+        wheels = []
+        for _ in range(4):
+            state = self._build_state_from_json('{"type":"mouse","wheel_hr":3,"hwheel_hr":-3}')
+            report = (ctypes.c_uint8 * HID_MOUSE_REPORT_LEN)()
+            self._lib.mouse_build_report(ctypes.byref(state), ctypes.byref(carry), report)
+            wheels.append((ctypes.c_int8(report[4]).value, ctypes.c_int8(report[5]).value))
+        # 12/8 detents each way: one whole detent once 8 have built up
+        self.assertEqual(wheels, [(0, 0), (0, 0), (1, -1), (0, 0)])
+        self.assertEqual((carry.wheel, carry.hwheel), (4, -4))
+
+    def test_full_resolution_wheel_drops_carry(self) -> None:
+        carry = WheelCarry(5, -5)
+        state = self._build_state_from_json('{"type":"mouse","wheel_hr":-1,"hwheel_hr":1}')
+        feature = HiresMouseFeature(5, 1, 1)
+        report = (ctypes.c_uint8 * HID_HIRES_MOUSE_REPORT_LEN)()
+        self._lib.mouse_build_hires_report(ctypes.byref(state), ctypes.byref(feature), ctypes.byref(carry), report)
+        self.assertEqual([ctypes.c_int8(v).value for v in report[6:]], [-1, 1])
+        self.assertEqual((carry.wheel, carry.hwheel), (0, 0))
+
+    def test_boot_report_keeps_three_buttons_and_8_bit_axes(self) -> None:
+        state = self._build_state_from_json(
+            '{"type":"mouse","dx":-500,"dy":12,"buttons":{"left":true,"forward":true}}'
+        )
+        report_buffer = (ctypes.c_uint8 * HID_BOOT_MOUSE_REPORT_LEN)()
+        self._lib.mouse_build_boot_report(ctypes.byref(state), report_buffer)
+        self.assertEqual(list(report_buffer), [0x01, 0x81, 12])
+
+    def _pointer_report_for(self, payload: str) -> list[int]:
+        message = json.loads(payload)
+        if message.get("type") != "pointer_abs":
+            raise AssertionError("Message must describe an absolute pointer update")
+
+        state = PointerAbsState()
+        state.x = max(0, min(0xFFFF, message["x"]))
+        state.y = max(0, min(0xFFFF, message["y"]))
+        buttons = message.get("buttons", {}) or {}
+        state.buttons = 0
+        if buttons.get("left"):
+            state.buttons |= 0x01
+        if buttons.get("right"):
+            state.buttons |= 0x02
+        if buttons.get("middle"):
+            state.buttons |= 0x04
+
+        report_buffer = (ctypes.c_uint8 * HID_POINTER_REPORT_LEN)()
+        self._lib.pointer_abs_build_report(ctypes.byref(state), report_buffer)
+        return list(report_buffer)
+
+    def test_pointer_abs_encodes_little_endian_axes(self) -> None:
+        report = self._pointer_report_for('{"type":"pointer_abs","x":16384,"y":4660}')
+        self.assertEqual(report, [4, 0x00, 0x00, 0x40, 0x34, 0x12])
+
+    def test_pointer_abs_clamps_to_logical_maximum(self) -> None:
+        report = self._pointer_report_for('{"type":"pointer_abs","x":65535,"y":40000}')
+        self.assertEqual(report, [4, 0x00, 0xFF, 0x7F, 0xFF, 0x7F])
+
+    def test_pointer_abs_click_at_origin(self) -> None:
+        report = self._pointer_report_for(
+            '{"type":"pointer_abs","x":0,"y":0,"buttons":{"left":true,"middle":true}}'
+        )
+        self.assertEqual(report, [4, 0x05, 0, 0, 0, 0])
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Measure POST /api/input throughput against a running device.
+
+Sends batches of zero-motion mouse events (the pointer does not move, but
+every event takes the full decode and HID path) over one keep-alive
+connection, for several batch sizes. For each size it prints the events/s
+seen by the client, which includes Wi-Fi and HTTP overhead, and the mean
+events_per_s the device reports for decoding alone. Batch size 1 is the
+cost of one request per event.
+"""
+from __future__ import annotations
+
+import argparse
+import http.client
+import json
+import socket
+import time
+
+
+def make_batch(size: int) -> bytes:
+    event = json.dumps({"type": "mouse", "dx": 0, "dy": 0, "buttons": {}})
+    return ("\n".join([event] * size) + "\n").encode()
+
+
+def run(conn: http.client.HTTPConnection, size: int, requests: int) -> tuple[float, float, float]:
+    body = make_batch(size)
+    headers = {"Content-Type": "application/x-ndjson", "Connection": "keep-alive"}
+    device_rates = []
+    start = time.perf_counter()
+    for _ in range(requests):
+        conn.request("POST", "/api/input", body=body, headers=headers)
+        resp = conn.getresponse()
+        reply = json.loads(resp.read())
+        if resp.status != 200 or reply.get("events") != size:
+            raise SystemExit(f"batch of {size} failed: {resp.status} {reply}")
+        device_rates.append(reply.get("events_per_s", 0))
+    elapsed = time.perf_counter() - start
+    return size * requests / elapsed, elapsed / requests * 1000.0, sum(device_rates) / len(device_rates)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--sizes", default="1,10,50,200", help="comma-separated batch sizes")
+    parser.add_argument("--events", type=int, default=2000, help="events sent per batch size")
+    args = parser.parse_args()
+
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=10)
+    conn.connect()
+    # Headers and body go out as separate writes; without this, Nagle and
+    # delayed ACKs add ~40 ms to every request
+    conn.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    print(f"{'batch':>6} {'client ev/s':>12} {'ms/request':>11} {'device ev/s':>12}")
+    for size in (int(s) for s in args.sizes.split(",")):
+        requests = max(1, args.events // size)
+        client_rate, latency_ms, device_rate = run(conn, size, requests)
+        print(f"{size:>6} {client_rate:>12.0f} {latency_ms:>11.2f} {device_rate:>12.0f}")
+    conn.close()
+
+
+if __name__ == "__main__":
+    main()
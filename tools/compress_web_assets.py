@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Embed the web UI files as gzipped C arrays with build-time ETags.
+
+Run by main/CMakeLists.txt whenever a file under main/web changes. Every
+file under --root is served at its relative path, an index.html also at
+its directory, and extra files can be added as URI=FILE. The result is the
+``g_web_assets`` table declared in main/web_assets.h, sorted by path so the
+firmware can binary-search it. The gzip stream is written with a zero
+timestamp, so the same input always gives the same bytes and ETags.
+"""
+from __future__ import annotations
+
+import argparse
+import gzip
+import hashlib
+import mimetypes
+from pathlib import Path
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+    ".png": "image/png",
+}
+
+BYTES_PER_LINE = 16
+
+
+def content_type(path: Path) -> str:
+    guessed = CONTENT_TYPES.get(path.suffix.lower()) or mimetypes.guess_type(path.name)[0]
+    return guessed or "application/octet-stream"
+
+
+def etag(data: bytes) -> str:
+    # 64 bits of SHA-256 is plenty to tell firmware builds apart
+    return '"' + hashlib.sha256(data).hexdigest()[:16] + '"'
+
+
+def c_array(name: str, data: bytes) -> str:
+    lines = []
+    for i in range(0, len(data), BYTES_PER_LINE):
+        chunk = data[i:i + BYTES_PER_LINE]
+        lines.append("    " + ", ".join(f"0x{b:02x}" for b in chunk) + ",")
+    body = "\n".join(lines) if lines else "    0x00,"
+    return f"static const uint8_t {name}[] = {{\n{body}\n}};\n"
+
+
+def c_string(text: str) -> str:
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def collect(root: Path | None, extra: list[tuple[str, Path]]) -> list[tuple[str, Path]]:
+    assets: dict[str, Path] = {}
+    if root is not None:
+        for path in sorted(p for p in root.rglob("*") if p.is_file()):
+            rel = path.relative_to(root).as_posix()
+            if any(part.startswith(".") for part in rel.split("/")):
+                continue
+            assets["/" + rel] = path
+            if path.name == "index.html":
+                assets["/" + rel[: -len("index.html")]] = path
+    for uri, path in extra:
+        assets[uri] = path
+    # strcmp order, which is what web_assets_find searches by
+    return sorted(assets.items(), key=lambda item: item[0].encode())
+
+
+def render(assets: list[tuple[str, Path]]) -> str:
+    out = [
+        "// Generated by tools/compress_web_assets.py; do not edit.\n",
+        '#include "web_assets.h"\n',
+        "\n",
+    ]
+    # Aliases such as "/" and "/index.html" share one copy of the data
+    arrays: dict[Path, tuple[int, bytes, bytes]] = {}
+    entries = []
+    for uri, path in assets:
+        key = path.resolve()
+        if key not in arrays:
+            index = len(arrays)
+            raw = path.read_bytes()
+            packed = gzip.compress(raw, compresslevel=9, mtime=0)
+            arrays[key] = (index, raw, packed)
+            out.append(f"// {path.name}: {len(raw)} bytes, {len(packed)} gzipped\n")
+            out.append(c_array(f"s_asset_{index}", raw))
+            out.append(c_array(f"s_asset_{index}_gz", packed))
+            out.append("\n")
+        index, raw, packed = arrays[key]
+        entries.append(
+            "    {\n"
+            f"        .path = {c_string(uri)},\n"
+            f"        .content_type = {c_string(content_type(path))},\n"
+            f"        .data = s_asset_{index},\n"
+            f"        .size = {len(raw)},\n"
+            f"        .etag = {c_string(etag(raw))},\n"
+            f"        .gz_data = s_asset_{index}_gz,\n"
+            f"        .gz_size = {len(packed)},\n"
+            f"        .gz_etag = {c_string(etag(packed))},\n"
+            "    },\n"
+        )
+    out.append("const web_asset_t g_web_assets[] = {\n")
+    out.extend(entries)
+    out.append("};\n\n")
+    out.append(f"const size_t g_web_asset_count = {len(assets)};\n")
+    return "".join(out)
+
+
+def parse_asset(spec: str) -> tuple[str, Path]:
+    uri, sep, file = spec.partition("=")
+    if not sep or not uri.startswith("/") or not file:
+        raise argparse.ArgumentTypeError(f"expected URI=FILE, got {spec!r}")
+    return uri, Path(file)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--output", type=Path, required=True, help="C file to write")
+    parser.add_argument("--root", type=Path, help="directory served at /")
+    parser.add_argument("assets", nargs="*", type=parse_asset, metavar="URI=FILE")
+    args = parser.parse_args()
+
+    assets = collect(args.root, args.assets)
+    if not assets:
+        parser.error("no assets given")
+    args.output.parent.mkdir(parents=True, exist_ok=True)
+    args.output.write_text(render(assets), encoding="utf-8")
+
+
+if __name__ == "__main__":
+    main()
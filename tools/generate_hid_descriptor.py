@@ -0,0 +1,651 @@
+#!/usr/bin/env python3
+"""Generate the composite HID report descriptor and report layouts.
+
+The report map served over GATT, the packed report structs, byte offsets and
+Report Reference descriptors used by the firmware all come from the single
+declarative ``DESCRIPTOR`` spec below, so adding or reshaping a report only
+means editing the spec and re-running this script.
+"""
+from __future__ import annotations
+
+import argparse
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[1]
+HEADER_PATH = ROOT / "main" / "hid_report_descriptor.h"
+
+# Main item data bits
+CONST = 0x01
+VAR = 0x02
+REL = 0x04
+
+DATA_ARRAY = 0x00
+DATA_VAR_ABS = VAR
+DATA_VAR_REL = VAR | REL
+CONST_ARRAY = CONST
+CONST_VAR_ABS = CONST | VAR
+
+# Collection types
+PHYSICAL = 0x00
+APPLICATION = 0x01
+LOGICAL = 0x02
+
+# Report Reference types (HID over GATT)
+REPORT_TYPE_INPUT = 0x01
+REPORT_TYPE_OUTPUT = 0x02
+REPORT_TYPE_FEATURE = 0x03
+
+
+@dataclass
+class Item:
+    prefix: int
+    data: int | None
+    comment: str
+    signed: bool = False
+    # Main item annotations
+    name: str | None = None
+    usage_table: bool = False
+
+    @property
+    def kind(self) -> int:
+        return self.prefix & 0xFC
+
+    def encode(self) -> list[int]:
+        if self.data is None:
+            return [self.prefix]
+        if self.kind in (0x80, 0x90, 0xB0):
+            # Main items always carry one data byte, even when zero.
+            return [self.prefix | 0x01, self.data & 0xFF]
+        for size, code in ((1, 0x01), (2, 0x02), (4, 0x03)):
+            bits = size * 8
+            if self.signed:
+                fits = -(1 << (bits - 1)) <= self.data < (1 << (bits - 1))
+            else:
+                fits = 0 <= self.data < (1 << bits)
+            if fits:
+                value = self.data & ((1 << bits) - 1)
+                return [self.prefix | code] + [(value >> (8 * i)) & 0xFF for i in range(size)]
+        raise ValueError(f"Item data out of range: {self.data}")
+
+
+def usage_page(page: int, comment: str) -> Item:
+    return Item(0x04, page, f"Usage Page ({comment})")
+
+
+def usage(value: int, comment: str) -> Item:
+    return Item(0x08, value, f"Usage ({comment})")
+
+
+def usage_min(value: int, comment: str | None = None) -> Item:
+    return Item(0x18, value, f"Usage Minimum ({comment or value})")
+
+
+def usage_max(value: int, comment: str | None = None) -> Item:
+    return Item(0x28, value, f"Usage Maximum ({comment or value})")
+
+
+def logical_min(value: int) -> Item:
+    return Item(0x14, value, f"Logical Minimum ({value})", signed=True)
+
+
+def logical_max(value: int) -> Item:
+    return Item(0x24, value, f"Logical Maximum ({value})", signed=True)
+
+
+def physical_min(value: int) -> Item:
+    return Item(0x34, value, f"Physical Minimum ({value})", signed=True)
+
+
+def physical_max(value: int) -> Item:
+    return Item(0x44, value, f"Physical Maximum ({value})", signed=True)
+
+
+def report_size(bits: int, note: str = "") -> Item:
+    return Item(0x74, bits, f"Report Size ({bits}){note}")
+
+
+def report_count(count: int, note: str = "") -> Item:
+    return Item(0x94, count, f"Report Count ({count}){note}")
+
+
+def report_id(value: int) -> Item:
+    return Item(0x84, value, f"Report ID ({value})")
+
+
+def collection(kind: int, comment: str) -> Item:
+    return Item(0xA0, kind, f"Collection ({comment})")
+
+
+def end_collection() -> Item:
+    return Item(0xC0, None, "End Collection")
+
+
+def _main_comment(kind: str, flags: int, comment: str | None) -> str:
+    if comment:
+        return f"{kind} ({comment})"
+    parts = ["Constant" if flags & CONST else "Data"]
+    if flags & VAR:
+        parts.append("Variable")
+        parts.append("Relative" if flags & REL else "Absolute")
+    elif not flags & CONST:
+        parts.append("Array")
+    return f"{kind} ({', '.join(parts)})"
+
+
+def input_item(flags: int, name: str | None = None, comment: str | None = None,
+               usage_table: bool = False) -> Item:
+    return Item(0x80, flags, _main_comment("Input", flags, comment), name=name,
+                usage_table=usage_table)
+
+
+def output_item(flags: int, name: str | None = None, comment: str | None = None) -> Item:
+    return Item(0x90, flags, _main_comment("Output", flags, comment), name=name)
+
+
+def feature_item(flags: int, name: str | None = None, comment: str | None = None) -> Item:
+    return Item(0xB0, flags, _main_comment("Feature", flags, comment), name=name)
+
+
+@dataclass
+class Section:
+    """One top-level application collection and its report(s)."""
+
+    report: str
+    title: str
+    items: list[Item]
+
+
+# ---------------------------------------------------------------------------
+# Declarative spec. Named main items become struct fields; unnamed constant
+# items are padding. Report lengths include the leading Report ID byte, which
+# this firmware sends as part of every report-protocol notification.
+# ---------------------------------------------------------------------------
+DESCRIPTOR: list[Section] = [
+    Section(
+        report="mouse",
+        title="Mouse (Report ID 1) — five buttons with vertical & horizontal scroll",
+        items=[
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x02, "Mouse"),
+            collection(APPLICATION, "Application"),
+            report_id(1),
+            usage(0x01, "Pointer"),
+            collection(PHYSICAL, "Physical"),
+            usage_page(0x09, "Buttons"),
+            usage_min(0x01, "Button 1"),
+            usage_max(0x05, "Button 5"),
+            logical_min(0),
+            logical_max(1),
+            report_count(5),
+            report_size(1),
+            input_item(DATA_VAR_ABS, name="buttons"),
+            report_count(1, " - padding"),
+            report_size(3),
+            input_item(CONST_VAR_ABS),
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x30, "X"),
+            usage(0x31, "Y"),
+            usage(0x38, "Wheel"),
+            logical_min(-127),
+            logical_max(127),
+            report_size(8),
+            report_count(3),
+            input_item(DATA_VAR_REL, name="x,y,wheel"),
+            usage_page(0x0C, "Consumer"),
+            Item(0x08, 0x0238, "Usage (AC Pan) - horizontal scroll"),
+            logical_min(-127),
+            logical_max(127),
+            report_size(8),
+            report_count(1),
+            input_item(DATA_VAR_REL, name="hwheel"),
+            end_collection(),
+            end_collection(),
+        ],
+    ),
+    Section(
+        report="keyboard",
+        title="Keyboard (Report ID 2) — byte-for-byte match with reference",
+        items=[
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x06, "Keyboard"),
+            collection(APPLICATION, "Application"),
+            report_id(2),
+            report_size(1),
+            report_count(8),
+            usage_page(0x07, "Key Codes"),
+            usage_min(0xE0, "224"),
+            usage_max(0xE7, "231"),
+            logical_min(0),
+            logical_max(1),
+            input_item(DATA_VAR_ABS, name="modifiers"),
+            report_count(1),
+            report_size(8),
+            input_item(CONST_ARRAY, name="reserved", comment="Constant"),
+            report_count(5),
+            report_size(1),
+            usage_page(0x08, "LEDs"),
+            usage_min(0x01),
+            usage_max(0x05),
+            output_item(DATA_VAR_ABS, name="leds"),
+            report_count(1),
+            report_size(3),
+            output_item(CONST_ARRAY, comment="Constant"),
+            report_count(6),
+            report_size(8),
+            logical_min(0),
+            logical_max(101),
+            usage_page(0x07, "Key Codes"),
+            usage_min(0x00, "0"),
+            usage_max(0x65, "101"),
+            input_item(DATA_ARRAY, name="keys"),
+            end_collection(),
+        ],
+    ),
+    Section(
+        report="consumer",
+        title="Consumer Control (Report ID 3) — ESP32 combo bitfield layout",
+        items=[
+            usage_page(0x0C, "Consumer"),
+            usage(0x01, "Consumer Control"),
+            collection(APPLICATION, "Application"),
+            report_id(3),
+            usage_page(0x0C, "Consumer"),
+            logical_min(0),
+            logical_max(1),
+            report_size(1),
+            report_count(16),
+            usage(0x00B5, "Scan Next Track"),
+            usage(0x00B6, "Scan Previous Track"),
+            usage(0x00B7, "Stop"),
+            usage(0x00CD, "Play/Pause"),
+            usage(0x00E2, "Mute"),
+            usage(0x00E9, "Volume Up"),
+            usage(0x00EA, "Volume Down"),
+            usage(0x0223, "AC Home / WWW Home"),
+            usage(0x0194, "AL My Computer"),
+            usage(0x0192, "AL Calculator"),
+            usage(0x022A, "AC Bookmarks"),
+            usage(0x0221, "AC Search"),
+            usage(0x0226, "AC Stop"),
+            usage(0x0224, "AC Back"),
+            usage(0x0183, "AL Consumer Control Configuration / Media Select"),
+            usage(0x018A, "AL Email Reader / Mail"),
+            input_item(DATA_VAR_ABS, name="usages", usage_table=True),
+            end_collection(),
+        ],
+    ),
+    Section(
+        report="pointer",
+        title="Absolute Pointer (Report ID 4) — three buttons with 16-bit absolute X/Y",
+        items=[
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x02, "Mouse"),
+            collection(APPLICATION, "Application"),
+            report_id(4),
+            usage(0x01, "Pointer"),
+            collection(PHYSICAL, "Physical"),
+            usage_page(0x09, "Buttons"),
+            usage_min(0x01, "Button 1"),
+            usage_max(0x03, "Button 3"),
+            logical_min(0),
+            logical_max(1),
+            report_count(3),
+            report_size(1),
+            input_item(DATA_VAR_ABS, name="buttons"),
+            report_count(1, " - padding"),
+            report_size(5),
+            input_item(CONST_VAR_ABS),
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x30, "X"),
+            usage(0x31, "Y"),
+            logical_min(0),
+            logical_max(32767),
+            report_size(16),
+            report_count(2),
+            input_item(DATA_VAR_ABS, name="x,y"),
+            end_collection(),
+            end_collection(),
+        ],
+    ),
+    Section(
+        report="hires_mouse",
+        title="High-Resolution Mouse (Report ID 5) — 16-bit X/Y, wheels with Resolution Multiplier",
+        items=[
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x02, "Mouse"),
+            collection(APPLICATION, "Application"),
+            report_id(5),
+            usage(0x01, "Pointer"),
+            collection(PHYSICAL, "Physical"),
+            usage_page(0x09, "Buttons"),
+            usage_min(0x01, "Button 1"),
+            usage_max(0x05, "Button 5"),
+            logical_min(0),
+            logical_max(1),
+            report_count(5),
+            report_size(1),
+            input_item(DATA_VAR_ABS, name="buttons"),
+            report_count(1, " - padding"),
+            report_size(3),
+            input_item(CONST_VAR_ABS),
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x30, "X"),
+            usage(0x31, "Y"),
+            logical_min(-32767),
+            logical_max(32767),
+            report_size(16),
+            report_count(2),
+            input_item(DATA_VAR_REL, name="x,y"),
+            collection(LOGICAL, "Logical"),
+            usage(0x48, "Resolution Multiplier"),
+            logical_min(0),
+            logical_max(1),
+            physical_min(1),
+            physical_max(8),
+            report_size(2),
+            report_count(1),
+            feature_item(DATA_VAR_ABS, name="wheel_multiplier"),
+            report_size(6, " - padding"),
+            feature_item(CONST_VAR_ABS),
+            usage(0x38, "Wheel"),
+            logical_min(-127),
+            logical_max(127),
+            physical_min(0),
+            physical_max(0),
+            report_size(8),
+            input_item(DATA_VAR_REL, name="wheel"),
+            end_collection(),
+            collection(LOGICAL, "Logical"),
+            usage(0x48, "Resolution Multiplier"),
+            logical_min(0),
+            logical_max(1),
+            physical_min(1),
+            physical_max(8),
+            report_size(2),
+            feature_item(DATA_VAR_ABS, name="hwheel_multiplier"),
+            report_size(6, " - padding"),
+            feature_item(CONST_VAR_ABS),
+            usage_page(0x0C, "Consumer"),
+            Item(0x08, 0x0238, "Usage (AC Pan) - horizontal scroll"),
+            logical_min(-127),
+            logical_max(127),
+            physical_min(0),
+            physical_max(0),
+            report_size(8),
+            input_item(DATA_VAR_REL, name="hwheel"),
+            end_collection(),
+            end_collection(),
+            end_collection(),
+        ],
+    ),
+    Section(
+        report="keyboard_nkro",
+        title="N-Key Rollover Keyboard (Report ID 6) — modifiers plus a 120-key usage bitmap",
+        items=[
+            usage_page(0x01, "Generic Desktop"),
+            usage(0x06, "Keyboard"),
+            collection(APPLICATION, "Application"),
+            report_id(6),
+            usage_page(0x07, "Key Codes"),
+            usage_min(0xE0, "224"),
+            usage_max(0xE7, "231"),
+            logical_min(0),
+            logical_max(1),
+            report_size(1),
+            report_count(8),
+            input_item(DATA_VAR_ABS, name="modifiers"),
+            usage_min(0x00, "0"),
+            usage_max(0x77, "119"),
+            report_count(120),
+            input_item(DATA_VAR_ABS, name="keys"),
+            end_collection(),
+        ],
+    ),
+]
+
+
+@dataclass
+class Field:
+    name: str
+    bit_offset: int
+    size: int
+    count: int
+    signed: bool
+    logical_min: int = 0
+    logical_max: int = 0
+    constant: bool = False
+    physical_min: int = 0
+    physical_max: int = 0
+    usages: list[tuple[int, str]] = field(default_factory=list)
+
+    @property
+    def bits(self) -> int:
+        return self.size * self.count
+
+
+@dataclass
+class Layout:
+    report: str
+    direction: str
+    report_id: int
+    fields: list[Field] = field(default_factory=list)
+    bits: int = 0
+
+    @property
+    def length(self) -> int:
+        # Leading Report ID byte plus the payload rounded up to whole bytes.
+        return 1 + (self.bits + 7) // 8
+
+    @property
+    def ref_type(self) -> int:
+        return {
+            "input": REPORT_TYPE_INPUT,
+            "output": REPORT_TYPE_OUTPUT,
+            "feature": REPORT_TYPE_FEATURE,
+        }[self.direction]
+
+
+def build_layouts(sections: list[Section]) -> list[Layout]:
+    layouts: dict[tuple[int, str], Layout] = {}
+    order: list[Layout] = []
+
+    for section in sections:
+        globals_state = {"size": 0, "count": 0, "min": 0, "max": 0,
+                         "phys_min": 0, "phys_max": 0, "id": None}
+        local_usages: list[tuple[int, str]] = []
+
+        for item in section.items:
+            kind = item.kind
+            if kind == 0x84:
+                globals_state["id"] = item.data
+            elif kind == 0x74:
+                globals_state["size"] = item.data
+            elif kind == 0x94:
+                globals_state["count"] = item.data
+            elif kind == 0x14:
+                globals_state["min"] = item.data
+            elif kind == 0x24:
+                globals_state["max"] = item.data
+            elif kind == 0x34:
+                globals_state["phys_min"] = item.data
+            elif kind == 0x44:
+                globals_state["phys_max"] = item.data
+            elif kind == 0x08:
+                local_usages.append((item.data, item.comment[len("Usage ("):-1]))
+            elif kind in (0x80, 0x90, 0xB0):
+                direction = {0x80: "input", 0x90: "output", 0xB0: "feature"}[kind]
+                if globals_state["id"] is None:
+                    raise ValueError(f"{section.report}: main item before Report ID")
+                key = (globals_state["id"], direction)
+                layout = layouts.get(key)
+                if layout is None:
+                    layout = Layout(section.report, direction, globals_state["id"])
+                    layouts[key] = layout
+                    order.append(layout)
+                size, count = globals_state["size"], globals_state["count"]
+                signed = globals_state["min"] < 0
+                limits = (globals_state["min"], globals_state["max"], bool(item.data & CONST),
+                          globals_state["phys_min"], globals_state["phys_max"])
+                if item.name:
+                    names = item.name.split(",")
+                    if len(names) > 1:
+                        # Comma-separated names split a multi-count item into
+                        # one scalar field per usage (e.g. X, Y, Wheel).
+                        if len(names) != count:
+                            raise ValueError(f"{item.name}: expected {count} names")
+                        for index, name in enumerate(names):
+                            layout.fields.append(
+                                Field(name, layout.bits + index * size, size, 1, signed, *limits))
+                    else:
+                        layout.fields.append(
+                            Field(item.name, layout.bits, size, count, signed, *limits,
+                                  list(local_usages) if item.usage_table else []))
+                layout.bits += size * count
+            if kind in (0x80, 0x90, 0xB0, 0xA0, 0xC0):
+                local_usages = []
+
+    return order
+
+
+def _c_type(f: Field) -> tuple[str, str]:
+    """Return (C type, array suffix) for a field's storage."""
+    if f.count > 1 and f.size in (8, 16):
+        base = f"{'int' if f.signed else 'uint'}{f.size}_t"
+        return base, f"[{f.count}]"
+    if f.count == 1 and f.size in (8, 16):
+        return f"{'int' if f.signed else 'uint'}{f.size}_t", ""
+    storage = (f.bits + 7) // 8
+    if storage == 1:
+        return "uint8_t", ""
+    if storage == 2:
+        return "uint16_t", ""
+    return "uint8_t", f"[{storage}]"
+
+
+def _macro(*parts: str) -> str:
+    return "_".join(p.upper() for p in parts if p)
+
+
+def render_descriptor(sections: list[Section]) -> list[str]:
+    lines = ["// Combined HID Report Descriptor (generated from tools/generate_hid_descriptor.py)",
+             "static const uint8_t hid_report_map[] = {"]
+    for index, section in enumerate(sections):
+        if index:
+            lines.append("")
+        lines.append(f"    // {section.title}")
+        depth = 0
+        for item in section.items:
+            if item.kind == 0xC0:
+                depth -= 1
+            encoded = ", ".join(f"0x{b:02X}" for b in item.encode()) + ","
+            lines.append(f"    {encoded:<18} // {'  ' * depth}{item.comment}")
+            if item.kind == 0xA0:
+                depth += 1
+    lines.append("};")
+    return lines
+
+
+def render_header(sections: list[Section]) -> str:
+    layouts = build_layouts(sections)
+    out = [
+        "// Generated by tools/generate_hid_descriptor.py - do not edit by hand.",
+        "#pragma once",
+        "#include <stdint.h>",
+        "",
+    ]
+
+    seen_ids: set[str] = set()
+    for layout in layouts:
+        if layout.report in seen_ids:
+            continue
+        seen_ids.add(layout.report)
+        out.append(f"#define {_macro('hid_report_id', layout.report)} 0x{layout.report_id:02X}")
+    out.append("")
+
+    out.extend(render_descriptor(sections))
+    out.append("")
+
+    for layout in layouts:
+        prefix = _macro("hid", layout.report, layout.direction)
+        struct_name = f"hid_{layout.report}_{layout.direction}_report_t"
+        out.append(f"// Report ID {layout.report_id} {layout.direction}")
+        out.append(f"#define {prefix}_REPORT_LEN {layout.length}")
+
+        members = ["    uint8_t report_id;"]
+        cursor = 0
+        for f in layout.fields:
+            if f.bit_offset < cursor:
+                raise ValueError(f"{layout.report}.{f.name} overlaps previous field")
+            if f.bit_offset % 8:
+                raise ValueError(f"{layout.report}.{f.name} is not byte aligned")
+            if f.bit_offset > cursor:
+                gap = (f.bit_offset - cursor) // 8
+                members.append(f"    uint8_t _pad{cursor // 8}[{gap}];")
+            c_type, suffix = _c_type(f)
+            members.append(f"    {c_type} {f.name}{suffix};")
+            storage_bits = ((f.bits + 7) // 8) * 8
+            cursor = f.bit_offset + storage_bits
+
+            field_prefix = _macro(prefix, f.name)
+            out.append(f"#define {field_prefix}_OFFSET {1 + f.bit_offset // 8}")
+            if f.size == 1:
+                out.append(f"#define {field_prefix}_BITS {f.bits}")
+                if f.bits <= 16:
+                    out.append(f"#define {field_prefix}_MASK 0x{(1 << f.bits) - 1:0{4 if f.bits > 8 else 2}X}")
+            elif not f.constant:
+                out.append(f"#define {field_prefix}_LOGICAL_MIN ({f.logical_min})")
+                out.append(f"#define {field_prefix}_LOGICAL_MAX ({f.logical_max})")
+                if f.physical_min or f.physical_max:
+                    out.append(f"#define {field_prefix}_PHYSICAL_MIN ({f.physical_min})")
+                    out.append(f"#define {field_prefix}_PHYSICAL_MAX ({f.physical_max})")
+                if f.count > 1:
+                    out.append(f"#define {field_prefix}_COUNT {f.count}")
+        if cursor < layout.bits:
+            members.append(f"    uint8_t _pad{cursor // 8}[{(layout.bits - cursor + 7) // 8}];")
+
+        out.append("")
+        out.append("typedef struct __attribute__((packed))")
+        out.append("{")
+        out.extend(members)
+        out.append(f"}} {struct_name};")
+        out.append(f"_Static_assert(sizeof({struct_name}) == {prefix}_REPORT_LEN,")
+        out.append(f"               \"{struct_name} does not match the report map\");")
+        out.append("")
+        out.append(f"static const uint8_t hid_{layout.report}_{layout.direction}_report_ref[] = "
+                   f"{{0x{layout.report_id:02X}, 0x{layout.ref_type:02X}}};")
+        out.append("")
+
+        for f in layout.fields:
+            if not f.usages:
+                continue
+            table = f"hid_{layout.report}_{f.name}"
+            out.append(f"// {layout.report.capitalize()} {f.name}: bit n of the field maps to entry n")
+            out.append(f"static const uint16_t {table}[] = {{")
+            for value, comment in f.usages:
+                out.append(f"    0x{value:04X}, // {comment}")
+            out.append("};")
+            out.append("")
+
+    return "\n".join(out).rstrip() + "\n"
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="fail if the committed header is out of date")
+    args = parser.parse_args()
+
+    content = render_header(DESCRIPTOR)
+    if args.check:
+        current = HEADER_PATH.read_text(encoding="utf-8") if HEADER_PATH.exists() else ""
+        if current != content:
+            sys.exit(f"{HEADER_PATH.relative_to(ROOT)} is stale; run tools/generate_hid_descriptor.py")
+        return
+
+    HEADER_PATH.write_text(content, encoding="utf-8")
+
+
+if __name__ == "__main__":
+    main()